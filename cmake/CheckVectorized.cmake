@@ -0,0 +1,53 @@
+# cmake/CheckVectorized.cmake
+# Confere, pelo relatório do gcc (-fopt-info-vec), que o laço logo abaixo
+# de um marcador vetoriza. Roda em modo script (cmake -P), via ctest:
+#
+#   -DCC=<gcc> -DSOURCE=<arquivo .c> -DHEADER=<arquivo com o laço>
+#   -DMARKER=<texto do comentário> -DINCLUDES=<dir;dir> -DEXPECT=<n>
+#   -DFLAGS=<flags separadas por ;>
+#
+# EXPECT é quantas vezes o laço precisa aparecer vetorizado (um header
+# incluído N vezes gera N laços na mesma linha).
+
+foreach(var CC SOURCE HEADER MARKER INCLUDES EXPECT FLAGS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "CheckVectorized: falta -D${var}")
+    endif()
+endforeach()
+
+# Linha do marcador = quebras de linha antes dele + 1; o laço vem depois
+file(READ "${HEADER}" content)
+string(FIND "${content}" "${MARKER}" at)
+if(at LESS 0)
+    message(FATAL_ERROR "CheckVectorized: marcador ${MARKER} não achado")
+endif()
+string(SUBSTRING "${content}" 0 ${at} before)
+string(REGEX MATCHALL "\n" breaks "${before}")
+list(LENGTH breaks loop_line)
+math(EXPR loop_line "${loop_line} + 2")
+
+set(include_flags)
+foreach(dir IN LISTS INCLUDES)
+    list(APPEND include_flags "-I${dir}")
+endforeach()
+
+execute_process(
+    COMMAND "${CC}" ${FLAGS} -std=gnu11 ${include_flags}
+            -fopt-info-vec-optimized -c "${SOURCE}" -o /dev/null
+    RESULT_VARIABLE result
+    ERROR_VARIABLE report
+    OUTPUT_QUIET)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "CheckVectorized: falha ao compilar:\n${report}")
+endif()
+
+get_filename_component(header_name "${HEADER}" NAME)
+string(REGEX MATCHALL "${header_name}:${loop_line}:[0-9]+: optimized: loop vectorized"
+       hits "${report}")
+list(LENGTH hits count)
+if(count LESS EXPECT)
+    message(FATAL_ERROR
+        "CheckVectorized: ${header_name}:${loop_line} vetorizou ${count} "
+        "de ${EXPECT} vezes com '${FLAGS}'")
+endif()
+message(STATUS "${header_name}:${loop_line}: ${count} laços vetorizados com '${FLAGS}'")
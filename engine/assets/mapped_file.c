@@ -0,0 +1,182 @@
+/**
+ * @file mapped_file.c
+ * @brief mmap / MapViewOfFile atrás da mesma interface
+ *
+ * "Memória virtual: a única mentira que todo mundo aceita."
+ */
+
+#include "mapped_file.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int bhs_mapped_file_open(struct bhs_mapped_file *mf, const char *path)
+{
+	mf->data = NULL;
+	mf->size = 0;
+	mf->handle = NULL;
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+				  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return -1;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return -1;
+	}
+
+	/* O mapping segura o arquivo sozinho: o handle pode fechar já */
+	HANDLE mapping =
+		CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!mapping)
+		return -1;
+
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(mapping);
+		return -1;
+	}
+
+	mf->data = view;
+	mf->size = (size_t)size.QuadPart;
+	mf->handle = mapping;
+	return 0;
+}
+
+void bhs_mapped_file_close(struct bhs_mapped_file *mf)
+{
+	if (mf->data)
+		UnmapViewOfFile(mf->data);
+	if (mf->handle)
+		CloseHandle(mf->handle);
+	mf->data = NULL;
+	mf->size = 0;
+	mf->handle = NULL;
+}
+
+int bhs_atomic_file_create(struct bhs_atomic_file *af, const char *path)
+{
+	static atomic_uint counter;
+
+	af->f = NULL;
+	af->path = path;
+
+	/* "x": falha se o nome já existe, então nenhum escritor trunca outro */
+	for (int tries = 0; tries < 16; tries++) {
+		unsigned id = atomic_fetch_add(&counter, 1);
+		int n = snprintf(af->tmp, sizeof(af->tmp), "%s.%lu.%u", path,
+				 (unsigned long)GetCurrentProcessId(), id);
+		if (n < 0 || (size_t)n >= sizeof(af->tmp))
+			return -1;
+
+		af->f = fopen(af->tmp, "wbx");
+		if (af->f)
+			return 0;
+	}
+	return -1;
+}
+
+int bhs_atomic_file_commit(struct bhs_atomic_file *af, bool ok)
+{
+	if (fclose(af->f) != 0)
+		ok = false;
+	af->f = NULL;
+
+	/* rename() do CRT não substitui um destino existente */
+	if (!ok || !MoveFileExA(af->tmp, af->path, MOVEFILE_REPLACE_EXISTING)) {
+		remove(af->tmp);
+		return -1;
+	}
+	return 0;
+}
+
+#else /* POSIX */
+
+int bhs_mapped_file_open(struct bhs_mapped_file *mf, const char *path)
+{
+	mf->data = NULL;
+	mf->size = 0;
+	mf->handle = NULL;
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return -1;
+	}
+
+	/* O mapeamento sobrevive ao close() do descritor */
+	void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return -1;
+
+	mf->data = p;
+	mf->size = (size_t)st.st_size;
+	return 0;
+}
+
+void bhs_mapped_file_close(struct bhs_mapped_file *mf)
+{
+	if (mf->data)
+		munmap((void *)mf->data, mf->size);
+	mf->data = NULL;
+	mf->size = 0;
+	mf->handle = NULL;
+}
+
+int bhs_atomic_file_create(struct bhs_atomic_file *af, const char *path)
+{
+	af->f = NULL;
+	af->path = path;
+
+	int n = snprintf(af->tmp, sizeof(af->tmp), "%s.XXXXXX", path);
+	if (n < 0 || (size_t)n >= sizeof(af->tmp))
+		return -1;
+
+	int fd = mkstemp(af->tmp);
+	if (fd < 0)
+		return -1;
+
+	/* mkstemp cria 0600; o cache é para outros processos lerem */
+	fchmod(fd, 0644);
+	af->f = fdopen(fd, "wb");
+	if (!af->f) {
+		close(fd);
+		remove(af->tmp);
+		return -1;
+	}
+	return 0;
+}
+
+int bhs_atomic_file_commit(struct bhs_atomic_file *af, bool ok)
+{
+	if (fclose(af->f) != 0)
+		ok = false;
+	af->f = NULL;
+
+	if (!ok || rename(af->tmp, af->path) != 0) {
+		remove(af->tmp);
+		return -1;
+	}
+	return 0;
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file mapped_file.h
+ * @brief Arquivo mapeado em memória, só leitura
+ *
+ * "fread copia. mmap só promete. O kernel cumpre quando você olhar."
+ *
+ * Caches grandes (mapas de deflexão, tabelas de métrica) são abertos com
+ * mmap: o custo de abrir é O(1), as páginas vêm sob demanda e vários
+ * processos renderizando a mesma configuração dividem o mesmo page cache.
+ *
+ * Do lado da escrita, bhs_atomic_file grava num temporário só seu e
+ * renomeia por cima do destino: quem mapeia vê o arquivo antigo ou o
+ * novo inteiro, nunca um pela metade.
+ */
+
+#ifndef BHS_ENGINE_ASSETS_MAPPED_FILE_H
+#define BHS_ENGINE_ASSETS_MAPPED_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * struct bhs_mapped_file - Mapeamento só leitura de um arquivo inteiro
+ * @data: início do arquivo (NULL se fechado)
+ * @size: tamanho em bytes
+ * @handle: recurso do SO (mapping no Windows; não usado em POSIX)
+ */
+struct bhs_mapped_file {
+	const void *data;
+	size_t size;
+	void *handle;
+};
+
+/**
+ * bhs_mapped_file_open - Mapeia @path inteiro para leitura
+ * @mf: [out] mapeamento (zerado em falha)
+ * @path: caminho do arquivo
+ *
+ * Arquivo vazio é erro: não há o que mapear.
+ *
+ * Retorna: 0 em sucesso, -1 se não abrir ou não mapear
+ */
+int bhs_mapped_file_open(struct bhs_mapped_file *mf, const char *path);
+
+/**
+ * bhs_mapped_file_close - Desfaz o mapeamento (aceita fechado/zerado)
+ */
+void bhs_mapped_file_close(struct bhs_mapped_file *mf);
+
+/**
+ * struct bhs_atomic_file - Arquivo sendo escrito num temporário
+ * @f: stream de escrita (binário)
+ * @path: destino final
+ * @tmp: temporário, único por escritor ("<path>.XXXXXX")
+ */
+struct bhs_atomic_file {
+	FILE *f;
+	const char *path;
+	char tmp[4096];
+};
+
+/**
+ * bhs_atomic_file_create - Abre um temporário novo ao lado de @path
+ * @af: [out] escritor
+ * @path: destino (precisa viver até o commit)
+ *
+ * Dois escritores do mesmo @path nunca dividem o temporário: o nome é
+ * criado com exclusividade (mkstemp no POSIX, pid + contador no Windows).
+ *
+ * Retorna: 0 em sucesso, -1 se o nome não couber ou não criar
+ */
+int bhs_atomic_file_create(struct bhs_atomic_file *af, const char *path);
+
+/**
+ * bhs_atomic_file_commit - Fecha e publica (ou descarta) o temporário
+ * @af: escritor aberto
+ * @ok: toda a escrita deu certo
+ *
+ * Com @ok e fclose bem-sucedido, renomeia o temporário sobre o destino
+ * (substituindo o anterior); caso contrário apaga o temporário.
+ *
+ * Retorna: 0 se publicou, -1 caso contrário
+ */
+int bhs_atomic_file_commit(struct bhs_atomic_file *af, bool ok);
+
+#endif /* BHS_ENGINE_ASSETS_MAPPED_FILE_H */
@@ -13,6 +13,10 @@
 #include "disk.h"
 #include <math.h>
 
+#include "engine/components/disk/spectrum.h"
+#include "math/once.h"
+#include "math/spacetime/kerr_spin.h"
+
 /* ============================================================================
  * FUNÇÕES AUXILIARES INTERNAS
  * ============================================================================
@@ -77,8 +81,10 @@ static double kerr_circular_energy(const struct bhs_kerr *bh, double r)
 
 double bhs_disk_isco(const struct bhs_kerr *bh)
 {
-	/* Usa a função do módulo Kerr */
-	return bhs_kerr_isco(bh, true); /* Prograde */
+	/* Tabela de spin: sem as raízes cúbicas a cada amostra do disco */
+	struct bhs_kerr_radii radii;
+	bhs_kerr_spin_radii(bh, &radii);
+	return radii.isco_pro;
 }
 
 /* ============================================================================
@@ -232,6 +238,29 @@ double bhs_disk_doppler_factor(const struct bhs_kerr *bh, double r, double phi,
 	return 1.0 / (1.0 + z);
 }
 
+double bhs_disk_g_factor(const struct bhs_kerr *bh, double r, double xi)
+{
+	/*
+	 * u^μ = u^t (1, 0, 0, Ω) e p_μ = E (-1, p_r, p_θ, ξ):
+	 *   -p_μ u^μ = E u^t (1 - Ω ξ)
+	 * com (Bardeen, Press & Teukolsky 1972)
+	 *   u^t = (r^(3/2) + a√M) / (r^(3/4) √(r^(3/2) - 3M√r + 2a√M))
+	 */
+	double M = bh->M;
+	double a = bh->a;
+	double sqrtM = sqrt(M);
+	double sr = sqrt(r);
+	double r32 = r * sr;
+
+	double den = r32 - 3.0 * M * sr + 2.0 * a * sqrtM;
+	if (den <= 0.0)
+		return 0.0; /* Dentro da órbita de fótons */
+
+	double ut = (r32 + a * sqrtM) / sqrt(r32 * den);
+	double omega = sqrtM / (r32 + a * sqrtM);
+	return 1.0 / (ut * (1.0 - omega * xi));
+}
+
 /* ============================================================================
  * CORES
  * ============================================================================
@@ -289,61 +318,70 @@ struct bhs_color_rgb bhs_blackbody_color(double temperature)
 	return c;
 }
 
-struct bhs_color_rgb bhs_color_apply_redshift(struct bhs_color_rgb color,
-					      double z)
+/*
+ * Deslocamento de cor de bhs_color_apply_redshift(), antes do brilho e da
+ * saturação. É linear em z de cada lado de z = 0, o que a tabela de cores
+ * do sombreamento em lote aproveita.
+ */
+static void redshift_tint(struct bhs_color_rgb color, double z, double out[3])
 {
-	/*
-   * Aplica redshift à cor de forma simplificada.
-   *
-   * z > 0: redshift (mais vermelho)
-   * z < 0: blueshift (mais azul)
-   *
-   * Também ajusta brilho (redshift = dimmer, blueshift = brighter)
-   */
-	struct bhs_color_rgb result;
+	double shift = -z * 0.3; /* Quanto deslocar no espectro */
+
+	if (shift > 0) {
+		/* Blueshift: mais azul */
+		out[0] = color.r * (1.0 - shift);
+		out[1] = color.g;
+		out[2] = color.b + shift * (1.0 - color.b);
+	} else {
+		/* Redshift: mais vermelho */
+		shift = -shift;
+		out[0] = color.r + shift * (1.0 - color.r);
+		out[1] = color.g * (1.0 - shift * 0.5);
+		out[2] = color.b * (1.0 - shift);
+	}
+}
 
-	/* Fator de brilho (beaming) */
+/* Fator de brilho (beaming): g⁴ para intensidade bolométrica */
+static double redshift_brightness(double z)
+{
 	double g = 1.0 / (1.0 + z);
-	double brightness =
-		g * g * g * g; /* g^4 para intensidade bolométrica */
+	double brightness = g * g * g * g;
 
 	/* Clamp brightness */
 	if (brightness > 5.0)
 		brightness = 5.0;
 	if (brightness < 0.05)
 		brightness = 0.05;
+	return brightness;
+}
 
-	/* Deslocamento de cor */
-	double shift = -z * 0.3; /* Quanto deslocar no espectro */
+static float clamp_unit(double v)
+{
+	return (float)(v > 1.0 ? 1.0 : (v < 0.0 ? 0.0 : v));
+}
 
-	if (shift > 0) {
-		/* Blueshift: mais azul */
-		result.r = color.r * (1.0 - shift) * brightness;
-		result.g = color.g * brightness;
-		result.b = (color.b + shift * (1.0 - color.b)) * brightness;
-	} else {
-		/* Redshift: mais vermelho */
-		shift = -shift;
-		result.r = (color.r + shift * (1.0 - color.r)) * brightness;
-		result.g = color.g * (1.0 - shift * 0.5) * brightness;
-		result.b = color.b * (1.0 - shift) * brightness;
-	}
+struct bhs_color_rgb bhs_color_apply_redshift(struct bhs_color_rgb color,
+					      double z)
+{
+	/*
+	 * Aplica redshift à cor de forma simplificada.
+	 *
+	 * z > 0: redshift (mais vermelho)
+	 * z < 0: blueshift (mais azul)
+	 *
+	 * Também ajusta brilho (redshift = dimmer, blueshift = brighter)
+	 */
+	double tint[3];
+	double brightness = redshift_brightness(z);
+
+	redshift_tint(color, z, tint);
 
 	/* Clamp final */
-	if (result.r > 1.0)
-		result.r = 1.0;
-	if (result.g > 1.0)
-		result.g = 1.0;
-	if (result.b > 1.0)
-		result.b = 1.0;
-	if (result.r < 0.0)
-		result.r = 0.0;
-	if (result.g < 0.0)
-		result.g = 0.0;
-	if (result.b < 0.0)
-		result.b = 0.0;
-
-	return result;
+	return (struct bhs_color_rgb){
+		clamp_unit(tint[0] * brightness),
+		clamp_unit(tint[1] * brightness),
+		clamp_unit(tint[2] * brightness),
+	};
 }
 
 struct bhs_color_rgb bhs_disk_color(const struct bhs_kerr *bh,
@@ -367,3 +405,202 @@ struct bhs_color_rgb bhs_disk_color(const struct bhs_kerr *bh,
 	/* Aplica redshift */
 	return bhs_color_apply_redshift(base_color, z);
 }
+
+/* ============================================================================
+ * SOMBREAMENTO EM LOTE
+ * ============================================================================
+ */
+
+/*
+ * Tabela global (temperatura × z) → deslocamento de cor, antes do brilho.
+ * 255 intervalos em T põem as quebras do corpo negro (0.2, 0.4, ...) em
+ * nós; em z os nós vão de -0.5 a 1.5 em passos de 1/16, com z = 0 num nó.
+ * Fora dessa faixa a célula da ponta extrapola, o que é exato porque o
+ * deslocamento é linear em z de cada lado de 0.
+ */
+#define TINT_TEMP 256
+#define TINT_Z 33
+#define TINT_Z_MIN (-0.5)
+#define TINT_Z_RES 16.0
+
+static float tint_table[TINT_TEMP][TINT_Z][3];
+
+/* Estado de bhs_once() */
+static atomic_int tint_state;
+
+static void build_tint_table(void)
+{
+	for (int i = 0; i < TINT_TEMP; i++) {
+		struct bhs_color_rgb c =
+			bhs_blackbody_color(i / (TINT_TEMP - 1.0));
+		for (int k = 0; k < TINT_Z; k++) {
+			double tint[3];
+			redshift_tint(c, TINT_Z_MIN + k / TINT_Z_RES, tint);
+			for (int ch = 0; ch < 3; ch++)
+				tint_table[i][k][ch] = (float)tint[ch];
+		}
+	}
+}
+
+static void tint_table_ensure(void)
+{
+	bhs_once(&tint_state, build_tint_table);
+}
+
+void bhs_disk_shade_init(struct bhs_disk_shade *t, const struct bhs_kerr *bh,
+			 const struct bhs_disk *disk, double inclination)
+{
+	double isco = bhs_disk_isco(bh);
+	double outer = disk->outer_radius;
+	double sin_incl = sin(inclination);
+
+	t->M = bh->M;
+	t->r_isco = isco;
+	t->r_outer = outer;
+	t->kelvin = 0.0;
+	t->y_norm = 0.0;
+
+	/* Disco vazio: todo raio cai fora de [r_isco, r_outer] */
+	double p_out = 0.0;
+	if (outer > isco)
+		p_out = sqrt(sqrt(1.0 - sqrt(isco / outer)));
+	t->p_scale = p_out > 0.0 ? (BHS_DISK_SHADE_NODES - 1) / p_out : 0.0;
+
+	for (int j = 0; j < BHS_DISK_SHADE_NODES; j++) {
+		double p = p_out * j / (BHS_DISK_SHADE_NODES - 1);
+		double w = 1.0 - p * p * p * p;
+		double r = isco / (w * w);
+
+		/* Arredondamento não pode jogar o último nó fora do anel */
+		r = fmin(fmax(r, isco), fmax(outer, isco));
+		t->temp[j] = (float)bhs_disk_temperature(bh, disk, r);
+		t->v_los[j] = (float)(bhs_disk_velocity_phi(bh, r) * sin_incl);
+	}
+}
+
+/* Cor de (T, z) pela tabela global; abaixo do corte de bhs_disk_color, preto */
+static struct bhs_color_rgb tint_lookup(float temp, double z)
+{
+	if (!(temp >= 0.001f))
+		return (struct bhs_color_rgb){ 0.0f, 0.0f, 0.0f };
+
+	float tp = fminf(temp, 1.0f) * (TINT_TEMP - 1);
+	int ti = tp < TINT_TEMP - 2 ? (int)tp : TINT_TEMP - 2;
+	float tf = tp - ti;
+
+	/* z fora da faixa: extrapola a célula da ponta */
+	float zp = (float)((z - TINT_Z_MIN) * TINT_Z_RES);
+	float zc = fminf(fmaxf(zp, 0.0f), TINT_Z - 2);
+	int zi = (int)zc;
+	float zf = zp - zi;
+
+	const float *c00 = tint_table[ti][zi], *c01 = tint_table[ti][zi + 1];
+	const float *c10 = tint_table[ti + 1][zi];
+	const float *c11 = tint_table[ti + 1][zi + 1];
+	double brightness = redshift_brightness(z);
+	float v[3];
+
+	for (int ch = 0; ch < 3; ch++) {
+		float lo = c00[ch] + zf * (c01[ch] - c00[ch]);
+		float hi = c10[ch] + zf * (c11[ch] - c10[ch]);
+		v[ch] = clamp_unit((lo + tf * (hi - lo)) * brightness);
+	}
+	return (struct bhs_color_rgb){ v[0], v[1], v[2] };
+}
+
+/*
+ * Fase radial de um bloco de até BHS_DISK_SHADE_LANES amostras: índice na
+ * grade em p, temperatura normalizada (0 fora do anel) e z, sem desvio
+ * por amostra
+ */
+static void shade_radial(const struct bhs_disk_shade *t, const double *r,
+			 const double *phi, const double *g, int m,
+			 float *temp, double *z)
+{
+	enum { LAST = BHS_DISK_SHADE_NODES - 2 };
+
+	for (int k = 0; k < m; k++) {
+		double rr = r[k];
+		int lit = rr >= t->r_isco && rr <= t->r_outer;
+		double q = fmax(1.0 - sqrt(t->r_isco / rr), 0.0);
+		double pos = lit ? sqrt(sqrt(q)) * t->p_scale : 0.0;
+		int j = pos < LAST ? (int)pos : LAST;
+		float f = (float)(pos - j);
+
+		const float *tj = &t->temp[j], *vj = &t->v_los[j];
+		float tk = tj[0] + f * (tj[1] - tj[0]);
+		float vk = vj[0] + f * (vj[1] - vj[0]);
+		temp[k] = lit ? tk : 0.0f;
+
+		/* Mesmo z de bhs_disk_redshift_total() */
+		double fg = 1.0 - 2.0 * t->M / rr;
+		double zg =
+			fg > 0.01 ? 1.0 / sqrt(fmax(fg, 0.01)) - 1.0 : 100.0;
+		z[k] = g ? 1.0 / g[k] - 1.0
+			 : (1.0 + zg) * (1.0 + vk * sin(phi[k])) - 1.0;
+	}
+}
+
+void bhs_disk_shade_batch(const struct bhs_disk_shade *t, const double *r,
+			  const double *phi, const double *g, int n,
+			  struct bhs_color_rgb *out)
+{
+	enum { LANES = BHS_DISK_SHADE_LANES };
+
+	tint_table_ensure();
+
+	for (int i0 = 0; i0 < n; i0 += LANES) {
+		int m = n - i0 < LANES ? n - i0 : LANES;
+		float temp[LANES];
+		double z[LANES];
+
+		shade_radial(t, r + i0, phi ? phi + i0 : NULL,
+			     g ? g + i0 : NULL, m, temp, z);
+		for (int k = 0; k < m; k++)
+			out[i0 + k] = tint_lookup(temp[k], z[k]);
+	}
+}
+
+void bhs_disk_shade_spectral_init(struct bhs_disk_shade *t, double t_peak)
+{
+	float peak = 0.0f;
+	for (int j = 0; j < BHS_DISK_SHADE_NODES; j++)
+		peak = fmaxf(peak, t->temp[j]);
+
+	double spec[BHS_SPECTRUM_BINS], xyz[3];
+	bhs_spectrum_blackbody(t_peak, spec);
+	bhs_spectrum_to_xyz(spec, xyz);
+
+	t->kelvin = peak > 0.0f ? t_peak / peak : 0.0;
+	t->y_norm = xyz[1] > 0.0 ? 1.0 / xyz[1] : 0.0;
+}
+
+void bhs_disk_shade_spectral(const struct bhs_disk_shade *t, const double *r,
+			     const double *phi, const double *g, int n,
+			     struct bhs_color_rgb *out)
+{
+	enum { LANES = BHS_DISK_SHADE_LANES };
+
+	for (int i0 = 0; i0 < n; i0 += LANES) {
+		int m = n - i0 < LANES ? n - i0 : LANES;
+		float temp[LANES];
+		double z[LANES];
+
+		shade_radial(t, r + i0, phi ? phi + i0 : NULL,
+			     g ? g + i0 : NULL, m, temp, z);
+
+		/* Mesmo corte de bhs_disk_color; fora dele, preto */
+		for (int k = 0; k < m; k++) {
+			double spec[BHS_SPECTRUM_BINS], xyz[3];
+			double T = temp[k] >= 0.001f
+					   ? t->kelvin * temp[k] / (1.0 + z[k])
+					   : 0.0;
+
+			bhs_spectrum_blackbody(T, spec);
+			bhs_spectrum_to_xyz(spec, xyz);
+			for (int c = 0; c < 3; c++)
+				xyz[c] *= t->y_norm;
+			out[i0 + k] = bhs_spectrum_xyz_to_rgb(xyz);
+		}
+	}
+}
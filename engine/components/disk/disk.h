@@ -139,6 +139,20 @@ double bhs_disk_redshift_total(const struct bhs_kerr *bh, double r, double phi,
 double bhs_disk_doppler_factor(const struct bhs_kerr *bh, double r, double phi,
 			       double inclination);
 
+/**
+ * bhs_disk_g_factor - g exato para um fóton emitido pelo disco kepleriano
+ * @bh: parâmetros do buraco negro
+ * @r: raio de emissão no equador
+ * @xi: ξ = L/E do fóton (constante ao longo da geodésica)
+ *
+ * Emissor em órbita circular prograde: g = 1 / (u^t (1 - Ω ξ)), para
+ * observador no infinito. Ao contrário de bhs_disk_doppler_factor, não
+ * aproxima nada; só precisa do ξ que o traçado dá.
+ *
+ * Retorna: g = ν_obs / ν_emit, ou 0 onde não há órbita circular
+ */
+double bhs_disk_g_factor(const struct bhs_kerr *bh, double r, double xi);
+
 /* ============================================================================
  * VELOCIDADE ORBITAL
  * ============================================================================
@@ -213,4 +227,104 @@ struct bhs_color_rgb bhs_blackbody_color(double temperature);
 struct bhs_color_rgb bhs_color_apply_redshift(struct bhs_color_rgb color,
 					      double z);
 
+/* ============================================================================
+ * SOMBREAMENTO EM LOTE
+ * ============================================================================
+ */
+
+/** Nós radiais de struct bhs_disk_shade */
+#define BHS_DISK_SHADE_NODES 512
+
+/** Amostras por bloco em bhs_disk_shade_batch() */
+#define BHS_DISK_SHADE_LANES 8
+
+/**
+ * struct bhs_disk_shade - Tabelas radiais de um disco visto de um ângulo
+ * @M: massa (o redshift gravitacional sai na hora, é só um sqrt)
+ * @r_isco, @r_outer: anel iluminado
+ * @p_scale: nós por unidade de p = (1 - √(r_isco / r))^(1/4)
+ * @temp: bhs_disk_temperature() nos nós
+ * @v_los: bhs_disk_velocity_phi() · sin(inclinação) nos nós
+ * @kelvin: K por unidade de temperatura normalizada (modo espectral)
+ * @y_norm: escala que leva o anel mais quente, com g = 1, a Y = 1
+ *
+ * A grade é uniforme em p, não em r: T = p (1 - p⁴)^(3/2) é suave em p,
+ * enquanto em r o fator Q^(1/4) tem derivada infinita no ISCO, justo no
+ * anel mais quente. Preenchida por bhs_disk_shade_init(); só leitura
+ * depois, pode ser dividida entre threads.
+ */
+struct bhs_disk_shade {
+	double M;
+	double r_isco;
+	double r_outer;
+	double p_scale;
+	double kelvin;
+	double y_norm;
+	float temp[BHS_DISK_SHADE_NODES];
+	float v_los[BHS_DISK_SHADE_NODES];
+};
+
+/**
+ * bhs_disk_shade_init - Monta as tabelas radiais de um disco
+ * @t: [out] tabelas
+ * @bh: buraco negro
+ * @disk: disco (só outer_radius entra: o anel começa no ISCO, como em
+ *        bhs_disk_temperature)
+ * @inclination: inclinação do observador
+ *
+ * Custa umas mil avaliações do modelo escalar; vale a partir de algumas
+ * centenas de amostras. Refaça quando spin, disco ou câmera mudarem.
+ */
+void bhs_disk_shade_init(struct bhs_disk_shade *t, const struct bhs_kerr *bh,
+			 const struct bhs_disk *disk, double inclination);
+
+/**
+ * bhs_disk_shade_batch - bhs_disk_color() para um lote de amostras
+ * @t: tabelas de bhs_disk_shade_init()
+ * @r: raios no disco
+ * @phi: ângulos azimutais (ignorados, e podem ser NULL, com @g)
+ * @g: fatores g = ν_obs / ν_emit já conhecidos (1 + z = 1 / g), ou NULL
+ *     para o redshift do modelo de bhs_disk_redshift_total()
+ * @n: amostras
+ * @out: [out] cores
+ *
+ * Temperatura e velocidade vêm da tabela radial; cor e deslocamento, de
+ * uma tabela (temperatura × z) global, montada na primeira chamada. As
+ * duas são lidas por índice em blocos de BHS_DISK_SHADE_LANES, sem pow
+ * nem desvio por amostra. O corpo negro é linear por partes com as
+ * quebras em nós, e o deslocamento é linear em z de cada lado de z = 0,
+ * então a interpolação bilinear reproduz bhs_color_apply_redshift() a
+ * menos de arredondamento em float; a diferença para bhs_disk_color()
+ * fica abaixo de 1e-4 por canal (erro da tabela radial).
+ */
+void bhs_disk_shade_batch(const struct bhs_disk_shade *t, const double *r,
+			  const double *phi, const double *g, int n,
+			  struct bhs_color_rgb *out);
+
+/**
+ * bhs_disk_shade_spectral_init - Liga o modo espectral nas tabelas
+ * @t: tabelas já montadas por bhs_disk_shade_init()
+ * @t_peak: temperatura física do anel mais quente (K)
+ *
+ * A temperatura normalizada do disco vira kelvin em escala linear, com o
+ * máximo do perfil em @t_peak.
+ */
+void bhs_disk_shade_spectral_init(struct bhs_disk_shade *t, double t_peak);
+
+/**
+ * bhs_disk_shade_spectral - Cor espectral de um lote de amostras
+ * @t: tabelas com bhs_disk_shade_spectral_init()
+ * @r, @phi, @g, @n: como em bhs_disk_shade_batch(); passe o g exato
+ *                   (bhs_disk_g_factor) sempre que o traçado der ξ
+ * @out: [out] sRGB linear, HDR (1 = Y do anel mais quente visto com g = 1)
+ *
+ * Em vez de tingir a cor, monta o espectro do corpo negro a g·T nas
+ * BHS_SPECTRUM_BINS faixas de spectrum.h e integra para XYZ e sRGB.
+ * Custo fixo por amostra; o brilho (g⁴ no bolométrico) e a mudança de
+ * cor vêm do próprio espectro.
+ */
+void bhs_disk_shade_spectral(const struct bhs_disk_shade *t, const double *r,
+			     const double *phi, const double *g, int n,
+			     struct bhs_color_rgb *out);
+
 #endif /* BHS_ENGINE_DISK_DISK_H */
@@ -0,0 +1,148 @@
+/**
+ * @file spectrum.c
+ * @brief Corpo negro por faixa e funções de cor CIE
+ *
+ * "Quarenta e oito exponenciais por pixel? Não. Duas, e o resto é
+ * tabuada."
+ */
+
+#include "spectrum.h"
+
+#include <math.h>
+
+#include "math/once.h"
+
+/* ============================================================================
+ * TABELA
+ * ============================================================================
+ */
+
+#define N BHS_SPECTRUM_BINS
+
+/* Bloco da recorrência das exponenciais (lanes de um registrador) */
+#define LANES 8
+
+/*
+ * σ em 1/μm, da faixa mais vermelha (0) à mais azul; cmf[c][i] já vem
+ * multiplicado pela largura da faixa em nm, então o produto escalar com
+ * o espectro é a integral
+ */
+static struct {
+	double sigma0;
+	double dsigma;
+	double lambda_um[N];
+	double inv_l5[N];
+	double cmf[3][N];
+} table;
+
+/* Estado de bhs_once() */
+static atomic_int table_state;
+
+/* Gaussiana por partes (Wyman et al.): uma largura de cada lado do pico */
+static double lobe(double lambda, double mu, double s1, double s2)
+{
+	double t = (lambda - mu) / (lambda < mu ? s1 : s2);
+	return exp(-0.5 * t * t);
+}
+
+static void build_table(void)
+{
+	double s_lo = 1000.0 / BHS_SPECTRUM_LAMBDA_MAX;
+	double s_hi = 1000.0 / BHS_SPECTRUM_LAMBDA_MIN;
+
+	table.dsigma = (s_hi - s_lo) / N;
+	table.sigma0 = s_lo + 0.5 * table.dsigma;
+
+	for (int i = 0; i < N; i++) {
+		double l_um = 1.0 / (table.sigma0 + i * table.dsigma);
+		double l = 1000.0 * l_um;
+		double l2 = l_um * l_um;
+
+		table.lambda_um[i] = l_um;
+		table.inv_l5[i] = 1.0 / (l2 * l2 * l_um);
+
+		/* dλ = λ² dσ, em nm */
+		double dl = 1000.0 * l2 * table.dsigma;
+		table.cmf[0][i] = dl * (1.056 * lobe(l, 599.8, 37.9, 31.0) +
+					0.362 * lobe(l, 442.0, 16.0, 26.7) -
+					0.065 * lobe(l, 501.1, 20.4, 26.2));
+		table.cmf[1][i] = dl * (0.821 * lobe(l, 568.8, 46.9, 40.5) +
+					0.286 * lobe(l, 530.9, 16.3, 31.1));
+		table.cmf[2][i] = dl * (1.217 * lobe(l, 437.0, 11.8, 36.0) +
+					0.681 * lobe(l, 459.0, 26.0, 13.8));
+	}
+}
+
+static void table_ensure(void)
+{
+	bhs_once(&table_state, build_table);
+}
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+double bhs_spectrum_lambda(int i)
+{
+	table_ensure();
+	return 1000.0 * table.lambda_um[i];
+}
+
+void bhs_spectrum_blackbody(double temperature, double *out)
+{
+	table_ensure();
+
+	if (!(temperature > 0.0)) {
+		for (int i = 0; i < N; i++)
+			out[i] = 0.0;
+		return;
+	}
+
+	/*
+	 * x_i = c₂ σ_i / T = x_0 + i Δx: e^(x_i) = e^(x_0) q^i. As potências
+	 * de um bloco saem de q^0..q^7 e o bloco seguinte multiplica por q⁸.
+	 * Frio demais estoura para inf e a faixa vale 0, como deve.
+	 */
+	double a = BHS_SPECTRUM_C2 / temperature;
+	double q = exp(a * table.dsigma);
+	double base = exp(a * table.sigma0);
+	double qp[LANES];
+
+	qp[0] = 1.0;
+	for (int l = 1; l < LANES; l++)
+		qp[l] = qp[l - 1] * q;
+	double q_block = qp[LANES - 1] * q;
+
+	for (int b = 0; b < N; b += LANES) {
+		for (int l = 0; l < LANES; l++)
+			out[b + l] = table.inv_l5[b + l] / (base * qp[l] - 1.0);
+		base *= q_block;
+	}
+}
+
+void bhs_spectrum_to_xyz(const double *spec, double xyz[3])
+{
+	table_ensure();
+
+	for (int c = 0; c < 3; c++) {
+		double s = 0.0;
+		for (int i = 0; i < N; i++)
+			s += spec[i] * table.cmf[c][i];
+		xyz[c] = s;
+	}
+}
+
+struct bhs_color_rgb bhs_spectrum_xyz_to_rgb(const double xyz[3])
+{
+	double X = xyz[0], Y = xyz[1], Z = xyz[2];
+	double r = 3.2406 * X - 1.5372 * Y - 0.4986 * Z;
+	double g = -0.9689 * X + 1.8758 * Y + 0.0415 * Z;
+	double b = 0.0557 * X - 0.2040 * Y + 1.0570 * Z;
+
+	return (struct bhs_color_rgb){
+		(float)fmax(r, 0.0),
+		(float)fmax(g, 0.0),
+		(float)fmax(b, 0.0),
+	};
+}
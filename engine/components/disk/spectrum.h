@@ -0,0 +1,80 @@
+/**
+ * @file spectrum.h
+ * @brief Espectro visível em faixas fixas e conversão para XYZ/sRGB
+ *
+ * "Pintar o redshift de vermelho é fácil. Difícil é explicar por que o
+ * lado que se afasta ficou laranja e não vinho."
+ *
+ * Um espectro aqui é BHS_SPECTRUM_BINS amostras de I_λ entre 380 e 780 nm,
+ * com faixas uniformes em número de onda σ = 1/λ (não em λ). Com σ
+ * uniforme, o expoente de Planck c₂σ/T cresce em passo constante e as
+ * exponenciais de todas as faixas saem de duas exp() e multiplicações,
+ * em blocos que o compilador vetoriza.
+ *
+ * O deslocamento Doppler/gravitacional de um corpo negro é exato e de
+ * graça: I_λ/λ⁻⁵ é invariante, então um corpo negro a T visto com fator
+ * g é um corpo negro a g·T.
+ *
+ * A cor sai das funções de cor CIE 1931 (ajuste multi-lobo de Wyman,
+ * Sloan e Shirley 2013) e da matriz XYZ → sRGB linear (D65).
+ */
+
+#ifndef BHS_ENGINE_DISK_SPECTRUM_H
+#define BHS_ENGINE_DISK_SPECTRUM_H
+
+#include "engine/components/disk/disk.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Faixas do espectro (múltiplo de 8: blocos inteiros de vetor) */
+#define BHS_SPECTRUM_BINS 48
+
+/** Limites do visível (nm) */
+#define BHS_SPECTRUM_LAMBDA_MIN 380.0
+#define BHS_SPECTRUM_LAMBDA_MAX 780.0
+
+/** Segunda constante de radiação hc/k (μm·K) */
+#define BHS_SPECTRUM_C2 14387.77
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_spectrum_lambda - Comprimento de onda central da faixa @i (nm)
+ *
+ * A faixa 0 é a mais vermelha.
+ */
+double bhs_spectrum_lambda(int i);
+
+/**
+ * bhs_spectrum_blackbody - Corpo negro em todas as faixas
+ * @temperature: temperatura (K); ≤ 0 dá espectro nulo
+ * @out: [out] BHS_SPECTRUM_BINS valores de λ⁻⁵ / (exp(c₂/λT) - 1), com λ
+ *       em μm (B_λ sem o fator 2hc²)
+ *
+ * Custo fixo: duas exp() e 2 * BHS_SPECTRUM_BINS multiplicações e
+ * divisões, qualquer que seja @temperature.
+ */
+void bhs_spectrum_blackbody(double temperature, double *out);
+
+/**
+ * bhs_spectrum_to_xyz - Integra o espectro contra x̄, ȳ, z̄
+ * @spec: BHS_SPECTRUM_BINS valores de I_λ
+ * @xyz: [out] tristímulo (mesma unidade de @spec vezes nm)
+ */
+void bhs_spectrum_to_xyz(const double *spec, double xyz[3]);
+
+/**
+ * bhs_spectrum_xyz_to_rgb - XYZ → sRGB linear (D65)
+ *
+ * Componentes negativas (fora do gamut) viram 0; não há teto, a cor é
+ * HDR como a imagem do tracer.
+ */
+struct bhs_color_rgb bhs_spectrum_xyz_to_rgb(const double xyz[3]);
+
+#endif /* BHS_ENGINE_DISK_SPECTRUM_H */
@@ -12,6 +12,8 @@
 #define _GNU_SOURCE /* Para M_PI */
 
 #include "geodesic.h"
+#include "math/spacetime/kerr_schild.h"
+#include "math/spacetime/kerr_spin.h"
 #include <math.h>
 #include <string.h>
 
@@ -21,16 +23,16 @@
  */
 
 /**
- * Calcula Christoffel para Kerr via diferença finita
- * (wrapper interno que usa a função de métrica)
+ * Calcula Christoffel para Kerr em forma fechada
+ *
+ * Antes isso era bhs_christoffel_compute() com h = 1e-5: 9 métricas,
+ * inversão 4x4 e erro de truncamento justamente perto do horizonte.
  */
 static int compute_christoffel_kerr(const struct bhs_kerr *bh,
 				    struct bhs_vec4 pos,
 				    struct bhs_christoffel *out)
 {
-	double h = 1e-5; /* Passo para diferença finita */
-	return bhs_christoffel_compute(bhs_kerr_metric_func, pos, (void *)bh, h,
-				       out);
+	return bhs_kerr_christoffel(bh, pos.x, pos.y, out);
 }
 
 /**
@@ -55,6 +57,38 @@ static struct bhs_vec4 dvel_dlambda(const struct bhs_kerr *bh,
 	return bhs_geodesic_accel(&chris, vel);
 }
 
+/**
+ * k^t que anula g_μν k^μ k^ν dados (k^r, k^θ, k^φ)
+ *
+ * Raiz maior (futuro) da quadrática em k^t; os termos cruzados com r e
+ * θ só existem em métricas genéricas e entram em B.
+ */
+static double null_kt(const struct bhs_metric *m, double kr, double ktheta,
+		      double kphi)
+{
+	const real_t(*g)[4] = m->g;
+	double S = g[1][1] * kr * kr + g[2][2] * ktheta * ktheta +
+		   g[3][3] * kphi * kphi +
+		   2.0 * (g[1][2] * kr * ktheta + g[1][3] * kr * kphi +
+			  g[2][3] * ktheta * kphi);
+	double B = g[0][1] * kr + g[0][2] * ktheta + g[0][3] * kphi;
+	double A = g[0][0];
+	double disc = B * B - A * S;
+
+	if (fabs(A) > 1e-12 && disc >= 0.0) {
+		double sq = sqrt(disc);
+		double k1 = (-B + sq) / A;
+		double k2 = (-B - sq) / A;
+		return fmax(k1, k2);
+	}
+	if (fabs(A) <= 1e-12 && fabs(B) > 1e-15) {
+		/* Superfície estacionária: g_tt = 0, equação linear */
+		return -S / (2.0 * B);
+	}
+	/* Fallback - pode acontecer perto do horizonte */
+	return 1.0;
+}
+
 /* ============================================================================
  * INICIALIZAÇÃO
  * ============================================================================
@@ -83,11 +117,12 @@ void bhs_geodesic_init_photon(struct bhs_geodesic *geo, struct bhs_vec4 pos,
    *
    * g_tt (k^t)² + 2 g_tφ k^t k^φ + g_rr (k^r)² + g_θθ (k^θ)² + g_φφ (k^φ)² = 0
    *
-   * Para simplificar, começamos com k^φ = 0 (sem momento angular inicial)
-   * e resolvemos para k^t dado k^r, k^θ.
+   * Dados (k^r, k^θ, k^φ), isso é uma quadrática em k^t:
+   *
+   * g_tt (k^t)² + 2B k^t + S = 0,  B = g_tφ k^φ,  S = parte espacial
    *
-   * g_tt (k^t)² = -(g_rr (k^r)² + g_θθ (k^θ)²)
-   * k^t = √[-(g_rr (k^r)² + g_θθ (k^θ)²) / g_tt]
+   * Pegamos a raiz maior (orientada para o futuro). Fora da ergosfera
+   * g_tt < 0 e ela é sempre positiva.
    */
 
 	double r = pos.x;
@@ -105,20 +140,7 @@ void bhs_geodesic_init_photon(struct bhs_geodesic *geo, struct bhs_vec4 pos,
 	double ktheta = dir_norm.y;
 	double kphi = dir_norm.z;
 
-	/* Componente temporal para geodésica nula */
-	double spatial_norm = g.g[1][1] * kr * kr +
-			      g.g[2][2] * ktheta * ktheta +
-			      g.g[3][3] * kphi * kphi +
-			      2.0 * g.g[0][3] * kphi; /* Termo g_tφ */
-
-	double kt;
-	if (g.g[0][0] < 0.0 && -spatial_norm / g.g[0][0] >= 0.0) {
-		kt = sqrt(-spatial_norm / g.g[0][0]);
-	} else {
-		/* Fallback - pode acontecer perto do horizonte */
-		kt = 1.0;
-	}
-
+	double kt = null_kt(&g, kr, ktheta, kphi);
 	struct bhs_vec4 vel = bhs_vec4_make(kt, kr, ktheta, kphi);
 	bhs_geodesic_init(geo, pos, vel, BHS_GEODESIC_NULL);
 }
@@ -199,51 +221,765 @@ int bhs_geodesic_step_rk4(struct bhs_geodesic *geo, const struct bhs_kerr *bh,
 		geo->pos.z += M_PI;
 	}
 
-	/* Wrap φ para [-π, π] */
-	while (geo->pos.z > M_PI)
-		geo->pos.z -= 2.0 * M_PI;
-	while (geo->pos.z < -M_PI)
-		geo->pos.z += 2.0 * M_PI;
+	/* Wrap φ para [-π, π] (remainder não trava se φ divergir) */
+	geo->pos.z = remainder(geo->pos.z, 2.0 * M_PI);
 
 	return 0;
 }
 
+/* ============================================================================
+ * INTEGRAÇÃO DORMAND-PRINCE 5(4)
+ * ============================================================================
+ */
+
+#define N_DIM BHS_GEODESIC_DIM
+
+/*
+ * Tableau de Dormand & Prince (1980), o mesmo do DOPRI5 de Hairer.
+ * O sistema é autônomo (λ não aparece em f), então os nós c_i não entram.
+ */
+
+static const double DP_A21 = 1.0 / 5.0;
+static const double DP_A31 = 3.0 / 40.0, DP_A32 = 9.0 / 40.0;
+static const double DP_A41 = 44.0 / 45.0, DP_A42 = -56.0 / 15.0,
+		    DP_A43 = 32.0 / 9.0;
+static const double DP_A51 = 19372.0 / 6561.0, DP_A52 = -25360.0 / 2187.0,
+		    DP_A53 = 64448.0 / 6561.0, DP_A54 = -212.0 / 729.0;
+static const double DP_A61 = 9017.0 / 3168.0, DP_A62 = -355.0 / 33.0,
+		    DP_A63 = 46732.0 / 5247.0, DP_A64 = 49.0 / 176.0,
+		    DP_A65 = -5103.0 / 18656.0;
+static const double DP_A71 = 35.0 / 384.0, DP_A73 = 500.0 / 1113.0,
+		    DP_A74 = 125.0 / 192.0, DP_A75 = -2187.0 / 6784.0,
+		    DP_A76 = 11.0 / 84.0;
+
+/* Erro embutido: b(5) - b(4) */
+static const double DP_E1 = 71.0 / 57600.0, DP_E3 = -71.0 / 16695.0,
+		    DP_E4 = 71.0 / 1920.0, DP_E5 = -17253.0 / 339200.0,
+		    DP_E6 = 22.0 / 525.0, DP_E7 = -1.0 / 40.0;
+
+/* Saída densa (contd5) */
+static const double DP_D1 = -12715105075.0 / 11282082432.0,
+		    DP_D3 = 87487479700.0 / 32700410799.0,
+		    DP_D4 = -10690763975.0 / 1880347072.0,
+		    DP_D5 = 701980252875.0 / 199316789632.0,
+		    DP_D6 = -1453857185.0 / 822651844.0,
+		    DP_D7 = 69997945.0 / 29380423.0;
+
+static void geo_pack(const struct bhs_geodesic *geo, double y[N_DIM])
+{
+	y[0] = geo->pos.t;
+	y[1] = geo->pos.x;
+	y[2] = geo->pos.y;
+	y[3] = geo->pos.z;
+	y[4] = geo->vel.t;
+	y[5] = geo->vel.x;
+	y[6] = geo->vel.y;
+	y[7] = geo->vel.z;
+}
+
+/*
+ * Lado direito do sistema de 1ª ordem numa carta qualquer; @ctx é o que
+ * a formulação precisa (o buraco negro, ou a métrica do modo métrica)
+ */
+typedef void (*geo_deriv_fn)(const void *ctx, const double y[N_DIM],
+			     double dy[N_DIM]);
+
+static void geo_deriv(const void *ctx, const double y[N_DIM],
+		      double dy[N_DIM])
+{
+	const struct bhs_kerr *bh = ctx;
+	struct bhs_vec4 pos = bhs_vec4_make(y[0], y[1], y[2], y[3]);
+	struct bhs_vec4 vel = bhs_vec4_make(y[4], y[5], y[6], y[7]);
+	struct bhs_vec4 acc = dvel_dlambda(bh, pos, vel);
+
+	dy[0] = y[4];
+	dy[1] = y[5];
+	dy[2] = y[6];
+	dy[3] = y[7];
+	dy[4] = acc.t;
+	dy[5] = acc.x;
+	dy[6] = acc.y;
+	dy[7] = acc.z;
+}
+
+/**
+ * Wrap de θ para [0, π] e φ para [-π, π], como em bhs_geodesic_step_rk4
+ *
+ * Retorna: true se θ foi refletido (a derivada no ponto muda)
+ */
+static bool wrap_angles(double *theta, double *phi)
+{
+	bool reflected = false;
+
+	if (*theta < 0.0) {
+		*theta = -*theta;
+		*phi += M_PI;
+		reflected = true;
+	}
+	if (*theta > M_PI) {
+		*theta = 2.0 * M_PI - *theta;
+		*phi += M_PI;
+		reflected = true;
+	}
+	*phi = remainder(*phi, 2.0 * M_PI);
+	return reflected;
+}
+
+/**
+ * Uma tentativa DOPRI5 de tamanho h a partir de y0 com k1 conhecido
+ *
+ * Preenche y1, k7 = f(y1) e os estágios para a saída densa.
+ * Retorna: norma RMS do erro escalada por componente (≤ 1 aceita)
+ */
+static double dopri5_attempt(const void *ctx, geo_deriv_fn deriv,
+			     double h, double rtol, double atol,
+			     const double y0[N_DIM], double k[7][N_DIM],
+			     double y1[N_DIM])
+{
+	double tmp[N_DIM];
+	int i;
+
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y0[i] + h * DP_A21 * k[0][i];
+	deriv(ctx, tmp, k[1]);
+
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y0[i] + h * (DP_A31 * k[0][i] + DP_A32 * k[1][i]);
+	deriv(ctx, tmp, k[2]);
+
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y0[i] + h * (DP_A41 * k[0][i] + DP_A42 * k[1][i] +
+				      DP_A43 * k[2][i]);
+	deriv(ctx, tmp, k[3]);
+
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y0[i] + h * (DP_A51 * k[0][i] + DP_A52 * k[1][i] +
+				      DP_A53 * k[2][i] + DP_A54 * k[3][i]);
+	deriv(ctx, tmp, k[4]);
+
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y0[i] + h * (DP_A61 * k[0][i] + DP_A62 * k[1][i] +
+				      DP_A63 * k[2][i] + DP_A64 * k[3][i] +
+				      DP_A65 * k[4][i]);
+	deriv(ctx, tmp, k[5]);
+
+	/* 5ª ordem: os pesos b são a última linha de A (FSAL) */
+	for (i = 0; i < N_DIM; i++)
+		y1[i] = y0[i] + h * (DP_A71 * k[0][i] + DP_A73 * k[2][i] +
+				     DP_A74 * k[3][i] + DP_A75 * k[4][i] +
+				     DP_A76 * k[5][i]);
+	deriv(ctx, y1, k[6]);
+
+	double err2 = 0.0;
+	for (i = 0; i < N_DIM; i++) {
+		double e = h * (DP_E1 * k[0][i] + DP_E3 * k[2][i] +
+				DP_E4 * k[3][i] + DP_E5 * k[4][i] +
+				DP_E6 * k[5][i] + DP_E7 * k[6][i]);
+		double sc = atol + rtol * fmax(fabs(y0[i]), fabs(y1[i]));
+		err2 += (e / sc) * (e / sc);
+	}
+
+	double err = sqrt(err2 / N_DIM);
+	return isfinite(err) ? err : INFINITY;
+}
+
+/**
+ * Fator de mudança do passo a partir do erro (controle elementar)
+ */
+static double dopri5_factor(double err, bool rejected)
+{
+	double fac = 0.9 * pow(fmax(err, 1e-10), -0.2);
+	fac = fmax(0.2, fmin(rejected ? 1.0 : 10.0, fac));
+	return fac;
+}
+
+void bhs_geodesic_stepper_init(struct bhs_geodesic_stepper *st, double h0,
+			       double rtol, double atol)
+{
+	memset(st, 0, sizeof(*st));
+	st->h = h0 > 0.0 ? h0 : 0.1;
+	st->h_min = 1e-10;
+	st->rtol = rtol;
+	st->atol = atol > 0.0 ? atol : rtol;
+}
+
+/**
+ * Um passo aceito de y0 para y1 com o lado direito @deriv
+ *
+ * Atualiza saída densa (a partir de @lambda), FSAL e o próximo h; quem
+ * chama decide se o FSAL continua válido. @forced (pode ser NULL) diz se
+ * o passo foi aceito à força em h_min. Retorna o h usado.
+ */
+static double dopri5_advance(const void *ctx, geo_deriv_fn deriv,
+			     struct bhs_geodesic_stepper *st, double lambda,
+			     const double y0[N_DIM], double y1[N_DIM],
+			     bool *forced)
+{
+	double k[7][N_DIM];
+	int i;
+	bool dummy;
+
+	if (!forced)
+		forced = &dummy;
+	*forced = false;
+	if (st->fsal_valid)
+		memcpy(k[0], st->fsal, sizeof(k[0]));
+	else
+		deriv(ctx, y0, k[0]);
+
+	double h = st->h;
+	if (st->h_max > 0.0)
+		h = fmin(h, st->h_max);
+
+	bool rejected = false;
+	double err;
+	for (;;) {
+		err = dopri5_attempt(ctx, deriv, h, st->rtol, st->atol, y0, k,
+				     y1);
+		if (err <= 1.0)
+			break;
+
+		st->rejected++;
+		rejected = true;
+		if (h <= st->h_min) {
+			/* Melhor avançar que travar (igual ao shader) */
+			*forced = true;
+			break;
+		}
+		h = fmax(st->h_min, h * dopri5_factor(err, true));
+	}
+
+	/* Saída densa, no referencial ainda sem wrap dos ângulos */
+	for (i = 0; i < N_DIM; i++) {
+		double dy = y1[i] - y0[i];
+		double bspl = h * k[0][i] - dy;
+
+		st->rcont[0][i] = y0[i];
+		st->rcont[1][i] = dy;
+		st->rcont[2][i] = bspl;
+		st->rcont[3][i] = dy - h * k[6][i] - bspl;
+		st->rcont[4][i] =
+			h * (DP_D1 * k[0][i] + DP_D3 * k[2][i] +
+			     DP_D4 * k[3][i] + DP_D5 * k[4][i] +
+			     DP_D6 * k[5][i] + DP_D7 * k[6][i]);
+	}
+	st->lambda0 = lambda;
+	st->h_last = h;
+
+	memcpy(st->fsal, k[6], sizeof(st->fsal));
+	st->fsal_valid = true;
+	st->accepted++;
+	st->h = h * dopri5_factor(err, rejected);
+	return h;
+}
+
+int bhs_geodesic_step_dopri5(struct bhs_geodesic *geo,
+			     const struct bhs_kerr *bh,
+			     struct bhs_geodesic_stepper *st)
+{
+	double y0[N_DIM], y1[N_DIM];
+	bool forced;
+
+	geo_pack(geo, y0);
+	double h = dopri5_advance(bh, geo_deriv, st, geo->affine_param, y0, y1,
+				  &forced);
+
+	/* Saída densa fica no referencial ainda sem wrap dos ângulos */
+	bool reflected = wrap_angles(&y1[2], &y1[3]);
+
+	geo->pos = bhs_vec4_make(y1[0], y1[1], y1[2], y1[3]);
+	geo->vel = bhs_vec4_make(y1[4], y1[5], y1[6], y1[7]);
+	geo->affine_param += h;
+	geo->step_count++;
+
+	/* φ não entra na métrica; reflexão de θ invalida o k7 */
+	st->fsal_valid = !reflected;
+
+	if (forced || !isfinite(y1[1]))
+		return -1;
+	return 0;
+}
+
+/* Interpolante denso sem wrap: serve para qualquer carta */
+static void dense_raw(const struct bhs_geodesic_stepper *st, double lambda,
+		      double y[N_DIM])
+{
+	double s = st->h_last > 0.0 ? (lambda - st->lambda0) / st->h_last : 0.0;
+	double s1 = 1.0 - s;
+
+	for (int i = 0; i < N_DIM; i++) {
+		y[i] = st->rcont[0][i] +
+		       s * (st->rcont[1][i] +
+			    s1 * (st->rcont[2][i] +
+				  s * (st->rcont[3][i] +
+				       s1 * st->rcont[4][i])));
+	}
+}
+
+void bhs_geodesic_dense_eval(const struct bhs_geodesic_stepper *st,
+			     double lambda, struct bhs_vec4 *pos,
+			     struct bhs_vec4 *vel)
+{
+	double y[N_DIM];
+
+	dense_raw(st, lambda, y);
+	wrap_angles(&y[2], &y[3]);
+
+	if (pos)
+		*pos = bhs_vec4_make(y[0], y[1], y[2], y[3]);
+	if (vel)
+		*vel = bhs_vec4_make(y[4], y[5], y[6], y[7]);
+}
+
 int bhs_geodesic_step_adaptive(struct bhs_geodesic *geo,
 			       const struct bhs_kerr *bh, double *dlambda,
 			       double tolerance)
 {
+	/* Um passo DOPRI5 avulso, sem FSAL nem saída densa reaproveitados */
+	struct bhs_geodesic_stepper st;
+	bhs_geodesic_stepper_init(&st, *dlambda, tolerance, tolerance);
+
+	int ret = bhs_geodesic_step_dopri5(geo, bh, &st);
+	*dlambda = st.h;
+	return ret;
+}
+
+/* ============================================================================
+ * CRUZAMENTO DO DISCO (θ = π/2)
+ * ============================================================================
+ */
+
+/**
+ * Interpolação dentro do passo [prev, cur]
+ *
+ * Com o stepper do DOPRI5 usa a saída densa. Sem ele, Hermite cúbica na
+ * posição (as pontas têm x e dx/dλ = u) e a derivada dela na velocidade.
+ */
+struct step_interp {
+	const struct bhs_geodesic *prev;
+	const struct bhs_geodesic *cur;
+	const struct bhs_geodesic_stepper *st;
+	double h;
+	double dphi; /* φ_cur - φ_prev desembrulhado */
+};
+
+static void interp_eval(const struct step_interp *in, double s,
+			struct bhs_vec4 *pos, struct bhs_vec4 *vel)
+{
+	if (in->st) {
+		bhs_geodesic_dense_eval(in->st, in->st->lambda0 + s * in->h,
+					pos, vel);
+		return;
+	}
+
+	double s2 = s * s;
+	double s3 = s2 * s;
+	double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+	double h10 = s3 - 2.0 * s2 + s;
+	double h01 = -2.0 * s3 + 3.0 * s2;
+	double h11 = s3 - s2;
+
+	/* Derivadas em s, divididas por h para virar d/dλ */
+	double d00 = (6.0 * s2 - 6.0 * s) / in->h;
+	double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+	double d01 = (-6.0 * s2 + 6.0 * s) / in->h;
+	double d11 = 3.0 * s2 - 2.0 * s;
+
+	const struct bhs_vec4 *p0 = &in->prev->pos, *u0 = &in->prev->vel;
+	const struct bhs_vec4 *p1 = &in->cur->pos, *u1 = &in->cur->vel;
+	double h = in->h;
+	double x0[4] = { p0->t, p0->x, p0->y, p0->z };
+	double x1[4] = { p1->t, p1->x, p1->y, p0->z + in->dphi };
+	double v0[4] = { u0->t, u0->x, u0->y, u0->z };
+	double v1[4] = { u1->t, u1->x, u1->y, u1->z };
+	double x[4], v[4];
+
+	for (int i = 0; i < 4; i++) {
+		x[i] = h00 * x0[i] + h10 * h * v0[i] + h01 * x1[i] +
+		       h11 * h * v1[i];
+		v[i] = d00 * x0[i] + d10 * v0[i] + d01 * x1[i] + d11 * v1[i];
+	}
+
+	if (pos)
+		*pos = bhs_vec4_make(x[0], x[1], x[2], remainder(x[3],
+								 2.0 * M_PI));
+	if (vel)
+		*vel = bhs_vec4_make(v[0], v[1], v[2], v[3]);
+}
+
+/**
+ * Illinois (regula falsi modificada) para g(s) = 0 em s ∈ [0, 1]
+ * @g0, @g1: g(0) e g(1), de sinais opostos
+ */
+static double illinois_root(double (*g)(const void *ctx, double s),
+			    const void *ctx, double g0, double g1)
+{
+	double a = 0.0, b = 1.0;
+	double fa = g0, fb = g1;
+	int side = 0;
+
+	for (int it = 0; it < 60; it++) {
+		double s = (a * fb - b * fa) / (fb - fa);
+		double fs = g(ctx, s);
+
+		if (fabs(fs) < 1e-13 || b - a < 1e-14)
+			return s;
+		if (fs * fb > 0.0) {
+			b = s;
+			fb = fs;
+			if (side == -1)
+				fa *= 0.5;
+			side = -1;
+		} else {
+			a = s;
+			fa = fs;
+			if (side == 1)
+				fb *= 0.5;
+			side = 1;
+		}
+	}
+	return 0.5 * (a + b);
+}
+
+static double plane_offset_bl(const void *ctx, double s)
+{
+	struct bhs_vec4 pos;
+	interp_eval(ctx, s, &pos, NULL);
+	return M_PI_2 - pos.y;
+}
+
+/**
+ * Procura o cruzamento de θ = π/2 no último passo
+ * @prev: estado antes do passo
+ * @geo: estado depois do passo (vira o ponto de impacto se acertou)
+ * @st: stepper do DOPRI5 ou NULL (RK4/Carter)
+ *
+ * Illinois sobre g(s) = π/2 - θ(s), s ∈ [0, 1].
+ *
+ * Retorna: true se cruzou o plano dentro de [disk_inner, disk_outer]
+ */
+static bool find_disk_crossing(const struct bhs_geodesic *prev,
+			       struct bhs_geodesic *geo,
+			       const struct bhs_kerr *bh,
+			       const struct bhs_geodesic_config *config,
+			       const struct bhs_geodesic_stepper *st)
+{
+	double g0 = M_PI_2 - prev->pos.y;
+	double g1 = M_PI_2 - geo->pos.y;
+
+	/* Nasceu no plano ou não trocou de sinal */
+	if (g0 == 0.0 || g0 * g1 > 0.0)
+		return false;
+
+	struct step_interp in = {
+		.prev = prev,
+		.cur = geo,
+		.st = st,
+		.h = geo->affine_param - prev->affine_param,
+		.dphi = remainder(geo->pos.z - prev->pos.z, 2.0 * M_PI),
+	};
+	if (!(in.h > 0.0))
+		return false;
+
+	struct bhs_vec4 pos, vel;
+	double s = illinois_root(plane_offset_bl, &in, g0, g1);
+	interp_eval(&in, s, &pos, &vel);
+
+	if (pos.x < config->disk_inner || pos.x > config->disk_outer)
+		return false;
+
+	pos.y = M_PI_2;
+	geo->pos = pos;
+	geo->vel = vel;
+	geo->affine_param = prev->affine_param + s * in.h;
+
+	struct bhs_metric g;
+	bhs_kerr_metric(bh, pos.x, pos.y, &g);
+
+	geo->hit.r = pos.x;
+	geo->hit.phi = pos.z;
+	geo->hit.lambda = geo->affine_param;
+	geo->hit.p = bhs_metric_lower(&g, vel);
+	return true;
+}
+
+bool bhs_geodesic_disk_crossing(const struct bhs_geodesic *prev,
+				struct bhs_geodesic *geo,
+				const struct bhs_kerr *bh,
+				const struct bhs_geodesic_config *config)
+{
+	return find_disk_crossing(prev, geo, bh, config, NULL);
+}
+
+static bool thin_disk(const struct bhs_geodesic_config *config)
+{
+	return config->disk_outer > 0 && config->disk_half_thickness <= 0;
+}
+
+/* ============================================================================
+ * ATALHOS ANALÍTICOS
+ * ============================================================================
+ */
+
+/**
+ * struct shortcut_ctx - Decisões dos atalhos tomadas uma vez por raio
+ * @shadow: (ξ, η) estritamente dentro da curva crítica
+ * @shadow_r: abaixo deste raio a captura pode ser antecipada
+ * @far_r: acima deste raio um raio saindo é fechado (0 = desligado)
+ * @E, @L: energia e momento axial do fóton
+ */
+struct shortcut_ctx {
+	bool shadow;
+	double shadow_r;
+	double far_r;
+	double E;
+	double L;
+};
+
+static void shortcut_init(struct shortcut_ctx *ctx,
+			  const struct bhs_geodesic *geo,
+			  const struct bhs_kerr *bh,
+			  const struct bhs_geodesic_config *config)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	if (geo->type != BHS_GEODESIC_NULL ||
+	    (!config->shadow_capture && config->far_field_radius <= 0.0))
+		return;
+
+	struct bhs_geodesic_constants k;
+	bhs_geodesic_constants(geo, bh, &k);
+	if (!(k.E > 0.0))
+		return;
+	ctx->E = k.E;
+	ctx->L = k.L;
+
+	if (config->shadow_capture) {
+		double xi = k.L / k.E;
+		double eta = k.Q / (k.E * k.E);
+
+		/* Rente à curva quem decide é o integrador: margem relativa */
+		double margin = 1e-6 * (xi * xi + fabs(eta) + bh->M * bh->M);
+		ctx->shadow = bhs_kerr_spin_in_shadow(bh, xi, eta + margin);
+
+		/* Com disco o raio ainda pode bater nele até passar de inner */
+		ctx->shadow_r = config->disk_outer > 0.0 ? config->disk_inner
+							 : INFINITY;
+	}
+
+	/* Saindo além da região de fótons e do disco, não volta nem acerta */
+	if (config->far_field_radius > 0.0) {
+		struct bhs_kerr_radii radii;
+		bhs_kerr_spin_radii(bh, &radii);
+		ctx->far_r = fmax(config->far_field_radius,
+				  fmax(radii.photon_retro, config->disk_outer));
+	}
+}
+
+/*
+ * Órbita de 1ª ordem em M no plano orbital, ψ medido a partir da posição
+ * atual: u = sin(ψ+ψ0)/b + k(1 + cos²(ψ+ψ0)) + C cos ψ + D sin ψ, com
+ * k = M/b². C e D zeram a correção em ψ = 0 (posição e du/dψ exatos).
+ */
+struct binet_orbit {
+	double b, psi0, k, C, D;
+};
+
+static double binet_u(const struct binet_orbit *o, double psi)
+{
+	double c = cos(psi + o->psi0);
+	return sin(psi + o->psi0) / o->b + o->k * (1.0 + c * c) +
+	       o->C * cos(psi) + o->D * sin(psi);
+}
+
+static double binet_du(const struct binet_orbit *o, double psi)
+{
+	return cos(psi + o->psi0) / o->b - o->k * sin(2.0 * (psi + o->psi0)) -
+	       o->C * sin(psi) + o->D * cos(psi);
+}
+
+/*
+ * Com M → 0, Boyer-Lindquist vira esferoidal oblata do espaço plano:
+ *   x = ρ sinθ cosφ,  y = ρ sinθ sinφ,  z = r cosθ,  ρ = √(r² + a²)
+ * É o mapa usado para levar o estado ao plano orbital e de volta.
+ */
+static struct bhs_vec3 oblate_to_cart(double a, double r, double theta,
+				      double phi)
+{
+	double rho = sqrt(r * r + a * a);
+	return bhs_vec3_make(rho * sin(theta) * cos(phi),
+			     rho * sin(theta) * sin(phi), r * cos(theta));
+}
+
+static struct bhs_vec3 oblate_vel_to_cart(double a, struct bhs_vec4 pos,
+					  struct bhs_vec4 vel)
+{
+	double r = pos.x;
+	double rho = sqrt(r * r + a * a);
+	double st = sin(pos.y), ct = cos(pos.y);
+	double sp = sin(pos.z), cp = cos(pos.z);
+
+	/* Horizontal ao longo de (cos φ, sin φ) */
+	double h = r / rho * st * vel.x + rho * ct * vel.y;
+	return bhs_vec3_make(h * cp - rho * st * sp * vel.z,
+			     h * sp + rho * st * cp * vel.z,
+			     ct * vel.x - r * st * vel.y);
+}
+
+/**
+ * far_field_finish - Leva um raio saindo até escape_r em forma fechada
+ *
+ * Além da curvatura de Schwarzschild, o arrasto de referenciais soma a
+ * φ o termo de 1ª ordem de dφ/dλ ≈ 2MaE/r³ ao longo da reta:
+ *   Δφ = 2Ma (1/r0² - 1/R²) / (c0 + cR),  c = √(1 - b²/r²)
+ * O tempo ganha o atraso de Shapiro radial 2M ln(R/r) em cima da corda.
+ */
+static void far_field_finish(struct bhs_geodesic *geo, double a, double M,
+			     double E, double L, double escape_r)
+{
+	struct bhs_vec3 x0 = oblate_to_cart(a, geo->pos.x, geo->pos.y,
+					    geo->pos.z);
+
 	/*
-   * Passo adaptativo usando estimativa de erro.
-   * Compara resultado de um passo h vs dois passos h/2.
-   */
+	 * dφ/dλ em BL já carrega o arrasto 2Mr·aP/(Δ ρ² Σ): se entrasse na
+	 * reta plana seria contado como movimento de verdade. Tira aqui e
+	 * devolve integrado (Δφ) no fim.
+	 */
+	struct bhs_vec4 vflat = geo->vel;
+	{
+		double r = geo->pos.x;
+		double ct = cos(geo->pos.y);
+		double rho2 = r * r + a * a;
+		double Delta = rho2 - 2.0 * M * r;
+		double Sigma = r * r + a * a * ct * ct;
+		double P = E * rho2 - a * L;
+		vflat.z -= 2.0 * M * r * a * P / (Delta * rho2 * Sigma);
+	}
+	struct bhs_vec3 v = oblate_vel_to_cart(a, geo->pos, vflat);
 
-	struct bhs_geodesic geo_full = *geo;
-	struct bhs_geodesic geo_half = *geo;
+	double r0 = bhs_vec3_norm(x0);
+	struct bhs_vec3 er = bhs_vec3_scale(x0, 1.0 / r0);
+	double vr = bhs_vec3_dot(v, er);
+	struct bhs_vec3 vperp = bhs_vec3_sub(v, bhs_vec3_scale(er, vr));
+	double vp = bhs_vec3_norm(vperp);
 
-	double h = *dlambda;
+	/* Sem movimento transversal o raio sai reto */
+	struct binet_orbit o = { .b = INFINITY };
+	struct bhs_vec3 e2 = bhs_vec3_make(0.0, 0.0, 0.0);
+	if (vp > 1e-12 * bhs_vec3_norm(v)) {
+		e2 = bhs_vec3_scale(vperp, 1.0 / vp);
 
-	/* Um passo grande */
-	bhs_geodesic_step_rk4(&geo_full, bh, h);
+		double u = 1.0 / r0;
+		double du = -vr / (r0 * vp);
+		o.b = 1.0 / sqrt(u * u + du * du);
+		o.psi0 = atan2(u * o.b, du * o.b);
+		o.k = M / (o.b * o.b);
+		o.C = -o.k * (1.0 + cos(o.psi0) * cos(o.psi0));
+		o.D = o.k * sin(2.0 * o.psi0);
+	}
+
+	/*
+	 * Raio cartesiano de r_BL = R na direção final: R² + a² sin²θ.
+	 * θ depende de ψ, que depende do alvo: duas voltas bastam.
+	 */
+	double psi = 0.0;
+	double target = escape_r;
+	struct bhs_vec3 dir = er;
+	if (isfinite(o.b))
+		/* Reta: sin(ψ + ψ0) = b/R no ramo de saída */
+		psi = M_PI - o.psi0 - asin(fmin(o.b / target, 1.0));
+	for (int pass = 0; pass < 2 && isfinite(o.b); pass++) {
+		/*
+		 * Newton a partir da reta: a correção é O(M/b) e u' < 0 no
+		 * ramo de saída, então poucas iterações bastam.
+		 */
+		for (int i = 0; i < 8; i++) {
+			double du = binet_du(&o, psi);
+			if (!(du < 0.0))
+				break;
+			double step = (binet_u(&o, psi) - 1.0 / target) / du;
+			psi -= step;
+			if (fabs(step) < 1e-13)
+				break;
+		}
+		dir = bhs_vec3_add(bhs_vec3_scale(er, cos(psi)),
+				   bhs_vec3_scale(e2, sin(psi)));
+		target = sqrt(escape_r * escape_r +
+			      a * a * (1.0 - dir.z * dir.z));
+	}
+	if (!isfinite(o.b))
+		target = sqrt(escape_r * escape_r +
+			      a * a * (1.0 - dir.z * dir.z));
 
-	/* Dois passos pequenos */
-	bhs_geodesic_step_rk4(&geo_half, bh, h / 2.0);
-	bhs_geodesic_step_rk4(&geo_half, bh, h / 2.0);
+	/* dX/dψ = -(u'/u²) ê_r + (1/u) ê_ψ */
+	struct bhs_vec3 tangent = dir;
+	if (isfinite(o.b)) {
+		struct bhs_vec3 epsi =
+			bhs_vec3_add(bhs_vec3_scale(er, -sin(psi)),
+				     bhs_vec3_scale(e2, cos(psi)));
+		double ue = binet_u(&o, psi);
+		tangent = bhs_vec3_normalize(bhs_vec3_add(
+			bhs_vec3_scale(dir, -binet_du(&o, psi) / (ue * ue)),
+			bhs_vec3_scale(epsi, 1.0 / ue)));
+	}
 
-	/* Estimativa de erro (diferença nas posições) */
-	struct bhs_vec4 diff = bhs_vec4_sub(geo_full.pos, geo_half.pos);
-	double error = sqrt(diff.t * diff.t + diff.x * diff.x +
-			    diff.y * diff.y + diff.z * diff.z);
+	struct bhs_vec3 x1 = bhs_vec3_scale(dir, target);
+	double s = bhs_vec3_norm(bhs_vec3_sub(x1, x0));
 
-	/* Ajusta passo */
-	double safety = 0.9;
-	double factor = safety * pow(tolerance / (error + 1e-15), 0.2);
-	factor = fmax(0.1, fmin(4.0, factor));
-	*dlambda = h * factor;
+	/* Arrasto: gira em torno do eixo de spin */
+	double b = isfinite(o.b) ? fmin(o.b, r0) : 0.0;
+	double c0 = sqrt(fmax(1.0 - b * b / (r0 * r0), 0.0));
+	double cR = sqrt(fmax(1.0 - b * b / (target * target), 0.0));
+	double dphi = 2.0 * M * a * (1.0 / (r0 * r0) - 1.0 / (target * target)) /
+		      fmax(c0 + cR, 1e-12);
+	double cd = cos(dphi), sd = sin(dphi);
+	x1 = bhs_vec3_make(cd * x1.x - sd * x1.y, sd * x1.x + cd * x1.y, x1.z);
+	tangent = bhs_vec3_make(cd * tangent.x - sd * tangent.y,
+				sd * tangent.x + cd * tangent.y, tangent.z);
 
-	/* Usa resultado mais preciso (dois passos) */
-	*geo = geo_half;
+	/* De volta para BL em r = escape_r */
+	double R = escape_r;
+	double theta = acos(fmin(fmax(x1.z / R, -1.0), 1.0));
+	double phi = atan2(x1.y, x1.x);
+	double rho = sqrt(R * R + a * a);
+	double st = fmax(sin(theta), 1e-12), ct = cos(theta);
+	double Sigma = R * R + a * a * ct * ct;
+	double h = cos(phi) * tangent.x + sin(phi) * tangent.y;
 
-	return error > tolerance * 10.0 ? -1 : 0;
+	geo->pos = bhs_vec4_make(geo->pos.t + s + 2.0 * M * log(R / geo->pos.x),
+				 R, theta, phi);
+	geo->vel = bhs_vec4_make(
+		E, E * rho * (R * st * h + rho * ct * tangent.z) / Sigma,
+		E * (rho * ct * h - R * st * tangent.z) / Sigma,
+		E * (-sin(phi) * tangent.x + cos(phi) * tangent.y) /
+			(rho * st));
+	geo->affine_param += s / E;
+}
+
+/**
+ * try_shortcut - Aplica os atalhos no estado atual
+ *
+ * Retorna: BHS_GEO_PROPAGATING se nenhum se aplica
+ */
+static enum bhs_geodesic_status try_shortcut(const struct shortcut_ctx *ctx,
+					     struct bhs_geodesic *geo,
+					     const struct bhs_kerr *bh,
+					     double escape_r)
+{
+	double r = geo->pos.x;
+
+	if (ctx->shadow && geo->vel.x < 0.0 && r < ctx->shadow_r) {
+		geo->shortcut = BHS_GEO_SHORTCUT_SHADOW;
+		return BHS_GEO_CAPTURED;
+	}
+
+	if (ctx->far_r > 0.0 && geo->vel.x > 0.0 && r > ctx->far_r &&
+	    r < escape_r) {
+		far_field_finish(geo, bh->a, bh->M, ctx->E, ctx->L, escape_r);
+		geo->shortcut = BHS_GEO_SHORTCUT_FAR_FIELD;
+		return BHS_GEO_ESCAPED;
+	}
+
+	return BHS_GEO_PROPAGATING;
 }
 
 /* ============================================================================
@@ -251,44 +987,747 @@ int bhs_geodesic_step_adaptive(struct bhs_geodesic *geo,
  * ============================================================================
  */
 
+/**
+ * Critérios de parada comuns a todas as formulações
+ */
+static enum bhs_geodesic_status
+check_stop(const struct bhs_geodesic *geo, double r_horizon, double escape_r,
+	   const struct bhs_geodesic_config *config)
+{
+	double r = geo->pos.x;
+
+	/*
+	 * Passo fixo perto do horizonte pode divergir (k^t → ∞). O raio
+	 * já estava caindo: conta como capturado em vez de propagar NaN.
+	 */
+	if (!isfinite(r) || !isfinite(geo->vel.t))
+		return BHS_GEO_CAPTURED;
+
+	/* Capturado pelo horizonte */
+	if (r < r_horizon * 1.01)
+		return BHS_GEO_CAPTURED;
+
+	/* Escapou */
+	if (r > escape_r)
+		return BHS_GEO_ESCAPED;
+
+	/* Atingiu o disco */
+	if (config->disk_outer > 0 && config->disk_half_thickness > 0 &&
+	    bhs_geodesic_is_in_disk(geo, config->disk_inner, config->disk_outer,
+				    config->disk_half_thickness))
+		return BHS_GEO_HIT_DISK;
+
+	return BHS_GEO_PROPAGATING;
+}
+
+/**
+ * Teto do passo adaptativo perto do disco grosso (BL)
+ *
+ * Passo longo não pode pular a fatia |z| < meia-espessura do disco: indo
+ * em direção ao plano, limita h para no máximo chegar em z = 0 (em 1ª
+ * ordem). Se afastando, sem teto (0).
+ */
+static double disk_h_max(const struct bhs_geodesic *geo,
+			 const struct bhs_geodesic_config *config)
+{
+	if (config->disk_outer <= 0 || config->disk_half_thickness <= 0)
+		return 0.0;
+
+	double r = geo->pos.x;
+	double z = r * cos(geo->pos.y);
+	double dz = geo->vel.x * cos(geo->pos.y) -
+		    r * sin(geo->pos.y) * geo->vel.y;
+	if (z * dz >= 0.0)
+		return 0.0;
+	return fmax(fabs(z), config->disk_half_thickness) / fabs(dz);
+}
+
+static int config_max_steps(const struct bhs_geodesic_config *config)
+{
+	return config->max_steps > 0 ? config->max_steps
+				     : BHS_GEODESIC_MAX_STEPS;
+}
+
+static double config_escape_radius(const struct bhs_geodesic_config *config)
+{
+	return config->escape_radius > 0 ? config->escape_radius
+					 : BHS_GEODESIC_ESCAPE_RADIUS;
+}
+
 enum bhs_geodesic_status
 bhs_geodesic_propagate(struct bhs_geodesic *geo, const struct bhs_kerr *bh,
 		       const struct bhs_geodesic_config *config)
 {
-	int max_steps = config->max_steps > 0 ? config->max_steps
-					      : BHS_GEODESIC_MAX_STEPS;
-	double escape_r = config->escape_radius > 0
-				  ? config->escape_radius
-				  : BHS_GEODESIC_ESCAPE_RADIUS;
+	if (config->mode == BHS_GEO_MODE_CARTER)
+		return bhs_geodesic_propagate_carter(geo, bh, config);
+	if (config->mode == BHS_GEO_MODE_KERR_SCHILD)
+		return bhs_geodesic_propagate_kerr_schild(geo, bh, config);
+	if (config->mode == BHS_GEO_MODE_PLANAR)
+		return bhs_geodesic_propagate_planar(geo, bh, config);
+	if (config->mode == BHS_GEO_MODE_ELLIPTIC)
+		return bhs_geodesic_propagate_elliptic(geo, bh, config);
+	if (config->mode == BHS_GEO_MODE_METRIC)
+		return bhs_geodesic_propagate_metric(geo, bh, config);
+
+	int max_steps = config_max_steps(config);
+	double escape_r = config_escape_radius(config);
 	double r_horizon = bhs_kerr_horizon_outer(bh);
+	bool adaptive = config->tolerance > 0.0;
+	bool thin = thin_disk(config);
+
+	struct shortcut_ctx sc;
+	shortcut_init(&sc, geo, bh, config);
+
+	struct bhs_geodesic_stepper stepper;
+	if (adaptive)
+		bhs_geodesic_stepper_init(&stepper, config->dlambda,
+					  config->tolerance,
+					  config->abs_tolerance);
 
 	for (int i = 0; i < max_steps; i++) {
-		/* Verifica condições de parada */
-		double r = geo->pos.x;
+		enum bhs_geodesic_status st =
+			check_stop(geo, r_horizon, escape_r, config);
+		if (st == BHS_GEO_PROPAGATING)
+			st = try_shortcut(&sc, geo, bh, escape_r);
+		if (st != BHS_GEO_PROPAGATING) {
+			geo->status = st;
+			return st;
+		}
+
+		struct bhs_geodesic prev = *geo;
 
-		/* Capturado pelo horizonte */
-		if (r < r_horizon * 1.01) {
-			geo->status = BHS_GEO_CAPTURED;
-			return BHS_GEO_CAPTURED;
+		/* Próximo passo */
+		if (!adaptive) {
+			bhs_geodesic_step_rk4(geo, bh, config->dlambda);
+			if (thin && find_disk_crossing(&prev, geo, bh, config,
+						       NULL)) {
+				geo->status = BHS_GEO_HIT_DISK;
+				return BHS_GEO_HIT_DISK;
+			}
+			continue;
 		}
 
-		/* Escapou */
-		if (r > escape_r) {
-			geo->status = BHS_GEO_ESCAPED;
-			return BHS_GEO_ESCAPED;
+		stepper.h_max = disk_h_max(geo, config);
+		bhs_geodesic_step_dopri5(geo, bh, &stepper);
+		bool hit = thin && find_disk_crossing(&prev, geo, bh, config,
+						      &stepper);
+		if (config->on_step &&
+		    !config->on_step(&stepper, geo->affine_param,
+				     config->step_userdata)) {
+			geo->status = BHS_GEO_ABSORBED;
+			return BHS_GEO_ABSORBED;
 		}
+		if (hit) {
+			geo->status = BHS_GEO_HIT_DISK;
+			return BHS_GEO_HIT_DISK;
+		}
+	}
+
+	geo->status = BHS_GEO_TIMEOUT;
+	return BHS_GEO_TIMEOUT;
+}
+
+/* ============================================================================
+ * FORMULAÇÃO DE CARTER (1ª ORDEM)
+ * ============================================================================
+ */
+
+/*
+ * Estado em tempo de Mino σ (dλ = Σ dσ):
+ *   y = (t, r, θ, φ, r' = dr/dσ, θ' = dθ/dσ)
+ *
+ *   P(r)  = E(r² + a²) - aL
+ *   R(r)  = P² - Δ [μ² r² + Q + (L - aE)²]
+ *   Θ(θ)  = Q - cos²θ [a²(μ² - E²) + L²/sin²θ]
+ *
+ *   dt/dσ = (r² + a²) P / Δ - a(aE sin²θ - L)
+ *   dφ/dσ = a P / Δ - aE + L / sin²θ
+ *   dr'/dσ = R'(r)/2,   dθ'/dσ = Θ'(θ)/2
+ */
+struct carter_state {
+	double t, r, theta, phi, pr, ptheta;
+};
+
+struct carter_ctx {
+	double M, a, a2;
+	double E, L, Q, mu2;
+	double K; /* Q + (L - aE)² */
+};
+
+static void carter_ctx_init(struct carter_ctx *c, const struct bhs_kerr *bh,
+			    const struct bhs_geodesic_constants *k)
+{
+	c->M = bh->M;
+	c->a = bh->a;
+	c->a2 = bh->a * bh->a;
+	c->E = k->E;
+	c->L = k->L;
+	c->Q = k->Q;
+	c->mu2 = k->mu2;
+	c->K = k->Q + (k->L - bh->a * k->E) * (k->L - bh->a * k->E);
+}
+
+static double carter_R(const struct carter_ctx *c, double r)
+{
+	double P = c->E * (r * r + c->a2) - c->a * c->L;
+	double Delta = r * r - 2.0 * c->M * r + c->a2;
+	return P * P - Delta * (c->mu2 * r * r + c->K);
+}
+
+static double carter_Theta(const struct carter_ctx *c, double theta)
+{
+	double s = sin(theta);
+	double cs = cos(theta);
+	double s2 = fmax(s * s, 1e-300);
+	return c->Q - cs * cs * (c->a2 * (c->mu2 - c->E * c->E) +
+				 c->L * c->L / s2);
+}
+
+static void carter_deriv(const struct carter_ctx *c,
+			 const struct carter_state *y, struct carter_state *dy)
+{
+	double r = y->r;
+	double r2 = r * r;
+	double rho2 = r2 + c->a2;
+	double Delta = r2 - 2.0 * c->M * r + c->a2;
+	double P = c->E * rho2 - c->a * c->L;
 
-		/* Atingiu o disco */
-		if (config->disk_outer > 0 &&
-		    bhs_geodesic_is_in_disk(geo, config->disk_inner,
-					    config->disk_outer,
-					    config->disk_half_thickness)) {
+	double s = sin(y->theta);
+	double cs = cos(y->theta);
+	double s2 = s * s;
+	if (s2 < 1e-12) {
+		/* Eixo: L ≈ 0 para chegar aqui, o termo L/sin² some junto */
+		s2 = 1e-12;
+		s = s >= 0.0 ? 1e-6 : -1e-6;
+	}
+
+	dy->t = rho2 * P / Delta - c->a * (c->a * c->E * s2 - c->L);
+	dy->phi = c->a * P / Delta - c->a * c->E + c->L / s2;
+	dy->r = y->pr;
+	dy->theta = y->ptheta;
+
+	/* R'(r)/2 */
+	double mass_term = c->mu2 * r2 + c->K;
+	dy->pr = 2.0 * c->E * r * P - (r - c->M) * mass_term -
+		 c->mu2 * r * Delta;
+
+	/* Θ'(θ)/2 */
+	dy->ptheta = s * cs * c->a2 * (c->mu2 - c->E * c->E) +
+		     c->L * c->L * cs / (s2 * s);
+}
+
+static void carter_axpy(struct carter_state *out, const struct carter_state *y,
+			const struct carter_state *k, double h)
+{
+	out->t = y->t + h * k->t;
+	out->r = y->r + h * k->r;
+	out->theta = y->theta + h * k->theta;
+	out->phi = y->phi + h * k->phi;
+	out->pr = y->pr + h * k->pr;
+	out->ptheta = y->ptheta + h * k->ptheta;
+}
+
+static void carter_rk4(const struct carter_ctx *c, struct carter_state *y,
+		       double h)
+{
+	struct carter_state k1, k2, k3, k4, tmp;
+
+	carter_deriv(c, y, &k1);
+	carter_axpy(&tmp, y, &k1, 0.5 * h);
+	carter_deriv(c, &tmp, &k2);
+	carter_axpy(&tmp, y, &k2, 0.5 * h);
+	carter_deriv(c, &tmp, &k3);
+	carter_axpy(&tmp, y, &k3, h);
+	carter_deriv(c, &tmp, &k4);
+
+	double w = h / 6.0;
+	y->t += w * (k1.t + 2.0 * k2.t + 2.0 * k3.t + k4.t);
+	y->r += w * (k1.r + 2.0 * k2.r + 2.0 * k3.r + k4.r);
+	y->theta += w * (k1.theta + 2.0 * k2.theta + 2.0 * k3.theta +
+			 k4.theta);
+	y->phi += w * (k1.phi + 2.0 * k2.phi + 2.0 * k3.phi + k4.phi);
+	y->pr += w * (k1.pr + 2.0 * k2.pr + 2.0 * k3.pr + k4.pr);
+	y->ptheta += w * (k1.ptheta + 2.0 * k2.ptheta + 2.0 * k3.ptheta +
+			  k4.ptheta);
+}
+
+/**
+ * Reprojeta r' e θ' na casca R = r'², Θ = θ'²
+ *
+ * Mantém o sinal vindo da integração (que já cruzou o ponto de retorno
+ * se era o caso) e só corrige o módulo. Onde o potencial ficou
+ * numericamente negativo não mexemos: estamos colados no retorno.
+ */
+static void carter_project(const struct carter_ctx *c, struct carter_state *y)
+{
+	double R = carter_R(c, y->r);
+	if (R > 0.0)
+		y->pr = copysign(sqrt(R), y->pr);
+
+	double Th = carter_Theta(c, y->theta);
+	if (Th > 0.0)
+		y->ptheta = copysign(sqrt(Th), y->ptheta);
+}
+
+static void carter_to_geo(const struct carter_ctx *c,
+			  const struct carter_state *y,
+			  struct bhs_geodesic *geo)
+{
+	struct carter_state dy;
+	carter_deriv(c, y, &dy);
+
+	double cs = cos(y->theta);
+	double inv_S = 1.0 / (y->r * y->r + c->a2 * cs * cs);
+
+	geo->pos = bhs_vec4_make(y->t, y->r, y->theta, y->phi);
+	geo->vel = bhs_vec4_make(dy.t * inv_S, y->pr * inv_S,
+				 y->ptheta * inv_S, dy.phi * inv_S);
+}
+
+enum bhs_geodesic_status
+bhs_geodesic_propagate_carter(struct bhs_geodesic *geo,
+			      const struct bhs_kerr *bh,
+			      const struct bhs_geodesic_config *config)
+{
+	int max_steps = config_max_steps(config);
+	double escape_r = config_escape_radius(config);
+	double r_horizon = bhs_kerr_horizon_outer(bh);
+	bool thin = thin_disk(config);
+
+	struct bhs_geodesic_constants k;
+	struct carter_ctx c;
+	bhs_geodesic_constants(geo, bh, &k);
+	carter_ctx_init(&c, bh, &k);
+
+	struct shortcut_ctx sc;
+	shortcut_init(&sc, geo, bh, config);
+
+	double cs0 = cos(geo->pos.y);
+	double Sigma0 = geo->pos.x * geo->pos.x + c.a2 * cs0 * cs0;
+	struct carter_state y = {
+		.t = geo->pos.t,
+		.r = geo->pos.x,
+		.theta = geo->pos.y,
+		.phi = geo->pos.z,
+		.pr = Sigma0 * geo->vel.x,
+		.ptheta = Sigma0 * geo->vel.y,
+	};
+
+	for (int i = 0; i < max_steps; i++) {
+		enum bhs_geodesic_status st =
+			check_stop(geo, r_horizon, escape_r, config);
+		if (st == BHS_GEO_PROPAGATING)
+			st = try_shortcut(&sc, geo, bh, escape_r);
+		if (st != BHS_GEO_PROPAGATING) {
+			geo->status = st;
+			return st;
+		}
+
+		struct bhs_geodesic prev = *geo;
+
+		/* Mesmo dλ do modo Christoffel: dσ = dλ / Σ */
+		double cs = cos(y.theta);
+		double Sigma = y.r * y.r + c.a2 * cs * cs;
+		carter_rk4(&c, &y, config->dlambda / Sigma);
+
+		/* Atravessou o eixo (só acontece com L ≈ 0) */
+		if (y.theta < 0.0) {
+			y.theta = -y.theta;
+			y.ptheta = -y.ptheta;
+			y.phi += M_PI;
+		} else if (y.theta > M_PI) {
+			y.theta = 2.0 * M_PI - y.theta;
+			y.ptheta = -y.ptheta;
+			y.phi += M_PI;
+		}
+		y.phi = remainder(y.phi, 2.0 * M_PI);
+
+		carter_project(&c, &y);
+		carter_to_geo(&c, &y, geo);
+		geo->affine_param += config->dlambda;
+		geo->step_count++;
+
+		if (thin && find_disk_crossing(&prev, geo, bh, config, NULL)) {
 			geo->status = BHS_GEO_HIT_DISK;
 			return BHS_GEO_HIT_DISK;
 		}
+	}
 
-		/* Próximo passo */
-		bhs_geodesic_step_rk4(geo, bh, config->dlambda);
+	geo->status = BHS_GEO_TIMEOUT;
+	return BHS_GEO_TIMEOUT;
+}
+
+/* ============================================================================
+ * KERR-SCHILD (ATRAVESSA O HORIZONTE)
+ * ============================================================================
+ */
+
+/*
+ * Estado y = (t̃, x, y, z, u^t̃, u^x, u^y, u^z). Nada de ângulos: sem wrap,
+ * e o FSAL do DOPRI5 vale sempre.
+ */
+static void ks_deriv(const void *ctx, const double y[N_DIM],
+		     double dy[N_DIM])
+{
+	const struct bhs_kerr *bh = ctx;
+	struct bhs_vec4 acc;
+	if (bhs_kerr_schild_accel(bh, bhs_vec4_make(y[0], y[1], y[2], y[3]),
+				  bhs_vec4_make(y[4], y[5], y[6], y[7]),
+				  &acc) != 0)
+		acc = bhs_vec4_zero(); /* Anel: só acontece bem dentro */
+
+	dy[0] = y[4];
+	dy[1] = y[5];
+	dy[2] = y[6];
+	dy[3] = y[7];
+	dy[4] = acc.t;
+	dy[5] = acc.x;
+	dy[6] = acc.y;
+	dy[7] = acc.z;
+}
+
+/* RK4 clássico sobre o estado empacotado, para as cartas sem bhs_vec4 */
+static void rk4_raw(const void *ctx, geo_deriv_fn deriv, double y[N_DIM],
+		    double h)
+{
+	double k[4][N_DIM], tmp[N_DIM];
+	int i;
+
+	deriv(ctx, y, k[0]);
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y[i] + 0.5 * h * k[0][i];
+	deriv(ctx, tmp, k[1]);
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y[i] + 0.5 * h * k[1][i];
+	deriv(ctx, tmp, k[2]);
+	for (i = 0; i < N_DIM; i++)
+		tmp[i] = y[i] + h * k[2][i];
+	deriv(ctx, tmp, k[3]);
+
+	for (i = 0; i < N_DIM; i++)
+		y[i] += h / 6.0 * (k[0][i] + 2.0 * k[1][i] + 2.0 * k[2][i] +
+				   k[3][i]);
+}
+
+/**
+ * struct ks_step - Último passo em KS, para interpolar dentro dele
+ * @y0, @y1: estados nas pontas
+ * @h: tamanho do passo
+ * @st: stepper do DOPRI5 (saída densa) ou NULL (Hermite cúbica)
+ */
+struct ks_step {
+	const double *y0;
+	const double *y1;
+	double h;
+	const struct bhs_geodesic_stepper *st;
+};
+
+static void ks_interp(const struct ks_step *in, double s, double y[N_DIM])
+{
+	if (in->st) {
+		dense_raw(in->st, in->st->lambda0 + s * in->h, y);
+		return;
+	}
+
+	double s2 = s * s;
+	double s3 = s2 * s;
+	double h = in->h;
+
+	for (int i = 0; i < 4; i++) {
+		double x0 = in->y0[i], x1 = in->y1[i];
+		double v0 = in->y0[i + 4], v1 = in->y1[i + 4];
+
+		y[i] = (2.0 * s3 - 3.0 * s2 + 1.0) * x0 +
+		       (s3 - 2.0 * s2 + s) * h * v0 +
+		       (-2.0 * s3 + 3.0 * s2) * x1 + (s3 - s2) * h * v1;
+		y[i + 4] = (6.0 * s2 - 6.0 * s) / h * (x0 - x1) +
+			   (3.0 * s2 - 4.0 * s + 1.0) * v0 +
+			   (3.0 * s2 - 2.0 * s) * v1;
+	}
+}
+
+static double plane_offset_ks(const void *ctx, double s)
+{
+	double y[N_DIM];
+	ks_interp(ctx, s, y);
+	return y[3];
+}
+
+/**
+ * Devolve o estado KS para @geo em Boyer-Lindquist
+ *
+ * No eixo (x = y = 0) BL não tem φ: fica só a posição, com φ̃ no lugar.
+ */
+static void ks_to_geo(const struct bhs_kerr *bh, const double y[N_DIM],
+		      struct bhs_geodesic *geo)
+{
+	struct bhs_vec4 pos, vel;
+	if (bhs_kerr_schild_to_bl(bh, bhs_vec4_make(y[0], y[1], y[2], y[3]),
+				  bhs_vec4_make(y[4], y[5], y[6], y[7]), &pos,
+				  &vel) == 0) {
+		geo->pos = pos;
+		geo->vel = vel;
+		return;
+	}
+
+	double r = bhs_kerr_schild_r(bh, y[1], y[2], y[3]);
+	double ct = r > 0.0 ? fmin(fmax(y[3] / r, -1.0), 1.0) : 0.0;
+	geo->pos = bhs_vec4_make(y[0], r, acos(ct), atan2(y[2], y[1]));
+}
+
+/**
+ * Cruzamento de z = 0 no último passo (o plano equatorial é o mesmo)
+ *
+ * Retorna: true se cruzou entre disk_inner e disk_outer; aí @geo vira o
+ * ponto de impacto em BL e geo->hit é preenchido
+ */
+static bool ks_disk_crossing(const struct bhs_kerr *bh,
+			     const struct bhs_geodesic_config *config,
+			     const struct ks_step *in, double lambda0,
+			     struct bhs_geodesic *geo)
+{
+	double g0 = in->y0[3];
+	double g1 = in->y1[3];
+
+	if (g0 == 0.0 || g0 * g1 > 0.0 || !(in->h > 0.0))
+		return false;
+
+	double y[N_DIM];
+	double s = illinois_root(plane_offset_ks, in, g0, g1);
+	ks_interp(in, s, y);
+	y[3] = 0.0;
+
+	double r = bhs_kerr_schild_r(bh, y[1], y[2], y[3]);
+	if (r < config->disk_inner || r > config->disk_outer)
+		return false;
+
+	ks_to_geo(bh, y, geo);
+	geo->pos.y = M_PI_2;
+	geo->affine_param = lambda0 + s * in->h;
+
+	struct bhs_metric g;
+	bhs_kerr_metric(bh, geo->pos.x, geo->pos.y, &g);
+
+	geo->hit.r = geo->pos.x;
+	geo->hit.phi = geo->pos.z;
+	geo->hit.lambda = geo->affine_param;
+	geo->hit.p = bhs_metric_lower(&g, geo->vel);
+	return true;
+}
+
+static enum bhs_geodesic_status
+ks_check_stop(const struct bhs_kerr *bh, const double y[N_DIM],
+	      double r_horizon, double escape_r,
+	      const struct bhs_geodesic_config *config)
+{
+	double r = bhs_kerr_schild_r(bh, y[1], y[2], y[3]);
+
+	if (!isfinite(r) || !isfinite(y[4]))
+		return BHS_GEO_CAPTURED;
+
+	/* O horizonte de verdade: aqui nada diverge ao cruzá-lo */
+	if (r < r_horizon)
+		return BHS_GEO_CAPTURED;
+
+	if (r > escape_r)
+		return BHS_GEO_ESCAPED;
+
+	/* z de KS é o r cosθ de BL */
+	if (config->disk_outer > 0 && config->disk_half_thickness > 0 &&
+	    r > config->disk_inner && r < config->disk_outer &&
+	    fabs(y[3]) < config->disk_half_thickness)
+		return BHS_GEO_HIT_DISK;
+
+	return BHS_GEO_PROPAGATING;
+}
+
+enum bhs_geodesic_status
+bhs_geodesic_propagate_kerr_schild(struct bhs_geodesic *geo,
+				   const struct bhs_kerr *bh,
+				   const struct bhs_geodesic_config *config)
+{
+	int max_steps = config_max_steps(config);
+	double escape_r = config_escape_radius(config);
+	double r_horizon = bhs_kerr_horizon_outer(bh);
+	bool adaptive = config->tolerance > 0.0;
+	bool thin = thin_disk(config);
+
+	struct bhs_vec4 pos, vel;
+	if (bhs_kerr_schild_from_bl(bh, geo->pos, geo->vel, &pos, &vel) != 0) {
+		/* Nasceu em cima do horizonte */
+		geo->status = BHS_GEO_CAPTURED;
+		return BHS_GEO_CAPTURED;
+	}
+	double y[N_DIM] = { pos.t, pos.x, pos.y, pos.z,
+			    vel.t, vel.x, vel.y, vel.z };
+	double y0[N_DIM];
+
+	struct bhs_geodesic_stepper stepper;
+	if (adaptive)
+		bhs_geodesic_stepper_init(&stepper, config->dlambda,
+					  config->tolerance,
+					  config->abs_tolerance);
+
+	enum bhs_geodesic_status st = BHS_GEO_TIMEOUT;
+	for (int i = 0; i < max_steps; i++) {
+		st = ks_check_stop(bh, y, r_horizon, escape_r, config);
+		if (st != BHS_GEO_PROPAGATING)
+			break;
+		st = BHS_GEO_TIMEOUT;
+
+		memcpy(y0, y, sizeof(y0));
+		double lambda0 = geo->affine_param;
+		double h = config->dlambda;
+
+		if (adaptive) {
+			/* Mesmo teto do modo BL para não pular a fatia grossa */
+			stepper.h_max = 0.0;
+			if (config->disk_outer > 0 &&
+			    config->disk_half_thickness > 0 && y[3] * y[7] < 0.0)
+				stepper.h_max =
+					fmax(fabs(y[3]),
+					     config->disk_half_thickness) /
+					fabs(y[7]);
+
+			/* Passo forçado avança, como no modo BL */
+			h = dopri5_advance(bh, ks_deriv, &stepper, lambda0, y0,
+					   y, NULL);
+		} else {
+			rk4_raw(bh, ks_deriv, y, h);
+		}
+		geo->affine_param += h;
+		geo->step_count++;
+
+		struct ks_step in = {
+			.y0 = y0,
+			.y1 = y,
+			.h = h,
+			.st = adaptive ? &stepper : NULL,
+		};
+		if (thin && ks_disk_crossing(bh, config, &in, lambda0, geo)) {
+			geo->status = BHS_GEO_HIT_DISK;
+			return BHS_GEO_HIT_DISK;
+		}
+	}
+
+	ks_to_geo(bh, y, geo);
+	geo->status = st;
+	return st;
+}
+
+/* ============================================================================
+ * MÉTRICA NUMÉRICA (DESCRITOR)
+ * ============================================================================
+ */
+
+/* Passo da diferença finita quando o descritor não tem dual_fn */
+#define METRIC_FD_STEP 1e-5
+
+struct metric_ctx {
+	const struct bhs_metric_desc *desc;
+	void *userdata;
+};
+
+static void metric_deriv(const void *ctx, const double y[N_DIM],
+			 double dy[N_DIM])
+{
+	const struct metric_ctx *m = ctx;
+	struct bhs_christoffel_sparse chris;
+	struct bhs_vec4 acc = bhs_vec4_zero();
+
+	if (bhs_christoffel_compute_desc(m->desc,
+					 bhs_vec4_make(y[0], y[1], y[2], y[3]),
+					 m->userdata, METRIC_FD_STEP,
+					 &chris) == 0)
+		acc = bhs_geodesic_accel_sparse(
+			&chris, bhs_vec4_make(y[4], y[5], y[6], y[7]));
+
+	dy[0] = y[4];
+	dy[1] = y[5];
+	dy[2] = y[6];
+	dy[3] = y[7];
+	dy[4] = acc.t;
+	dy[5] = acc.x;
+	dy[6] = acc.y;
+	dy[7] = acc.z;
+}
+
+enum bhs_geodesic_status
+bhs_geodesic_propagate_metric(struct bhs_geodesic *geo,
+			      const struct bhs_kerr *bh,
+			      const struct bhs_geodesic_config *config)
+{
+	int max_steps = config_max_steps(config);
+	double escape_r = config_escape_radius(config);
+	double r_horizon = config->metric_horizon > 0.0
+				   ? config->metric_horizon
+				   : bhs_kerr_horizon_outer(bh);
+	bool adaptive = config->tolerance > 0.0;
+	bool thin = thin_disk(config);
+	struct metric_ctx ctx = {
+		.desc = config->metric,
+		.userdata = config->metric_userdata,
+	};
+	struct bhs_metric g;
+
+	/* Sem descritor não há o que integrar: nenhum passo é dado */
+	if (!ctx.desc || !ctx.desc->fn) {
+		geo->status = BHS_GEO_TIMEOUT;
+		return BHS_GEO_TIMEOUT;
+	}
+
+	if (geo->type == BHS_GEODESIC_NULL) {
+		ctx.desc->fn(geo->pos, ctx.userdata, &g);
+		geo->vel.t = null_kt(&g, geo->vel.x, geo->vel.y, geo->vel.z);
+	}
+
+	struct bhs_geodesic_stepper stepper;
+	if (adaptive)
+		bhs_geodesic_stepper_init(&stepper, config->dlambda,
+					  config->tolerance,
+					  config->abs_tolerance);
+
+	for (int i = 0; i < max_steps; i++) {
+		enum bhs_geodesic_status st =
+			check_stop(geo, r_horizon, escape_r, config);
+		if (st != BHS_GEO_PROPAGATING) {
+			geo->status = st;
+			return st;
+		}
+
+		struct bhs_geodesic prev = *geo;
+		double y0[N_DIM], y[N_DIM];
+		double h = config->dlambda;
+
+		geo_pack(geo, y0);
+		memcpy(y, y0, sizeof(y));
+		if (adaptive) {
+			stepper.h_max = disk_h_max(geo, config);
+			h = dopri5_advance(&ctx, metric_deriv, &stepper,
+					   geo->affine_param, y0, y, NULL);
+		} else {
+			rk4_raw(&ctx, metric_deriv, y, h);
+		}
+
+		/* Mesma reflexão nos polos do modo BL; ela invalida o FSAL */
+		bool reflected = wrap_angles(&y[2], &y[3]);
+		if (adaptive)
+			stepper.fsal_valid = !reflected;
+
+		geo->pos = bhs_vec4_make(y[0], y[1], y[2], y[3]);
+		geo->vel = bhs_vec4_make(y[4], y[5], y[6], y[7]);
+		geo->affine_param += h;
+		geo->step_count++;
+
+		if (thin && find_disk_crossing(&prev, geo, bh, config,
+					       adaptive ? &stepper : NULL)) {
+			/* find_disk_crossing baixa o índice com Kerr */
+			ctx.desc->fn(geo->pos, ctx.userdata, &g);
+			g.structure = bhs_metric_structure_of(ctx.desc->zero);
+			geo->hit.p = bhs_metric_lower(&g, geo->vel);
+			geo->status = BHS_GEO_HIT_DISK;
+			return BHS_GEO_HIT_DISK;
+		}
 	}
 
 	geo->status = BHS_GEO_TIMEOUT;
@@ -320,6 +1759,31 @@ bool bhs_geodesic_is_in_disk(const struct bhs_geodesic *geo, double inner,
 	return (r > inner && r < outer && fabs(z) < half_thickness);
 }
 
+void bhs_geodesic_constants(const struct bhs_geodesic *geo,
+			    const struct bhs_kerr *bh,
+			    struct bhs_geodesic_constants *out)
+{
+	/*
+   * p_μ = g_μν u^ν
+   * E = -p_t,  L = p_φ
+   * Q = p_θ² + cos²θ [a²(μ² - E²) + L²/sin²θ]
+   */
+	struct bhs_metric g;
+	bhs_kerr_metric(bh, geo->pos.x, geo->pos.y, &g);
+	struct bhs_vec4 p = bhs_metric_lower(&g, geo->vel);
+
+	double s = sin(geo->pos.y);
+	double cs = cos(geo->pos.y);
+	double s2 = fmax(s * s, 1e-300);
+
+	out->mu2 = geo->type == BHS_GEODESIC_TIMELIKE ? 1.0 : 0.0;
+	out->E = -p.t;
+	out->L = p.z;
+	out->Q = p.y * p.y +
+		 cs * cs * (bh->a * bh->a * (out->mu2 - out->E * out->E) +
+			    out->L * out->L / s2);
+}
+
 double bhs_geodesic_norm2(const struct bhs_geodesic *geo,
 			  const struct bhs_kerr *bh)
 {
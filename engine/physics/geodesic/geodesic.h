@@ -21,6 +21,8 @@
 #include "math/tensor/tensor.h"
 #include "math/vec4.h"
 
+struct bhs_planar_lut;
+
 /* ============================================================================
  * TIPOS
  * ============================================================================
@@ -45,6 +47,35 @@ enum bhs_geodesic_status {
 	BHS_GEO_CAPTURED,    /* Capturada pelo horizonte (r < r+) */
 	BHS_GEO_HIT_DISK,    /* Atingiu o disco de acreção */
 	BHS_GEO_TIMEOUT,     /* Limite de passos atingido */
+	BHS_GEO_ABSORBED,    /* Parada pelo observador de passos (on_step) */
+};
+
+/**
+ * enum bhs_geodesic_shortcut - Atalho analítico que encerrou a propagação
+ * @BHS_GEO_SHORTCUT_NONE: parou pelos critérios numéricos normais
+ * @BHS_GEO_SHORTCUT_SHADOW: capturado por estar dentro da sombra de Bardeen
+ * @BHS_GEO_SHORTCUT_FAR_FIELD: escape fechado com a deflexão de campo fraco
+ */
+enum bhs_geodesic_shortcut {
+	BHS_GEO_SHORTCUT_NONE = 0,
+	BHS_GEO_SHORTCUT_SHADOW,
+	BHS_GEO_SHORTCUT_FAR_FIELD,
+};
+
+/**
+ * struct bhs_geodesic_hit - Onde a geodésica cruzou o plano do disco
+ * @r: raio do cruzamento
+ * @phi: azimute do cruzamento
+ * @lambda: parâmetro afim no cruzamento
+ * @p: 4-momento covariante p_μ = g_μν k^ν na chegada
+ *
+ * Com p_μ o redshift vem direto: g = 1 / (-p_μ u^μ_emissor).
+ */
+struct bhs_geodesic_hit {
+	double r;
+	double phi;
+	double lambda;
+	struct bhs_vec4 p;
 };
 
 /**
@@ -57,6 +88,47 @@ struct bhs_geodesic {
 	enum bhs_geodesic_status status; /* Status atual */
 	double affine_param;		 /* Parâmetro afim acumulado */
 	int step_count;			 /* Número de passos dados */
+	struct bhs_geodesic_hit hit;	 /* Válido se status == HIT_DISK */
+	enum bhs_geodesic_shortcut shortcut; /* Como terminou (estatística) */
+};
+
+/**
+ * struct bhs_geodesic_constants - Constantes de movimento em Kerr
+ * @E: energia específica (-p_t)
+ * @L: momento angular axial (p_φ)
+ * @Q: constante de Carter
+ * @mu2: massa² da partícula (0 para fótons, 1 para timelike)
+ *
+ * Com elas o movimento vira problema de primeira ordem em (r, θ):
+ *   (dr/dσ)² = R(r),  (dθ/dσ)² = Θ(θ),  dλ = Σ dσ (tempo de Mino)
+ */
+struct bhs_geodesic_constants {
+	double E;
+	double L;
+	double Q;
+	double mu2;
+};
+
+/**
+ * enum bhs_geodesic_mode - Formulação usada na propagação
+ * @BHS_GEO_MODE_CHRISTOFFEL: sistema de 2ª ordem com Γ^α_μν (padrão)
+ * @BHS_GEO_MODE_CARTER: potenciais R(r), Θ(θ) com E, L, Q fixos
+ * @BHS_GEO_MODE_KERR_SCHILD: Christoffel em Kerr-Schild cartesiano,
+ *                            sem singularidade no horizonte nem nos polos
+ * @BHS_GEO_MODE_PLANAR: fótons em Schwarzschild (a = 0) pela equação de
+ *                       Binet no plano orbital; o resto cai no Christoffel
+ * @BHS_GEO_MODE_ELLIPTIC: fótons de Kerr em forma fechada (integrais
+ *                         elípticas); o resto cai no Christoffel
+ * @BHS_GEO_MODE_METRIC: Christoffel de uma métrica qualquer em (t, r, θ, φ)
+ *                       (config->metric), p.ex. uma tabela numérica
+ */
+enum bhs_geodesic_mode {
+	BHS_GEO_MODE_CHRISTOFFEL = 0,
+	BHS_GEO_MODE_CARTER,
+	BHS_GEO_MODE_KERR_SCHILD,
+	BHS_GEO_MODE_PLANAR,
+	BHS_GEO_MODE_ELLIPTIC,
+	BHS_GEO_MODE_METRIC,
 };
 
 /* ============================================================================
@@ -73,6 +145,9 @@ struct bhs_geodesic {
 /** Raio de escape padrão */
 #define BHS_GEODESIC_ESCAPE_RADIUS 100.0
 
+/** Passo em ψ do modo planar sem tolerância (rad) */
+#define BHS_GEODESIC_PLANAR_DPSI 0.02
+
 /* ============================================================================
  * INICIALIZAÇÃO
  * ============================================================================
@@ -127,15 +202,105 @@ int bhs_geodesic_step_rk4(struct bhs_geodesic *geo, const struct bhs_kerr *bh,
  * bhs_geodesic_step_adaptive - Passo adaptativo
  * @geo: geodésica
  * @bh: parâmetros
- * @dlambda: tamanho do passo inicial (pode ser modificado)
- * @tolerance: erro relativo tolerado
+ * @dlambda: [in/out] passo tentado; sai com o passo sugerido para o próximo
+ * @tolerance: erro tolerado (relativo e absoluto, por componente)
  *
- * Ajusta automaticamente dlambda para manter precisão.
+ * Um passo Dormand-Prince 5(4) sem estado: repete com passo menor até o
+ * erro embutido ficar abaixo de @tolerance. Para uma trajetória inteira
+ * prefira bhs_geodesic_step_dopri5(), que reaproveita a última derivada.
+ *
+ * Retorna:
+ *   0 se o passo foi aceito dentro da tolerância
+ *  -1 se foi forçado (passo mínimo atingido ou estado não-finito)
  */
 int bhs_geodesic_step_adaptive(struct bhs_geodesic *geo,
 			       const struct bhs_kerr *bh, double *dlambda,
 			       double tolerance);
 
+/* ============================================================================
+ * INTEGRAÇÃO DORMAND-PRINCE 5(4)
+ * ============================================================================
+ */
+
+/** Estado integrado pelo DOPRI5: (t, r, θ, φ, u^t, u^r, u^θ, u^φ) */
+#define BHS_GEODESIC_DIM 8
+
+/**
+ * struct bhs_geodesic_stepper - Estado do integrador adaptativo
+ * @h: passo a tentar no próximo bhs_geodesic_step_dopri5()
+ * @h_min: abaixo disso o passo é aceito à força
+ * @h_max: teto do passo (0 = sem teto)
+ * @rtol: tolerância relativa
+ * @atol: tolerância absoluta
+ * @fsal: derivada no fim do último passo (= k1 do próximo)
+ * @fsal_valid: @fsal corresponde ao estado atual da geodésica
+ * @lambda0: parâmetro afim no início do último passo aceito
+ * @h_last: tamanho do último passo aceito
+ * @rcont: coeficientes da saída densa do último passo aceito
+ * @accepted: passos aceitos
+ * @rejected: passos rejeitados
+ *
+ * O erro é medido componente a componente contra
+ * sc_i = atol + rtol · max(|y_i|, |y_i'|), e não como norma euclidiana
+ * misturando t, r, θ e φ.
+ */
+struct bhs_geodesic_stepper {
+	double h;
+	double h_min;
+	double h_max;
+	double rtol;
+	double atol;
+	double fsal[BHS_GEODESIC_DIM];
+	bool fsal_valid;
+	double lambda0;
+	double h_last;
+	double rcont[5][BHS_GEODESIC_DIM];
+	int accepted;
+	int rejected;
+};
+
+/**
+ * bhs_geodesic_stepper_init - Prepara o integrador
+ * @st: [out] estado
+ * @h0: passo inicial
+ * @rtol: tolerância relativa
+ * @atol: tolerância absoluta (0 = igual a @rtol)
+ */
+void bhs_geodesic_stepper_init(struct bhs_geodesic_stepper *st, double h0,
+			       double rtol, double atol);
+
+/**
+ * bhs_geodesic_step_dopri5 - Um passo aceito de Dormand-Prince 5(4)
+ * @geo: geodésica (avança um passo)
+ * @bh: parâmetros do buraco negro
+ * @st: estado do integrador (passo, FSAL, saída densa)
+ *
+ * Par embutido de ordem 5(4) com FSAL: 6 avaliações de Γ por passo
+ * aceito (a 7ª vira o k1 do passo seguinte), contra 12 do step doubling.
+ * Passos rejeitados são refeitos aqui dentro com h menor.
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 se o passo foi forçado com h = h_min ou o estado divergiu
+ */
+int bhs_geodesic_step_dopri5(struct bhs_geodesic *geo,
+			     const struct bhs_kerr *bh,
+			     struct bhs_geodesic_stepper *st);
+
+/**
+ * bhs_geodesic_dense_eval - Interpola dentro do último passo aceito
+ * @st: integrador após bhs_geodesic_step_dopri5()
+ * @lambda: parâmetro afim em [lambda0, lambda0 + h_last]
+ * @pos: [out] posição (pode ser NULL)
+ * @vel: [out] 4-velocidade (pode ser NULL)
+ *
+ * Interpolante de 4ª ordem do DOPRI5: estado em qualquer λ do passo sem
+ * nenhuma avaliação extra de Γ.
+ */
+void bhs_geodesic_dense_eval(const struct bhs_geodesic_stepper *st,
+			     double lambda, struct bhs_vec4 *pos,
+			     struct bhs_vec4 *vel);
+
 /* ============================================================================
  * PROPAGAÇÃO COMPLETA
  * ============================================================================
@@ -145,12 +310,27 @@ int bhs_geodesic_step_adaptive(struct bhs_geodesic *geo,
  * struct bhs_geodesic_config - Configuração de propagação
  */
 struct bhs_geodesic_config {
-	double dlambda;		    /* Tamanho do passo */
+	double dlambda;		    /* Passo (inicial, se tolerance > 0) */
 	int max_steps;		    /* Máximo de passos (0 = default) */
 	double escape_radius;	    /* Raio de escape (0 = default) */
 	double disk_inner;	    /* Raio interno do disco */
 	double disk_outer;	    /* Raio externo do disco */
-	double disk_half_thickness; /* Meia-espessura do disco (em z) */
+	double disk_half_thickness; /* Meia-espessura (0 = plano fino) */
+	enum bhs_geodesic_mode mode; /* Formulação (0 = Christoffel) */
+	double tolerance;	     /* > 0: DOPRI5 adaptativo (rtol) */
+	double abs_tolerance;	     /* atol do DOPRI5 (0 = tolerance) */
+	bool shadow_capture;	     /* Captura analítica dentro da sombra */
+	double far_field_radius;     /* > 0: fecha escapes além deste raio */
+	const struct bhs_planar_lut *planar_lut; /* Tabela do modo planar */
+	bool mixed_precision; /* Lote: float longe do buraco, double perto */
+	/* Métrica do modo métrica (obrigatória, com fn; sem ela TIMEOUT) */
+	const struct bhs_metric_desc *metric;
+	void *metric_userdata;		      /* userdata de metric */
+	double metric_horizon; /* Captura do modo métrica (0 = r+ de bh) */
+	/* Observador de cada passo aceito do DOPRI5 (modo Christoffel) */
+	bool (*on_step)(const struct bhs_geodesic_stepper *st,
+			double lambda_end, void *user);
+	void *step_userdata; /* user de on_step */
 };
 
 /**
@@ -159,12 +339,172 @@ struct bhs_geodesic_config {
  * @bh: parâmetros do buraco negro
  * @config: configuração de propagação
  *
+ * Com config->tolerance > 0 (modo Christoffel) usa DOPRI5 adaptativo:
+ * passos longos longe do buraco, curtos na esfera de fótons. max_steps
+ * conta passos aceitos.
+ *
+ * Com disk_half_thickness = 0 o disco é o plano θ = π/2: a troca de
+ * sinal de θ - π/2 entre dois passos dispara uma busca de raiz dentro do
+ * passo (saída densa no DOPRI5, Hermite cúbica no RK4 e no Carter). O
+ * estado final fica exatamente no cruzamento e geo->hit é preenchido.
+ * Sem fatia para acertar, o passo não precisa ser pequeno por causa do
+ * disco. Com meia-espessura > 0 vale o teste de fatia antigo.
+ *
+ * Dois atalhos analíticos, só para fótons, cortam passos desperdiçados:
+ * - shadow_capture: se (ξ, η) = (L/E, Q/E²) está estritamente dentro da
+ *   curva crítica de Kerr, R(r) não tem raiz fora do horizonte e um raio
+ *   caindo é capturado na hora. Com disco, só depois de passar para
+ *   dentro de disk_inner (antes disso ainda pode bater no disco).
+ * - far_field_radius: um raio saindo além desse raio (e além do disco e
+ *   da região de fótons) não volta mais. O resto da órbita sai da solução
+ *   de 1ª ordem em M/r da equação de Binet no plano orbital instantâneo,
+ *   u'' + u = 3Mu², e o estado final fica em r = escape_radius.
+ *   Spin entra só em O(aM/r²): use raios de 20 M ou mais.
+ * geo->shortcut registra qual atalho encerrou o raio.
+ *
+ * Com DOPRI5 e config->on_step, cada passo aceito é entregue ao
+ * observador com a saída densa de [st->lambda0, lambda_end] (lambda_end
+ * é o cruzamento, se o passo parou no disco). Quem integra algo ao longo
+ * do raio (volume.h) amostra dali sem mexer no passo; on_step devolvendo
+ * false encerra com BHS_GEO_ABSORBED.
+ *
  * Retorna: status final (BHS_GEO_ESCAPED, BHS_GEO_CAPTURED, etc.)
  */
 enum bhs_geodesic_status
 bhs_geodesic_propagate(struct bhs_geodesic *geo, const struct bhs_kerr *bh,
 		       const struct bhs_geodesic_config *config);
 
+/**
+ * bhs_geodesic_propagate_carter - Propaga usando constantes de movimento
+ * @geo: geodésica (modificada in-place)
+ * @bh: parâmetros do buraco negro
+ * @config: configuração (config->mode é ignorado)
+ *
+ * E, L e Q são extraídos do estado inicial e ficam fixos: a integração
+ * é feita em tempo de Mino sobre (t, r, θ, φ, dr/dσ, dθ/dσ) usando
+ * d²r/dσ² = R'(r)/2 e d²θ/dσ² = Θ'(θ)/2, que atravessa pontos de retorno
+ * radiais e polares sem trocar sinal de raiz na mão. Nenhum Christoffel
+ * é avaliado. Cada passo cobre o mesmo dλ = config->dlambda.
+ *
+ * Retorna: status final (mesma semântica de bhs_geodesic_propagate)
+ */
+enum bhs_geodesic_status
+bhs_geodesic_propagate_carter(struct bhs_geodesic *geo,
+			      const struct bhs_kerr *bh,
+			      const struct bhs_geodesic_config *config);
+
+/**
+ * bhs_geodesic_propagate_kerr_schild - Propaga em coordenadas Kerr-Schild
+ * @geo: geodésica em Boyer-Lindquist (modificada in-place)
+ * @bh: parâmetros do buraco negro
+ * @config: configuração (config->mode é ignorado)
+ *
+ * Converte o estado para (t̃, x, y, z), integra lá (RK4 ou DOPRI5, mesma
+ * semântica de tolerance) e converte de volta no fim. Sem Δ no
+ * denominador, o passo não desaba perto do horizonte e a captura é o
+ * cruzamento real de r = r+, sem a margem de 1% do modo BL. O disco
+ * fino é o plano z = 0; geo->hit sai em BL como nos outros modos.
+ *
+ * Os atalhos analíticos não se aplicam aqui. Um raio capturado termina
+ * já dentro do horizonte, onde u^t e u^φ de BL não significam nada.
+ *
+ * Retorna: status final (mesma semântica de bhs_geodesic_propagate)
+ */
+enum bhs_geodesic_status
+bhs_geodesic_propagate_kerr_schild(struct bhs_geodesic *geo,
+				   const struct bhs_kerr *bh,
+				   const struct bhs_geodesic_config *config);
+
+/**
+ * bhs_geodesic_propagate_planar - Fóton de Schwarzschild no plano orbital
+ * @geo: geodésica em Boyer-Lindquist (modificada in-place)
+ * @bh: parâmetros do buraco negro (a = 0)
+ * @config: configuração (config->mode é ignorado)
+ *
+ * Com simetria esférica o fóton fica no plano de (r̂, dr̂/dλ). A base
+ * (ê1, ê2) desse plano é montada uma vez e a trajetória vira o sistema
+ * 1D u'' = 3Mu² - u em ψ (mais t e λ como quadraturas), integrado com
+ * RK4 em passo fixo de ψ: tolerance^(1/4) se tolerance > 0, senão
+ * BHS_GEODESIC_PLANAR_DPSI. Nenhum Christoffel, nenhuma trigonometria
+ * por passo.
+ *
+ * O plano do disco (z = 0) corta o plano orbital em ângulos ψ conhecidos
+ * de antemão, a cada π: o passo é cortado para cair exatamente neles,
+ * sem busca de raiz. O escape termina exatamente em r = escape_radius.
+ * Posição, velocidade e geo->hit voltam em BL, como nos outros modos.
+ *
+ * Com config->planar_lut (planar_lut.h) montada para este raio inicial,
+ * M e escape_radius, nem o RK4 roda: a órbita sai da tabela pelo b do
+ * raio, os cruzamentos com o disco são consultas de u(ψ) e step_count
+ * fica em zero. t e o parâmetro afim não são tabelados e ficam com o
+ * valor inicial; direções, r, φ e geo->hit saem como no integrado.
+ *
+ * Spin, geodésica tipo tempo, raio puramente radial ou disco com
+ * espessura caem em bhs_geodesic_propagate() no modo Christoffel.
+ *
+ * Retorna: status final (mesma semântica de bhs_geodesic_propagate)
+ */
+enum bhs_geodesic_status
+bhs_geodesic_propagate_planar(struct bhs_geodesic *geo,
+			      const struct bhs_kerr *bh,
+			      const struct bhs_geodesic_config *config);
+
+/**
+ * bhs_geodesic_propagate_elliptic - Fóton de Kerr sem integrar nada
+ * @geo: geodésica em Boyer-Lindquist (modificada in-place)
+ * @bh: parâmetros do buraco negro
+ * @config: configuração (config->mode é ignorado)
+ *
+ * Com λ = L/E e η = Q/E² do estado inicial, math/spacetime/kerr_elliptic.h
+ * dá o destino do raio (captura em 1.01 r+, como no modo BL, ou
+ * escape_radius), os cruzamentos do equador em ordem e r, θ, φ em cada
+ * um: o primeiro dentro de [disk_inner, disk_outer] é o impacto, seja
+ * imagem direta ou de ordem mais alta. Custo fixo por raio, inclusive
+ * rente à esfera de fótons, onde o DOPRI5 mais sofre; step_count fica em
+ * zero. Sem erro de passo: o que sobra é arredondamento e a tolerância
+ * das integrais de Carlson.
+ *
+ * t e o parâmetro afim não são calculados e ficam com o valor inicial;
+ * r, θ, φ, a 4-velocidade e geo->hit saem como no integrado.
+ *
+ * Geodésica tipo tempo, disco com espessura e os casos que
+ * bhs_kerr_elliptic_init() recusa (η ≤ 0, λ ≈ 0, Kerr extremo) caem em
+ * bhs_geodesic_propagate() no modo Christoffel.
+ *
+ * Retorna: status final (mesma semântica de bhs_geodesic_propagate)
+ */
+enum bhs_geodesic_status
+bhs_geodesic_propagate_elliptic(struct bhs_geodesic *geo,
+				const struct bhs_kerr *bh,
+				const struct bhs_geodesic_config *config);
+
+/**
+ * bhs_geodesic_propagate_metric - Propaga numa métrica dada por descritor
+ * @geo: geodésica em (t, r, θ, φ) (modificada in-place)
+ * @bh: só para a captura quando config->metric_horizon = 0
+ * @config: configuração (config->mode é ignorado)
+ *
+ * Mesmo laço do modo Christoffel (RK4 ou DOPRI5, disco fino com busca de
+ * raiz), mas com Γ de bhs_christoffel_compute_desc() sobre
+ * config->metric e config->metric_userdata: exato com dual_fn, diferença
+ * finita só nas coordenadas não-Killing sem ela. A carta tem que ser do
+ * tipo Boyer-Lindquist (r radial, disco em θ = π/2). A captura é em
+ * 1.01 config->metric_horizon.
+ *
+ * k^t do estado inicial é refeito na métrica dada, para que um raio
+ * montado em Kerr (bhs_geodesic_ray_from_camera) saia nulo nela. Os
+ * atalhos analíticos são de Kerr e não se aplicam.
+ *
+ * config->metric (e seu fn) é obrigatório. Sem ele nenhum passo é dado e
+ * a geodésica sai com BHS_GEO_TIMEOUT e step_count = 0.
+ *
+ * Retorna: status final (mesma semântica de bhs_geodesic_propagate)
+ */
+enum bhs_geodesic_status
+bhs_geodesic_propagate_metric(struct bhs_geodesic *geo,
+			      const struct bhs_kerr *bh,
+			      const struct bhs_geodesic_config *config);
+
 /* ============================================================================
  * VERIFICAÇÕES
  * ============================================================================
@@ -182,6 +522,34 @@ bool bhs_geodesic_is_inside_horizon(const struct bhs_geodesic *geo,
 bool bhs_geodesic_is_in_disk(const struct bhs_geodesic *geo, double inner,
 			     double outer, double half_thickness);
 
+/**
+ * bhs_geodesic_disk_crossing - Cruzamento de θ = π/2 dentro de um passo
+ * @prev: estado antes do passo
+ * @geo: estado depois do passo; vira o ponto de impacto se acertou
+ * @bh: parâmetros do buraco negro (para p_μ)
+ * @config: raios do disco (disk_inner, disk_outer)
+ *
+ * Hermite cúbica entre os dois estados (posição e u^μ nas pontas). Para
+ * quem tem o próprio laço de passos; bhs_geodesic_propagate já chama.
+ *
+ * Retorna: true se cruzou o plano entre disk_inner e disk_outer (aí
+ * geo->pos, geo->vel, geo->affine_param e geo->hit são atualizados)
+ */
+bool bhs_geodesic_disk_crossing(const struct bhs_geodesic *prev,
+				struct bhs_geodesic *geo,
+				const struct bhs_kerr *bh,
+				const struct bhs_geodesic_config *config);
+
+/**
+ * bhs_geodesic_constants - Extrai E, L e Q do estado atual
+ * @geo: geodésica
+ * @bh: parâmetros do buraco negro
+ * @out: [out] constantes de movimento
+ */
+void bhs_geodesic_constants(const struct bhs_geodesic *geo,
+			    const struct bhs_kerr *bh,
+			    struct bhs_geodesic_constants *out);
+
 /**
  * bhs_geodesic_norm2 - Norma² da 4-velocidade (para debug)
  *
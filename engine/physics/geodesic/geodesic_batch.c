@@ -0,0 +1,505 @@
+/**
+ * @file geodesic_batch.c
+ * @brief RK4 em lote, vetorizado ao longo dos raios
+ *
+ * "O compilador não é burro. Ele só precisa que você pare de esconder
+ * os dados dele atrás de structs passados por valor."
+ *
+ * Nada de intrínsecos: cada estágio do RK4 é uma sequência de laços de
+ * largura fixa BHS_GEO_BATCH_LANES sobre arrays locais, sem chamadas
+ * opacas nem desvios dependentes de dados. Com -mavx2/-mavx512f (ou
+ * BHS_ENABLE_NATIVE_ARCH) o compilador gera os registradores largos; sem
+ * eles o mesmo código vira o fallback escalar. Só sin/cos ficam num laço
+ * separado, porque a libm não vetoriza em todo lugar.
+ *
+ * O kernel existe duas vezes no mesmo binário (geodesic_batch_kernel.h),
+ * em double e em float com o dobro de lanes; BHS_USE_FLOAT e real_t não
+ * entram aqui. O estado do lote é sempre double: o kernel float só
+ * arredonda na carga, então promover um raio é trocar um byte.
+ */
+
+#define _GNU_SOURCE /* Para M_PI */
+
+#include "geodesic_batch.h"
+#include "math/spacetime/kerr_spin.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LANES BHS_GEO_BATCH_LANES
+#define LANES_F32 BHS_GEO_BATCH_LANES_F32
+#define BATCH_ALIGN 64
+
+/*
+ * Bloco de estado: y[0..3] = (t, r, θ, φ), y[4..7] = (u^t, u^r, u^θ, u^φ)
+ */
+enum { Y_T, Y_R, Y_TH, Y_PH, Y_VT, Y_VR, Y_VTH, Y_VPH, Y_N };
+
+/* ============================================================================
+ * ALOCAÇÃO
+ * ============================================================================
+ */
+
+static void *lane_alloc(size_t n, size_t elem)
+{
+	size_t bytes = n * elem;
+	bytes = (bytes + BATCH_ALIGN - 1) & ~(size_t)(BATCH_ALIGN - 1);
+
+	void *p = aligned_alloc(BATCH_ALIGN, bytes);
+	if (p)
+		memset(p, 0, bytes);
+	return p;
+}
+
+int bhs_geodesic_batch_init(struct bhs_geodesic_batch *batch, int capacity)
+{
+	memset(batch, 0, sizeof(*batch));
+	if (capacity <= 0)
+		return -1;
+
+	/* Folga até múltiplo do bloco largo: o último lê sem checar limites */
+	size_t n = ((size_t)capacity + LANES_F32 - 1) / LANES_F32 * LANES_F32;
+
+	double **d[] = { &batch->t,  &batch->r,  &batch->theta,	 &batch->phi,
+			 &batch->vt, &batch->vr, &batch->vtheta, &batch->vphi,
+			 &batch->affine };
+	for (size_t i = 0; i < sizeof(d) / sizeof(d[0]); i++)
+		*d[i] = lane_alloc(n, sizeof(double));
+
+	batch->steps = lane_alloc(n, sizeof(int));
+	batch->status = lane_alloc(n, sizeof(enum bhs_geodesic_status));
+	batch->id = lane_alloc(n, sizeof(int));
+	batch->fp32 = lane_alloc(n, sizeof(unsigned char));
+	batch->hit = lane_alloc(n, sizeof(struct bhs_geodesic_hit));
+
+	for (size_t i = 0; i < sizeof(d) / sizeof(d[0]); i++) {
+		if (!*d[i])
+			goto fail;
+	}
+	if (!batch->steps || !batch->status || !batch->id || !batch->fp32 ||
+	    !batch->hit)
+		goto fail;
+
+	batch->capacity = capacity;
+	return 0;
+
+fail:
+	bhs_geodesic_batch_free(batch);
+	return -1;
+}
+
+void bhs_geodesic_batch_free(struct bhs_geodesic_batch *batch)
+{
+	free(batch->t);
+	free(batch->r);
+	free(batch->theta);
+	free(batch->phi);
+	free(batch->vt);
+	free(batch->vr);
+	free(batch->vtheta);
+	free(batch->vphi);
+	free(batch->affine);
+	free(batch->steps);
+	free(batch->status);
+	free(batch->id);
+	free(batch->fp32);
+	free(batch->hit);
+	memset(batch, 0, sizeof(*batch));
+}
+
+void bhs_geodesic_batch_clear(struct bhs_geodesic_batch *batch)
+{
+	batch->count = 0;
+	batch->active = 0;
+}
+
+int bhs_geodesic_batch_push(struct bhs_geodesic_batch *batch,
+			    const struct bhs_geodesic *geo)
+{
+	if (batch->count >= batch->capacity)
+		return -1;
+
+	/* Mantém [0, active) contíguo: empurra o primeiro terminado pro fim */
+	int i = batch->count;
+	if (batch->active < batch->count) {
+		int j = batch->active;
+		batch->t[i] = batch->t[j];
+		batch->r[i] = batch->r[j];
+		batch->theta[i] = batch->theta[j];
+		batch->phi[i] = batch->phi[j];
+		batch->vt[i] = batch->vt[j];
+		batch->vr[i] = batch->vr[j];
+		batch->vtheta[i] = batch->vtheta[j];
+		batch->vphi[i] = batch->vphi[j];
+		batch->affine[i] = batch->affine[j];
+		batch->steps[i] = batch->steps[j];
+		batch->status[i] = batch->status[j];
+		batch->id[i] = batch->id[j];
+		batch->fp32[i] = batch->fp32[j];
+		batch->hit[i] = batch->hit[j];
+		i = j;
+	}
+
+	batch->t[i] = geo->pos.t;
+	batch->r[i] = geo->pos.x;
+	batch->theta[i] = geo->pos.y;
+	batch->phi[i] = geo->pos.z;
+	batch->vt[i] = geo->vel.t;
+	batch->vr[i] = geo->vel.x;
+	batch->vtheta[i] = geo->vel.y;
+	batch->vphi[i] = geo->vel.z;
+	batch->affine[i] = geo->affine_param;
+	batch->steps[i] = geo->step_count;
+	batch->status[i] = BHS_GEO_PROPAGATING;
+	batch->id[i] = batch->count;
+	batch->fp32[i] = 0;
+	batch->hit[i] = geo->hit;
+
+	batch->active++;
+	return batch->count++;
+}
+
+void bhs_geodesic_batch_scatter(const struct bhs_geodesic_batch *batch,
+				struct bhs_geodesic *out)
+{
+	for (int i = 0; i < batch->count; i++) {
+		struct bhs_geodesic *geo = &out[batch->id[i]];
+
+		geo->pos = bhs_vec4_make(batch->t[i], batch->r[i],
+					 batch->theta[i], batch->phi[i]);
+		geo->vel = bhs_vec4_make(batch->vt[i], batch->vr[i],
+					 batch->vtheta[i], batch->vphi[i]);
+		geo->type = BHS_GEODESIC_NULL;
+		geo->status = batch->status[i];
+		geo->affine_param = batch->affine[i];
+		geo->step_count = batch->steps[i];
+		geo->hit = batch->hit[i];
+		geo->shortcut = BHS_GEO_SHORTCUT_NONE;
+	}
+}
+
+/* ============================================================================
+ * FIM DE PASSO (DOUBLE, COMUM ÀS DUAS PRECISÕES)
+ * ============================================================================
+ */
+
+/**
+ * Cruzamento do plano θ = π/2 num raio (evento raro: escalar)
+ *
+ * O estado anterior ainda está no lote. Retorna: true se acertou o
+ * disco; @y1 passa a conter o impacto
+ */
+static bool lane_disk_crossing(struct bhs_geodesic_batch *b, int idx,
+			       double y1[Y_N], double dlambda,
+			       const struct bhs_kerr *bh,
+			       const struct bhs_geodesic_config *config)
+{
+	if ((M_PI_2 - b->theta[idx]) * (M_PI_2 - y1[Y_TH]) > 0.0)
+		return false;
+
+	struct bhs_geodesic prev = {
+		.pos = bhs_vec4_make(b->t[idx], b->r[idx], b->theta[idx],
+				     b->phi[idx]),
+		.vel = bhs_vec4_make(b->vt[idx], b->vr[idx], b->vtheta[idx],
+				     b->vphi[idx]),
+		.affine_param = b->affine[idx],
+	};
+	struct bhs_geodesic cur = {
+		.pos = bhs_vec4_make(y1[Y_T], y1[Y_R], y1[Y_TH], y1[Y_PH]),
+		.vel = bhs_vec4_make(y1[Y_VT], y1[Y_VR], y1[Y_VTH], y1[Y_VPH]),
+		.affine_param = b->affine[idx] + dlambda,
+	};
+
+	if (!bhs_geodesic_disk_crossing(&prev, &cur, bh, config))
+		return false;
+
+	y1[Y_T] = cur.pos.t;
+	y1[Y_R] = cur.pos.x;
+	y1[Y_TH] = cur.pos.y;
+	y1[Y_PH] = cur.pos.z;
+	y1[Y_VT] = cur.vel.t;
+	y1[Y_VR] = cur.vel.x;
+	y1[Y_VTH] = cur.vel.y;
+	y1[Y_VPH] = cur.vel.z;
+	b->hit[idx] = cur.hit;
+	return true;
+}
+
+/**
+ * Grava o resultado de um passo RK4 do raio @idx
+ *
+ * Disco fino (só com @config), wrap de θ e φ, parâmetro afim e status.
+ * Os kernels das duas precisões terminam aqui, sempre em double.
+ */
+static void lane_commit(struct bhs_geodesic_batch *b, int idx, double y1[Y_N],
+			double dlambda, const struct bhs_kerr *bh,
+			const struct bhs_geodesic_config *config)
+{
+	bool thin = config && config->disk_outer > 0 &&
+		    config->disk_half_thickness <= 0;
+	bool hit = thin && lane_disk_crossing(b, idx, y1, dlambda, bh, config);
+	double step = hit ? b->hit[idx].lambda - b->affine[idx] : dlambda;
+
+	/* Mesmo wrap de θ e φ que bhs_geodesic_step_rk4() */
+	double th = y1[Y_TH];
+	double ph = y1[Y_PH];
+
+	if (th < 0.0) {
+		th = -th;
+		ph += M_PI;
+	}
+	if (th > M_PI) {
+		th = 2.0 * M_PI - th;
+		ph += M_PI;
+	}
+
+	b->t[idx] = y1[Y_T];
+	b->r[idx] = y1[Y_R];
+	b->theta[idx] = th;
+	b->phi[idx] = remainder(ph, 2.0 * M_PI);
+	b->vt[idx] = y1[Y_VT];
+	b->vr[idx] = y1[Y_VR];
+	b->vtheta[idx] = y1[Y_VTH];
+	b->vphi[idx] = y1[Y_VPH];
+	b->affine[idx] += step;
+	b->steps[idx]++;
+	if (hit)
+		b->status[idx] = BHS_GEO_HIT_DISK;
+}
+
+/* ============================================================================
+ * KERNELS: RK4 POR BLOCO EM DOUBLE E EM FLOAT
+ * ============================================================================
+ */
+
+#define KERNEL_REAL double
+#define KERNEL_LANES BHS_GEO_BATCH_LANES
+#define KERNEL_FP32 0
+#define KERNEL_FN(x) x##_f64
+#define KERNEL_SIN sin
+#define KERNEL_COS cos
+#define KERNEL_FABS fabs
+#define KERNEL_COPYSIGN copysign
+#include "geodesic_batch_kernel.h"
+
+#define KERNEL_REAL float
+#define KERNEL_LANES BHS_GEO_BATCH_LANES_F32
+#define KERNEL_FP32 1
+#define KERNEL_FN(x) x##_f32
+#define KERNEL_SIN sinf
+#define KERNEL_COS cosf
+#define KERNEL_FABS fabsf
+#define KERNEL_COPYSIGN copysignf
+#include "geodesic_batch_kernel.h"
+
+/* ============================================================================
+ * INTEGRAÇÃO
+ * ============================================================================
+ */
+
+/**
+ * Passo RK4 do lote; com @config de disco fino também detecta impactos
+ *
+ * Cada bloco largo passa pelo kernel float (raios com fp32) e pelas suas
+ * duas metades no kernel double (o resto). Depois da compactação os
+ * blocos são homogêneos e só um dos dois tem trabalho.
+ */
+static void batch_step(struct bhs_geodesic_batch *batch,
+		       const struct bhs_kerr *bh, double dlambda,
+		       const struct bhs_geodesic_config *config)
+{
+	for (int base = 0; base < batch->active; base += LANES_F32) {
+		block_step_f32(batch, base, bh, dlambda, config);
+		for (int half = base; half < base + LANES_F32; half += LANES)
+			block_step_f64(batch, half, bh, dlambda, config);
+	}
+}
+
+void bhs_geodesic_batch_step_rk4(struct bhs_geodesic_batch *batch,
+				 const struct bhs_kerr *bh, double dlambda)
+{
+	batch_step(batch, bh, dlambda, NULL);
+}
+
+static void batch_swap(struct bhs_geodesic_batch *b, int i, int j)
+{
+#define SWAP(arr)                                                              \
+	do {                                                                   \
+		__typeof__(arr[0]) tmp_ = arr[i];                              \
+		arr[i] = arr[j];                                               \
+		arr[j] = tmp_;                                                 \
+	} while (0)
+
+	SWAP(b->t);
+	SWAP(b->r);
+	SWAP(b->theta);
+	SWAP(b->phi);
+	SWAP(b->vt);
+	SWAP(b->vr);
+	SWAP(b->vtheta);
+	SWAP(b->vphi);
+	SWAP(b->affine);
+	SWAP(b->steps);
+	SWAP(b->status);
+	SWAP(b->id);
+	SWAP(b->fp32);
+	SWAP(b->hit);
+
+#undef SWAP
+}
+
+int bhs_geodesic_batch_compact(struct bhs_geodesic_batch *batch)
+{
+	int i = 0;
+	int j = batch->active - 1;
+
+	while (i <= j) {
+		if (batch->status[i] == BHS_GEO_PROPAGATING) {
+			i++;
+		} else {
+			batch_swap(batch, i, j);
+			j--;
+		}
+	}
+
+	batch->active = i;
+
+	/* Raios float antes dos double: blocos de uma precisão só */
+	j = i - 1;
+	i = 0;
+	while (i <= j) {
+		if (batch->fp32[i]) {
+			i++;
+		} else {
+			batch_swap(batch, i, j);
+			j--;
+		}
+	}
+
+	return batch->active;
+}
+
+/**
+ * Aplica os critérios de check_stop() em [0, active)
+ *
+ * Retorna: quantos raios continuam propagando
+ */
+static int batch_check_stop(struct bhs_geodesic_batch *b, double r_horizon,
+			    double r_promote, double escape_r,
+			    const struct bhs_geodesic_config *config)
+{
+	int alive = 0;
+	int disk = config->disk_outer > 0;
+
+	for (int i = 0; i < b->active; i++) {
+		if (b->status[i] != BHS_GEO_PROPAGATING)
+			continue;
+
+		double r = b->r[i];
+		double z = r * cos(b->theta[i]);
+		enum bhs_geodesic_status st = BHS_GEO_PROPAGATING;
+
+		if (!isfinite(r) || !isfinite(b->vt[i]))
+			st = BHS_GEO_CAPTURED;
+		else if (r < r_horizon * 1.01)
+			st = BHS_GEO_CAPTURED;
+		else if (r > escape_r)
+			st = BHS_GEO_ESCAPED;
+		else if (disk && config->disk_half_thickness > 0 &&
+			 r > config->disk_inner &&
+			 r < config->disk_outer &&
+			 fabs(z) < config->disk_half_thickness)
+			st = BHS_GEO_HIT_DISK;
+
+		b->status[i] = st;
+		alive += st == BHS_GEO_PROPAGATING;
+
+		/* Esfera de fótons e horizonte: daqui pra dentro, double */
+		if (r < r_promote)
+			b->fp32[i] = 0;
+	}
+
+	return alive;
+}
+
+/**
+ * Promove a double os raios float cuja norma nula já derivou
+ *
+ * Mesma conta de bhs_geodesic_norm2(), relativa a (u^t)² para não
+ * depender da escala da velocidade. Escalar e com métrica completa: só
+ * roda junto com a compactação.
+ */
+static void batch_check_norm(struct bhs_geodesic_batch *b,
+			     const struct bhs_kerr *bh)
+{
+	for (int i = 0; i < b->active; i++) {
+		if (!b->fp32[i] || b->status[i] != BHS_GEO_PROPAGATING)
+			continue;
+
+		struct bhs_geodesic geo = {
+			.pos = bhs_vec4_make(b->t[i], b->r[i], b->theta[i],
+					     b->phi[i]),
+			.vel = bhs_vec4_make(b->vt[i], b->vr[i], b->vtheta[i],
+					     b->vphi[i]),
+			.type = BHS_GEODESIC_NULL,
+		};
+		double n2 = bhs_geodesic_norm2(&geo, bh);
+		double scale = b->vt[i] * b->vt[i];
+
+		if (!(fabs(n2) <= BHS_GEO_BATCH_F32_NULL_TOL * scale))
+			b->fp32[i] = 0;
+	}
+}
+
+int bhs_geodesic_batch_propagate(struct bhs_geodesic_batch *batch,
+				 const struct bhs_kerr *bh,
+				 const struct bhs_geodesic_config *config)
+{
+	int max_steps = config->max_steps > 0 ? config->max_steps
+					      : BHS_GEODESIC_MAX_STEPS;
+	double escape_r = config->escape_radius > 0
+				  ? config->escape_radius
+				  : BHS_GEODESIC_ESCAPE_RADIUS;
+	double r_horizon = bhs_kerr_horizon_outer(bh);
+	double r_promote = 0.0;
+
+	/* Todo raio começa em float; batch_check_stop() devolve os de perto */
+	if (config->mixed_precision) {
+		struct bhs_kerr_radii radii;
+		bhs_kerr_spin_radii(bh, &radii);
+		r_promote = BHS_GEO_BATCH_F32_PROMOTE * radii.photon_retro;
+		for (int i = 0; i < batch->active; i++)
+			batch->fp32[i] = 1;
+	}
+
+	for (int step = 0; step < max_steps; step++) {
+		if (batch_check_stop(batch, r_horizon, r_promote, escape_r,
+				     config) == 0)
+			break;
+
+		/*
+		 * Compactar a cada passo custa mais que os lanes mascarados
+		 * economizam; a cada poucos passos os blocos voltam a ficar
+		 * cheios.
+		 */
+		if (step % BHS_GEO_BATCH_COMPACT_INTERVAL == 0) {
+			bhs_geodesic_batch_compact(batch);
+			if (config->mixed_precision)
+				batch_check_norm(batch, bh);
+		}
+
+		batch_step(batch, bh, config->dlambda, config);
+	}
+
+	int timeouts = 0;
+	for (int i = 0; i < batch->active; i++) {
+		if (batch->status[i] == BHS_GEO_PROPAGATING) {
+			batch->status[i] = BHS_GEO_TIMEOUT;
+			timeouts++;
+		}
+	}
+	bhs_geodesic_batch_compact(batch);
+
+	return timeouts;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file geodesic_batch.h
+ * @brief Integração de geodésicas em lote (structure-of-arrays)
+ *
+ * "Um fóton por vez é física. Oito milhões por quadro é engenharia."
+ *
+ * A API de geodesic.h trabalha com um struct bhs_geodesic por vez, com
+ * bhs_vec4 por valor. Ótimo para depurar, péssimo para o compilador:
+ * nada vetoriza. Aqui cada componente do estado vive no seu próprio
+ * array contíguo e o RK4 roda em blocos de BHS_GEO_BATCH_LANES raios,
+ * com o mesmo código servindo AVX2, AVX-512 e o fallback escalar.
+ *
+ * Raios que terminam (escaparam, capturados, disco) ficam mascarados no
+ * bloco até a próxima compactação, que os move para depois de @active.
+ * A ordem muda; @id guarda o índice original de cada raio.
+ *
+ * Com config->mixed_precision o RK4 roda em float enquanto o raio está
+ * longe do buraco. O ganho vem do dobro de raios por registrador, então
+ * só existe se o laço de aceleração do kernel vetorizar (o teste
+ * BatchVectorizeTest confere). Perto da esfera de fótons ou com a norma
+ * nula derivando o raio é promovido a double no meio do voo e não volta
+ * mais.
+ */
+
+#ifndef BHS_ENGINE_GEODESIC_GEODESIC_BATCH_H
+#define BHS_ENGINE_GEODESIC_GEODESIC_BATCH_H
+
+#include "engine/physics/geodesic/geodesic.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Raios por bloco (8 doubles = um registrador AVX-512, dois AVX2) */
+#define BHS_GEO_BATCH_LANES 8
+
+/** Raios por bloco no kernel float (mesma largura de registrador) */
+#define BHS_GEO_BATCH_LANES_F32 (2 * BHS_GEO_BATCH_LANES)
+
+/** Promove a double abaixo deste múltiplo da órbita de fótons retrógrada */
+#define BHS_GEO_BATCH_F32_PROMOTE 1.5
+
+/** Promove a double quando |g(u, u)| / (u^t)² passa disto */
+#define BHS_GEO_BATCH_F32_NULL_TOL 1e-5
+
+/** Passos entre compactações durante a propagação */
+#define BHS_GEO_BATCH_COMPACT_INTERVAL 16
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_geodesic_batch - Lote de geodésicas em SoA
+ * @count: raios carregados
+ * @active: raios ainda propagando após a última compactação: [0, active)
+ * @capacity: capacidade (arrays alocados com folga até múltiplo de lanes)
+ * @t, @r, @theta, @phi: posição (t, r, θ, φ) de cada raio
+ * @vt, @vr, @vtheta, @vphi: 4-velocidade dx^μ/dλ de cada raio
+ * @affine: parâmetro afim acumulado
+ * @steps: passos dados
+ * @status: estado de cada raio
+ * @id: índice do raio na ordem de bhs_geodesic_batch_push()
+ * @fp32: 1 enquanto o raio integra em float (depois da compactação os
+ *        raios float vêm antes dos double)
+ * @hit: ponto de impacto no disco fino (dado frio, AoS; só vale com
+ *       status == BHS_GEO_HIT_DISK)
+ *
+ * Todos os arrays são alinhados em 64 bytes.
+ */
+struct bhs_geodesic_batch {
+	int count;
+	int active;
+	int capacity;
+
+	double *t, *r, *theta, *phi;
+	double *vt, *vr, *vtheta, *vphi;
+	double *affine;
+	int *steps;
+	enum bhs_geodesic_status *status;
+	int *id;
+	unsigned char *fp32;
+	struct bhs_geodesic_hit *hit;
+};
+
+/* ============================================================================
+ * CICLO DE VIDA
+ * ============================================================================
+ */
+
+/**
+ * bhs_geodesic_batch_init - Aloca um lote vazio
+ * @batch: [out] lote
+ * @capacity: número máximo de raios
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 se a alocação falhar (o lote fica zerado)
+ */
+int bhs_geodesic_batch_init(struct bhs_geodesic_batch *batch, int capacity);
+
+/**
+ * bhs_geodesic_batch_free - Libera os arrays do lote
+ */
+void bhs_geodesic_batch_free(struct bhs_geodesic_batch *batch);
+
+/**
+ * bhs_geodesic_batch_clear - Esvazia o lote mantendo a memória
+ */
+void bhs_geodesic_batch_clear(struct bhs_geodesic_batch *batch);
+
+/**
+ * bhs_geodesic_batch_push - Adiciona uma geodésica ao lote
+ * @batch: lote
+ * @geo: geodésica já inicializada (ex.: bhs_geodesic_ray_from_camera)
+ *
+ * Só geodésicas nulas: o lote não carrega o tipo.
+ *
+ * Retorna: id do raio, ou -1 se o lote estiver cheio
+ */
+int bhs_geodesic_batch_push(struct bhs_geodesic_batch *batch,
+			    const struct bhs_geodesic *geo);
+
+/**
+ * bhs_geodesic_batch_scatter - Devolve o lote para AoS
+ * @batch: lote
+ * @out: [out] array com pelo menos batch->count entradas
+ *
+ * out[id] recebe o estado do raio id, independente das compactações.
+ */
+void bhs_geodesic_batch_scatter(const struct bhs_geodesic_batch *batch,
+				struct bhs_geodesic *out);
+
+/* ============================================================================
+ * INTEGRAÇÃO
+ * ============================================================================
+ */
+
+/**
+ * bhs_geodesic_batch_step_rk4 - Um passo RK4 em todos os raios ativos
+ * @batch: lote
+ * @bh: parâmetros do buraco negro
+ * @dlambda: passo no parâmetro afim
+ *
+ * Equivale a bhs_geodesic_step_rk4() raio a raio, com Γ de Kerr em forma
+ * fechada contraído direto com a velocidade. Raios em [0, active) que
+ * já terminaram não são alterados. Cada raio usa a precisão de @fp32.
+ */
+void bhs_geodesic_batch_step_rk4(struct bhs_geodesic_batch *batch,
+				 const struct bhs_kerr *bh, double dlambda);
+
+/**
+ * bhs_geodesic_batch_compact - Move os raios terminados para o fim
+ * @batch: lote
+ *
+ * Dentro de [0, active) os raios float ficam antes dos double.
+ *
+ * Retorna: novo batch->active
+ */
+int bhs_geodesic_batch_compact(struct bhs_geodesic_batch *batch);
+
+/**
+ * bhs_geodesic_batch_propagate - Propaga o lote até todos pararem
+ * @batch: lote
+ * @bh: parâmetros do buraco negro
+ * @config: mesma configuração de bhs_geodesic_propagate()
+ *
+ * Critérios de parada idênticos ao caminho escalar, incluindo o disco
+ * fino (disk_half_thickness = 0) por troca de sinal de θ - π/2 com
+ * Hermite dentro do passo. Só a formulação Christoffel com passo fixo é
+ * vetorizada: config->mode, config->tolerance e os atalhos analíticos
+ * (shadow_capture, far_field_radius) são ignorados.
+ *
+ * Com config->mixed_precision todo raio ativo começa em float e é
+ * promovido a double ao descer abaixo de BHS_GEO_BATCH_F32_PROMOTE vezes
+ * a órbita de fótons retrógrada (o que cobre o horizonte) ou quando
+ * bhs_geodesic_norm2() sai de BHS_GEO_BATCH_F32_NULL_TOL, checado a cada
+ * compactação. Longe do buraco o erro fica em ~1e-5 relativo.
+ *
+ * Retorna: número de raios que estouraram max_steps (BHS_GEO_TIMEOUT)
+ */
+int bhs_geodesic_batch_propagate(struct bhs_geodesic_batch *batch,
+				 const struct bhs_kerr *bh,
+				 const struct bhs_geodesic_config *config);
+
+#endif /* BHS_ENGINE_GEODESIC_GEODESIC_BATCH_H */
@@ -0,0 +1,247 @@
+/**
+ * @file geodesic_batch_kernel.h
+ * @brief Passo RK4 de um bloco de raios, genérico na precisão
+ *
+ * "Mesmo código, metade dos bits, o dobro de raios. O truque é saber
+ * quando devolver os bits."
+ *
+ * Não é um header comum: geodesic_batch.c inclui este arquivo uma vez por
+ * precisão, depois de definir
+ *   KERNEL_REAL    tipo dos lanes (double, float)
+ *   KERNEL_LANES   raios por bloco (mesma largura de registrador)
+ *   KERNEL_FP32    valor de batch->fp32 dos raios deste kernel
+ *   KERNEL_FN(x)   nome com sufixo (x ## _f64, x ## _f32)
+ *   KERNEL_SIN, KERNEL_COS, KERNEL_FABS, KERNEL_COPYSIGN
+ * e de ter Y_*, lane_commit() e o struct bhs_geodesic_batch visíveis. Os
+ * parâmetros são desfeitos no fim. Constantes passam por KC() para o
+ * kernel float não promover nada a double no meio do laço.
+ */
+
+#define KC(x) ((KERNEL_REAL)(x))
+
+/*
+ * 1 se |x| >= eps, 0 se não, sem comparação: o gcc não vetoriza a máscara
+ * de uma comparação em double no SSE2, nem um ?: sobre ela com
+ * -ftrapping-math. copysign é só bits, vetoriza em qualquer largura.
+ */
+#define KERNEL_STEP(x, eps)                                               \
+	(KERNEL_COPYSIGN(KC(0.5), KERNEL_FABS(x) - KC(eps)) + KC(0.5))
+
+typedef KERNEL_REAL KERNEL_FN(lane_t)[KERNEL_LANES];
+
+struct KERNEL_FN(block) {
+	KERNEL_FN(lane_t) y[Y_N];
+};
+
+/*
+ * a^α = -Γ^α_μν u^μ u^ν com as mesmas 20 componentes de
+ * bhs_kerr_christoffel(), mas contraídas na hora: nada de tensor
+ * 4x4x4 por raio. Onde Σ, Δ ou det degeneram a aceleração é zero, igual
+ * ao caminho escalar; os denominadores são trocados por 1 antes da
+ * divisão. A troca é aritmética (ok em 0/1, KERNEL_STEP), não ?:, para o
+ * laço vetorizar já no -O2 sem -march.
+ */
+static void KERNEL_FN(lane_deriv)(KERNEL_REAL M, KERNEL_REAL a,
+				  const struct KERNEL_FN(block) *restrict in,
+				  struct KERNEL_FN(block) *restrict out)
+{
+	const KERNEL_FN(lane_t) *y = in->y;
+	KERNEL_FN(lane_t) *dy = out->y;
+	KERNEL_FN(lane_t) s, c;
+
+	for (int i = 0; i < KERNEL_LANES; i++) {
+		s[i] = KERNEL_SIN(y[Y_TH][i]);
+		c[i] = KERNEL_COS(y[Y_TH][i]);
+	}
+
+	KERNEL_REAL a2 = a * a;
+
+	/* BHS_VEC_CHECK: tests/CMakeLists.txt exige que este laço vetorize */
+	for (int i = 0; i < KERNEL_LANES; i++) {
+		KERNEL_REAL r = y[Y_R][i];
+		KERNEL_REAL ut = y[Y_VT][i];
+		KERNEL_REAL ur = y[Y_VR][i];
+		KERNEL_REAL uh = y[Y_VTH][i];
+		KERNEL_REAL up = y[Y_VPH][i];
+
+		KERNEL_REAL s2 = s[i] * s[i];
+		KERNEL_REAL sc = s[i] * c[i];
+		KERNEL_REAL r2 = r * r;
+		KERNEL_REAL rho2 = r2 + a2;
+
+		KERNEL_REAL Sigma = r2 + a2 * c[i] * c[i];
+		KERNEL_REAL Delta = r2 - KC(2) * M * r + a2;
+		KERNEL_REAL det_block = -Delta * s2;
+
+		KERNEL_REAL ok = KERNEL_STEP(Sigma, 1e-15) *
+				 KERNEL_STEP(Delta, 1e-15) *
+				 KERNEL_STEP(det_block, 1e-15);
+		Sigma = Sigma * ok + (KC(1) - ok);
+		Delta = Delta * ok + (KC(1) - ok);
+		det_block = det_block * ok + (KC(1) - ok);
+
+		KERNEL_REAL inv_S = KC(1) / Sigma;
+		KERNEL_REAL inv_S2 = inv_S * inv_S;
+		KERNEL_REAL inv_D = KC(1) / Delta;
+		KERNEL_REAL S_2r2 = Sigma - KC(2) * r2;
+
+		KERNEL_REAL g_tt = -(KC(1) - KC(2) * M * r * inv_S);
+		KERNEL_REAL g_tp = -KC(2) * M * a * r * s2 * inv_S;
+		KERNEL_REAL g_pp =
+			s2 * (rho2 + KC(2) * M * r * a2 * s2 * inv_S);
+
+		KERNEL_REAL dr_tt = KC(2) * M * S_2r2 * inv_S2;
+		KERNEL_REAL dh_tt = KC(4) * M * r * a2 * sc * inv_S2;
+		KERNEL_REAL dr_tp = -KC(2) * M * a * s2 * S_2r2 * inv_S2;
+		KERNEL_REAL dh_tp = -KC(4) * M * a * r * sc * rho2 * inv_S2;
+		KERNEL_REAL dr_pp = KC(2) * r * s2 +
+				    KC(2) * M * a2 * s2 * s2 * S_2r2 * inv_S2;
+		KERNEL_REAL dh_pp =
+			KC(2) * sc * rho2 + KC(4) * M * r * a2 * sc * s2 *
+						    (KC(2) * Sigma + a2 * s2) *
+						    inv_S2;
+		KERNEL_REAL dr_rr =
+			(KC(2) * r * Delta - Sigma * (KC(2) * r - KC(2) * M)) *
+			inv_D * inv_D;
+		KERNEL_REAL dh_rr = -KC(2) * a2 * sc * inv_D;
+		KERNEL_REAL dr_hh = KC(2) * r;
+		KERNEL_REAL dh_hh = -KC(2) * a2 * sc;
+
+		KERNEL_REAL inv_det = KC(1) / det_block;
+		KERNEL_REAL gi_tt = g_pp * inv_det;
+		KERNEL_REAL gi_tp = -g_tp * inv_det;
+		KERNEL_REAL gi_pp = g_tt * inv_det;
+		KERNEL_REAL gi_rr = Delta * inv_S;
+		KERNEL_REAL gi_hh = inv_S;
+
+		/*
+		 * Γ^t e Γ^φ só misturam (r|θ) com (t|φ). Com ½ g^αβ ∂g e o
+		 * fator 2 da simetria, sobra g^αβ (∂g_βt u^t + ∂g_βφ u^φ).
+		 */
+		KERNEL_REAL wr_t = dr_tt * ut + dr_tp * up;
+		KERNEL_REAL wr_p = dr_tp * ut + dr_pp * up;
+		KERNEL_REAL wh_t = dh_tt * ut + dh_tp * up;
+		KERNEL_REAL wh_p = dh_tp * ut + dh_pp * up;
+
+		KERNEL_REAL at = -(ur * (gi_tt * wr_t + gi_tp * wr_p) +
+				   uh * (gi_tt * wh_t + gi_tp * wh_p));
+		KERNEL_REAL ap = -(ur * (gi_tp * wr_t + gi_pp * wr_p) +
+				   uh * (gi_tp * wh_t + gi_pp * wh_p));
+
+		/* Γ^r e Γ^θ: ½ g^αα (-∂_α g_μν u^μ u^ν + termos r-θ) */
+		KERNEL_REAL q_r = dr_tt * ut * ut + KC(2) * dr_tp * ut * up +
+				  dr_pp * up * up;
+		KERNEL_REAL q_h = dh_tt * ut * ut + KC(2) * dh_tp * ut * up +
+				  dh_pp * up * up;
+
+		KERNEL_REAL ar = -KC(0.5) * gi_rr *
+				 (-q_r + dr_rr * ur * ur +
+				  KC(2) * dh_rr * ur * uh - dr_hh * uh * uh);
+		KERNEL_REAL ah = -KC(0.5) * gi_hh *
+				 (-q_h - dh_rr * ur * ur +
+				  KC(2) * dr_hh * ur * uh + dh_hh * uh * uh);
+
+		dy[Y_T][i] = ut;
+		dy[Y_R][i] = ur;
+		dy[Y_TH][i] = uh;
+		dy[Y_PH][i] = up;
+		dy[Y_VT][i] = at * ok;
+		dy[Y_VR][i] = ar * ok;
+		dy[Y_VTH][i] = ah * ok;
+		dy[Y_VPH][i] = ap * ok;
+	}
+}
+
+static void KERNEL_FN(lane_axpy)(struct KERNEL_FN(block) *out,
+				 const struct KERNEL_FN(block) *y,
+				 KERNEL_REAL h,
+				 const struct KERNEL_FN(block) *k)
+{
+	for (int j = 0; j < Y_N; j++) {
+		for (int i = 0; i < KERNEL_LANES; i++)
+			out->y[j][i] = y->y[j][i] + h * k->y[j][i];
+	}
+}
+
+/* O lote guarda tudo em double: o kernel float arredonda na carga */
+static void KERNEL_FN(block_load)(const struct bhs_geodesic_batch *b,
+				  int base, struct KERNEL_FN(block) *y)
+{
+	const double *src[Y_N] = { b->t,  b->r,	 b->theta,  b->phi,
+				   b->vt, b->vr, b->vtheta, b->vphi };
+
+	for (int j = 0; j < Y_N; j++) {
+		for (int i = 0; i < KERNEL_LANES; i++)
+			y->y[j][i] = (KERNEL_REAL)src[j][base + i];
+	}
+}
+
+/**
+ * Passo RK4 dos raios deste kernel em [base, base + KERNEL_LANES)
+ *
+ * Só entram raios propagando com batch->fp32 == KERNEL_FP32; o resto do
+ * bloco é calculado e descartado. Cada lane aceito segue para
+ * lane_commit() em double.
+ */
+static void KERNEL_FN(block_step)(struct bhs_geodesic_batch *batch, int base,
+				  const struct bhs_kerr *bh, double dlambda,
+				  const struct bhs_geodesic_config *config)
+{
+	int mask[KERNEL_LANES];
+	int any = 0;
+
+	for (int i = 0; i < KERNEL_LANES; i++) {
+		int idx = base + i;
+		mask[i] = idx < batch->active &&
+			  batch->status[idx] == BHS_GEO_PROPAGATING &&
+			  batch->fp32[idx] == KERNEL_FP32;
+		any |= mask[i];
+	}
+	if (!any)
+		return;
+
+	KERNEL_REAL M = (KERNEL_REAL)bh->M;
+	KERNEL_REAL a = (KERNEL_REAL)bh->a;
+	KERNEL_REAL h = (KERNEL_REAL)dlambda;
+	struct KERNEL_FN(block) blk, tmp, k1, k2, k3, k4;
+	KERNEL_FN(lane_t) *y = blk.y;
+
+	KERNEL_FN(block_load)(batch, base, &blk);
+
+	KERNEL_FN(lane_deriv)(M, a, &blk, &k1);
+	KERNEL_FN(lane_axpy)(&tmp, &blk, KC(0.5) * h, &k1);
+	KERNEL_FN(lane_deriv)(M, a, &tmp, &k2);
+	KERNEL_FN(lane_axpy)(&tmp, &blk, KC(0.5) * h, &k2);
+	KERNEL_FN(lane_deriv)(M, a, &tmp, &k3);
+	KERNEL_FN(lane_axpy)(&tmp, &blk, h, &k3);
+	KERNEL_FN(lane_deriv)(M, a, &tmp, &k4);
+
+	for (int j = 0; j < Y_N; j++) {
+		for (int i = 0; i < KERNEL_LANES; i++) {
+			y[j][i] += h / KC(6) *
+				   (k1.y[j][i] + KC(2) * k2.y[j][i] +
+				    KC(2) * k3.y[j][i] + k4.y[j][i]);
+		}
+	}
+
+	for (int i = 0; i < KERNEL_LANES; i++) {
+		if (!mask[i])
+			continue;
+
+		double y1[Y_N];
+		for (int j = 0; j < Y_N; j++)
+			y1[j] = (double)y[j][i];
+		lane_commit(batch, base + i, y1, dlambda, bh, config);
+	}
+}
+
+#undef KC
+#undef KERNEL_STEP
+#undef KERNEL_REAL
+#undef KERNEL_LANES
+#undef KERNEL_FP32
+#undef KERNEL_FN
+#undef KERNEL_SIN
+#undef KERNEL_COS
+#undef KERNEL_FABS
+#undef KERNEL_COPYSIGN
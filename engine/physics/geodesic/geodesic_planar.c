@@ -0,0 +1,382 @@
+/**
+ * @file geodesic_planar.c
+ * @brief Fótons de Schwarzschild pela equação de Binet no plano orbital
+ *
+ * "Simetria esférica: o fóton escolhe um plano e nunca mais sai dele.
+ * Quatro dimensões viram uma, de graça."
+ *
+ * Estado em ψ (ângulo no plano orbital, a partir da posição inicial):
+ *   u = 1/r,  u' = du/dψ,  t,  λ
+ *   u''    = 3Mu² - u
+ *   dt/dψ  = 1 / [b u² (1 - 2Mu)]
+ *   dλ/dψ  = 1 / (L u²)
+ * com L = E b o momento angular total. A posição 3D é
+ *   x(ψ) = (cos ψ ê1 + sin ψ ê2) / u
+ */
+
+#define _GNU_SOURCE /* Para M_PI */
+
+#include "geodesic.h"
+#include "planar_lut.h"
+#include "math/spacetime/schwarzschild.h"
+#include <math.h>
+
+/* ============================================================================
+ * SISTEMA 1D
+ * ============================================================================
+ */
+
+struct planar_state {
+	double u;
+	double du;
+	double t;
+	double lambda;
+};
+
+/**
+ * struct planar_ctx - O que é fixo ao longo do raio
+ * @bh: Schwarzschild de massa M
+ * @E, @L: energia e momento angular total
+ * @b: L / E
+ * @e1, @e2: base do plano orbital (ê1 = r̂ inicial)
+ */
+struct planar_ctx {
+	struct bhs_schwarzschild bh;
+	double E;
+	double L;
+	double b;
+	struct bhs_vec3 e1;
+	struct bhs_vec3 e2;
+};
+
+static void planar_deriv(const struct planar_ctx *c,
+			 const struct planar_state *y, struct planar_state *dy)
+{
+	double u2 = y->u * y->u;
+
+	dy->u = y->du;
+	dy->du = bhs_schwarzschild_binet(&c->bh, y->u);
+	dy->t = 1.0 / (c->b * u2 * (1.0 - 2.0 * c->bh.M * y->u));
+	dy->lambda = 1.0 / (c->L * u2);
+}
+
+static void planar_axpy(struct planar_state *out, const struct planar_state *y,
+			double h, const struct planar_state *k)
+{
+	out->u = y->u + h * k->u;
+	out->du = y->du + h * k->du;
+	out->t = y->t + h * k->t;
+	out->lambda = y->lambda + h * k->lambda;
+}
+
+static void planar_rk4(const struct planar_ctx *c, struct planar_state *y,
+		       double h)
+{
+	struct planar_state k1, k2, k3, k4, tmp;
+
+	planar_deriv(c, y, &k1);
+	planar_axpy(&tmp, y, 0.5 * h, &k1);
+	planar_deriv(c, &tmp, &k2);
+	planar_axpy(&tmp, y, 0.5 * h, &k2);
+	planar_deriv(c, &tmp, &k3);
+	planar_axpy(&tmp, y, h, &k3);
+	planar_deriv(c, &tmp, &k4);
+
+	y->u += h / 6.0 * (k1.u + 2.0 * k2.u + 2.0 * k3.u + k4.u);
+	y->du += h / 6.0 * (k1.du + 2.0 * k2.du + 2.0 * k3.du + k4.du);
+	y->t += h / 6.0 * (k1.t + 2.0 * k2.t + 2.0 * k3.t + k4.t);
+	y->lambda += h / 6.0 * (k1.lambda + 2.0 * k2.lambda +
+				2.0 * k3.lambda + k4.lambda);
+}
+
+/**
+ * Passo parcial δ ∈ (0, h) a partir de @prev que leva u a @u_target
+ *
+ * Newton sobre o próprio RK4 (u'(δ) vem do estado): o ponto final fica
+ * na trajetória discreta, sem interpolação.
+ */
+static double planar_land(const struct planar_ctx *c,
+			  const struct planar_state *prev, double h,
+			  double u_target, struct planar_state *out)
+{
+	/* Chute: linear entre as pontas */
+	struct planar_state end = *prev;
+	planar_rk4(c, &end, h);
+	double d = h * (prev->u - u_target) / (prev->u - end.u);
+
+	for (int it = 0; it < 8; it++) {
+		*out = *prev;
+		planar_rk4(c, out, d);
+		if (!(out->du != 0.0))
+			break;
+		double step = (out->u - u_target) / out->du;
+		d = fmin(fmax(d - step, 0.0), h);
+		if (fabs(step) < 1e-14 * h)
+			break;
+	}
+
+	*out = *prev;
+	planar_rk4(c, out, d);
+	return d;
+}
+
+/* ============================================================================
+ * PLANO ORBITAL ↔ BOYER-LINDQUIST
+ * ============================================================================
+ */
+
+/**
+ * planar_to_geo - Escreve o estado em ψ de volta em @geo (BL)
+ *
+ * dr/dλ = -u' L, dn̂/dλ = L u² ê_ψ e θ, φ saem da direção n̂.
+ */
+static void planar_to_geo(const struct planar_ctx *c,
+			  const struct planar_state *y, double psi,
+			  struct bhs_geodesic *geo)
+{
+	double cp = cos(psi), sp = sin(psi);
+	struct bhs_vec3 n = bhs_vec3_add(bhs_vec3_scale(c->e1, cp),
+					 bhs_vec3_scale(c->e2, sp));
+	struct bhs_vec3 epsi = bhs_vec3_add(bhs_vec3_scale(c->e1, -sp),
+					    bhs_vec3_scale(c->e2, cp));
+	struct bhs_vec3 dn = bhs_vec3_scale(epsi, c->L * y->u * y->u);
+
+	double r = 1.0 / y->u;
+	double ct = fmin(fmax(n.z, -1.0), 1.0);
+	double theta = acos(ct);
+	double st = fmax(sin(theta), 1e-300);
+	double rc2 = fmax(n.x * n.x + n.y * n.y, 1e-300);
+
+	geo->pos = bhs_vec4_make(y->t, r, theta, atan2(n.y, n.x));
+	geo->vel = bhs_vec4_make(c->E / (1.0 - 2.0 * c->bh.M * y->u),
+				 -y->du * c->L, -dn.z / st,
+				 (n.x * dn.y - n.y * dn.x) / rc2);
+	geo->affine_param = y->lambda;
+}
+
+/**
+ * planar_init - Monta plano orbital, constantes e estado inicial
+ *
+ * Retorna: false se o raio não tem plano definido (radial) ou E ≤ 0
+ */
+static bool planar_init(struct planar_ctx *c, struct planar_state *y,
+			const struct bhs_geodesic *geo, double M)
+{
+	double r = geo->pos.x;
+	double st = sin(geo->pos.y), ct = cos(geo->pos.y);
+	double sp = sin(geo->pos.z), cp = cos(geo->pos.z);
+
+	struct bhs_vec3 n = bhs_vec3_make(st * cp, st * sp, ct);
+	struct bhs_vec3 eth = bhs_vec3_make(ct * cp, ct * sp, -st);
+	struct bhs_vec3 eph = bhs_vec3_make(-sp, cp, 0.0);
+
+	/* dn̂/dλ: só a parte angular da velocidade */
+	struct bhs_vec3 w = bhs_vec3_add(bhs_vec3_scale(eth, geo->vel.y),
+					 bhs_vec3_scale(eph, st * geo->vel.z));
+	double wn = bhs_vec3_norm(w);
+
+	c->bh.M = M;
+	c->E = (1.0 - 2.0 * M / r) * geo->vel.t;
+	c->L = r * r * wn;
+	if (!(c->E > 0.0) || !(c->L > 1e-12 * r * fabs(geo->vel.x)))
+		return false;
+
+	c->b = c->L / c->E;
+	c->e1 = n;
+	c->e2 = bhs_vec3_scale(w, 1.0 / wn);
+
+	y->u = 1.0 / r;
+	y->du = -geo->vel.x / (r * r * wn);
+	y->t = geo->pos.t;
+	y->lambda = geo->affine_param;
+	return true;
+}
+
+/* ============================================================================
+ * DISCO
+ * ============================================================================
+ */
+
+/**
+ * first_disk_crossing - Primeiro ψ > 0 em que a órbita corta z = 0
+ *
+ * z(ψ) ∝ cos ψ ê1.z + sin ψ ê2.z: zera em ψ = atan2(-ê1.z, ê2.z) + kπ.
+ * Órbita contida no próprio equador nunca "cruza" (como no modo BL).
+ *
+ * Retorna: ψ do cruzamento, INFINITY sem disco
+ */
+static double first_disk_crossing(const struct planar_ctx *c,
+				  const struct bhs_geodesic_config *config)
+{
+	if (!(config->disk_outer > 0.0) || (c->e1.z == 0.0 && c->e2.z == 0.0))
+		return INFINITY;
+
+	double psi = atan2(-c->e1.z, c->e2.z);
+	while (psi <= 0.0)
+		psi += M_PI;
+	return psi;
+}
+
+/* Fecha o raio no disco: estado em BL, θ = π/2 exato e geo->hit */
+static enum bhs_geodesic_status planar_hit(const struct planar_ctx *c,
+					   const struct planar_state *y,
+					   double psi, const struct bhs_kerr *bh,
+					   struct bhs_geodesic *geo)
+{
+	planar_to_geo(c, y, psi, geo);
+	geo->pos.y = M_PI_2;
+
+	struct bhs_metric g;
+	bhs_kerr_metric(bh, geo->pos.x, geo->pos.y, &g);
+	geo->hit.r = geo->pos.x;
+	geo->hit.phi = geo->pos.z;
+	geo->hit.lambda = geo->affine_param;
+	geo->hit.p = bhs_metric_lower(&g, geo->vel);
+
+	geo->status = BHS_GEO_HIT_DISK;
+	return BHS_GEO_HIT_DISK;
+}
+
+/* ============================================================================
+ * TABELA
+ * ============================================================================
+ */
+
+/**
+ * planar_from_lut - Fecha o raio consultando a tabela, sem integrar
+ * @y: estado inicial (só o sentido de u' e as quadraturas são usados)
+ *
+ * u' sai da própria equação de energia, (du/dψ)² = 1/b² - u² + 2Mu³,
+ * com o sinal do ramo: saindo é negativo, entrando é positivo até o
+ * periastro.
+ *
+ * Retorna: false se o b do raio não está na tabela (integra então)
+ */
+static bool planar_from_lut(const struct planar_ctx *c,
+			    const struct planar_state *y,
+			    const struct bhs_geodesic_config *config,
+			    const struct bhs_kerr *bh, struct bhs_geodesic *geo,
+			    enum bhs_geodesic_status *status)
+{
+	const struct bhs_planar_lut *lut = config->planar_lut;
+	struct bhs_planar_lut_orbit o;
+
+	if (!bhs_planar_lut_orbit(lut, c->b, y->du < 0.0, &o))
+		return false;
+
+	struct planar_state s = *y;
+	double M = c->bh.M, ib2 = 1.0 / (c->b * c->b);
+
+	for (double psi = first_disk_crossing(c, config); psi < o.sweep;
+	     psi += M_PI) {
+		double r = 1.0 / bhs_planar_lut_u(lut, &o, psi);
+		if (r < config->disk_inner || r > config->disk_outer)
+			continue;
+
+		s.u = 1.0 / r;
+		s.du = sqrt(fmax(ib2 - s.u * s.u + 2.0 * M * s.u * s.u * s.u,
+				 0.0));
+		if (o.outgoing || psi > o.psi_peri)
+			s.du = -s.du;
+		*status = planar_hit(c, &s, psi, bh, geo);
+		return true;
+	}
+
+	s.u = o.u_end;
+	s.du = sqrt(fmax(ib2 - s.u * s.u + 2.0 * M * s.u * s.u * s.u, 0.0));
+	if (!o.captured)
+		s.du = -s.du;
+	planar_to_geo(c, &s, o.sweep, geo);
+
+	*status = o.captured ? BHS_GEO_CAPTURED : BHS_GEO_ESCAPED;
+	geo->status = *status;
+	return true;
+}
+
+/* ============================================================================
+ * PROPAGAÇÃO
+ * ============================================================================
+ */
+
+enum bhs_geodesic_status
+bhs_geodesic_propagate_planar(struct bhs_geodesic *geo,
+			      const struct bhs_kerr *bh,
+			      const struct bhs_geodesic_config *config)
+{
+	struct planar_ctx c;
+	struct planar_state y;
+
+	if (bh->a != 0.0 || geo->type != BHS_GEODESIC_NULL ||
+	    config->disk_half_thickness > 0.0 ||
+	    !planar_init(&c, &y, geo, bh->M)) {
+		struct bhs_geodesic_config generic = *config;
+		generic.mode = BHS_GEO_MODE_CHRISTOFFEL;
+		return bhs_geodesic_propagate(geo, bh, &generic);
+	}
+
+	int max_steps = config->max_steps > 0 ? config->max_steps
+					      : BHS_GEODESIC_MAX_STEPS;
+	double escape_r = config->escape_radius > 0
+				  ? config->escape_radius
+				  : BHS_GEODESIC_ESCAPE_RADIUS;
+
+	enum bhs_geodesic_status lut_status;
+	if (config->planar_lut &&
+	    bhs_planar_lut_matches(config->planar_lut, bh->M, geo->pos.x,
+				   escape_r) &&
+	    planar_from_lut(&c, &y, config, bh, geo, &lut_status))
+		return lut_status;
+
+	double dpsi = config->tolerance > 0.0
+			      ? fmin(fmax(pow(config->tolerance, 0.25), 1e-3),
+				     0.05)
+			      : BHS_GEODESIC_PLANAR_DPSI;
+
+	/* Mesma margem de captura do modo Christoffel */
+	double u_capture = 1.0 / (1.01 * 2.0 * bh->M);
+	double u_escape = 1.0 / escape_r;
+
+	double psi_disk = first_disk_crossing(&c, config);
+	double psi = 0.0;
+	enum bhs_geodesic_status st = BHS_GEO_TIMEOUT;
+
+	for (int i = 0; i < max_steps; i++) {
+		if (!isfinite(y.u) || y.u > u_capture) {
+			st = BHS_GEO_CAPTURED;
+			break;
+		}
+		if (y.u < u_escape) {
+			st = BHS_GEO_ESCAPED;
+			break;
+		}
+
+		double h = dpsi;
+		bool crossing = psi + h >= psi_disk;
+		if (crossing)
+			h = psi_disk - psi;
+
+		struct planar_state prev = y;
+		planar_rk4(&c, &y, h);
+		geo->step_count++;
+
+		/* Saiu dentro do passo: termina exatamente em r = escape_r */
+		if (y.u < u_escape && y.du < 0.0) {
+			psi += planar_land(&c, &prev, h, u_escape, &y);
+			st = BHS_GEO_ESCAPED;
+			break;
+		}
+		psi += h;
+
+		if (crossing) {
+			psi_disk += M_PI;
+			double r = 1.0 / y.u;
+			if (y.u <= u_capture && r >= config->disk_inner &&
+			    r <= config->disk_outer)
+				return planar_hit(&c, &y, psi, bh, geo);
+		}
+	}
+
+	planar_to_geo(&c, &y, psi, geo);
+	geo->status = st;
+	return st;
+}
@@ -0,0 +1,446 @@
+/**
+ * @file metric_table.c
+ * @brief Interpolação, cache e persistência da métrica tabelada
+ *
+ * "Dezesseis números por componente, dez componentes por célula.
+ * Calcular uma vez e lembrar é o que separa um lookup de um gargalo."
+ */
+
+#include "metric_table.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Nós começam alinhados em linha de cache */
+#define DATA_ALIGN 64
+
+#define NC BHS_METRIC_TABLE_COMPS
+
+/* Componente k da tabela é g[COMP_MU[k]][COMP_NU[k]] */
+static const unsigned char COMP_MU[NC] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 3 };
+static const unsigned char COMP_NU[NC] = { 0, 1, 2, 3, 1, 2, 3, 2, 3, 3 };
+
+/*
+ * B-spline cúbica uniforme na forma de potências: com os coeficientes
+ * -1, 0, 1, 2 da célula, p(t) = Σ_p t^p Σ_k BS[p][k] c_k, t ∈ [0, 1]
+ */
+static const double BS[4][4] = {
+	{ 1.0 / 6.0, 4.0 / 6.0, 1.0 / 6.0, 0.0 },
+	{ -0.5, 0.0, 0.5, 0.0 },
+	{ 0.5, -1.0, 0.5, 0.0 },
+	{ -1.0 / 6.0, 0.5, -0.5, 1.0 / 6.0 },
+};
+
+/* 0 fica livre para "cache vazio" */
+static atomic_uint_fast64_t next_serial = 1;
+
+/**
+ * struct cell_cache - Última célula avaliada por esta thread
+ * @serial: tabela dona dos coeficientes (0 = nenhuma)
+ * @i, @j: célula em r e θ
+ * @c: c[k][p][q], polinômio de g_k em t^p s^q
+ */
+struct cell_cache {
+	uint64_t serial;
+	int i;
+	int j;
+	double c[NC][4][4];
+};
+
+static _Thread_local struct cell_cache cache;
+
+/* ============================================================================
+ * GEOMETRIA DA GRADE
+ * ============================================================================
+ */
+
+/* Coeficientes por linha: um a mais em cada ponta */
+static size_t line_r(const struct bhs_metric_table_key *key)
+{
+	return (size_t)key->nr + 2;
+}
+
+static size_t data_count(const struct bhs_metric_table_key *key)
+{
+	return line_r(key) * ((size_t)key->ntheta + 2) * NC;
+}
+
+static uint64_t data_offset(void)
+{
+	uint64_t h = sizeof(struct bhs_metric_table_header);
+	return (h + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+}
+
+static bool key_valid(const struct bhs_metric_table_key *key)
+{
+	return key->nr >= 4 && key->ntheta >= 4 && key->r_max > key->r_min &&
+	       key->theta_max > key->theta_min && key->r_horizon >= 0.0;
+}
+
+static double step_r(const struct bhs_metric_table_key *key)
+{
+	return (key->r_max - key->r_min) / (key->nr - 1);
+}
+
+static double step_theta(const struct bhs_metric_table_key *key)
+{
+	return (key->theta_max - key->theta_min) / (key->ntheta - 1);
+}
+
+/* Coeficiente (i - 1, j - 1) da grade: i, j ≥ 0 */
+static const double *coef(const struct bhs_metric_table *table, int i, int j)
+{
+	return table->data + ((size_t)j * line_r(&table->key) + i) * NC;
+}
+
+/* Descritor e identidade novos: o cache de qualquer thread fica velho */
+static void table_finish(struct bhs_metric_table *table, unsigned zero)
+{
+	table->desc = (struct bhs_metric_desc){
+		.fn = bhs_metric_table_metric,
+		.dual_fn = bhs_metric_table_metric_dual,
+		.killing = BHS_METRIC_COORD(0) | BHS_METRIC_COORD(3),
+		.zero = zero,
+	};
+	table->serial = atomic_fetch_add(&next_serial, 1);
+
+	table->nactive = 0;
+	for (int k = 0; k < NC; k++) {
+		if (!(zero & BHS_METRIC_COMP(COMP_MU[k], COMP_NU[k])))
+			table->active[table->nactive++] = (unsigned char)k;
+	}
+}
+
+/* ============================================================================
+ * GERAÇÃO
+ * ============================================================================
+ */
+
+/**
+ * Coeficientes da B-spline que interpola f[0..n-1]
+ * @c: c_{-1}, c_0, ..., c_n com passo @cs
+ * @work: n doubles
+ *
+ * (c_{i-1} + 4c_i + c_{i+1})/6 = f_i nos nós. Nas pontas, S'' igual à
+ * segunda diferença de 2ª ordem dos quatro nós da borda: isso fixa c_0 e
+ * c_{n-1} direto e o miolo é um tridiagonal (Thomas).
+ */
+static void prefilter(const double *f, int n, double *c, ptrdiff_t cs,
+		      double *work)
+{
+	double d0 = 2.0 * f[0] - 5.0 * f[1] + 4.0 * f[2] - f[3];
+	double dn = 2.0 * f[n - 1] - 5.0 * f[n - 2] + 4.0 * f[n - 3] -
+		    f[n - 4];
+	double first = f[0] - d0 / 6.0;
+	double last = f[n - 1] - dn / 6.0;
+	int m = n - 2;
+
+	/* c_1..c_{n-2}, eliminação para frente com o rhs em c */
+	for (int i = 0; i < m; i++) {
+		double rhs = 6.0 * f[i + 1];
+		if (i == 0)
+			rhs -= first;
+		if (i == m - 1)
+			rhs -= last;
+
+		double den = i == 0 ? 4.0 : 4.0 - work[i - 1];
+		work[i] = 1.0 / den;
+		c[(i + 2) * cs] =
+			(rhs - (i == 0 ? 0.0 : c[(i + 1) * cs])) / den;
+	}
+	for (int i = m - 2; i >= 0; i--)
+		c[(i + 2) * cs] -= work[i] * c[(i + 3) * cs];
+
+	c[cs] = first;
+	c[n * cs] = last;
+	c[0] = 6.0 * f[0] - 4.0 * first - c[2 * cs];
+	c[(n + 1) * cs] = 6.0 * f[n - 1] - 4.0 * last - c[(n - 1) * cs];
+}
+
+int bhs_metric_table_from_samples(struct bhs_metric_table *table,
+				  const struct bhs_metric_table_key *key,
+				  const double *samples)
+{
+	memset(table, 0, sizeof(*table));
+	if (!key_valid(key))
+		return -1;
+
+	int nr = key->nr, nth = key->ntheta;
+	size_t lr = line_r(key);
+	int nmax = nr > nth ? nr : nth;
+	double *work = malloc(2 * (size_t)nmax * sizeof(double));
+	table->owned = malloc(data_count(key) * sizeof(double));
+	if (!work || !table->owned) {
+		free(work);
+		free(table->owned);
+		table->owned = NULL;
+		return -1;
+	}
+	double *line = work + nmax;
+	unsigned nonzero = 0;
+
+	/* Produto tensorial: primeiro ao longo de r, depois de θ */
+	for (int j = 0; j < nth; j++) {
+		for (int k = 0; k < NC; k++) {
+			for (int i = 0; i < nr; i++) {
+				line[i] = samples[((size_t)j * nr + i) * NC +
+						  k];
+				if (line[i] != 0.0)
+					nonzero |= BHS_METRIC_COMP(COMP_MU[k],
+								   COMP_NU[k]);
+			}
+			prefilter(line, nr, table->owned +
+						    (j + 1) * lr * NC + k,
+				  NC, work);
+		}
+	}
+	for (size_t i = 0; i < lr; i++) {
+		for (int k = 0; k < NC; k++) {
+			double *col = table->owned + i * NC + k;
+			ptrdiff_t cs = (ptrdiff_t)(lr * NC);
+
+			for (int j = 0; j < nth; j++)
+				line[j] = col[(j + 1) * cs];
+			prefilter(line, nth, col, cs, work);
+		}
+	}
+	free(work);
+
+	table->key = *key;
+	table->data = table->owned;
+	table_finish(table, ~nonzero & 0xffffu);
+	return 0;
+}
+
+int bhs_metric_table_build(struct bhs_metric_table *table,
+			   const struct bhs_metric_table_key *key,
+			   bhs_metric_func fn, void *userdata)
+{
+	memset(table, 0, sizeof(*table));
+	if (!key_valid(key))
+		return -1;
+
+	double *samples = malloc((size_t)key->nr * (size_t)key->ntheta * NC *
+				 sizeof(double));
+	if (!samples)
+		return -1;
+
+	double dr = step_r(key), dth = step_theta(key);
+	for (int j = 0; j < key->ntheta; j++) {
+		for (int i = 0; i < key->nr; i++) {
+			struct bhs_metric g;
+			double *out = samples + ((size_t)j * key->nr + i) * NC;
+
+			fn(bhs_vec4_make(0.0, key->r_min + i * dr,
+					 key->theta_min + j * dth, 0.0),
+			   userdata, &g);
+			for (int k = 0; k < NC; k++)
+				out[k] = g.g[COMP_MU[k]][COMP_NU[k]];
+		}
+	}
+
+	int ret = bhs_metric_table_from_samples(table, key, samples);
+	free(samples);
+	return ret;
+}
+
+/* ============================================================================
+ * INTERPOLAÇÃO
+ * ============================================================================
+ */
+
+/* Monta os polinômios da célula (i, j) no cache desta thread */
+static void cell_load(const struct bhs_metric_table *table, int i, int j)
+{
+	/* Coeficientes i-1..i+2, j-1..j+2: armazenados a partir de (i, j) */
+	for (int n = 0; n < table->nactive; n++) {
+		int k = table->active[n];
+		double tmp[4][4];
+		for (int p = 0; p < 4; p++) {
+			for (int b = 0; b < 4; b++) {
+				const double *row = coef(table, i, j + b) + k;
+				tmp[p][b] = BS[p][0] * row[0] +
+					    BS[p][1] * row[NC] +
+					    BS[p][2] * row[2 * NC] +
+					    BS[p][3] * row[3 * NC];
+			}
+		}
+		for (int p = 0; p < 4; p++)
+			for (int q = 0; q < 4; q++)
+				cache.c[k][p][q] = tmp[p][0] * BS[q][0] +
+						   tmp[p][1] * BS[q][1] +
+						   tmp[p][2] * BS[q][2] +
+						   tmp[p][3] * BS[q][3];
+	}
+
+	cache.serial = table->serial;
+	cache.i = i;
+	cache.j = j;
+}
+
+/* Posição na grade: célula e fração, presa à borda */
+static int locate(double x, double x0, double dx, int n, double *frac)
+{
+	double u = (x - x0) / dx;
+	u = fmin(fmax(u, 0.0), (double)(n - 1));
+
+	int i = (int)u;
+	if (i > n - 2)
+		i = n - 2;
+	*frac = u - i;
+	return i;
+}
+
+void bhs_metric_table_eval(const struct bhs_metric_table *table, double r,
+			   double theta, struct bhs_metric *g,
+			   struct bhs_metric *dg_dr,
+			   struct bhs_metric *dg_dtheta)
+{
+	const struct bhs_metric_table_key *key = &table->key;
+	double dr = step_r(key), dth = step_theta(key);
+	double t, s;
+	int i = locate(r, key->r_min, dr, key->nr, &t);
+	int j = locate(theta, key->theta_min, dth, key->ntheta, &s);
+
+	if (cache.serial != table->serial || cache.i != i || cache.j != j)
+		cell_load(table, i, j);
+
+	*g = bhs_metric_zero();
+	g->structure = bhs_metric_structure_of(table->desc.zero);
+	if (dg_dr)
+		*dg_dr = *g;
+	if (dg_dtheta)
+		*dg_dtheta = *g;
+
+	for (int n = 0; n < table->nactive; n++) {
+		int k = table->active[n];
+		double(*c)[4] = cache.c[k];
+		double row[4], drow[4];
+
+		/* Horner em s por potência de t */
+		for (int p = 0; p < 4; p++) {
+			row[p] = ((c[p][3] * s + c[p][2]) * s + c[p][1]) * s +
+				 c[p][0];
+			drow[p] = (3.0 * c[p][3] * s + 2.0 * c[p][2]) * s +
+				  c[p][1];
+		}
+
+		double v = ((row[3] * t + row[2]) * t + row[1]) * t + row[0];
+		double vt = (3.0 * row[3] * t + 2.0 * row[2]) * t + row[1];
+		double vs = ((drow[3] * t + drow[2]) * t + drow[1]) * t +
+			    drow[0];
+		int mu = COMP_MU[k], nu = COMP_NU[k];
+
+		g->g[mu][nu] = g->g[nu][mu] = v;
+		if (dg_dr)
+			dg_dr->g[mu][nu] = dg_dr->g[nu][mu] = vt / dr;
+		if (dg_dtheta)
+			dg_dtheta->g[mu][nu] = dg_dtheta->g[nu][mu] = vs / dth;
+	}
+}
+
+void bhs_metric_table_metric(struct bhs_vec4 coords, void *userdata,
+			     struct bhs_metric *out)
+{
+	bhs_metric_table_eval(userdata, coords.x, coords.y, out, NULL, NULL);
+}
+
+void bhs_metric_table_metric_dual(const struct bhs_dual coords[4],
+				  void *userdata, struct bhs_dual out[4][4])
+{
+	struct bhs_metric g, gr, gth;
+	bhs_metric_table_eval(userdata, coords[1].v, coords[2].v, &g, &gr,
+			      &gth);
+
+	for (int mu = 0; mu < 4; mu++) {
+		for (int nu = 0; nu < 4; nu++) {
+			out[mu][nu].v = g.g[mu][nu];
+			for (int s = 0; s < 4; s++)
+				out[mu][nu].d[s] =
+					gr.g[mu][nu] * coords[1].d[s] +
+					gth.g[mu][nu] * coords[2].d[s];
+		}
+	}
+}
+
+void bhs_metric_table_use(const struct bhs_metric_table *table,
+			  struct bhs_geodesic_config *config)
+{
+	config->mode = BHS_GEO_MODE_METRIC;
+	config->metric = &table->desc;
+	config->metric_userdata = (void *)table;
+	config->metric_horizon = table->key.r_horizon;
+}
+
+/* ============================================================================
+ * PERSISTÊNCIA
+ * ============================================================================
+ */
+
+int bhs_metric_table_open(struct bhs_metric_table *table, const char *path)
+{
+	memset(table, 0, sizeof(*table));
+	if (bhs_mapped_file_open(&table->file, path) != 0)
+		return -1;
+
+	const struct bhs_metric_table_header *hdr = table->file.data;
+	if (table->file.size < sizeof(*hdr) ||
+	    memcmp(hdr->magic, BHS_METRIC_TABLE_MAGIC,
+		   sizeof(BHS_METRIC_TABLE_MAGIC)) != 0 ||
+	    hdr->version != BHS_METRIC_TABLE_VERSION ||
+	    hdr->data_offset != data_offset() || !key_valid(&hdr->key))
+		goto fail;
+
+	size_t need = (size_t)hdr->data_offset +
+		      data_count(&hdr->key) * sizeof(double);
+	if (table->file.size < need)
+		goto fail;
+
+	table->key = hdr->key;
+	table->data = (const double *)((const char *)table->file.data +
+				       hdr->data_offset);
+	table_finish(table, hdr->zero);
+	return 0;
+
+fail:
+	bhs_metric_table_free(table);
+	return -1;
+}
+
+int bhs_metric_table_save(const struct bhs_metric_table *table,
+			  const char *path)
+{
+	struct bhs_atomic_file af;
+	if (bhs_atomic_file_create(&af, path) != 0)
+		return -1;
+	FILE *f = af.f;
+
+	struct bhs_metric_table_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, BHS_METRIC_TABLE_MAGIC,
+	       sizeof(BHS_METRIC_TABLE_MAGIC));
+	hdr.version = BHS_METRIC_TABLE_VERSION;
+	hdr.zero = table->desc.zero;
+	hdr.data_offset = data_offset();
+	hdr.key = table->key;
+
+	static const char zeros[DATA_ALIGN];
+	size_t pad = (size_t)hdr.data_offset - sizeof(hdr);
+	size_t count = data_count(&table->key);
+
+	int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+		 fwrite(zeros, 1, pad, f) == pad &&
+		 fwrite(table->data, sizeof(double), count, f) == count;
+	return bhs_atomic_file_commit(&af, ok);
+}
+
+void bhs_metric_table_free(struct bhs_metric_table *table)
+{
+	free(table->owned);
+	bhs_mapped_file_close(&table->file);
+	memset(table, 0, sizeof(*table));
+}
@@ -0,0 +1,221 @@
+/**
+ * @file metric_table.h
+ * @brief Métrica tabelada numa grade (r, θ), mapeada do disco
+ *
+ * "Quando a métrica não cabe numa fórmula, ela cabe num arquivo.
+ * Às vezes num arquivo bem grande."
+ *
+ * Espaço-tempos estacionários e axissimétricos que só existem como saída
+ * numérica (estrelas de bósons, Kerr com cabelo, soluções de solvers de
+ * RG) viram um bhs_metric_func: as 10 componentes de g_μν amostradas
+ * numa grade uniforme em r e θ, com t e φ de Killing.
+ *
+ * Interpolação: B-spline cúbica interpolante, produto tensorial (C², erro
+ * O(h⁴)). As amostras são trocadas pelos coeficientes da spline uma vez,
+ * na montagem (um tridiagonal por linha); na consulta cada célula é um
+ * polinômio de 4x4 coeficientes, então ∂_r g e ∂_θ g saem dele em forma
+ * fechada: o bhs_metric_dual_func da tabela dá o Christoffel do
+ * interpolante sem diferença finita. Com g em C², Γ é contínuo e
+ * derivável entre células e o DOPRI5 não tropeça nas bordas delas (uma
+ * Catmull-Rom, só C¹, custava 2 a 3 vezes mais passos). Fora da grade
+ * vale a borda.
+ *
+ * Cache: cada thread guarda os coeficientes da última célula avaliada
+ * (_Thread_local). Um raio passa dezenas de avaliações seguidas na mesma
+ * célula (estágios do DOPRI5, passos curtos), e só a primeira lê a grade
+ * e monta os 10 polinômios.
+ *
+ * Formato (endianness nativa, versão BHS_METRIC_TABLE_VERSION):
+ *   struct bhs_metric_table_header
+ *   double[ntheta + 2][nr + 2][BHS_METRIC_TABLE_COMPS]   (de data_offset)
+ * com os coeficientes da spline (um a mais em cada ponta) e as
+ * componentes na ordem tt, tr, tθ, tφ, rr, rθ, rφ, θθ, θφ, φφ. Os
+ * coeficientes de uma célula ficam em 4 trechos contíguos, e o arquivo é
+ * aberto com mmap: tabelas de centenas de MB custam só as páginas que os
+ * raios de fato visitam.
+ */
+
+#ifndef BHS_ENGINE_GEODESIC_METRIC_TABLE_H
+#define BHS_ENGINE_GEODESIC_METRIC_TABLE_H
+
+#include <stdint.h>
+
+#include "engine/assets/mapped_file.h"
+#include "engine/physics/geodesic/geodesic.h"
+#include "math/tensor/tensor.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Assinatura do arquivo */
+#define BHS_METRIC_TABLE_MAGIC "BHSMTAB"
+
+/** Versão do formato */
+#define BHS_METRIC_TABLE_VERSION 1
+
+/** Componentes independentes de g_μν por nó */
+#define BHS_METRIC_TABLE_COMPS 10
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_metric_table_key - Grade da tabela
+ * @r_min, @r_max: extremos em r (nós uniformes)
+ * @theta_min, @theta_max: extremos em θ (nós uniformes)
+ * @r_horizon: captura dos raios (fim da região confiável da tabela)
+ * @nr, @ntheta: nós em cada direção (≥ 4)
+ *
+ * Só doubles e int32 sem buracos: comparada byte a byte.
+ */
+struct bhs_metric_table_key {
+	double r_min;
+	double r_max;
+	double theta_min;
+	double theta_max;
+	double r_horizon;
+	int32_t nr;
+	int32_t ntheta;
+};
+
+/**
+ * struct bhs_metric_table_header - Cabeçalho no disco
+ * @magic: BHS_METRIC_TABLE_MAGIC com NUL
+ * @version: BHS_METRIC_TABLE_VERSION
+ * @zero: componentes nulas em toda a grade (BHS_METRIC_COMP)
+ * @data_offset: início dos coeficientes (alinhado em 64)
+ * @key: grade
+ */
+struct bhs_metric_table_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t zero;
+	uint64_t data_offset;
+	struct bhs_metric_table_key key;
+};
+
+/**
+ * struct bhs_metric_table - Tabela em memória (própria ou mapeada)
+ * @key: grade
+ * @data: coeficientes da spline
+ * @owned: buffer alocado (NULL se vier de arquivo)
+ * @file: mapeamento (data NULL se @owned)
+ * @desc: descritor para bhs_christoffel_compute_desc() (userdata = a
+ *        própria tabela)
+ * @serial: identidade para o cache por thread
+ * @active, @nactive: componentes fora de desc.zero, as únicas
+ *                    interpoladas (4 de 10 em Kerr)
+ */
+struct bhs_metric_table {
+	struct bhs_metric_table_key key;
+	const double *data;
+	double *owned;
+	struct bhs_mapped_file file;
+	struct bhs_metric_desc desc;
+	uint64_t serial;
+	unsigned char active[BHS_METRIC_TABLE_COMPS];
+	int nactive;
+};
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_metric_table_from_samples - Monta a tabela a partir de amostras
+ * @table: [out] tabela em RAM (liberar com bhs_metric_table_free)
+ * @key: grade
+ * @samples: double[ntheta][nr][BHS_METRIC_TABLE_COMPS], g_μν nos nós
+ *
+ * Entrada para dados de solver já na grade. Componentes que valem
+ * exatamente 0 em todos os nós entram em desc.zero.
+ *
+ * Retorna: 0 em sucesso, -1 se @key é inválida ou faltar memória
+ */
+int bhs_metric_table_from_samples(struct bhs_metric_table *table,
+				  const struct bhs_metric_table_key *key,
+				  const double *samples);
+
+/**
+ * bhs_metric_table_build - Amostra uma métrica nos nós da grade
+ * @table: [out] tabela em RAM (liberar com bhs_metric_table_free)
+ * @key: grade
+ * @fn: métrica em (t, r, θ, φ); avaliada com t = φ = 0
+ * @userdata: parâmetros passados para @fn
+ *
+ * Para testes e para soluções que já têm um avaliador; dados de solver
+ * em outra grade são reamostrados por um @fn que os interpole.
+ *
+ * Retorna: 0 em sucesso, -1 se @key é inválida ou faltar memória
+ */
+int bhs_metric_table_build(struct bhs_metric_table *table,
+			   const struct bhs_metric_table_key *key,
+			   bhs_metric_func fn, void *userdata);
+
+/**
+ * bhs_metric_table_open - Mapeia uma tabela salva
+ * @table: [out] tabela (só leitura)
+ * @path: arquivo
+ *
+ * Só valida cabeçalho e tamanho: nenhum coeficiente é lido aqui.
+ *
+ * Retorna: 0 em sucesso, -1 se ausente ou corrompida
+ */
+int bhs_metric_table_open(struct bhs_metric_table *table, const char *path);
+
+/**
+ * bhs_metric_table_save - Grava a tabela em @path (temporário + rename)
+ *
+ * Retorna: 0 em sucesso, -1 em erro de I/O
+ */
+int bhs_metric_table_save(const struct bhs_metric_table *table,
+			  const char *path);
+
+/**
+ * bhs_metric_table_free - Libera buffer ou desfaz o mmap
+ */
+void bhs_metric_table_free(struct bhs_metric_table *table);
+
+/**
+ * bhs_metric_table_eval - Interpolante e suas derivadas num ponto
+ * @table: tabela
+ * @r, @theta: ponto
+ * @g: [out] g_μν
+ * @dg_dr: [out] ∂_r g_μν (pode ser NULL)
+ * @dg_dtheta: [out] ∂_θ g_μν (pode ser NULL)
+ */
+void bhs_metric_table_eval(const struct bhs_metric_table *table, double r,
+			   double theta, struct bhs_metric *g,
+			   struct bhs_metric *dg_dr,
+			   struct bhs_metric *dg_dtheta);
+
+/**
+ * bhs_metric_table_metric - bhs_metric_func da tabela (@userdata = tabela)
+ */
+void bhs_metric_table_metric(struct bhs_vec4 coords, void *userdata,
+			     struct bhs_metric *out);
+
+/**
+ * bhs_metric_table_metric_dual - bhs_metric_dual_func da tabela
+ *
+ * ∂_r e ∂_θ do interpolante entram pela regra da cadeia nos gradientes
+ * de coords[1] e coords[2].
+ */
+void bhs_metric_table_metric_dual(const struct bhs_dual coords[4],
+				  void *userdata, struct bhs_dual out[4][4]);
+
+/**
+ * bhs_metric_table_use - Aponta @config para a tabela
+ *
+ * Liga BHS_GEO_MODE_METRIC com table->desc e captura em r_horizon. A
+ * tabela precisa viver enquanto @config for usada.
+ */
+void bhs_metric_table_use(const struct bhs_metric_table *table,
+			  struct bhs_geodesic_config *config);
+
+#endif /* BHS_ENGINE_GEODESIC_METRIC_TABLE_H */
@@ -0,0 +1,392 @@
+/**
+ * @file planar_lut.c
+ * @brief Geração, consulta e persistência da tabela de órbitas planas
+ *
+ * "Integrar uma vez é engenharia. Integrar a cada quadro é hobby."
+ */
+
+#include "planar_lut.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "math/spacetime/schwarzschild.h"
+#include "math/spline.h"
+
+/* Linhas começam alinhadas em linha de cache */
+#define DATA_ALIGN 64
+
+/* Passo em ψ da integração que gera as linhas (erro RK4 ~ 1e-12) */
+#define GEN_DPSI 1e-3
+
+/* Menor b do ramo de captura: abaixo disso a órbita é radial */
+#define B_MIN 1e-3
+
+/* Teto de passos por linha (b a 1e-9 de b_c dá ~30 rad) */
+#define GEN_MAX_STEPS 1000000
+
+/* Colunas de cada linha */
+#define COL_PSI_IN 0
+#define COL_PSI_OUT 1
+#define COL_PSI_PERI 2
+#define COL_U 3
+
+/* ============================================================================
+ * GEOMETRIA DA GRADE
+ * ============================================================================
+ */
+
+static size_t row_size(const struct bhs_planar_lut_key *key)
+{
+	return COL_U + 2 * (size_t)key->samples;
+}
+
+static size_t data_count(const struct bhs_planar_lut_key *key)
+{
+	return 2 * (size_t)key->rows * row_size(key);
+}
+
+static uint64_t data_offset(void)
+{
+	uint64_t h = sizeof(struct bhs_planar_lut_header);
+	return (h + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+}
+
+/* Mesma margem de captura do modo planar integrado */
+static double u_capture(const struct bhs_planar_lut_key *key)
+{
+	return 1.0 / (1.01 * 2.0 * key->M);
+}
+
+static double b_max(const struct bhs_planar_lut_key *key)
+{
+	return key->r_obs / sqrt(1.0 - 2.0 * key->M / key->r_obs);
+}
+
+/* Maior |b - b_c| do ramo (0 = captura, 1 = escape) */
+static double delta_max(const struct bhs_planar_lut_key *key, int branch)
+{
+	struct bhs_schwarzschild bh = { .M = key->M };
+	double bc = bhs_schwarzschild_critical_b(&bh);
+	return branch == 0 ? bc - B_MIN * key->M : b_max(key) - bc;
+}
+
+static double row_b(const struct bhs_planar_lut_key *key, int branch, int i)
+{
+	struct bhs_schwarzschild bh = { .M = key->M };
+	double bc = bhs_schwarzschild_critical_b(&bh);
+	double dmin = BHS_PLANAR_LUT_DELTA_MIN * key->M;
+	double d = dmin * pow(delta_max(key, branch) / dmin,
+			      (double)i / (key->rows - 1));
+	return branch == 0 ? bc - d : bc + d;
+}
+
+static bool key_valid(const struct bhs_planar_lut_key *key)
+{
+	return key->M > 0.0 && key->r_obs > 3.0 * key->M &&
+	       key->escape_radius > key->r_obs && key->rows >= 4 &&
+	       key->samples >= 4;
+}
+
+static struct bhs_planar_lut_key key_resolve(const struct bhs_planar_lut_key *k)
+{
+	struct bhs_planar_lut_key key = *k;
+	if (key.rows <= 0)
+		key.rows = BHS_PLANAR_LUT_ROWS;
+	if (key.samples <= 0)
+		key.samples = BHS_PLANAR_LUT_SAMPLES;
+	return key;
+}
+
+/* ============================================================================
+ * GERAÇÃO
+ * ============================================================================
+ */
+
+/* Binet sem as quadraturas: u e w = du/dψ */
+struct binet {
+	double u;
+	double w;
+};
+
+static void binet_rk4(double M, struct binet *y, double h)
+{
+	double u = y->u, w = y->w;
+	double k1u = w, k1w = 3.0 * M * u * u - u;
+	double u2 = u + 0.5 * h * k1u, w2 = w + 0.5 * h * k1w;
+	double k2u = w2, k2w = 3.0 * M * u2 * u2 - u2;
+	double u3 = u + 0.5 * h * k2u, w3 = w + 0.5 * h * k2w;
+	double k3u = w3, k3w = 3.0 * M * u3 * u3 - u3;
+	double u4 = u + h * k3u, w4 = w + h * k3w;
+	double k4u = w4, k4w = 3.0 * M * u4 * u4 - u4;
+
+	y->u += h / 6.0 * (k1u + 2.0 * k2u + 2.0 * k3u + k4u);
+	y->w += h / 6.0 * (k1w + 2.0 * k2w + 2.0 * k3w + k4w);
+}
+
+/* Passo parcial de @prev até u = @target (Newton sobre o próprio RK4) */
+static double binet_land(double M, struct binet prev, double h, double target,
+			 struct binet *out)
+{
+	struct binet end = prev;
+	binet_rk4(M, &end, h);
+	double d = h * (prev.u - target) / (prev.u - end.u);
+
+	for (int it = 0; it < 8; it++) {
+		*out = prev;
+		binet_rk4(M, out, d);
+		if (!(out->w != 0.0))
+			break;
+		double step = (out->u - target) / out->w;
+		d = fmin(fmax(d - step, 0.0), h);
+		if (fabs(step) < 1e-14 * h)
+			break;
+	}
+
+	*out = prev;
+	binet_rk4(M, out, d);
+	return d;
+}
+
+/**
+ * row_sweep - Percorre a órbita inteira uma vez
+ *
+ * Retorna: ψ até o fim (captura ou escape); @psi_peri recebe o ψ onde
+ * w troca de sinal (0 se já começa saindo, o total se nunca retorna).
+ */
+static double row_sweep(const struct bhs_planar_lut_key *key, double w0,
+			double *psi_peri)
+{
+	double M = key->M;
+	double u_cap = u_capture(key), u_esc = 1.0 / key->escape_radius;
+	struct binet y = { 1.0 / key->r_obs, w0 };
+	double psi = 0.0, peri = w0 > 0.0 ? -1.0 : 0.0;
+
+	for (int i = 0; i < GEN_MAX_STEPS; i++) {
+		struct binet prev = y;
+		binet_rk4(M, &y, GEN_DPSI);
+
+		if (y.u > u_cap) {
+			psi += binet_land(M, prev, GEN_DPSI, u_cap, &y);
+			break;
+		}
+		if (y.u < u_esc && y.w < 0.0) {
+			psi += binet_land(M, prev, GEN_DPSI, u_esc, &y);
+			break;
+		}
+		if (peri < 0.0 && prev.w > 0.0 && y.w <= 0.0)
+			peri = psi + GEN_DPSI * prev.w / (prev.w - y.w);
+		psi += GEN_DPSI;
+	}
+
+	*psi_peri = peri < 0.0 ? psi : peri;
+	return psi;
+}
+
+/* Refaz a órbita parando exatamente em ψ = sweep·j/(n-1) */
+static void row_sample(const struct bhs_planar_lut_key *key, double w0,
+		       double sweep, double u_end, double *out)
+{
+	int n = key->samples;
+	struct binet y = { 1.0 / key->r_obs, w0 };
+	double psi = 0.0;
+
+	out[0] = y.u;
+	for (int j = 1; j < n - 1; j++) {
+		double target = sweep * j / (n - 1);
+		while (target - psi > 1e-15 * sweep) {
+			double h = fmin(GEN_DPSI, target - psi);
+			binet_rk4(key->M, &y, h);
+			psi += h;
+		}
+		out[j] = y.u;
+	}
+	out[n - 1] = u_end;
+}
+
+static void build_row(const struct bhs_planar_lut_key *key, int branch, int i,
+		      double *row)
+{
+	double M = key->M, b = row_b(key, branch, i);
+	double u0 = 1.0 / key->r_obs;
+
+	/* (du/dψ)² = 1/b² - u² + 2Mu³ no observador */
+	double w0 = sqrt(fmax(1.0 / (b * b) - u0 * u0 + 2.0 * M * u0 * u0 * u0,
+			      0.0));
+	double u_in = branch == 0 ? u_capture(key) : 1.0 / key->escape_radius;
+	double u_out = 1.0 / key->escape_radius;
+	double dummy;
+	int n = key->samples;
+
+	row[COL_PSI_IN] = row_sweep(key, w0, &row[COL_PSI_PERI]);
+	row[COL_PSI_OUT] = row_sweep(key, -w0, &dummy);
+	row_sample(key, w0, row[COL_PSI_IN], u_in, row + COL_U);
+	row_sample(key, -w0, row[COL_PSI_OUT], u_out, row + COL_U + n);
+}
+
+int bhs_planar_lut_build(struct bhs_planar_lut *lut,
+			 const struct bhs_planar_lut_key *key)
+{
+	memset(lut, 0, sizeof(*lut));
+	struct bhs_planar_lut_key k = key_resolve(key);
+	if (!key_valid(&k))
+		return -1;
+
+	lut->owned = malloc(data_count(&k) * sizeof(double));
+	if (!lut->owned)
+		return -1;
+
+	size_t rs = row_size(&k);
+	for (int branch = 0; branch < 2; branch++)
+		for (int i = 0; i < k.rows; i++)
+			build_row(&k, branch, i,
+				  lut->owned + ((size_t)branch * k.rows + i) * rs);
+
+	lut->key = k;
+	lut->data = lut->owned;
+	return 0;
+}
+
+/* ============================================================================
+ * CONSULTA
+ * ============================================================================
+ */
+
+bool bhs_planar_lut_matches(const struct bhs_planar_lut *lut, double M,
+			    double r, double escape_radius)
+{
+	return lut->data && lut->key.M == M &&
+	       lut->key.escape_radius == escape_radius &&
+	       fabs(r - lut->key.r_obs) <= 1e-9 * lut->key.r_obs;
+}
+
+bool bhs_planar_lut_orbit(const struct bhs_planar_lut *lut, double b,
+			  bool outgoing, struct bhs_planar_lut_orbit *out)
+{
+	const struct bhs_planar_lut_key *key = &lut->key;
+	struct bhs_schwarzschild bh = { .M = key->M };
+	double bc = bhs_schwarzschild_critical_b(&bh);
+
+	if (!(b > 0.0) || b > b_max(key) * (1.0 + 1e-9))
+		return false;
+
+	int branch = b < bc ? 0 : 1;
+	double dmin = BHS_PLANAR_LUT_DELTA_MIN * key->M;
+	double dmax = delta_max(key, branch);
+	double d = fmin(fmax(fabs(b - bc), dmin), dmax);
+	size_t rs = row_size(key);
+
+	out->row = lut->data + (size_t)branch * key->rows * rs;
+	out->x = (key->rows - 1) * log(d / dmin) / log(dmax / dmin);
+	out->outgoing = outgoing;
+	out->captured = branch == 0 && !outgoing;
+	out->sweep = bhs_spline_monotone(out->row +
+						 (outgoing ? COL_PSI_OUT
+							   : COL_PSI_IN),
+					 (ptrdiff_t)rs, key->rows, out->x);
+	out->psi_peri = outgoing ? 0.0
+				 : bhs_spline_monotone(out->row + COL_PSI_PERI,
+						       (ptrdiff_t)rs, key->rows,
+						       out->x);
+	out->u_end = out->captured ? u_capture(key) : 1.0 / key->escape_radius;
+	return true;
+}
+
+double bhs_planar_lut_u(const struct bhs_planar_lut *lut,
+			const struct bhs_planar_lut_orbit *orbit, double psi)
+{
+	const struct bhs_planar_lut_key *key = &lut->key;
+	int n = key->samples;
+	size_t rs = row_size(key);
+	size_t col = COL_U + (orbit->outgoing ? (size_t)n : 0);
+	double s = (n - 1) * psi / orbit->sweep;
+
+	/* Só as 4 linhas que a spline entre linhas vai ler */
+	int i = (int)orbit->x;
+	if (i > key->rows - 2)
+		i = key->rows - 2;
+	int first = i > 0 ? i - 1 : 0;
+	int last = i + 2 < key->rows ? i + 2 : key->rows - 1;
+
+	double v[4];
+	for (int k = first; k <= last; k++)
+		v[k - first] = bhs_spline_monotone(orbit->row + k * rs + col, 1,
+						   n, s);
+	return bhs_spline_monotone(v, 1, last - first + 1, orbit->x - first);
+}
+
+/* ============================================================================
+ * PERSISTÊNCIA
+ * ============================================================================
+ */
+
+int bhs_planar_lut_open(struct bhs_planar_lut *lut, const char *path,
+			const struct bhs_planar_lut_key *expect)
+{
+	memset(lut, 0, sizeof(*lut));
+	if (bhs_mapped_file_open(&lut->file, path) != 0)
+		return -1;
+
+	const struct bhs_planar_lut_header *hdr = lut->file.data;
+	if (lut->file.size < sizeof(*hdr) ||
+	    memcmp(hdr->magic, BHS_PLANAR_LUT_MAGIC,
+		   sizeof(BHS_PLANAR_LUT_MAGIC)) != 0 ||
+	    hdr->version != BHS_PLANAR_LUT_VERSION ||
+	    hdr->data_offset != data_offset() || !key_valid(&hdr->key) ||
+	    hdr->row_size != row_size(&hdr->key))
+		goto fail;
+
+	if (expect) {
+		struct bhs_planar_lut_key want = key_resolve(expect);
+		if (memcmp(&hdr->key, &want, sizeof(want)) != 0)
+			goto fail;
+	}
+
+	size_t need = (size_t)hdr->data_offset +
+		      data_count(&hdr->key) * sizeof(double);
+	if (lut->file.size < need)
+		goto fail;
+
+	lut->key = hdr->key;
+	lut->data = (const double *)((const char *)lut->file.data +
+				     hdr->data_offset);
+	return 0;
+
+fail:
+	bhs_planar_lut_free(lut);
+	return -1;
+}
+
+int bhs_planar_lut_save(const struct bhs_planar_lut *lut, const char *path)
+{
+	struct bhs_atomic_file af;
+	if (bhs_atomic_file_create(&af, path) != 0)
+		return -1;
+	FILE *f = af.f;
+
+	struct bhs_planar_lut_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, BHS_PLANAR_LUT_MAGIC, sizeof(BHS_PLANAR_LUT_MAGIC));
+	hdr.version = BHS_PLANAR_LUT_VERSION;
+	hdr.row_size = (uint32_t)row_size(&lut->key);
+	hdr.data_offset = data_offset();
+	hdr.key = lut->key;
+
+	static const char zeros[DATA_ALIGN];
+	size_t pad = (size_t)hdr.data_offset - sizeof(hdr);
+	size_t count = data_count(&lut->key);
+
+	int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+		 fwrite(zeros, 1, pad, f) == pad &&
+		 fwrite(lut->data, sizeof(double), count, f) == count;
+	return bhs_atomic_file_commit(&af, ok);
+}
+
+void bhs_planar_lut_free(struct bhs_planar_lut *lut)
+{
+	free(lut->owned);
+	bhs_mapped_file_close(&lut->file);
+	memset(lut, 0, sizeof(*lut));
+}
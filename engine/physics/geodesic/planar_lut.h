@@ -0,0 +1,205 @@
+/**
+ * @file planar_lut.h
+ * @brief Tabela de órbitas de fótons de Schwarzschild, indexada por b
+ *
+ * "Toda órbita de fóton em Schwarzschild já foi calculada.
+ * Só falta lembrar onde anotamos."
+ *
+ * Com a = 0 e o observador num raio fixo r_obs, a órbita no plano
+ * orbital depende só do parâmetro de impacto b = L/E e do sentido
+ * inicial (entrando ou saindo). Esta tabela guarda u = 1/r em função do
+ * ângulo ψ varrido desde o observador, para uma grade de b, e com ela o
+ * modo planar (bhs_geodesic_propagate_planar) fecha um raio sem
+ * integrar nada: os cruzamentos com o disco caem em ψ conhecidos e o
+ * escape/captura é o fim da linha.
+ *
+ * Grade:
+ *   - dois ramos, captura (b < b_c) e escape (b > b_c), b_c = √27 M;
+ *   - linhas uniformes em log|b - b_c|, de BHS_PLANAR_LUT_DELTA_MIN até
+ *     b ≈ 0 (captura) ou b_max = r_obs/√(1 - 2M/r_obs) (escape): a
+ *     maior parte das linhas fica perto de b_c, onde a deflexão diverge;
+ *   - cada linha tem as amostras entrando, ψ ∈ [0, ψ_in(b)], e saindo,
+ *     ψ ∈ [0, ψ_out(b)], uniformes em ψ/ψ_fim.
+ * Entre amostras e entre linhas a interpolação é a spline monótona de
+ * math/spline.h: nenhuma oscilação perto de b_c.
+ *
+ * Formato (endianness nativa, versão BHS_PLANAR_LUT_VERSION):
+ *   struct bhs_planar_lut_header
+ *   double[2][rows][row_size]   (a partir de data_offset)
+ * com row_size = 3 + 2 * samples: ψ_in, ψ_out, ψ_peri, u entrando,
+ * u saindo.
+ */
+
+#ifndef BHS_ENGINE_GEODESIC_PLANAR_LUT_H
+#define BHS_ENGINE_GEODESIC_PLANAR_LUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "engine/assets/mapped_file.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Assinatura do arquivo */
+#define BHS_PLANAR_LUT_MAGIC "BHSPLUT"
+
+/** Versão do formato */
+#define BHS_PLANAR_LUT_VERSION 1
+
+/** Linhas (valores de b) por ramo */
+#define BHS_PLANAR_LUT_ROWS 256
+
+/** Amostras em ψ por sentido */
+#define BHS_PLANAR_LUT_SAMPLES 256
+
+/** Menor |b - b_c| tabelado (em M); mais perto usa a primeira linha */
+#define BHS_PLANAR_LUT_DELTA_MIN 1e-9
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_planar_lut_key - Tudo de que a tabela depende
+ * @M: massa
+ * @r_obs: raio do observador (> 3M)
+ * @escape_radius: fim dos raios que escapam (> r_obs)
+ * @rows, @samples: resolução (0 = padrões)
+ *
+ * Só doubles e int32 sem buracos: comparada byte a byte.
+ */
+struct bhs_planar_lut_key {
+	double M;
+	double r_obs;
+	double escape_radius;
+	int32_t rows;
+	int32_t samples;
+};
+
+/**
+ * struct bhs_planar_lut_header - Cabeçalho no disco
+ * @magic: BHS_PLANAR_LUT_MAGIC com NUL
+ * @version: BHS_PLANAR_LUT_VERSION
+ * @row_size: doubles por linha
+ * @data_offset: início das linhas (alinhado em 64)
+ * @key: configuração da tabela
+ */
+struct bhs_planar_lut_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t row_size;
+	uint64_t data_offset;
+	struct bhs_planar_lut_key key;
+};
+
+/**
+ * struct bhs_planar_lut - Tabela em memória (própria ou mapeada)
+ * @key: configuração (rows/samples já resolvidos)
+ * @data: linhas dos dois ramos
+ * @owned: buffer alocado (NULL se vier de arquivo)
+ * @file: mapeamento (data NULL se @owned)
+ */
+struct bhs_planar_lut {
+	struct bhs_planar_lut_key key;
+	const double *data;
+	double *owned;
+	struct bhs_mapped_file file;
+};
+
+/**
+ * struct bhs_planar_lut_orbit - Uma órbita localizada na tabela
+ * @row: primeira linha do ramo
+ * @x: posição entre linhas (unidades de índice)
+ * @outgoing: raio começa saindo (u decrescente)
+ * @captured: termina no horizonte (senão, em escape_radius)
+ * @sweep: ψ total até o fim
+ * @psi_peri: ψ do periastro (= @sweep se não há retorno)
+ * @u_end: u no fim
+ */
+struct bhs_planar_lut_orbit {
+	const double *row;
+	double x;
+	bool outgoing;
+	bool captured;
+	double sweep;
+	double psi_peri;
+	double u_end;
+};
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_planar_lut_build - Integra e tabela todas as órbitas
+ * @lut: [out] tabela em RAM (liberar com bhs_planar_lut_free)
+ * @key: configuração
+ *
+ * Cada linha é a equação de Binet integrada com RK4 em passo fino, com
+ * as amostras caindo exatamente na grade. Alguns décimos de segundo no
+ * padrão; feito uma vez por distância de câmera.
+ *
+ * Retorna: 0 em sucesso, -1 se @key é inválida ou faltar memória
+ */
+int bhs_planar_lut_build(struct bhs_planar_lut *lut,
+			 const struct bhs_planar_lut_key *key);
+
+/**
+ * bhs_planar_lut_open - Mapeia uma tabela salva
+ * @lut: [out] tabela (só leitura)
+ * @path: arquivo
+ * @expect: configuração exigida (NULL aceita qualquer uma)
+ *
+ * Retorna: 0 em sucesso, -1 se ausente, corrompida ou de outra config
+ */
+int bhs_planar_lut_open(struct bhs_planar_lut *lut, const char *path,
+			const struct bhs_planar_lut_key *expect);
+
+/**
+ * bhs_planar_lut_save - Grava a tabela em @path (temporário próprio + rename)
+ *
+ * Retorna: 0 em sucesso, -1 em erro de I/O
+ */
+int bhs_planar_lut_save(const struct bhs_planar_lut *lut, const char *path);
+
+/**
+ * bhs_planar_lut_free - Libera buffer ou desfaz o mmap
+ */
+void bhs_planar_lut_free(struct bhs_planar_lut *lut);
+
+/**
+ * bhs_planar_lut_matches - A tabela serve para este raio?
+ * @M: massa do buraco negro
+ * @r: raio inicial do raio
+ * @escape_radius: raio de escape da propagação
+ *
+ * M e escape_radius iguais, r igual a r_obs até 1e-9 relativo.
+ */
+bool bhs_planar_lut_matches(const struct bhs_planar_lut *lut, double M,
+			    double r, double escape_radius);
+
+/**
+ * bhs_planar_lut_orbit - Localiza a órbita de parâmetro de impacto @b
+ * @lut: tabela
+ * @b: L/E do fóton (> 0)
+ * @outgoing: começa saindo
+ * @out: [out] órbita para bhs_planar_lut_u()
+ *
+ * Retorna: false se @b passa de b_max (não existe em r_obs)
+ */
+bool bhs_planar_lut_orbit(const struct bhs_planar_lut *lut, double b,
+			  bool outgoing, struct bhs_planar_lut_orbit *out);
+
+/**
+ * bhs_planar_lut_u - u = 1/r depois de varrer @psi ∈ [0, sweep]
+ */
+double bhs_planar_lut_u(const struct bhs_planar_lut *lut,
+			const struct bhs_planar_lut_orbit *orbit, double psi);
+
+#endif /* BHS_ENGINE_GEODESIC_PLANAR_LUT_H */
@@ -0,0 +1,140 @@
+/**
+ * @file deflection_cache.c
+ * @brief Leitura, escrita e validação do mapa de deflexão
+ *
+ * "Cache inválido é pior que cache nenhum: é errado com confiança."
+ */
+
+#include "deflection_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Texels começam alinhados em linha de cache */
+#define DATA_ALIGN 64
+
+/* Limite de sanidade da resolução lida do arquivo */
+#define MAX_SIDE 65536
+
+static size_t texel_count(const struct bhs_deflection_key *key)
+{
+	return (size_t)key->width * (size_t)key->height;
+}
+
+static uint64_t data_offset(void)
+{
+	uint64_t h = sizeof(struct bhs_deflection_header);
+	return (h + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+}
+
+bool bhs_deflection_key_equal(const struct bhs_deflection_key *a,
+			      const struct bhs_deflection_key *b)
+{
+	return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+int bhs_deflection_cache_path(const struct bhs_deflection_key *key,
+			      const char *dir, char *buf, size_t size)
+{
+	/* FNV-1a 64 dos bytes da chave */
+	const unsigned char *p = (const unsigned char *)key;
+	uint64_t h = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < sizeof(*key); i++) {
+		h ^= p[i];
+		h *= 0x100000001b3ull;
+	}
+
+	int n = snprintf(buf, size, "%s/deflection-%016llx.bin", dir,
+			 (unsigned long long)h);
+	return n >= 0 && (size_t)n < size ? 0 : -1;
+}
+
+int bhs_deflection_map_alloc(struct bhs_deflection_map *map,
+			     const struct bhs_deflection_key *key)
+{
+	memset(map, 0, sizeof(*map));
+	if (key->width <= 0 || key->width > MAX_SIDE || key->height <= 0 ||
+	    key->height > MAX_SIDE)
+		return -1;
+
+	map->owned = calloc(texel_count(key), sizeof(*map->owned));
+	if (!map->owned)
+		return -1;
+
+	map->key = *key;
+	map->texels = map->owned;
+	return 0;
+}
+
+int bhs_deflection_map_open(struct bhs_deflection_map *map, const char *path,
+			    const struct bhs_deflection_key *expect)
+{
+	memset(map, 0, sizeof(*map));
+	if (bhs_mapped_file_open(&map->file, path) != 0)
+		return -1;
+
+	const struct bhs_deflection_header *hdr = map->file.data;
+	if (map->file.size < sizeof(*hdr) ||
+	    memcmp(hdr->magic, BHS_DEFLECTION_MAGIC,
+		   sizeof(BHS_DEFLECTION_MAGIC)) != 0 ||
+	    hdr->version != BHS_DEFLECTION_VERSION ||
+	    hdr->texel_size != sizeof(struct bhs_deflection_texel) ||
+	    hdr->data_offset != data_offset() || hdr->key.width <= 0 ||
+	    hdr->key.width > MAX_SIDE || hdr->key.height <= 0 ||
+	    hdr->key.height > MAX_SIDE)
+		goto fail;
+
+	if (expect && !bhs_deflection_key_equal(&hdr->key, expect))
+		goto fail;
+
+	/* Em 64 bits mesmo com size_t de 32: MAX_SIDE² texels não estoura */
+	uint64_t need = hdr->data_offset +
+			(uint64_t)hdr->key.width * (uint64_t)hdr->key.height *
+				sizeof(struct bhs_deflection_texel);
+	if ((uint64_t)map->file.size < need)
+		goto fail;
+
+	map->key = hdr->key;
+	map->texels = (const struct bhs_deflection_texel
+			       *)((const char *)map->file.data +
+				  hdr->data_offset);
+	return 0;
+
+fail:
+	bhs_deflection_map_free(map);
+	return -1;
+}
+
+int bhs_deflection_map_save(const struct bhs_deflection_map *map,
+			    const char *path)
+{
+	struct bhs_atomic_file af;
+	if (bhs_atomic_file_create(&af, path) != 0)
+		return -1;
+	FILE *f = af.f;
+
+	struct bhs_deflection_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, BHS_DEFLECTION_MAGIC, sizeof(BHS_DEFLECTION_MAGIC));
+	hdr.version = BHS_DEFLECTION_VERSION;
+	hdr.texel_size = sizeof(struct bhs_deflection_texel);
+	hdr.data_offset = data_offset();
+	hdr.key = map->key;
+
+	static const char zeros[DATA_ALIGN];
+	size_t pad = (size_t)hdr.data_offset - sizeof(hdr);
+	size_t count = texel_count(&map->key);
+
+	int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+		 fwrite(zeros, 1, pad, f) == pad &&
+		 fwrite(map->texels, sizeof(*map->texels), count, f) == count;
+	return bhs_atomic_file_commit(&af, ok);
+}
+
+void bhs_deflection_map_free(struct bhs_deflection_map *map)
+{
+	free(map->owned);
+	bhs_mapped_file_close(&map->file);
+	memset(map, 0, sizeof(*map));
+}
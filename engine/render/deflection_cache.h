@@ -0,0 +1,193 @@
+/**
+ * @file deflection_cache.h
+ * @brief Mapa de deflexão por pixel, persistente e mapeado em memória
+ *
+ * "A geodésica não sabe que cor o disco tem. Então para que traçá-la
+ * de novo?"
+ *
+ * Com spin, câmera e geometria do disco fixos, o destino de cada pixel
+ * (escapou para a direção (θ, φ), bateu no disco em (r, φ) ou foi
+ * capturado) não muda. Só a emissividade do disco, o céu e o tempo mudam.
+ * Este módulo guarda esse destino em um arquivo binário com cabeçalho
+ * descrevendo a configuração; o tracer monta o mapa uma vez e, daí em
+ * diante, um quadro é só consulta + shading (bhs_tracer_shade).
+ *
+ * Formato (endianness nativa, versão BHS_DEFLECTION_VERSION):
+ *   struct bhs_deflection_header
+ *   struct bhs_deflection_texel[height][width]   (a partir de data_offset)
+ */
+
+#ifndef BHS_ENGINE_RENDER_DEFLECTION_CACHE_H
+#define BHS_ENGINE_RENDER_DEFLECTION_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "engine/assets/mapped_file.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Assinatura do arquivo */
+#define BHS_DEFLECTION_MAGIC "BHSDEFL"
+
+/** Versão do formato (mudar quando texel ou cabeçalho mudarem) */
+#define BHS_DEFLECTION_VERSION 2
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_deflection_key - Tudo de que o mapa depende
+ * @M, @a: massa e spin
+ * @distance, @azimuth, @inclination, @fov: câmera
+ * @disk_inner, @disk_outer: anel do disco fino (decide bate/atravessa)
+ * @disk_half_thickness: plano fino (0) ou fatia
+ * @escape_radius: onde o (θ, φ) dos raios que escapam é lido
+ * @dlambda, @tolerance, @abs_tolerance: passo e tolerâncias da integração
+ * @far_field_radius: atalho de campo fraco (0 = desligado)
+ * @width, @height: resolução
+ * @mode: enum bhs_geodesic_mode
+ * @max_steps: limite de passos (decide BHS_GEO_TIMEOUT)
+ * @shadow_capture: atalho da sombra ligado
+ * @lut_rows, @lut_samples: resolução da tabela planar (0 = sem tabela)
+ *
+ * Só doubles e int32 sem buracos: o hash é dos bytes.
+ */
+struct bhs_deflection_key {
+	double M;
+	double a;
+	double distance;
+	double azimuth;
+	double inclination;
+	double fov;
+	double disk_inner;
+	double disk_outer;
+	double disk_half_thickness;
+	double escape_radius;
+	double dlambda;
+	double tolerance;
+	double abs_tolerance;
+	double far_field_radius;
+	int32_t width;
+	int32_t height;
+	int32_t mode;
+	int32_t max_steps;
+	int32_t shadow_capture;
+	int32_t lut_rows;
+	int32_t lut_samples;
+	int32_t reserved;
+};
+
+/**
+ * struct bhs_deflection_texel - Destino de um pixel
+ * @x, @y: (r, φ) do impacto se @status == BHS_GEO_HIT_DISK,
+ *         (θ, φ) finais se BHS_GEO_ESCAPED, zero caso contrário
+ * @status: enum bhs_geodesic_status
+ *
+ * Em double: o céu usa hash da direção e float mudaria as estrelas.
+ */
+struct bhs_deflection_texel {
+	double x;
+	double y;
+	uint32_t status;
+	uint32_t reserved;
+};
+
+/**
+ * struct bhs_deflection_header - Cabeçalho no disco
+ * @magic: BHS_DEFLECTION_MAGIC com NUL
+ * @version: BHS_DEFLECTION_VERSION
+ * @texel_size: sizeof(struct bhs_deflection_texel)
+ * @data_offset: início dos texels (alinhado em 64)
+ * @key: configuração do mapa
+ */
+struct bhs_deflection_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t texel_size;
+	uint64_t data_offset;
+	struct bhs_deflection_key key;
+};
+
+/**
+ * struct bhs_deflection_map - Mapa em memória (próprio ou mapeado)
+ * @key: configuração
+ * @texels: width * height texels, linha 0 no topo
+ * @owned: buffer alocado (NULL se vier de arquivo)
+ * @file: mapeamento (data NULL se @owned)
+ */
+struct bhs_deflection_map {
+	struct bhs_deflection_key key;
+	const struct bhs_deflection_texel *texels;
+	struct bhs_deflection_texel *owned;
+	struct bhs_mapped_file file;
+};
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_deflection_key_equal - Mesma configuração, bit a bit
+ */
+bool bhs_deflection_key_equal(const struct bhs_deflection_key *a,
+			      const struct bhs_deflection_key *b);
+
+/**
+ * bhs_deflection_cache_path - Nome do arquivo de cache para @key
+ * @key: configuração
+ * @dir: diretório do cache
+ * @buf, @size: [out] caminho "dir/deflection-<hash>.bin"
+ *
+ * Retorna: 0 em sucesso, -1 se não couber em @buf
+ */
+int bhs_deflection_cache_path(const struct bhs_deflection_key *key,
+			      const char *dir, char *buf, size_t size);
+
+/**
+ * bhs_deflection_map_alloc - Mapa vazio em RAM para ser preenchido
+ *
+ * Retorna: 0 em sucesso, -1 em falha de alocação ou resolução inválida
+ */
+int bhs_deflection_map_alloc(struct bhs_deflection_map *map,
+			     const struct bhs_deflection_key *key);
+
+/**
+ * bhs_deflection_map_open - Mapeia um arquivo de cache
+ * @map: [out] mapa (só leitura)
+ * @path: arquivo
+ * @expect: configuração exigida (NULL aceita qualquer uma)
+ *
+ * Valida assinatura, versão, tamanho do texel, tamanho do arquivo e,
+ * se pedido, a chave. Não copia nada: os texels apontam para o mmap.
+ *
+ * Retorna: 0 em sucesso, -1 se ausente, corrompido ou de outra config
+ */
+int bhs_deflection_map_open(struct bhs_deflection_map *map, const char *path,
+			    const struct bhs_deflection_key *expect);
+
+/**
+ * bhs_deflection_map_save - Grava o mapa em @path
+ *
+ * Escreve num temporário só deste escritor (bhs_atomic_file) e renomeia:
+ * quem abre em paralelo nunca vê arquivo pela metade, nem com dois
+ * processos montando a mesma chave.
+ *
+ * Retorna: 0 em sucesso, -1 em erro de I/O
+ */
+int bhs_deflection_map_save(const struct bhs_deflection_map *map,
+			    const char *path);
+
+/**
+ * bhs_deflection_map_free - Libera buffer ou desfaz o mmap
+ */
+void bhs_deflection_map_free(struct bhs_deflection_map *map);
+
+#endif /* BHS_ENGINE_RENDER_DEFLECTION_CACHE_H */
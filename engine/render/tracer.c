@@ -0,0 +1,1491 @@
+/**
+ * @file tracer.c
+ * @brief Ray tracer de referência na CPU
+ *
+ * "Um pixel, uma geodésica. Sem atalhos, sem Newton disfarçado."
+ */
+
+#define _GNU_SOURCE /* Para M_PI, sysconf e clock_gettime */
+
+#include "tracer.h"
+
+#include "engine/physics/geodesic/planar_lut.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * IMAGEM
+ * ============================================================================
+ */
+
+int bhs_tracer_image_alloc(struct bhs_tracer_image *img, int width,
+			   int height)
+{
+	img->width = width;
+	img->height = height;
+	img->rgb = NULL;
+	memset(&img->stats, 0, sizeof(img->stats));
+
+	if (width <= 0 || height <= 0)
+		return -1;
+
+	img->rgb = calloc((size_t)width * (size_t)height * 3, sizeof(float));
+	return img->rgb ? 0 : -1;
+}
+
+void bhs_tracer_image_free(struct bhs_tracer_image *img)
+{
+	free(img->rgb);
+	img->rgb = NULL;
+	img->width = 0;
+	img->height = 0;
+	memset(&img->stats, 0, sizeof(img->stats));
+}
+
+int bhs_tracer_write_pfm(const struct bhs_tracer_image *img, const char *path)
+{
+	FILE *f = fopen(path, "wb");
+	if (!f)
+		return -1;
+
+	/* Escala negativa = little-endian; linhas de baixo para cima */
+	fprintf(f, "PF\n%d %d\n-1.0\n", img->width, img->height);
+
+	size_t row = (size_t)img->width * 3;
+	int ok = 1;
+	for (int y = img->height - 1; y >= 0 && ok; y--)
+		ok = fwrite(img->rgb + (size_t)y * row, sizeof(float), row, f) ==
+		     row;
+
+	if (fclose(f) != 0)
+		ok = 0;
+	return ok ? 0 : -1;
+}
+
+/* ============================================================================
+ * PIXEL
+ * ============================================================================
+ */
+
+/* Polo exato deixa forward ∥ up: afasta um fio */
+static double camera_inclination(const struct bhs_tracer_camera *cam)
+{
+	return fmin(fmax(cam->inclination, 1e-4), M_PI - 1e-4);
+}
+
+/**
+ * Fundo para raios que escaparam: mesmo céu do blackhole.comp
+ * (névoa fraca + estrelas por hash da direção final (θ, φ)).
+ */
+static struct bhs_color_rgb background(double theta, double phi)
+{
+	double s = sin(theta);
+	double dx = s * cos(phi);
+	double dy = s * sin(phi);
+
+	double h = sin(dx * 12.9898 + dy * 78.233) * 43758.5453;
+	double star = (h - floor(h)) >= 0.998 ? 1.0 : 0.0;
+
+	float v = (float)(0.01 + star);
+	return (struct bhs_color_rgb){ v, v, v };
+}
+
+/* Tabelas do disco para a câmera de @cfg: uma vez por render */
+static void disk_shade_init(const struct bhs_tracer_config *cfg,
+			    struct bhs_disk_shade *ds)
+{
+	bhs_disk_shade_init(ds, &cfg->bh, &cfg->disk,
+			    camera_inclination(&cfg->camera));
+	if (cfg->spectral)
+		bhs_disk_shade_spectral_init(
+			ds, cfg->disk_temperature > 0.0
+				    ? cfg->disk_temperature
+				    : BHS_TRACER_DISK_TEMPERATURE);
+}
+
+/* g exato de um impacto em @r: ξ = L/E do raio do pixel, sem traçar */
+static double pixel_g(const struct bhs_tracer_config *cfg, double px,
+		      double py, double r)
+{
+	struct bhs_geodesic geo;
+	struct bhs_geodesic_constants c;
+
+	bhs_tracer_pixel_ray(cfg, px, py, &geo);
+	bhs_geodesic_constants(&geo, &cfg->bh, &c);
+	return bhs_disk_g_factor(&cfg->bh, r, c.L / c.E);
+}
+
+/**
+ * shade - Cor de um destino: (r, φ) no disco ou (θ, φ) no céu
+ * @ds: tabelas do disco (disk_shade_init)
+ * @px, @py: pixel de origem (o modo espectral tira o g do raio)
+ *
+ * Única parte do pixel que depende do modelo do disco; é o que
+ * bhs_tracer_shade() refaz a partir do mapa de deflexão.
+ */
+static struct bhs_color_rgb shade(const struct bhs_tracer_config *cfg,
+				  const struct bhs_disk_shade *ds,
+				  enum bhs_geodesic_status status, double x,
+				  double y, double px, double py)
+{
+	struct bhs_color_rgb c;
+	double g;
+
+	switch (status) {
+	case BHS_GEO_HIT_DISK:
+		if (cfg->spectral) {
+			g = pixel_g(cfg, px, py, x);
+			bhs_disk_shade_spectral(ds, &x, NULL, &g, 1, &c);
+		} else {
+			bhs_disk_shade_batch(ds, &x, &y, NULL, 1, &c);
+		}
+		return c;
+	case BHS_GEO_ESCAPED:
+		return background(x, y);
+	default:
+		/* Capturado ou sem veredito: sombra */
+		return (struct bhs_color_rgb){ 0.0f, 0.0f, 0.0f };
+	}
+}
+
+void bhs_tracer_pixel_ray(const struct bhs_tracer_config *cfg, double x,
+			  double y, struct bhs_geodesic *geo)
+{
+	const struct bhs_tracer_camera *cam = &cfg->camera;
+	double incl = camera_inclination(cam);
+
+	struct bhs_vec3 cam_pos = bhs_vec3_make(
+		cam->distance * sin(incl) * cos(cam->azimuth),
+		cam->distance * sin(incl) * sin(cam->azimuth),
+		cam->distance * cos(incl));
+	struct bhs_vec3 cam_dir = bhs_vec3_scale(cam_pos, -1.0);
+	struct bhs_vec3 cam_up = bhs_vec3_make(0.0, 0.0, 1.0);
+
+	/* NDC como no shader: [-1, 1] em y, x corrigido pelo aspecto */
+	double aspect = (double)cfg->width / (double)cfg->height;
+	double u = ((x + 0.5) / cfg->width * 2.0 - 1.0) * aspect;
+	double v = 1.0 - (y + 0.5) / cfg->height * 2.0;
+
+	bhs_geodesic_ray_from_camera(geo, cam_pos, cam_dir, cam_up, u, v,
+				     cam->fov, &cfg->bh);
+}
+
+/**
+ * trace_texel - Propaga a geodésica do pixel e guarda só o destino
+ * @vol: [out] luz e transmitância de cfg->volume no caminho (NULL = sem
+ *       volume)
+ * @stats: contadores da thread (pode ser NULL)
+ */
+static void trace_texel(const struct bhs_tracer_config *cfg, double x,
+			double y, struct bhs_deflection_texel *out,
+			struct bhs_volume_ray *vol,
+			struct bhs_tracer_stats *stats)
+{
+	struct bhs_geodesic geo;
+	bhs_tracer_pixel_ray(cfg, x, y, &geo);
+
+	struct bhs_geodesic_config gc = cfg->geo;
+	gc.disk_inner = cfg->disk.inner_radius;
+	gc.disk_outer = cfg->disk.outer_radius;
+	/* Combinação validada na entrada (bhs_volume_supports) */
+	if (vol)
+		bhs_volume_ray_attach(vol, cfg->volume, &geo, &gc);
+
+	enum bhs_geodesic_status st =
+		bhs_geodesic_propagate(&geo, &cfg->bh, &gc);
+
+	if (stats) {
+		stats->rays++;
+		stats->steps += geo.step_count;
+		stats->shadow_exits += geo.shortcut == BHS_GEO_SHORTCUT_SHADOW;
+		stats->far_field_exits +=
+			geo.shortcut == BHS_GEO_SHORTCUT_FAR_FIELD;
+		stats->volume_samples += vol ? vol->samples : 0;
+	}
+
+	out->status = (uint32_t)st;
+	out->reserved = 0;
+	switch (st) {
+	case BHS_GEO_HIT_DISK:
+		out->x = geo.pos.x;
+		out->y = geo.pos.z;
+		break;
+	case BHS_GEO_ESCAPED:
+		out->x = geo.pos.y;
+		out->y = geo.pos.z;
+		break;
+	default:
+		out->x = 0.0;
+		out->y = 0.0;
+		break;
+	}
+}
+
+/**
+ * struct tracer_sample - Resultado de uma geodésica, com o que o
+ * refinamento compara entre cantos
+ */
+struct tracer_sample {
+	struct bhs_color_rgb color;
+	enum bhs_geodesic_status status;
+	double r; /* raio do impacto no disco */
+	double z; /* redshift do impacto no disco */
+	bool done;
+};
+
+static void trace_sample(const struct bhs_tracer_config *cfg,
+			 const struct bhs_disk_shade *ds, double x, double y,
+			 struct tracer_sample *s,
+			 struct bhs_tracer_stats *stats)
+{
+	struct bhs_deflection_texel tx;
+	struct bhs_volume_ray vol;
+	trace_texel(cfg, x, y, &tx, cfg->volume ? &vol : NULL, stats);
+
+	s->status = (enum bhs_geodesic_status)tx.status;
+	s->color = shade(cfg, ds, s->status, tx.x, tx.y, x, y);
+	if (cfg->volume) {
+		/* O que está atrás do meio chega atenuado, mais o que ele emite */
+		float tr = (float)vol.transmittance;
+		s->color.r = tr * s->color.r + vol.emission.r;
+		s->color.g = tr * s->color.g + vol.emission.g;
+		s->color.b = tr * s->color.b + vol.emission.b;
+	}
+	s->r = 0.0;
+	s->z = 0.0;
+	s->done = true;
+
+	if (s->status == BHS_GEO_HIT_DISK) {
+		s->r = tx.x;
+		s->z = bhs_disk_redshift_total(
+			&cfg->bh, tx.x, tx.y,
+			camera_inclination(&cfg->camera));
+	}
+}
+
+struct bhs_color_rgb bhs_tracer_trace_pixel(const struct bhs_tracer_config *cfg,
+					    double x, double y)
+{
+	struct bhs_disk_shade ds;
+	struct tracer_sample s;
+
+	disk_shade_init(cfg, &ds);
+	trace_sample(cfg, &ds, x, y, &s, NULL);
+	return s.color;
+}
+
+/* ============================================================================
+ * REFINAMENTO ADAPTATIVO
+ * ============================================================================
+ */
+
+/**
+ * struct tile_ctx - Estado de uma thread durante um tile
+ * @cfg, @img: render
+ * @disk: tabelas do disco
+ * @defl: texels do mapa de deflexão (NULL = renderiza cores)
+ * @hist: quadro anterior a reprojetar (NULL = sem reprojeção)
+ * @x0, @y0, @w: origem e largura do tile (índice do cache)
+ * @cache: amostras já traçadas no tile (w * altura)
+ * @shift_u, @shift_v: deslocamento da última reprojeção (chute inicial
+ *                     da próxima)
+ * @stats: contadores desta thread
+ * @threshold: limiar efetivo de refinamento (ou de reprojeção)
+ */
+struct tile_ctx {
+	const struct bhs_tracer_config *cfg;
+	struct bhs_tracer_image *img;
+	const struct bhs_disk_shade *disk;
+	struct bhs_deflection_texel *defl;
+	struct bhs_tracer_history *hist;
+	int x0, y0, w;
+	struct tracer_sample *cache;
+	double shift_u, shift_v;
+	struct bhs_tracer_stats stats;
+	double threshold;
+};
+
+static const struct tracer_sample *tile_sample(struct tile_ctx *t, int x,
+					       int y)
+{
+	struct tracer_sample *s = &t->cache[(y - t->y0) * t->w + (x - t->x0)];
+	if (!s->done) {
+		trace_sample(t->cfg, t->disk, x, y, s, &t->stats);
+	}
+	return s;
+}
+
+static void put_pixel(struct tile_ctx *t, int x, int y,
+		      struct bhs_color_rgb c)
+{
+	float *px = t->img->rgb + ((size_t)y * t->img->width + x) * 3;
+	px[0] = c.r;
+	px[1] = c.g;
+	px[2] = c.b;
+}
+
+/**
+ * Cantos concordam se têm o mesmo status e, no disco, raio e redshift
+ * próximos. Fora do disco a cor decide: sombra e névoa são constantes,
+ * mas uma estrela num canto não pode virar mancha interpolada.
+ */
+static bool corners_agree(const struct tracer_sample *c[4], double thr)
+{
+	for (int i = 1; i < 4; i++)
+		if (c[i]->status != c[0]->status)
+			return false;
+
+	if (c[0]->status != BHS_GEO_HIT_DISK) {
+		for (int i = 1; i < 4; i++)
+			if (fabsf(c[i]->color.r - c[0]->color.r) > thr ||
+			    fabsf(c[i]->color.g - c[0]->color.g) > thr ||
+			    fabsf(c[i]->color.b - c[0]->color.b) > thr)
+				return false;
+		return true;
+	}
+
+	double rmin = c[0]->r, rmax = c[0]->r;
+	double zmin = c[0]->z, zmax = c[0]->z;
+	for (int i = 1; i < 4; i++) {
+		rmin = fmin(rmin, c[i]->r);
+		rmax = fmax(rmax, c[i]->r);
+		zmin = fmin(zmin, c[i]->z);
+		zmax = fmax(zmax, c[i]->z);
+	}
+	return rmax - rmin <= thr * rmin && zmax - zmin <= thr;
+}
+
+/**
+ * refine_cell - Preenche a célula de cantos (ax, ay)-(bx, by), inclusive
+ *
+ * Pixels já traçados sempre recebem o valor exato; os demais, a
+ * interpolação bilinear dos cantos. Células vizinhas dividem a borda,
+ * então um pixel pode ser escrito duas vezes, mas sempre com o exato
+ * depois de traçado.
+ */
+static void refine_cell(struct tile_ctx *t, int ax, int ay, int bx, int by)
+{
+	const struct tracer_sample *c[4] = {
+		tile_sample(t, ax, ay),
+		tile_sample(t, bx, ay),
+		tile_sample(t, ax, by),
+		tile_sample(t, bx, by),
+	};
+
+	if (bx - ax <= 1 && by - ay <= 1) {
+		put_pixel(t, ax, ay, c[0]->color);
+		put_pixel(t, bx, ay, c[1]->color);
+		put_pixel(t, ax, by, c[2]->color);
+		put_pixel(t, bx, by, c[3]->color);
+		return;
+	}
+
+	if (corners_agree(c, t->threshold)) {
+		double sx = bx > ax ? 1.0 / (bx - ax) : 0.0;
+		double sy = by > ay ? 1.0 / (by - ay) : 0.0;
+
+		for (int y = ay; y <= by; y++) {
+			float fy = (float)((y - ay) * sy);
+			for (int x = ax; x <= bx; x++) {
+				const struct tracer_sample *e =
+					&t->cache[(y - t->y0) * t->w +
+						  (x - t->x0)];
+				if (e->done) {
+					put_pixel(t, x, y, e->color);
+					continue;
+				}
+
+				float fx = (float)((x - ax) * sx);
+				float w00 = (1.0f - fx) * (1.0f - fy);
+				float w10 = fx * (1.0f - fy);
+				float w01 = (1.0f - fx) * fy;
+				float w11 = fx * fy;
+				put_pixel(t, x, y,
+					  (struct bhs_color_rgb){
+						  w00 * c[0]->color.r +
+							  w10 * c[1]->color.r +
+							  w01 * c[2]->color.r +
+							  w11 * c[3]->color.r,
+						  w00 * c[0]->color.g +
+							  w10 * c[1]->color.g +
+							  w01 * c[2]->color.g +
+							  w11 * c[3]->color.g,
+						  w00 * c[0]->color.b +
+							  w10 * c[1]->color.b +
+							  w01 * c[2]->color.b +
+							  w11 * c[3]->color.b,
+					  });
+			}
+		}
+		return;
+	}
+
+	/* Divide só as dimensões que ainda têm pixels no meio */
+	int mx = bx - ax > 1 ? (ax + bx) / 2 : bx;
+	int my = by - ay > 1 ? (ay + by) / 2 : by;
+
+	refine_cell(t, ax, ay, mx, my);
+	if (mx != bx)
+		refine_cell(t, mx, ay, bx, my);
+	if (my != by) {
+		refine_cell(t, ax, my, mx, by);
+		if (mx != bx)
+			refine_cell(t, mx, my, bx, by);
+	}
+}
+
+/* ============================================================================
+ * REPROJEÇÃO
+ * ============================================================================
+ */
+
+/**
+ * struct ray_key - O que identifica a órbita do raio de um pixel
+ * @xi: L/E
+ * @eta: Q/E²
+ * @beta: p_θ/E na câmera (o sinal diz para que lado o raio sai em θ)
+ */
+struct ray_key {
+	double xi;
+	double eta;
+	double beta;
+};
+
+/* p_θ/E de quem tem constantes (ξ, η) em θ; < 0 no radicando = não passa */
+static double ray_beta2(double a, double xi, double eta, double theta)
+{
+	double c = cos(theta);
+	double s = sin(theta);
+
+	return eta + a * a * c * c - xi * xi * c * c / (s * s);
+}
+
+static void pixel_key(const struct bhs_tracer_config *cfg, int x, int y,
+		      struct ray_key *k)
+{
+	struct bhs_geodesic geo;
+	struct bhs_geodesic_constants c;
+
+	bhs_tracer_pixel_ray(cfg, x, y, &geo);
+	bhs_geodesic_constants(&geo, &cfg->bh, &c);
+	k->xi = c.L / c.E;
+	k->eta = c.Q / (c.E * c.E);
+	k->beta = copysign(
+		sqrt(fmax(ray_beta2(cfg->bh.a, k->xi, k->eta, geo.pos.y), 0.0)),
+		geo.vel.y);
+}
+
+/*
+ * Confiança de um pixel recém-traçado: entre decay e 1 por um hash do
+ * pixel, para que uma imagem traçada de uma vez não expire de uma vez
+ */
+static float fresh_confidence(int x, int y, double decay)
+{
+	uint32_t h = (uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u;
+
+	h ^= h >> 13;
+	h *= 0x5bd1e995u;
+	h ^= h >> 15;
+	return (float)(1.0 - (1.0 - decay) * (h & 0xffff) / 65536.0);
+}
+
+/**
+ * history_locate - Acha (u, v) no quadro antigo com (ξ, β) dados
+ *
+ * Newton sobre a interpolação bilinear de ξ e β entre os pixels antigos.
+ * O mapa da câmera é quase linear, então poucas iterações bastam.
+ *
+ * Retorna: true se convergiu dentro da imagem
+ */
+static bool history_locate(const struct bhs_tracer_history *h, double xi,
+			   double beta, double *u, double *v)
+{
+	const struct bhs_tracer_history_texel *tx = h->texels;
+	int w = h->frame.width;
+	int hh = h->frame.height;
+
+	for (int it = 0; it < 8; it++) {
+		int i = (int)fmin(fmax(floor(*u), 0.0), w - 2);
+		int j = (int)fmin(fmax(floor(*v), 0.0), hh - 2);
+		double fx = *u - i, fy = *v - j;
+		const struct bhs_tracer_history_texel *a = &tx[j * w + i];
+		const struct bhs_tracer_history_texel *b = a + 1;
+		const struct bhs_tracer_history_texel *c = a + w;
+		const struct bhs_tracer_history_texel *d = c + 1;
+
+		double xx = a->xi - b->xi - c->xi + d->xi;
+		double bx = a->beta - b->beta - c->beta + d->beta;
+		double xu = b->xi - a->xi + xx * fy;
+		double xv = c->xi - a->xi + xx * fx;
+		double bu = b->beta - a->beta + bx * fy;
+		double bv = c->beta - a->beta + bx * fx;
+		double ex = xi - (a->xi + (b->xi - a->xi) * fx +
+				  (c->xi - a->xi) * fy + xx * fx * fy);
+		double eb = beta - (a->beta + (b->beta - a->beta) * fx +
+				    (c->beta - a->beta) * fy + bx * fx * fy);
+
+		double det = xu * bv - xv * bu;
+		if (fabs(det) < 1e-300)
+			return false;
+		double du = (ex * bv - eb * xv) / det;
+		double dv = (xu * eb - bu * ex) / det;
+		*u += du;
+		*v += dv;
+
+		/* ξ e β guardados em float: abaixo disso é ruído, que pode
+		 * oscilar entre duas células */
+		if (fabs(du) + fabs(dv) < 1e-5) {
+			/* Pixels da borda convergem para a borda, a menos de
+			 * arredondamento */
+			if (*u < -1e-3 || *u > w - 1 + 1e-3 || *v < -1e-3 ||
+			    *v > hh - 1 + 1e-3)
+				return false;
+			*u = fmin(fmax(*u, 0.0), w - 1);
+			*v = fmin(fmax(*v, 0.0), hh - 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Diferença de ângulos em (-π, π] */
+static double wrap_angle(double d)
+{
+	return d - 2.0 * M_PI * floor((d + M_PI) / (2.0 * M_PI));
+}
+
+/**
+ * reproject - Destino do pixel (x, y) a partir do quadro anterior
+ * @k: constantes do raio do pixel neste quadro
+ * @out: [out] destino (φ relativo ao azimute), se deu certo
+ *
+ * Falha (e o pixel é traçado) se a câmera antiga não vê essas constantes,
+ * se o ponto cai fora da imagem antiga, se os quatro vizinhos discordam
+ * de status ou além do limiar, ou se a confiança acabou.
+ */
+static bool reproject(struct tile_ctx *t, int x, int y,
+		      const struct ray_key *k,
+		      struct bhs_tracer_history_texel *out)
+{
+	const struct bhs_tracer_history *h = t->hist;
+	const struct bhs_tracer_config *old = &h->frame;
+	double decay = h->decay > 0.0 ? h->decay : BHS_TRACER_HISTORY_DECAY;
+	double min_conf = h->min_confidence > 0.0
+				  ? h->min_confidence
+				  : BHS_TRACER_HISTORY_MIN_CONFIDENCE;
+
+	double th_old = camera_inclination(&old->camera);
+	/* Raios rentes ao ponto de virada em θ dão b2 ≈ -0 por arredondamento */
+	double b2 = ray_beta2(old->bh.a, k->xi, k->eta, th_old);
+	if (b2 < -1e-9 * (fabs(k->eta) + 1.0))
+		return false;
+	double beta = copysign(sqrt(fmax(b2, 0.0)), k->beta);
+
+	double u = x + t->shift_u, v = y + t->shift_v;
+	if (!history_locate(h, k->xi, beta, &u, &v))
+		return false;
+	t->shift_u = u - x;
+	t->shift_v = v - y;
+
+	/*
+	 * Mesmas constantes, fase diferente: ir de uma câmera à outra pela
+	 * órbita custa Δσ_θ = ∫dθ/√Θ em θ e Δσ_r = ∫dr/√R em r (tempo de
+	 * Mino), e os dois não batem. Longe do buraco √R ≈ r², √Θ = |β|.
+	 */
+	double r_cam = t->cfg->camera.distance;
+	double dsigma =
+		2.0 * fabs(camera_inclination(&t->cfg->camera) - th_old) /
+			(fabs(beta) + fabs(k->beta) + 1e-300) +
+		fabs(r_cam - old->camera.distance) / (r_cam * r_cam);
+
+	/* Em cima de um pixel antigo (azimute puro): cópia exata */
+	int w = old->width;
+	int ru = (int)lround(u), rv = (int)lround(v);
+	const struct bhs_tracer_history_texel *n = &h->texels[rv * w + ru];
+	if (dsigma == 0.0 && fabs(u - ru) < 1e-4 && fabs(v - rv) < 1e-4) {
+		*out = *n;
+		out->xi = (float)k->xi;
+		out->beta = (float)k->beta;
+		return true;
+	}
+
+	int i = u < w - 1 ? (int)u : w - 2;
+	int j = v < old->height - 1 ? (int)v : old->height - 2;
+	double fx = u - i, fy = v - j;
+	const struct bhs_tracer_history_texel *c[4] = {
+		&h->texels[j * w + i],
+		&h->texels[j * w + i + 1],
+		&h->texels[(j + 1) * w + i],
+		&h->texels[(j + 1) * w + i + 1],
+	};
+	double wt[4] = {
+		(1.0 - fx) * (1.0 - fy),
+		fx * (1.0 - fy),
+		(1.0 - fx) * fy,
+		fx * fy,
+	};
+
+	/*
+	 * Bordas (sombra, disco) andam na imagem quando a câmera anda: um
+	 * anel de pixels em volta da célula também tem que concordar
+	 */
+	for (int jj = j - 1; jj <= j + 2; jj++) {
+		if (jj < 0 || jj >= old->height)
+			continue;
+		for (int ii = i - 1; ii <= i + 2; ii++)
+			if (ii >= 0 && ii < w &&
+			    h->texels[jj * w + ii].status != c[0]->status)
+				return false;
+	}
+
+	double px = 0.0, py = 0.0;
+	double xmin = c[0]->x, xmax = c[0]->x, spread = 0.0;
+	for (int q = 0; q < 4; q++) {
+		double dy = wrap_angle(c[q]->y - c[0]->y);
+		px += wt[q] * c[q]->x;
+		py += wt[q] * dy;
+		xmin = fmin(xmin, c[q]->x);
+		xmax = fmax(xmax, c[q]->x);
+		spread = fmax(spread, fabs(dy));
+	}
+
+	/*
+	 * Disco: |Δr|/r e |Δφ|; céu: ângulo (Δθ e sen θ Δφ). O erro de fase
+	 * move o cruzamento do equador de √R Δσ ≈ r² Δσ: no disco, |Δr|/r =
+	 * r Δσ; no céu, um raio que cruzou logo além da borda externa pode
+	 * cair nela, então o céu paga como um impacto na borda.
+	 */
+	double drift;
+	switch ((enum bhs_geodesic_status)c[0]->status) {
+	case BHS_GEO_HIT_DISK:
+		spread = fmax(spread, (xmax - xmin) / xmin);
+		drift = px * dsigma;
+		break;
+	case BHS_GEO_ESCAPED:
+		spread = fmax(spread * sin(px), xmax - xmin);
+		drift = t->cfg->disk.outer_radius * dsigma;
+		break;
+	default:
+		spread = 0.0;
+		drift = 0.0;
+		break;
+	}
+	if (spread > t->threshold)
+		return false;
+
+	/* Confiança: envelhece e paga o erro de fase estimado */
+	float conf = (float)(n->confidence * decay - drift / t->threshold);
+	if (conf < min_conf)
+		return false;
+
+	out->status = c[0]->status;
+	out->x = px;
+	out->y = c[0]->y + py;
+	out->xi = (float)k->xi;
+	out->beta = (float)k->beta;
+	out->confidence = conf;
+	return true;
+}
+
+/**
+ * temporal_tile - Reprojeta ou traça cada pixel do tile e colore
+ *
+ * Escreve o destino de cada pixel em hist->scratch, que vira o histórico
+ * do próximo quadro.
+ */
+static void temporal_tile(struct tile_ctx *t, int x0, int y0, int x1, int y1)
+{
+	const struct bhs_tracer_config *cfg = t->cfg;
+	struct bhs_tracer_history *h = t->hist;
+	double azimuth = cfg->camera.azimuth;
+	double decay = h->decay > 0.0 ? h->decay : BHS_TRACER_HISTORY_DECAY;
+
+	t->shift_u = 0.0;
+	t->shift_v = 0.0;
+	for (int y = y0; y < y1; y++) {
+		for (int x = x0; x < x1; x++) {
+			struct bhs_tracer_history_texel *o =
+				&h->scratch[(size_t)y * cfg->width + x];
+			struct bhs_deflection_texel tx;
+			struct ray_key k;
+
+			pixel_key(cfg, x, y, &k);
+			if (h->texels && reproject(t, x, y, &k, o)) {
+				tx.status = o->status;
+				tx.x = o->x;
+				tx.y = o->y + azimuth;
+			} else {
+				trace_texel(cfg, x, y, &tx, NULL, &t->stats);
+				o->status = tx.status;
+				o->x = tx.x;
+				o->y = tx.y - azimuth;
+				o->xi = (float)k.xi;
+				o->beta = (float)k.beta;
+				o->confidence = fresh_confidence(x, y, decay);
+			}
+
+			put_pixel(t, x, y,
+				  shade(cfg, t->disk,
+					(enum bhs_geodesic_status)tx.status,
+					tx.x, tx.y, x, y));
+		}
+	}
+}
+
+/* ============================================================================
+ * POOL DE THREADS
+ * ============================================================================
+ */
+
+/**
+ * struct tracer_job - Trabalho dividido entre as threads
+ * @img: destino das cores, com @disk, ou
+ * @defl: destino dos texels (monta o mapa de deflexão, sem shading)
+ * @hist: com @img, reprojeta o quadro anterior em vez de traçar tudo
+ */
+struct tracer_job {
+	const struct bhs_tracer_config *cfg;
+	struct bhs_tracer_image *img;
+	struct bhs_disk_shade disk;
+	struct bhs_deflection_texel *defl;
+	struct bhs_tracer_history *hist;
+	int tile;
+	int tiles_x;
+	int tiles_total;
+	atomic_int next_tile;
+	pthread_mutex_t lock;
+	struct bhs_tracer_stats stats;
+};
+
+static void render_tile(struct tile_ctx *t, int tile, int tiles_x, int index)
+{
+	const struct bhs_tracer_config *cfg = t->cfg;
+	int x0 = (index % tiles_x) * tile;
+	int y0 = (index / tiles_x) * tile;
+	int x1 = x0 + tile < cfg->width ? x0 + tile : cfg->width;
+	int y1 = y0 + tile < cfg->height ? y0 + tile : cfg->height;
+
+	if (t->defl) {
+		for (int y = y0; y < y1; y++)
+			for (int x = x0; x < x1; x++)
+				trace_texel(cfg, x, y,
+					    &t->defl[(size_t)y * cfg->width + x],
+					    NULL, &t->stats);
+		return;
+	}
+
+	if (t->hist) {
+		temporal_tile(t, x0, y0, x1, y1);
+		return;
+	}
+
+	if (cfg->refine_cell <= 1) {
+		for (int y = y0; y < y1; y++) {
+			for (int x = x0; x < x1; x++) {
+				struct tracer_sample s;
+				trace_sample(cfg, t->disk, x, y, &s,
+					     &t->stats);
+				put_pixel(t, x, y, s.color);
+			}
+		}
+		return;
+	}
+
+	t->x0 = x0;
+	t->y0 = y0;
+	t->w = x1 - x0;
+	for (int i = 0; i < (x1 - x0) * (y1 - y0); i++)
+		t->cache[i].done = false;
+
+	/* Grade grossa alinhada ao tile; a última célula fecha na borda */
+	int cell = cfg->refine_cell;
+	for (int ay = y0; ay < y1; ay += cell) {
+		int by = ay + cell < y1 - 1 ? ay + cell : y1 - 1;
+		for (int ax = x0; ax < x1; ax += cell) {
+			int bx = ax + cell < x1 - 1 ? ax + cell : x1 - 1;
+			refine_cell(t, ax, ay, bx, by);
+			if (bx == x1 - 1)
+				break;
+		}
+		if (by == y1 - 1)
+			break;
+	}
+}
+
+static void *tracer_worker(void *arg)
+{
+	struct tracer_job *job = arg;
+	const struct bhs_tracer_config *cfg = job->cfg;
+
+	struct tile_ctx t = {
+		.cfg = cfg,
+		.img = job->img,
+		.disk = &job->disk,
+		.defl = job->defl,
+		.hist = job->hist,
+		.threshold = cfg->refine_threshold > 0.0
+				     ? cfg->refine_threshold
+				     : BHS_TRACER_REFINE_THRESHOLD,
+	};
+	if (job->hist && job->hist->threshold > 0.0)
+		t.threshold = job->hist->threshold;
+	if (!job->defl && !job->hist && cfg->refine_cell > 1) {
+		t.cache = malloc((size_t)job->tile * job->tile *
+				 sizeof(*t.cache));
+		/* Sem cache a thread só não pega tiles; as outras cobrem */
+		if (!t.cache)
+			return NULL;
+	}
+
+	for (;;) {
+		int i = atomic_fetch_add_explicit(&job->next_tile, 1,
+						  memory_order_relaxed);
+		if (i >= job->tiles_total)
+			break;
+		render_tile(&t, job->tile, job->tiles_x, i);
+	}
+
+	pthread_mutex_lock(&job->lock);
+	job->stats.rays += t.stats.rays;
+	job->stats.steps += t.stats.steps;
+	job->stats.shadow_exits += t.stats.shadow_exits;
+	job->stats.far_field_exits += t.stats.far_field_exits;
+	job->stats.volume_samples += t.stats.volume_samples;
+	pthread_mutex_unlock(&job->lock);
+	free(t.cache);
+	return NULL;
+}
+
+static int online_cpus(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#else
+	return 1;
+#endif
+}
+
+/**
+ * run_threads - Roda @fn(@arg) em @n threads, a chamadora incluída
+ *
+ * Thread que não sobe só deixa o trabalho para as outras.
+ *
+ * Retorna: 0, ou -1 sem memória (nada rodou)
+ */
+static int run_threads(int n, void *(*fn)(void *), void *arg)
+{
+	pthread_t *threads = calloc((size_t)n, sizeof(pthread_t));
+	if (!threads)
+		return -1;
+
+	/* A thread chamadora também trabalha: cria n - 1 extras */
+	int started = 0;
+	for (int i = 1; i < n; i++) {
+		if (pthread_create(&threads[i], NULL, fn, arg) != 0)
+			break;
+		started++;
+	}
+
+	fn(arg);
+
+	for (int i = 1; i <= started; i++)
+		pthread_join(threads[i], NULL);
+
+	free(threads);
+	return 0;
+}
+
+/**
+ * run_pool - Reparte os tiles de @job entre as threads
+ *
+ * Retorna: 0 se todos os tiles foram feitos, -1 caso contrário
+ */
+static int run_pool(struct tracer_job *job)
+{
+	const struct bhs_tracer_config *cfg = job->cfg;
+
+	job->tile = cfg->tile_size > 0 ? cfg->tile_size : BHS_TRACER_TILE_SIZE;
+	job->tiles_x = (cfg->width + job->tile - 1) / job->tile;
+	job->tiles_total =
+		job->tiles_x * ((cfg->height + job->tile - 1) / job->tile);
+	atomic_init(&job->next_tile, 0);
+	memset(&job->stats, 0, sizeof(job->stats));
+
+	int n = cfg->threads > 0 ? cfg->threads : online_cpus();
+	if (n > job->tiles_total)
+		n = job->tiles_total;
+
+	if (pthread_mutex_init(&job->lock, NULL) != 0)
+		return -1;
+	int ret = run_threads(n, tracer_worker, job);
+	pthread_mutex_destroy(&job->lock);
+	if (ret != 0)
+		return -1;
+
+	/* Nenhuma thread conseguiu alocar o cache: tiles ficaram sem render */
+	return atomic_load(&job->next_tile) < job->tiles_total ? -1 : 0;
+}
+
+int bhs_tracer_render(const struct bhs_tracer_config *cfg,
+		      struct bhs_tracer_image *out)
+{
+	if (cfg->volume && !bhs_volume_supports(&cfg->geo))
+		return -1;
+	if (bhs_tracer_image_alloc(out, cfg->width, cfg->height) != 0)
+		return -1;
+
+	struct tracer_job job = { .cfg = cfg, .img = out };
+	disk_shade_init(cfg, &job.disk);
+	if (run_pool(&job) != 0) {
+		bhs_tracer_image_free(out);
+		return -1;
+	}
+
+	out->stats = job.stats;
+	return 0;
+}
+
+/* ============================================================================
+ * MAPA DE DEFLEXÃO
+ * ============================================================================
+ */
+
+void bhs_tracer_deflection_key(const struct bhs_tracer_config *cfg,
+			       struct bhs_deflection_key *key)
+{
+	memset(key, 0, sizeof(*key));
+	key->M = cfg->bh.M;
+	key->a = cfg->bh.a;
+	key->distance = cfg->camera.distance;
+	key->azimuth = cfg->camera.azimuth;
+	key->inclination = cfg->camera.inclination;
+	key->fov = cfg->camera.fov;
+	key->disk_inner = cfg->disk.inner_radius;
+	key->disk_outer = cfg->disk.outer_radius;
+	key->disk_half_thickness = cfg->geo.disk_half_thickness;
+	key->escape_radius = cfg->geo.escape_radius;
+	key->dlambda = cfg->geo.dlambda;
+	key->tolerance = cfg->geo.tolerance;
+	key->abs_tolerance = cfg->geo.abs_tolerance;
+	key->far_field_radius = cfg->geo.far_field_radius;
+	key->width = cfg->width;
+	key->height = cfg->height;
+	key->mode = (int32_t)cfg->geo.mode;
+	key->max_steps = cfg->geo.max_steps;
+	key->shadow_capture = cfg->geo.shadow_capture;
+	if (cfg->geo.planar_lut) {
+		key->lut_rows = cfg->geo.planar_lut->key.rows;
+		key->lut_samples = cfg->geo.planar_lut->key.samples;
+	}
+}
+
+static int build_deflection(const struct bhs_tracer_config *cfg,
+			    struct bhs_deflection_map *out,
+			    struct bhs_tracer_stats *stats)
+{
+	struct bhs_deflection_key key;
+	bhs_tracer_deflection_key(cfg, &key);
+	if (bhs_deflection_map_alloc(out, &key) != 0)
+		return -1;
+
+	struct tracer_job job = { .cfg = cfg, .defl = out->owned };
+	if (run_pool(&job) != 0) {
+		bhs_deflection_map_free(out);
+		return -1;
+	}
+	*stats = job.stats;
+	return 0;
+}
+
+int bhs_tracer_build_deflection(const struct bhs_tracer_config *cfg,
+				struct bhs_deflection_map *out)
+{
+	struct bhs_tracer_stats stats;
+	return build_deflection(cfg, out, &stats);
+}
+
+int bhs_tracer_shade(const struct bhs_tracer_config *cfg,
+		     const struct bhs_deflection_map *map,
+		     struct bhs_tracer_image *out)
+{
+	if (map->key.width != cfg->width || map->key.height != cfg->height)
+		return -1;
+	if (bhs_tracer_image_alloc(out, cfg->width, cfg->height) != 0)
+		return -1;
+
+	struct bhs_disk_shade ds;
+	disk_shade_init(cfg, &ds);
+
+	/* Acertos no disco vão em lote; céu e sombra, texel a texel */
+	enum { BATCH = 256 };
+	double r[BATCH], phi[BATCH], g[BATCH];
+	size_t at[BATCH];
+	struct bhs_color_rgb c[BATCH];
+	int m = 0;
+
+	size_t n = (size_t)cfg->width * (size_t)cfg->height;
+	for (size_t i = 0; i <= n; i++) {
+		if (m == BATCH || (i == n && m > 0)) {
+			if (cfg->spectral)
+				bhs_disk_shade_spectral(&ds, r, NULL, g, m, c);
+			else
+				bhs_disk_shade_batch(&ds, r, phi, NULL, m, c);
+			for (int k = 0; k < m; k++) {
+				float *px = out->rgb + at[k] * 3;
+				px[0] = c[k].r;
+				px[1] = c[k].g;
+				px[2] = c[k].b;
+			}
+			m = 0;
+		}
+		if (i == n)
+			break;
+
+		const struct bhs_deflection_texel *tx = &map->texels[i];
+		enum bhs_geodesic_status st =
+			(enum bhs_geodesic_status)tx->status;
+		double px = (double)(i % (size_t)cfg->width);
+		double py = (double)(i / (size_t)cfg->width);
+		if (st == BHS_GEO_HIT_DISK) {
+			r[m] = tx->x;
+			phi[m] = tx->y;
+			if (cfg->spectral)
+				g[m] = pixel_g(cfg, px, py, tx->x);
+			at[m++] = i;
+			continue;
+		}
+
+		struct bhs_color_rgb sky =
+			shade(cfg, &ds, st, tx->x, tx->y, px, py);
+		out->rgb[i * 3 + 0] = sky.r;
+		out->rgb[i * 3 + 1] = sky.g;
+		out->rgb[i * 3 + 2] = sky.b;
+	}
+	return 0;
+}
+
+int bhs_tracer_render_cached(const struct bhs_tracer_config *cfg,
+			     const char *cache_dir,
+			     struct bhs_tracer_image *out)
+{
+	struct bhs_deflection_key key;
+	char path[4096];
+	struct bhs_deflection_map map;
+
+	/* A chave não descreve a métrica tabelada nem guarda o volume */
+	if (cfg->geo.mode == BHS_GEO_MODE_METRIC || cfg->volume)
+		return -1;
+
+	bhs_tracer_deflection_key(cfg, &key);
+	if (bhs_deflection_cache_path(&key, cache_dir, path, sizeof(path)) != 0)
+		return -1;
+
+	struct bhs_tracer_stats stats = { 0 };
+	if (bhs_deflection_map_open(&map, path, &key) != 0) {
+		if (build_deflection(cfg, &map, &stats) != 0)
+			return -1;
+
+		/* Falha ao gravar só custa o próximo quadro: segue com a RAM */
+		bhs_deflection_map_save(&map, path);
+	}
+
+	int ret = bhs_tracer_shade(cfg, &map, out);
+	if (ret == 0)
+		out->stats = stats;
+	bhs_deflection_map_free(&map);
+	return ret;
+}
+
+/* ============================================================================
+ * RENDER PROGRESSIVO
+ * ============================================================================
+ */
+
+/* Amostras por vez de uma thread: a granularidade do prazo */
+#define PROGRESS_CHUNK 16
+
+static double monotonic_seconds(void *user)
+{
+	struct timespec ts;
+
+	(void)user;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static long gcd(long a, long b)
+{
+	while (b) {
+		long t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * build_order - Monta a sequência de pixels nível a nível
+ *
+ * Os pontos de cada nível são listados por linha e depois percorridos
+ * com passo ≈ 0.618 n (primo com n): toda a lista é visitada e
+ * qualquer prefixo fica espalhado pela tela.
+ *
+ * Retorna: 0 em sucesso, -1 sem memória
+ */
+static int build_order(struct bhs_tracer_progress *p, int width, int height,
+		       int stride)
+{
+	size_t n = (size_t)width * (size_t)height;
+	uint32_t *order = malloc(n * sizeof(*order));
+	uint32_t *pts = malloc(n * sizeof(*pts));
+
+	if (!order || !pts) {
+		free(order);
+		free(pts);
+		return -1;
+	}
+
+	long at = 0;
+	int levels = 0;
+	for (int s = stride; s >= 1; s /= 2) {
+		long m = 0;
+		for (int y = 0; y < height; y += s)
+			for (int x = 0; x < width; x += s)
+				if (s == stride || x % (2 * s) || y % (2 * s))
+					pts[m++] = (uint32_t)y * width + x;
+
+		long step = (long)(0.6180339887 * m + 0.5);
+		while (step < 1 || gcd(step, m) != 1)
+			step++;
+		for (long i = 0, j = 0; i < m; i++, j = (j + step) % m)
+			order[at + i] = pts[j];
+
+		at += m;
+		p->level_end[levels++] = at;
+	}
+
+	free(pts);
+	free(p->order);
+	p->order = order;
+	p->levels = levels;
+	return 0;
+}
+
+/* Mesma imagem: a chave do mapa, a métrica, o modelo de cor e o volume */
+static bool same_frame(const struct bhs_tracer_config *a,
+		       const struct bhs_tracer_config *b)
+{
+	struct bhs_deflection_key ka, kb;
+
+	bhs_tracer_deflection_key(a, &ka);
+	bhs_tracer_deflection_key(b, &kb);
+	return memcmp(&ka, &kb, sizeof(ka)) == 0 &&
+	       a->disk.mdot == b->disk.mdot &&
+	       a->disk.inclination == b->disk.inclination &&
+	       a->spectral == b->spectral &&
+	       a->disk_temperature == b->disk_temperature &&
+	       a->geo.metric == b->geo.metric &&
+	       a->geo.metric_userdata == b->geo.metric_userdata &&
+	       a->geo.metric_horizon == b->geo.metric_horizon &&
+	       a->volume == b->volume;
+}
+
+/**
+ * struct progress_job - Um nível (ou o resto dele) entre as threads
+ * @begin, @end: faixa de p->order deste quadro
+ * @block: lado do bloco que cada amostra pinta
+ * @timed: confere @deadline (falso no nível 0)
+ * @next: início do próximo pedaço a pegar
+ * @stop: primeiro pedaço largado por causa do prazo (@end = nenhum)
+ */
+struct progress_job {
+	const struct bhs_tracer_config *cfg;
+	struct bhs_tracer_progress *p;
+	const struct bhs_disk_shade *disk;
+	long begin;
+	long end;
+	int block;
+	bool timed;
+	double deadline;
+	atomic_long next;
+	atomic_long stop;
+	pthread_mutex_t lock;
+	struct bhs_tracer_stats stats;
+};
+
+static double progress_now(const struct bhs_tracer_progress *p)
+{
+	return p->clock ? p->clock(p->clock_user) : monotonic_seconds(NULL);
+}
+
+static void *progress_worker(void *arg)
+{
+	struct progress_job *job = arg;
+	const struct bhs_tracer_config *cfg = job->cfg;
+	struct bhs_tracer_image *img = &job->p->image;
+	struct bhs_tracer_stats stats = { 0 };
+
+	for (;;) {
+		long i = atomic_fetch_add_explicit(&job->next, PROGRESS_CHUNK,
+						   memory_order_relaxed);
+		if (i >= job->end)
+			break;
+
+		/*
+		 * Pedaços depois deste podem já estar com outras threads: o
+		 * cursor volta ao menor largado e eles são refeitos (pintam o
+		 * mesmo bloco) no próximo quadro
+		 */
+		if (job->timed && progress_now(job->p) >= job->deadline) {
+			long cur = atomic_load(&job->stop);
+			while (i < cur &&
+			       !atomic_compare_exchange_weak(&job->stop, &cur,
+							     i))
+				;
+			break;
+		}
+
+		long e = i + PROGRESS_CHUNK < job->end ? i + PROGRESS_CHUNK
+						       : job->end;
+		for (; i < e; i++) {
+			uint32_t idx = job->p->order[i];
+			int x0 = (int)(idx % (uint32_t)cfg->width);
+			int y0 = (int)(idx / (uint32_t)cfg->width);
+			int x1 = x0 + job->block < cfg->width ? x0 + job->block
+							      : cfg->width;
+			int y1 = y0 + job->block < cfg->height
+					 ? y0 + job->block
+					 : cfg->height;
+			struct tracer_sample s;
+
+			trace_sample(cfg, job->disk, x0, y0, &s, &stats);
+			for (int y = y0; y < y1; y++) {
+				float *px = img->rgb +
+					    ((size_t)y * cfg->width + x0) * 3;
+				for (int x = x0; x < x1; x++, px += 3) {
+					px[0] = s.color.r;
+					px[1] = s.color.g;
+					px[2] = s.color.b;
+				}
+			}
+		}
+	}
+
+	pthread_mutex_lock(&job->lock);
+	job->stats.rays += stats.rays;
+	job->stats.steps += stats.steps;
+	job->stats.shadow_exits += stats.shadow_exits;
+	job->stats.far_field_exits += stats.far_field_exits;
+	job->stats.volume_samples += stats.volume_samples;
+	pthread_mutex_unlock(&job->lock);
+	return NULL;
+}
+
+/* Maior potência de 2 que não passa de @stride nem do limite de níveis */
+static int progress_stride(int stride)
+{
+	int s = 1;
+
+	if (stride <= 0)
+		stride = BHS_TRACER_PROGRESS_STRIDE;
+	while (2 * s <= stride && 2 * s < (1 << BHS_TRACER_PROGRESS_LEVELS))
+		s *= 2;
+	return s;
+}
+
+void bhs_tracer_progress_init(struct bhs_tracer_progress *p)
+{
+	memset(p, 0, sizeof(*p));
+}
+
+void bhs_tracer_progress_free(struct bhs_tracer_progress *p)
+{
+	int stride = p->stride;
+	bhs_tracer_clock_fn clock = p->clock;
+	void *clock_user = p->clock_user;
+
+	bhs_tracer_image_free(&p->image);
+	free(p->order);
+	bhs_tracer_progress_init(p);
+	p->stride = stride;
+	p->clock = clock;
+	p->clock_user = clock_user;
+}
+
+int bhs_tracer_render_progressive(const struct bhs_tracer_config *cfg,
+				  double budget,
+				  struct bhs_tracer_progress *p)
+{
+	if (cfg->volume && !bhs_volume_supports(&cfg->geo))
+		return -1;
+
+	double deadline = progress_now(p) + budget;
+	bool timed = budget > 0.0;
+
+	int stride = progress_stride(p->stride);
+
+	if (p->image.width != cfg->width || p->image.height != cfg->height) {
+		bhs_tracer_progress_free(p);
+		if (bhs_tracer_image_alloc(&p->image, cfg->width,
+					   cfg->height) != 0) {
+			bhs_tracer_progress_free(p);
+			return -1;
+		}
+	}
+	if (!p->order || 1 << (p->levels - 1) != stride) {
+		if (build_order(p, cfg->width, cfg->height, stride) != 0) {
+			bhs_tracer_progress_free(p);
+			return -1;
+		}
+		p->cursor = 0;
+	} else if (!same_frame(cfg, &p->frame)) {
+		p->cursor = 0;
+	}
+	p->frame = *cfg;
+	memset(&p->image.stats, 0, sizeof(p->image.stats));
+
+	long total = p->level_end[p->levels - 1];
+	if (p->cursor >= total)
+		return 1;
+
+	struct progress_job job = { .cfg = cfg, .p = p };
+	struct bhs_disk_shade ds;
+	disk_shade_init(cfg, &ds);
+	job.disk = &ds;
+	job.deadline = deadline;
+	if (pthread_mutex_init(&job.lock, NULL) != 0)
+		return -1;
+
+	int level = 0;
+	while (p->level_end[level] <= p->cursor)
+		level++;
+
+	int ret = 0;
+	for (; level < p->levels; level++) {
+		job.begin = p->cursor;
+		job.end = p->level_end[level];
+		job.block = 1 << (p->levels - 1 - level);
+		job.timed = timed && level > 0;
+		if (job.timed && progress_now(p) >= deadline)
+			break;
+		atomic_init(&job.next, job.begin);
+		atomic_init(&job.stop, job.end);
+
+		long chunks = (job.end - job.begin + PROGRESS_CHUNK - 1) /
+			      PROGRESS_CHUNK;
+		int n = cfg->threads > 0 ? cfg->threads : online_cpus();
+		if (n > chunks)
+			n = (int)chunks;
+		if (run_threads(n, progress_worker, &job) != 0) {
+			ret = -1;
+			break;
+		}
+
+		p->cursor = atomic_load(&job.stop);
+		if (p->cursor < job.end)
+			break;
+	}
+
+	pthread_mutex_destroy(&job.lock);
+	p->image.stats = job.stats;
+	if (ret != 0)
+		return -1;
+	return p->cursor >= total ? 1 : 0;
+}
+
+/* ============================================================================
+ * REPROJEÇÃO TEMPORAL
+ * ============================================================================
+ */
+
+void bhs_tracer_history_init(struct bhs_tracer_history *h)
+{
+	memset(h, 0, sizeof(*h));
+}
+
+void bhs_tracer_history_free(struct bhs_tracer_history *h)
+{
+	free(h->texels);
+	free(h->scratch);
+	h->texels = NULL;
+	h->scratch = NULL;
+	memset(&h->frame, 0, sizeof(h->frame));
+}
+
+/* Chave do mapa sem a câmera: o que o quadro guardado precisa repetir */
+static void history_key(const struct bhs_tracer_config *cfg,
+			struct bhs_deflection_key *key)
+{
+	bhs_tracer_deflection_key(cfg, key);
+	key->distance = 0.0;
+	key->azimuth = 0.0;
+	key->inclination = 0.0;
+	key->fov = 0.0;
+}
+
+/* O quadro guardado serve se só a câmera (e o modelo de cor) mudou */
+static bool history_matches(const struct bhs_tracer_history *h,
+			    const struct bhs_tracer_config *cfg)
+{
+	const struct bhs_tracer_config *old = &h->frame;
+	struct bhs_deflection_key ka, kb;
+
+	if (!h->texels || cfg->width < 2 || cfg->height < 2)
+		return false;
+
+	history_key(old, &ka);
+	history_key(cfg, &kb);
+	return memcmp(&ka, &kb, sizeof(ka)) == 0 &&
+	       old->geo.metric == cfg->geo.metric &&
+	       old->geo.metric_userdata == cfg->geo.metric_userdata &&
+	       old->geo.metric_horizon == cfg->geo.metric_horizon;
+}
+
+int bhs_tracer_render_temporal(const struct bhs_tracer_config *cfg,
+			       struct bhs_tracer_history *h,
+			       struct bhs_tracer_image *out)
+{
+	size_t n = (size_t)cfg->width * (size_t)cfg->height;
+
+	/* O histórico guarda só o destino, como o mapa de deflexão */
+	if (cfg->volume)
+		return -1;
+
+	if (!history_matches(h, cfg)) {
+		bhs_tracer_history_free(h);
+		if (n > 0)
+			h->scratch = malloc(n * sizeof(*h->scratch));
+		if (!h->scratch)
+			return -1;
+	}
+	if (bhs_tracer_image_alloc(out, cfg->width, cfg->height) != 0)
+		return -1;
+
+	struct tracer_job job = { .cfg = cfg, .img = out, .hist = h };
+	disk_shade_init(cfg, &job.disk);
+	if (run_pool(&job) != 0) {
+		bhs_tracer_image_free(out);
+		return -1;
+	}
+	out->stats = job.stats;
+
+	/* O quadro novo vira o histórico; o antigo, rascunho do próximo */
+	struct bhs_tracer_history_texel *prev = h->texels;
+	h->texels = h->scratch;
+	h->scratch = prev ? prev : malloc(n * sizeof(*h->scratch));
+	h->frame = *cfg;
+
+	/* Sem rascunho o próximo quadro só traça tudo */
+	if (!h->scratch)
+		bhs_tracer_history_free(h);
+	return 0;
+}
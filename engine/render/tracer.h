@@ -0,0 +1,451 @@
+/**
+ * @file tracer.h
+ * @brief Ray tracer de referência na CPU (headless, multithread)
+ *
+ * "Se a GPU e a CPU discordam, a CPU está certa.
+ * Ela só demora mais para provar."
+ *
+ * Renderiza a imagem do buraco negro sem Vulkan: cada pixel vira uma
+ * geodésica de Kerr de verdade (bhs_geodesic_propagate), e quem acerta o
+ * disco é colorido pelas tabelas de bhs_disk_shade_batch (o modelo de
+ * bhs_disk_color, sem pow por pixel). A imagem é dividida em tiles e um
+ * pool de threads pega o próximo tile de um contador atômico, então não
+ * há trava no caminho quente e a escala é linear com os núcleos.
+ *
+ * Com refine_cell > 0 o render é adaptativo: cada tile começa numa grade
+ * grossa de geodésicas e só subdivide as células cujos cantos discordam
+ * (status diferente, raio/redshift no disco além de refine_threshold, ou
+ * cor do fundo diferente, para não borrar estrelas).
+ * O resto é interpolado bilinearmente. A borda da sombra, o anel de fótons
+ * e as bordas do disco recebem todos os raios; fundo e disco liso, quase
+ * nenhum.
+ *
+ * Para animações com câmera repetida, o destino de cada pixel pode ir
+ * para um mapa de deflexão em disco (deflection_cache.h): com o mapa,
+ * um quadro é só consulta + sombreamento em lote, sem nenhuma geodésica.
+ *
+ * Para previews interativos, bhs_tracer_render_progressive() traça em
+ * ordem hierárquica até um prazo por quadro: a imagem grossa sai
+ * primeiro, inteira, e os quadros seguintes com a mesma câmera só a
+ * refinam. Em animações, bhs_tracer_render_temporal() reaproveita o
+ * destino de cada pixel do quadro anterior e só traça o que a câmera
+ * nova não consegue reprojetar.
+ *
+ * Serve para nós de batch sem GPU e como verdade de referência para
+ * blackhole.comp. A câmera usa os mesmos parâmetros do push constant do
+ * shader (distância, ângulo, inclinação).
+ */
+
+#ifndef BHS_ENGINE_RENDER_TRACER_H
+#define BHS_ENGINE_RENDER_TRACER_H
+
+#include "engine/components/disk/disk.h"
+#include "engine/physics/geodesic/geodesic.h"
+#include "engine/render/deflection_cache.h"
+#include "engine/render/volume.h"
+#include "math/spacetime/kerr.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Lado padrão do tile em pixels */
+#define BHS_TRACER_TILE_SIZE 32
+
+/** Limiar padrão de refinamento (relativo em r, absoluto em z e na cor) */
+#define BHS_TRACER_REFINE_THRESHOLD 0.1
+
+/** Temperatura padrão do anel mais quente no modo espectral (K) */
+#define BHS_TRACER_DISK_TEMPERATURE 10000.0
+
+/** Lado padrão do bloco do nível grosso do render progressivo (pixels) */
+#define BHS_TRACER_PROGRESS_STRIDE 16
+
+/** Níveis máximos do render progressivo (lado do bloco até 2^15) */
+#define BHS_TRACER_PROGRESS_LEVELS 16
+
+/** Fator padrão da confiança a cada reprojeção interpolada */
+#define BHS_TRACER_HISTORY_DECAY 0.9
+
+/** Confiança padrão abaixo da qual o pixel é traçado de novo */
+#define BHS_TRACER_HISTORY_MIN_CONFIDENCE 0.5
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_tracer_camera - Câmera orbital (mesma do blackhole.comp)
+ * @distance: distância ao centro (em M)
+ * @azimuth: ângulo horizontal (rad)
+ * @inclination: ângulo a partir do polo (rad, π/2 = equador)
+ * @fov: campo de visão vertical (rad)
+ */
+struct bhs_tracer_camera {
+	double distance;
+	double azimuth;
+	double inclination;
+	double fov;
+};
+
+/**
+ * struct bhs_tracer_config - Configuração do render
+ * @width, @height: resolução
+ * @tile_size: lado do tile (0 = BHS_TRACER_TILE_SIZE)
+ * @threads: threads de trabalho (0 = núcleos online)
+ * @bh: buraco negro
+ * @disk: disco de acreção (outer_radius = 0 desliga o disco)
+ * @camera: câmera
+ * @geo: integração (disk_inner/outer vêm de @disk; disk_half_thickness
+ *       = 0 usa o plano fino exato; shadow_capture e far_field_radius
+ *       ligam os atalhos analíticos; com a = 0, modo planar e
+ *       planar_lut da distância da câmera, nenhum raio é integrado;
+ *       bhs_metric_table_use() troca Kerr por uma métrica tabelada, e
+ *       @bh fica só para o disco)
+ * @refine_cell: lado da célula grossa do render adaptativo em pixels
+ *               (0 ou 1 = um raio por pixel)
+ * @refine_threshold: diferença tolerada entre cantos: |Δr|/r e |Δz| no
+ *                    disco, |Δcor| fora dele (0 = BHS_TRACER_REFINE_THRESHOLD)
+ * @spectral: colore o disco pelo espectro (bhs_disk_shade_spectral) com
+ *            o g exato do raio, em vez de tingir a cor pelo z do modelo;
+ *            a imagem vira HDR de verdade (o anel mais quente tem Y = 1)
+ * @disk_temperature: anel mais quente no modo espectral, em K
+ *                    (0 = BHS_TRACER_DISK_TEMPERATURE)
+ * @volume: disco grosso e coroa integrados ao longo do raio (volume.h,
+ *          com o mesmo buraco negro de @bh), por cima do disco fino;
+ *          NULL = nenhum. Os raios passam a ir por DOPRI5 em Kerr; com
+ *          BHS_GEO_MODE_METRIC o render falha. O mapa de deflexão e a
+ *          reprojeção temporal guardam só o destino, então
+ *          bhs_tracer_render_cached() e bhs_tracer_render_temporal()
+ *          recusam um volume.
+ */
+struct bhs_tracer_config {
+	int width;
+	int height;
+	int tile_size;
+	int threads;
+	struct bhs_kerr bh;
+	struct bhs_disk disk;
+	struct bhs_tracer_camera camera;
+	struct bhs_geodesic_config geo;
+	int refine_cell;
+	double refine_threshold;
+	bool spectral;
+	double disk_temperature;
+	const struct bhs_volume *volume;
+};
+
+/**
+ * struct bhs_tracer_stats - Contadores de um render
+ * @rays: geodésicas traçadas
+ * @steps: passos de integração somados
+ * @shadow_exits: raios capturados pelo atalho da sombra
+ * @far_field_exits: raios fechados pelo atalho de campo fraco
+ * @volume_samples: amostras do volume dentro de células ocupadas
+ */
+struct bhs_tracer_stats {
+	long rays;
+	long steps;
+	long shadow_exits;
+	long far_field_exits;
+	long volume_samples;
+};
+
+/**
+ * struct bhs_tracer_image - Imagem HDR RGB float, linha 0 no topo
+ */
+struct bhs_tracer_image {
+	int width;
+	int height;
+	float *rgb; /* width * height * 3 */
+	struct bhs_tracer_stats stats;
+};
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_tracer_image_alloc - Aloca imagem zerada
+ *
+ * Retorna: 0 em sucesso, -1 em falha de alocação
+ */
+int bhs_tracer_image_alloc(struct bhs_tracer_image *img, int width,
+			   int height);
+
+/**
+ * bhs_tracer_image_free - Libera pixels da imagem
+ */
+void bhs_tracer_image_free(struct bhs_tracer_image *img);
+
+/**
+ * bhs_tracer_trace_pixel - Cor de um único pixel
+ * @cfg: configuração
+ * @x, @y: coordenadas do pixel (y = 0 no topo); aceita frações
+ *
+ * É o que cada thread chama; exposto para testes e depuração.
+ */
+struct bhs_color_rgb bhs_tracer_trace_pixel(const struct bhs_tracer_config *cfg,
+					    double x, double y);
+
+/**
+ * bhs_tracer_pixel_ray - Raio inicial do pixel (x, y), antes de propagar
+ * @cfg: configuração (câmera e resolução)
+ * @x, @y: coordenadas do pixel (y = 0 no topo); aceita frações
+ * @geo: [out] geodésica na câmera
+ *
+ * O mesmo raio do render: quem lê um mapa de deflexão tira daqui E, L e Q
+ * do pixel (bhs_geodesic_constants) sem traçar de novo.
+ */
+void bhs_tracer_pixel_ray(const struct bhs_tracer_config *cfg, double x,
+			  double y, struct bhs_geodesic *geo);
+
+/**
+ * bhs_tracer_render - Renderiza a imagem completa
+ * @cfg: configuração
+ * @out: [out] imagem (alocada aqui; liberar com bhs_tracer_image_free)
+ *
+ * Retorna: 0 em sucesso, -1 em erro (alocação, threads, volume sem suporte)
+ */
+int bhs_tracer_render(const struct bhs_tracer_config *cfg,
+		      struct bhs_tracer_image *out);
+
+/**
+ * bhs_tracer_write_pfm - Salva em Portable Float Map (RGB, little-endian)
+ *
+ * Retorna: 0 em sucesso, -1 em erro de I/O
+ */
+int bhs_tracer_write_pfm(const struct bhs_tracer_image *img, const char *path);
+
+/* ============================================================================
+ * MAPA DE DEFLEXÃO
+ * ============================================================================
+ */
+
+/**
+ * bhs_tracer_deflection_key - Chave do mapa para @cfg
+ *
+ * Entram spin, câmera, resolução, o anel do disco e tudo de cfg->geo
+ * que muda o destino guardado (modo, passo, tolerâncias, raio de escape,
+ * atalhos, resolução da tabela planar). Não entram mdot e céu; a métrica
+ * tabelada também não, por isso bhs_tracer_render_cached() a recusa.
+ */
+void bhs_tracer_deflection_key(const struct bhs_tracer_config *cfg,
+			       struct bhs_deflection_key *key);
+
+/**
+ * bhs_tracer_build_deflection - Traça todos os pixels e guarda o destino
+ * @cfg: configuração (refine_cell é ignorado: φ não interpola)
+ * @out: [out] mapa em RAM (liberar com bhs_deflection_map_free)
+ *
+ * Retorna: 0 em sucesso, -1 em erro (alocação, threads)
+ */
+int bhs_tracer_build_deflection(const struct bhs_tracer_config *cfg,
+				struct bhs_deflection_map *out);
+
+/**
+ * bhs_tracer_shade - Colore a imagem a partir do mapa, sem geodésicas
+ * @cfg: configuração (disco e céu atuais)
+ * @map: mapa com a mesma resolução de @cfg
+ * @out: [out] imagem
+ *
+ * Bit a bit igual a bhs_tracer_render() sem refinamento.
+ *
+ * Retorna: 0 em sucesso, -1 se a resolução não bate ou faltar memória
+ */
+int bhs_tracer_shade(const struct bhs_tracer_config *cfg,
+		     const struct bhs_deflection_map *map,
+		     struct bhs_tracer_image *out);
+
+/**
+ * bhs_tracer_render_cached - Render usando o cache em @cache_dir
+ * @cfg: configuração
+ * @cache_dir: diretório (já existente) dos arquivos de mapa
+ * @out: [out] imagem; out->stats.rays = 0 quando o mapa veio do cache
+ *
+ * Abre o mapa da chave de @cfg via mmap; se faltar ou não bater, traça,
+ * grava e usa.
+ *
+ * Retorna: 0 em sucesso, -1 em erro ou com BHS_GEO_MODE_METRIC ou volume
+ * (o mapa não os descreve)
+ */
+int bhs_tracer_render_cached(const struct bhs_tracer_config *cfg,
+			     const char *cache_dir,
+			     struct bhs_tracer_image *out);
+
+/* ============================================================================
+ * RENDER PROGRESSIVO
+ * ============================================================================
+ */
+
+/**
+ * bhs_tracer_clock_fn - Relógio em segundos (qualquer origem, monotônico)
+ *
+ * Chamado das threads de trabalho: tem que ser thread-safe.
+ */
+typedef double (*bhs_tracer_clock_fn)(void *user);
+
+/**
+ * struct bhs_tracer_progress - Render progressivo que continua entre quadros
+ * @image: melhor imagem até agora (completa, em baixa resolução, depois
+ *         do primeiro quadro)
+ * @stride: lado do bloco do nível 0, arredondado para baixo a uma
+ *          potência de 2 (0 = BHS_TRACER_PROGRESS_STRIDE); mudar
+ *          recomeça a sequência
+ * @clock: relógio do prazo (NULL = CLOCK_MONOTONIC)
+ * @clock_user: repassado a @clock
+ * @cursor: amostras de @order já traçadas
+ * @order: pixels (y * width + x) na ordem em que são traçados
+ * @level_end: fim de cada nível em @order
+ * @levels: número de níveis
+ * @frame: configuração que @image mostra
+ *
+ * O nível 0 traça um pixel a cada @stride em x e y; o nível k, os pontos
+ * da grade de passo @stride >> k que não estavam na anterior, até o passo
+ * 1. Cada amostra pinta o bloco de lado igual ao passo do seu nível à
+ * direita e abaixo dela, que só contém pixels de níveis mais finos: a
+ * imagem está sempre inteira e cada nível só melhora a anterior. Dentro
+ * de um nível a ordem salta pela razão áurea, então um nível pela metade
+ * já é uniforme na tela, sem faixas.
+ *
+ * Só @stride, @clock e @clock_user são do usuário; o resto é estado.
+ */
+struct bhs_tracer_progress {
+	struct bhs_tracer_image image;
+	int stride;
+	bhs_tracer_clock_fn clock;
+	void *clock_user;
+	long cursor;
+	uint32_t *order;
+	long level_end[BHS_TRACER_PROGRESS_LEVELS];
+	int levels;
+	struct bhs_tracer_config frame;
+};
+
+/**
+ * bhs_tracer_progress_init - Estado vazio (nada traçado)
+ */
+void bhs_tracer_progress_init(struct bhs_tracer_progress *p);
+
+/**
+ * bhs_tracer_progress_free - Libera imagem e sequência
+ *
+ * @stride, @clock e @clock_user ficam; o estado volta ao de _init().
+ */
+void bhs_tracer_progress_free(struct bhs_tracer_progress *p);
+
+/**
+ * bhs_tracer_render_progressive - Refina a imagem até o prazo
+ * @cfg: configuração (refine_cell é ignorado: a ordem já é hierárquica)
+ * @budget: tempo do quadro em segundos (≤ 0 = sem prazo, até o fim)
+ * @p: estado (bhs_tracer_progress_init na primeira vez)
+ *
+ * Com a mesma câmera, spin, resolução, disco e modo de cor do quadro
+ * anterior, continua de onde parou; com outros, recomeça a sequência
+ * sobre a imagem antiga. Outras mudanças (integração, métrica) pedem
+ * bhs_tracer_progress_free() antes.
+ *
+ * O prazo é conferido a cada poucas amostras por thread, e nunca antes
+ * de o nível 0 terminar: o primeiro quadro passa do orçamento se o nível
+ * grosso não couber nele, mas sempre sai com a imagem inteira. O último
+ * nível traça cada pixel como bhs_tracer_render(), então a imagem final
+ * é bit a bit igual à dele sem refinamento. p->image.stats conta só
+ * este quadro.
+ *
+ * Retorna: 1 com a imagem completa, 0 se ainda falta, -1 em erro
+ *          (alocação, threads, volume sem suporte)
+ */
+int bhs_tracer_render_progressive(const struct bhs_tracer_config *cfg,
+				  double budget,
+				  struct bhs_tracer_progress *p);
+
+/* ============================================================================
+ * REPROJEÇÃO TEMPORAL
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_tracer_history_texel - Destino de um pixel de um quadro
+ * @x, @y: como em bhs_deflection_texel, mas com φ (@y) relativo ao
+ *         azimute da câmera
+ * @xi: L/E do raio do pixel
+ * @beta: p_θ/E do raio na câmera
+ * @confidence: perto de 1 quando traçado; cai a cada reprojeção
+ *              interpolada
+ * @status: enum bhs_geodesic_status
+ */
+struct bhs_tracer_history_texel {
+	double x;
+	double y;
+	float xi;
+	float beta;
+	float confidence;
+	uint32_t status;
+};
+
+/**
+ * struct bhs_tracer_history - Quadro anterior, para reprojetar o próximo
+ * @threshold: diferença tolerada entre os quatro pixels antigos em volta
+ *             do ponto reprojetado: |Δr|/r e |Δφ| no disco, ângulo no
+ *             céu (0 = BHS_TRACER_REFINE_THRESHOLD)
+ * @decay: fator da confiança por reprojeção interpolada
+ *         (0 = BHS_TRACER_HISTORY_DECAY)
+ * @min_confidence: abaixo disso o pixel é traçado de novo
+ *                  (0 = BHS_TRACER_HISTORY_MIN_CONFIDENCE)
+ * @frame: configuração do quadro guardado
+ * @texels: destinos do quadro guardado (NULL = nenhum)
+ * @scratch: destinos do quadro em andamento
+ *
+ * Raios com as mesmas constantes (ξ, η) e o mesmo sentido em θ seguem a
+ * mesma órbita em (r, θ) a menos de fase; com a câmera quase parada, o
+ * raio antigo com as constantes do pixel novo é uma boa previsão do
+ * destino dele. Cada pixel novo acha esse raio no quadro antigo (Newton
+ * sobre o ξ e o β guardados, com β reescrito para a inclinação antiga) e
+ * interpola o destino dos quatro vizinhos, se eles concordam. Girar só o
+ * azimute é exato (Kerr é axissimétrico): o ponto cai em cima de um
+ * pixel antigo, que é copiado sem perder confiança.
+ *
+ * Só @threshold, @decay e @min_confidence são do usuário.
+ */
+struct bhs_tracer_history {
+	double threshold;
+	double decay;
+	double min_confidence;
+	struct bhs_tracer_config frame;
+	struct bhs_tracer_history_texel *texels;
+	struct bhs_tracer_history_texel *scratch;
+};
+
+/**
+ * bhs_tracer_history_init - Histórico vazio
+ */
+void bhs_tracer_history_init(struct bhs_tracer_history *h);
+
+/**
+ * bhs_tracer_history_free - Libera os quadros (os parâmetros ficam)
+ */
+void bhs_tracer_history_free(struct bhs_tracer_history *h);
+
+/**
+ * bhs_tracer_render_temporal - Render que reprojeta o quadro anterior
+ * @cfg: configuração (refine_cell é ignorado)
+ * @h: histórico (bhs_tracer_history_init na primeira vez); guarda este
+ *     quadro ao sair
+ * @out: [out] imagem; out->stats conta só os pixels traçados de novo
+ *
+ * Sem histórico, ou se algo além da câmera e do modelo de cor mudou
+ * (buraco negro, disco, resolução, integração, métrica), traça tudo e
+ * sai bit a bit igual a bhs_tracer_render() sem refinamento. Pixels
+ * traçados também saem iguais aos dele; os reprojetados, com o erro da
+ * interpolação.
+ *
+ * Retorna: 0 em sucesso, -1 em erro (alocação, threads, cfg->volume)
+ */
+int bhs_tracer_render_temporal(const struct bhs_tracer_config *cfg,
+			       struct bhs_tracer_history *h,
+			       struct bhs_tracer_image *out);
+
+#endif /* BHS_ENGINE_RENDER_TRACER_H */
@@ -0,0 +1,359 @@
+/**
+ * @file transfer.c
+ * @brief Montagem, convolução e arquivo das funções de transferência
+ *
+ * "Sessenta e cinco mil geodésicas para responder uma pergunta que
+ * cabe em trinta e dois KB. Depois disso, é só multiplicar."
+ */
+
+#define _GNU_SOURCE
+#include "transfer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/components/disk/disk.h"
+#include "engine/render/tracer.h"
+
+/* Índice e pesos começam alinhados em linha de cache */
+#define DATA_ALIGN 64
+
+/* Limite de sanidade das dimensões lidas do arquivo */
+#define MAX_BINS 65536
+
+static size_t weight_count(const struct bhs_transfer_key *key)
+{
+	return (size_t)key->radii * (size_t)key->gbins;
+}
+
+static uint64_t align_up(uint64_t x)
+{
+	return (x + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+}
+
+/* ============================================================================
+ * CONSTRUÇÃO
+ * ============================================================================
+ */
+
+/* Anel do raio r, uniforme em log r; -1 fora de [r_in, r_out] */
+static int radius_bin(const struct bhs_transfer_key *key, double r)
+{
+	if (!(r >= key->r_in && r <= key->r_out))
+		return -1;
+
+	int k = (int)(log(r / key->r_in) / log(key->r_out / key->r_in) *
+		      key->radii);
+	return k < key->radii ? k : key->radii - 1;
+}
+
+static int g_bin(const struct bhs_transfer_key *key, double g)
+{
+	double span = key->g_hi - key->g_lo;
+	int j = span > 0.0 ? (int)((g - key->g_lo) / span * key->gbins) : 0;
+	return j < 0 ? 0 : (j < key->gbins ? j : key->gbins - 1);
+}
+
+int bhs_transfer_build(const struct bhs_transfer_config *cfg,
+		       struct bhs_transfer_table *out)
+{
+	memset(out, 0, sizeof(*out));
+
+	int res = cfg->resolution > 0 ? cfg->resolution
+				      : BHS_TRANSFER_RESOLUTION;
+	double D = cfg->distance > 0.0 ? cfg->distance : BHS_TRANSFER_DISTANCE;
+	double r_in = cfg->r_in > 0.0 ? cfg->r_in : bhs_disk_isco(&cfg->bh);
+
+	struct bhs_transfer_key key = {
+		.M = cfg->bh.M,
+		.a = cfg->bh.a,
+		.inclination = cfg->inclination,
+		.r_in = r_in,
+		.r_out = cfg->r_out,
+		.radii = cfg->radii > 0 ? cfg->radii : BHS_TRANSFER_RADII,
+		.gbins = cfg->gbins > 0 ? cfg->gbins : BHS_TRANSFER_GBINS,
+	};
+	if (!(key.r_out > r_in) || !(D > key.r_out))
+		return -1;
+
+	struct bhs_tracer_config tc = {
+		.width = res,
+		.height = res,
+		.threads = cfg->threads,
+		.bh = cfg->bh,
+		.disk = { .inner_radius = r_in, .outer_radius = key.r_out },
+		.camera = {
+			.distance = D,
+			.inclination = cfg->inclination,
+			.fov = 2.0 * atan(1.1 * key.r_out / D),
+		},
+		.geo = cfg->geo,
+	};
+
+	struct bhs_deflection_map map;
+	if (bhs_tracer_build_deflection(&tc, &map) != 0)
+		return -1;
+
+	size_t n = (size_t)res * (size_t)res;
+	double *g = malloc(n * sizeof(*g));
+	out->owned = calloc(weight_count(&key), sizeof(*out->owned));
+	if (!g || !out->owned) {
+		free(g);
+		bhs_deflection_map_free(&map);
+		bhs_transfer_table_free(out);
+		return -1;
+	}
+
+	/* g de cada pixel que bateu no disco (0 nos outros) e a faixa */
+	key.g_lo = INFINITY;
+	key.g_hi = -INFINITY;
+	for (size_t i = 0; i < n; i++) {
+		const struct bhs_deflection_texel *tx = &map.texels[i];
+		g[i] = 0.0;
+		if (tx->status != BHS_GEO_HIT_DISK)
+			continue;
+
+		struct bhs_geodesic geo;
+		struct bhs_geodesic_constants c;
+		bhs_tracer_pixel_ray(&tc, (double)(i % res), (double)(i / res),
+				     &geo);
+		bhs_geodesic_constants(&geo, &cfg->bh, &c);
+
+		g[i] = bhs_disk_g_factor(&cfg->bh, tx->x, c.L / c.E);
+		if (g[i] > 0.0) {
+			key.g_lo = fmin(key.g_lo, g[i]);
+			key.g_hi = fmax(key.g_hi, g[i]);
+		}
+	}
+	if (!(key.g_hi >= key.g_lo)) {
+		/* Nenhum pixel no disco: tabela zerada com faixa qualquer */
+		key.g_lo = 0.0;
+		key.g_hi = 1.0;
+	}
+
+	/*
+	 * Pinhole de bhs_geodesic_ray_from_camera: o pixel cobre (dX, dY)
+	 * no plano tangente, X = u tan(fov/2), e subtende
+	 * dΩ = dX dY / (1 + X² + Y²)^(3/2). A área no plano da imagem é D² dΩ.
+	 */
+	double tan_half = tan(0.5 * tc.camera.fov);
+	double d = 2.0 * tan_half / res;
+	for (size_t i = 0; i < n; i++) {
+		int k = g[i] > 0.0 ? radius_bin(&key, map.texels[i].x) : -1;
+		if (k < 0)
+			continue;
+
+		double X = ((double)(i % res) + 0.5) * d - tan_half;
+		double Y = tan_half - ((double)(i / res) + 0.5) * d;
+		double s = 1.0 + X * X + Y * Y;
+		double area = D * D * d * d / (s * sqrt(s));
+
+		out->owned[(size_t)k * key.gbins + g_bin(&key, g[i])] +=
+			(float)area;
+	}
+
+	free(g);
+	bhs_deflection_map_free(&map);
+	out->key = key;
+	out->weights = out->owned;
+	return 0;
+}
+
+void bhs_transfer_table_free(struct bhs_transfer_table *t)
+{
+	free(t->owned);
+	memset(t, 0, sizeof(*t));
+}
+
+/* ============================================================================
+ * CONVOLUÇÃO
+ * ============================================================================
+ */
+
+double bhs_transfer_radius(const struct bhs_transfer_table *t, int k)
+{
+	const struct bhs_transfer_key *key = &t->key;
+	return key->r_in *
+	       pow(key->r_out / key->r_in, (k + 0.5) / key->radii);
+}
+
+double bhs_transfer_g(const struct bhs_transfer_table *t, int j)
+{
+	const struct bhs_transfer_key *key = &t->key;
+	return key->g_lo + (j + 0.5) * (key->g_hi - key->g_lo) / key->gbins;
+}
+
+void bhs_transfer_line(const struct bhs_transfer_table *t,
+		       bhs_transfer_emissivity_fn emissivity, void *user,
+		       double *out)
+{
+	const struct bhs_transfer_key *key = &t->key;
+	double dg = (key->g_hi - key->g_lo) / key->gbins;
+
+	for (int j = 0; j < key->gbins; j++)
+		out[j] = 0.0;
+
+	for (int k = 0; k < key->radii; k++) {
+		const float *w = t->weights + (size_t)k * key->gbins;
+		double eps = emissivity(bhs_transfer_radius(t, k), user);
+		for (int j = 0; j < key->gbins; j++)
+			out[j] += w[j] * eps;
+	}
+
+	for (int j = 0; j < key->gbins; j++) {
+		double g = bhs_transfer_g(t, j);
+		out[j] *= g * g * g * g / dg;
+	}
+}
+
+void bhs_transfer_spectrum(const struct bhs_transfer_table *t,
+			   bhs_transfer_intensity_fn intensity, void *user,
+			   const double *nu, int n, double *out)
+{
+	const struct bhs_transfer_key *key = &t->key;
+
+	for (int i = 0; i < n; i++)
+		out[i] = 0.0;
+
+	for (int k = 0; k < key->radii; k++) {
+		const float *w = t->weights + (size_t)k * key->gbins;
+		double r = bhs_transfer_radius(t, k);
+
+		for (int j = 0; j < key->gbins; j++) {
+			if (w[j] == 0.0f)
+				continue;
+
+			double g = bhs_transfer_g(t, j);
+			double wg3 = w[j] * g * g * g;
+			for (int i = 0; i < n; i++)
+				out[i] += wg3 * intensity(r, nu[i] / g, user);
+		}
+	}
+}
+
+/* ============================================================================
+ * ARQUIVO
+ * ============================================================================
+ */
+
+int bhs_transfer_save(const char *path, const struct bhs_transfer_table *tables,
+		      int count)
+{
+	struct bhs_atomic_file af;
+	if (count < 0 || bhs_atomic_file_create(&af, path) != 0)
+		return -1;
+	FILE *f = af.f;
+
+	struct bhs_transfer_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, BHS_TRANSFER_MAGIC, sizeof(BHS_TRANSFER_MAGIC));
+	hdr.version = BHS_TRANSFER_VERSION;
+	hdr.count = (uint32_t)count;
+	hdr.index_offset = align_up(sizeof(hdr));
+
+	static const char zeros[DATA_ALIGN];
+	uint64_t at = align_up(hdr.index_offset +
+			       (uint64_t)count *
+				       sizeof(struct bhs_transfer_entry));
+
+	int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+		 fwrite(zeros, 1, hdr.index_offset - sizeof(hdr), f) ==
+			 hdr.index_offset - sizeof(hdr);
+
+	/* Índice primeiro: os offsets já são conhecidos */
+	uint64_t pos = hdr.index_offset;
+	for (int i = 0; i < count && ok; i++) {
+		struct bhs_transfer_entry e;
+		memset(&e, 0, sizeof(e));
+		e.key = tables[i].key;
+		e.offset = at;
+		at = align_up(at + weight_count(&e.key) * sizeof(float));
+		ok = fwrite(&e, sizeof(e), 1, f) == 1;
+		pos += sizeof(e);
+	}
+
+	for (int i = 0; i < count && ok; i++) {
+		size_t pad = (size_t)(align_up(pos) - pos);
+		size_t w = weight_count(&tables[i].key);
+		ok = fwrite(zeros, 1, pad, f) == pad &&
+		     fwrite(tables[i].weights, sizeof(float), w, f) == w;
+		pos += pad + w * sizeof(float);
+	}
+
+	return bhs_atomic_file_commit(&af, ok);
+}
+
+int bhs_transfer_file_open(struct bhs_transfer_file *f, const char *path)
+{
+	memset(f, 0, sizeof(*f));
+	if (bhs_mapped_file_open(&f->file, path) != 0)
+		return -1;
+
+	const struct bhs_transfer_header *hdr = f->file.data;
+	uint64_t size = f->file.size;
+	if (size < sizeof(*hdr) ||
+	    memcmp(hdr->magic, BHS_TRANSFER_MAGIC,
+		   sizeof(BHS_TRANSFER_MAGIC)) != 0 ||
+	    hdr->version != BHS_TRANSFER_VERSION ||
+	    hdr->index_offset != align_up(sizeof(*hdr)) ||
+	    (size - hdr->index_offset) / sizeof(struct bhs_transfer_entry) <
+		    hdr->count)
+		goto fail;
+
+	f->index = (const struct bhs_transfer_entry
+			    *)((const char *)f->file.data + hdr->index_offset);
+	f->count = hdr->count;
+
+	for (uint32_t i = 0; i < f->count; i++) {
+		const struct bhs_transfer_entry *e = &f->index[i];
+		if (e->key.radii <= 0 || e->key.radii > MAX_BINS ||
+		    e->key.gbins <= 0 || e->key.gbins > MAX_BINS ||
+		    e->offset % DATA_ALIGN != 0 || e->offset > size ||
+		    (size - e->offset) / sizeof(float) < weight_count(&e->key))
+			goto fail;
+	}
+	return 0;
+
+fail:
+	bhs_transfer_file_close(f);
+	return -1;
+}
+
+void bhs_transfer_file_close(struct bhs_transfer_file *f)
+{
+	bhs_mapped_file_close(&f->file);
+	memset(f, 0, sizeof(*f));
+}
+
+int bhs_transfer_file_find(const struct bhs_transfer_file *f, double chi,
+			   double inclination)
+{
+	int best = -1;
+	double best_d = INFINITY;
+
+	for (uint32_t i = 0; i < f->count; i++) {
+		const struct bhs_transfer_key *key = &f->index[i].key;
+		double d = fabs(key->a / key->M - chi) +
+			   fabs(key->inclination - inclination);
+		if (d < best_d) {
+			best_d = d;
+			best = (int)i;
+		}
+	}
+	return best;
+}
+
+int bhs_transfer_file_get(const struct bhs_transfer_file *f, int i,
+			  struct bhs_transfer_table *out)
+{
+	memset(out, 0, sizeof(*out));
+	if (i < 0 || (uint32_t)i >= f->count)
+		return -1;
+
+	out->key = f->index[i].key;
+	out->weights = (const float *)((const char *)f->file.data +
+				       f->index[i].offset);
+	return 0;
+}
@@ -0,0 +1,289 @@
+/**
+ * @file transfer.h
+ * @brief Funções de transferência de Cunningham para espectros do disco
+ *
+ * "Ajustar espectro traçando imagem é como medir a febre fazendo
+ * ressonância. Funciona. Demora."
+ *
+ * Com spin e inclinação fixos, o que a lente faz com o disco se resume a
+ * quanto do céu do observador cada anel ocupa e com que g = ν_obs / ν_emit
+ * (Cunningham 1975). Este módulo traça uma imagem uma vez (pelo mapa de
+ * deflexão do tracer), guarda a área no plano da imagem por (raio de
+ * emissão, g) e daí qualquer lei de emissividade vira espectro ou perfil
+ * de linha por uma soma de poucos milhares de termos, sem geodésica.
+ *
+ * Fluxo observado a uma distância D ≫ M:
+ *   F_ν(ν) = (1 / D²) Σ_k Σ_j W[k][j] g_j³ I_ν(r_k, ν / g_j)
+ * com W em M² (área no plano da imagem) e I_ν a intensidade emitida.
+ *
+ * Várias tabelas (uma varredura de spin e inclinação) vão num arquivo só:
+ *   struct bhs_transfer_header
+ *   struct bhs_transfer_entry[count]            (índice, em index_offset)
+ *   float[radii][gbins] por entrada            (em entry.offset)
+ * aberto por mmap como o mapa de deflexão (deflection_cache.h).
+ */
+
+#ifndef BHS_ENGINE_RENDER_TRANSFER_H
+#define BHS_ENGINE_RENDER_TRANSFER_H
+
+#include <stdint.h>
+
+#include "engine/assets/mapped_file.h"
+#include "engine/physics/geodesic/geodesic.h"
+#include "math/spacetime/kerr.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Assinatura do arquivo */
+#define BHS_TRANSFER_MAGIC "BHSXFER"
+
+/** Versão do formato */
+#define BHS_TRANSFER_VERSION 1
+
+/** Anéis de emissão padrão (uniformes em log r) */
+#define BHS_TRANSFER_RADII 64
+
+/** Faixas de g padrão */
+#define BHS_TRANSFER_GBINS 128
+
+/** Pixels por lado padrão da imagem traçada */
+#define BHS_TRANSFER_RESOLUTION 256
+
+/** Distância padrão do observador (em M) */
+#define BHS_TRANSFER_DISTANCE 1000.0
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_transfer_config - O que traçar para uma tabela
+ * @bh: buraco negro
+ * @inclination: inclinação do observador (rad, 0 = face-on)
+ * @r_in: borda interna (0 = ISCO)
+ * @r_out: borda externa
+ * @distance: distância da câmera (0 = BHS_TRANSFER_DISTANCE)
+ * @resolution: pixels por lado (0 = BHS_TRANSFER_RESOLUTION)
+ * @radii, @gbins: tamanho da tabela (0 = padrões)
+ * @threads: threads do traçado (0 = núcleos online)
+ * @geo: integração (o anel do disco vem de @r_in, @r_out); com a câmera
+ *       longe, use tolerance > 0 e far_field_radius
+ */
+struct bhs_transfer_config {
+	struct bhs_kerr bh;
+	double inclination;
+	double r_in;
+	double r_out;
+	double distance;
+	int resolution;
+	int radii;
+	int gbins;
+	int threads;
+	struct bhs_geodesic_config geo;
+};
+
+/**
+ * struct bhs_transfer_key - Parâmetros de uma tabela
+ * @M, @a, @inclination: buraco negro e observador
+ * @r_in, @r_out: anéis k = 0..radii-1, de r_in a r_out em log r
+ * @g_lo, @g_hi: faixas j = 0..gbins-1, uniformes em g
+ * @radii, @gbins: dimensões
+ *
+ * Só doubles e int32 sem buracos, como bhs_deflection_key.
+ */
+struct bhs_transfer_key {
+	double M;
+	double a;
+	double inclination;
+	double r_in;
+	double r_out;
+	double g_lo;
+	double g_hi;
+	int32_t radii;
+	int32_t gbins;
+};
+
+/**
+ * struct bhs_transfer_table - Uma função de transferência
+ * @key: parâmetros
+ * @weights: W[k][j], área no plano da imagem (M²) dos pixels que veem o
+ *           anel k com g na faixa j (radii * gbins)
+ * @owned: buffer alocado (NULL se @weights aponta para um arquivo)
+ */
+struct bhs_transfer_table {
+	struct bhs_transfer_key key;
+	const float *weights;
+	float *owned;
+};
+
+/**
+ * struct bhs_transfer_header - Cabeçalho no disco
+ * @magic: BHS_TRANSFER_MAGIC com NUL
+ * @version: BHS_TRANSFER_VERSION
+ * @count: tabelas no arquivo
+ * @index_offset: início do índice
+ */
+struct bhs_transfer_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t count;
+	uint64_t index_offset;
+};
+
+/**
+ * struct bhs_transfer_entry - Entrada do índice
+ * @key: parâmetros da tabela
+ * @offset: início dos pesos no arquivo (alinhado em 64)
+ */
+struct bhs_transfer_entry {
+	struct bhs_transfer_key key;
+	uint64_t offset;
+};
+
+/**
+ * struct bhs_transfer_file - Arquivo de tabelas mapeado
+ * @index: entradas
+ * @count: número de entradas
+ * @file: mapeamento
+ */
+struct bhs_transfer_file {
+	const struct bhs_transfer_entry *index;
+	uint32_t count;
+	struct bhs_mapped_file file;
+};
+
+/**
+ * bhs_transfer_emissivity_fn - Emissividade de linha no raio r
+ */
+typedef double (*bhs_transfer_emissivity_fn)(double r, void *user);
+
+/**
+ * bhs_transfer_intensity_fn - Intensidade emitida I_ν no raio r
+ */
+typedef double (*bhs_transfer_intensity_fn)(double r, double nu, void *user);
+
+/* ============================================================================
+ * CONSTRUÇÃO
+ * ============================================================================
+ */
+
+/**
+ * bhs_transfer_build - Traça uma imagem e monta a tabela
+ * @cfg: configuração
+ * @out: [out] tabela (liberar com bhs_transfer_table_free)
+ *
+ * Usa bhs_tracer_build_deflection() para saber onde cada pixel bate e
+ * bhs_tracer_pixel_ray() para o ξ do pixel; g sai de bhs_disk_g_factor().
+ * A faixa de g é a dos pixels que bateram. O campo de visão cobre
+ * 1.1 r_out em volta do centro.
+ *
+ * Retorna: 0 em sucesso, -1 em erro (parâmetros, alocação, threads)
+ */
+int bhs_transfer_build(const struct bhs_transfer_config *cfg,
+		       struct bhs_transfer_table *out);
+
+/**
+ * bhs_transfer_table_free - Libera o buffer próprio (não mexe em arquivo)
+ */
+void bhs_transfer_table_free(struct bhs_transfer_table *t);
+
+/* ============================================================================
+ * CONVOLUÇÃO
+ * ============================================================================
+ */
+
+/**
+ * bhs_transfer_radius - Raio central do anel @k (média geométrica)
+ */
+double bhs_transfer_radius(const struct bhs_transfer_table *t, int k);
+
+/**
+ * bhs_transfer_g - g central da faixa @j
+ */
+double bhs_transfer_g(const struct bhs_transfer_table *t, int j);
+
+/**
+ * bhs_transfer_line - Perfil de uma linha estreita
+ * @t: tabela
+ * @emissivity: ε(r) da linha, por unidade de área do disco
+ * @user: repassado a @emissivity
+ * @out: [out] gbins valores: fluxo por unidade de g na faixa j,
+ *       Σ_k W[k][j] g_j⁴ ε(r_k) / Δg (vezes D² / ν₀)
+ *
+ * Uma chamada de @emissivity por anel; o resto são radii * gbins somas.
+ */
+void bhs_transfer_line(const struct bhs_transfer_table *t,
+		       bhs_transfer_emissivity_fn emissivity, void *user,
+		       double *out);
+
+/**
+ * bhs_transfer_spectrum - Espectro do disco
+ * @t: tabela
+ * @intensity: I_ν(r, ν_emit) emitida
+ * @user: repassado a @intensity
+ * @nu: frequências observadas
+ * @n: número de frequências
+ * @out: [out] F_ν(nu[i]) · D²
+ *
+ * Células com peso zero (quase todas: cada anel só vê uma faixa de g)
+ * não chamam @intensity.
+ */
+void bhs_transfer_spectrum(const struct bhs_transfer_table *t,
+			   bhs_transfer_intensity_fn intensity, void *user,
+			   const double *nu, int n, double *out);
+
+/* ============================================================================
+ * ARQUIVO
+ * ============================================================================
+ */
+
+/**
+ * bhs_transfer_save - Grava várias tabelas num arquivo indexado
+ * @path: arquivo (escrito num temporário próprio e renomeado)
+ * @tables: tabelas
+ * @count: número de tabelas
+ *
+ * Retorna: 0 em sucesso, -1 em erro de I/O
+ */
+int bhs_transfer_save(const char *path, const struct bhs_transfer_table *tables,
+		      int count);
+
+/**
+ * bhs_transfer_file_open - Mapeia um arquivo de tabelas
+ *
+ * Valida assinatura, versão e que índice e pesos cabem no arquivo.
+ *
+ * Retorna: 0 em sucesso, -1 se ausente ou corrompido
+ */
+int bhs_transfer_file_open(struct bhs_transfer_file *f, const char *path);
+
+/**
+ * bhs_transfer_file_close - Desfaz o mapeamento
+ *
+ * Tabelas obtidas de bhs_transfer_file_get() deixam de valer.
+ */
+void bhs_transfer_file_close(struct bhs_transfer_file *f);
+
+/**
+ * bhs_transfer_file_find - Entrada mais próxima de (a/M, inclinação)
+ *
+ * Distância |Δχ| + |Δi| (i em rad).
+ *
+ * Retorna: índice, ou -1 com arquivo vazio
+ */
+int bhs_transfer_file_find(const struct bhs_transfer_file *f, double chi,
+			   double inclination);
+
+/**
+ * bhs_transfer_file_get - Tabela @i, apontando para o mmap (sem cópia)
+ *
+ * Retorna: 0 em sucesso, -1 com @i fora do índice
+ */
+int bhs_transfer_file_get(const struct bhs_transfer_file *f, int i,
+			  struct bhs_transfer_table *out);
+
+#endif /* BHS_ENGINE_RENDER_TRANSFER_H */
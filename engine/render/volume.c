@@ -0,0 +1,389 @@
+/**
+ * @file volume.c
+ * @brief Transferência radiativa em disco grosso e coroa
+ *
+ * "Espaço vazio é de graça. Só a matéria cobra por amostra."
+ */
+
+#define _GNU_SOURCE /* Para M_PI */
+
+#include "volume.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MEIO
+ * ============================================================================
+ */
+
+/* Alturas de escala até o perfil gaussiano cair abaixo do corte */
+static double disk_cut(void)
+{
+	return sqrt(-2.0 * log(BHS_VOLUME_DENSITY_CUTOFF));
+}
+
+double bhs_volume_density(const struct bhs_volume_component *c, double r,
+			  double theta)
+{
+	if (r < c->r_in || r > c->r_out)
+		return 0.0;
+
+	double rho = pow(r / c->r_in, -c->power);
+	if (c->shape == BHS_VOLUME_THICK_DISK) {
+		double u = cos(theta) / c->h_over_r;
+		rho *= exp(-0.5 * u * u);
+	}
+	return rho >= BHS_VOLUME_DENSITY_CUTOFF ? rho : 0.0;
+}
+
+/* Máximo de bhs_volume_density na célula [r0, r1] x [t0, t1] (exato) */
+static double cell_max_density(const struct bhs_volume_component *c,
+			       double r0, double r1, double t0, double t1)
+{
+	double lo = fmax(r0, c->r_in);
+	double hi = fmin(r1, c->r_out);
+	if (lo > hi)
+		return 0.0;
+
+	/* Lei de potência é monotônica: o máximo está numa ponta */
+	double rho = fmax(pow(lo / c->r_in, -c->power),
+			  pow(hi / c->r_in, -c->power));
+	if (c->shape == BHS_VOLUME_THICK_DISK) {
+		double cmin = t0 <= M_PI_2 && t1 >= M_PI_2
+				      ? 0.0
+				      : fmin(fabs(cos(t0)), fabs(cos(t1)));
+		double u = cmin / c->h_over_r;
+		rho *= exp(-0.5 * u * u);
+	}
+	return rho;
+}
+
+/**
+ * emitter_g - g = ν_obs / ν_emit de um emissor do componente em (r, θ)
+ *
+ * Disco grosso: órbita kepleriana do raio r (bhs_disk_g_factor, fórmula
+ * equatorial também fora do plano). Coroa: ZAMO, u = e^-ν (1, 0, 0, ω),
+ * então -p_μ u^μ = E e^-ν (1 - ω ξ).
+ *
+ * Retorna: g, ou 0 onde o emissor não existe
+ */
+static double emitter_g(const struct bhs_volume *vol,
+			const struct bhs_volume_component *c, double xi,
+			double r, double theta)
+{
+	if (c->shape == BHS_VOLUME_THICK_DISK)
+		return bhs_disk_g_factor(&vol->bh, r, xi);
+
+	double M = vol->bh.M;
+	double a = vol->bh.a;
+	double ct = cos(theta);
+	double r2a2 = r * r + a * a;
+	double sigma = r * r + a * a * ct * ct;
+	double delta = r2a2 - 2.0 * M * r;
+	if (delta <= 0.0)
+		return 0.0;
+
+	double A = r2a2 * r2a2 - a * a * delta * (1.0 - ct * ct);
+	double omega = 2.0 * M * a * r / A;
+	double g = sqrt(sigma * delta / A) / (1.0 - omega * xi);
+	return g > 0.0 ? g : 0.0;
+}
+
+/* ============================================================================
+ * CASCA E GRADE
+ * ============================================================================
+ */
+
+int bhs_volume_init(struct bhs_volume *vol)
+{
+	bool occupied[BHS_VOLUME_GRID][BHS_VOLUME_GRID];
+	int n = BHS_VOLUME_GRID;
+
+	if (vol->count <= 0 || vol->count > BHS_VOLUME_MAX_COMPONENTS)
+		return -1;
+
+	vol->r_min = INFINITY;
+	vol->r_max = 0.0;
+	vol->cos_max = 0.0;
+	for (int k = 0; k < vol->count; k++) {
+		const struct bhs_volume_component *c = &vol->comp[k];
+
+		if (!(c->r_in > 0.0) || !(c->r_out > c->r_in))
+			return -1;
+		if (c->shape == BHS_VOLUME_THICK_DISK && !(c->h_over_r > 0.0))
+			return -1;
+
+		vol->r_min = fmin(vol->r_min, c->r_in);
+		vol->r_max = fmax(vol->r_max, c->r_out);
+		vol->cos_max = fmax(vol->cos_max,
+				    c->shape == BHS_VOLUME_THICK_DISK
+					    ? fmin(1.0, c->h_over_r * disk_cut())
+					    : 1.0);
+	}
+	vol->theta_lo = acos(vol->cos_max);
+
+	double cr = (vol->r_max - vol->r_min) / n;
+	double ct = (M_PI - 2.0 * vol->theta_lo) / n;
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			double r0 = vol->r_min + i * cr;
+			double t0 = vol->theta_lo + j * ct;
+			double rho = 0.0;
+
+			for (int k = 0; k < vol->count; k++)
+				rho = fmax(rho, cell_max_density(&vol->comp[k],
+								 r0, r0 + cr,
+								 t0, t0 + ct));
+			occupied[i][j] = rho >= BHS_VOLUME_DENSITY_CUTOFF;
+		}
+	}
+
+	/* Grade pequena e montada uma vez: força bruta basta */
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			int d = UINT8_MAX;
+			for (int p = 0; p < n; p++) {
+				for (int q = 0; q < n; q++) {
+					if (!occupied[p][q])
+						continue;
+					int dp = abs(p - i);
+					int dq = abs(q - j);
+					int dc = dp > dq ? dp : dq;
+					if (dc < d)
+						d = dc;
+				}
+			}
+			vol->dist[i][j] = (uint8_t)d;
+		}
+	}
+	return 0;
+}
+
+/* Fração máxima de um passo do integrador que um salto cobre */
+#define SKIP_FRACTION 0.25
+
+/**
+ * struct free_box - Região (r, θ) sem matéria em volta de um ponto
+ */
+struct free_box {
+	double r_lo, r_hi;
+	double t_lo, t_hi;
+};
+
+/**
+ * free_lambda - Quanto λ dá para andar sem encostar em matéria
+ * @box: [out] a região vazia usada na estimativa
+ *
+ * Fora da casca, a caixa livre vai até a borda da casca que deixa o ponto
+ * de fora (r ou θ, a que render mais). Dentro, é a caixa de células
+ * vazias garantida pela distância da grade. A caixa vira λ em 1ª ordem
+ * pela velocidade em r e θ: perto de um ponto de retorno isso superestima,
+ * e quem chama confere o destino (in_box).
+ */
+static double free_lambda(const struct bhs_volume *vol,
+			  const struct bhs_vec4 *pos,
+			  const struct bhs_vec4 *vel, struct free_box *box)
+{
+	double r = pos->x;
+	double th = pos->y;
+	double vr = fabs(vel->x);
+	double vt = fabs(vel->y);
+	double th_hi = M_PI - vol->theta_lo;
+
+	*box = (struct free_box){ -INFINITY, INFINITY, -INFINITY, INFINITY };
+
+	bool out_r = r < vol->r_min || r > vol->r_max;
+	bool out_t = th < vol->theta_lo || th > th_hi;
+	if (out_r || out_t) {
+		double lr = 0.0, lt = 0.0;
+		if (out_r)
+			lr = (r > vol->r_max ? r - vol->r_max
+					     : vol->r_min - r) / vr;
+		if (out_t)
+			lt = (th < vol->theta_lo ? vol->theta_lo - th
+						 : th - th_hi) / vt;
+		if (lr >= lt) {
+			if (r > vol->r_max)
+				box->r_lo = vol->r_max;
+			else
+				box->r_hi = vol->r_min;
+		} else {
+			if (th < vol->theta_lo)
+				box->t_hi = vol->theta_lo;
+			else
+				box->t_lo = th_hi;
+		}
+		return fmax(lr, lt);
+	}
+
+	int n = BHS_VOLUME_GRID;
+	double cr = (vol->r_max - vol->r_min) / n;
+	double ct = (th_hi - vol->theta_lo) / n;
+	double fr = (r - vol->r_min) / cr;
+	double ft = (th - vol->theta_lo) / ct;
+	int i = fr < n ? (int)fr : n - 1;
+	int j = ft < n ? (int)ft : n - 1;
+	int d = vol->dist[i][j];
+	if (d == 0)
+		return 0.0;
+
+	/* Células i-(d-1) .. i+(d-1) (e idem em θ) estão todas vazias */
+	box->r_lo = vol->r_min + (i - d + 1) * cr;
+	box->r_hi = vol->r_min + (i + d) * cr;
+	box->t_lo = vol->theta_lo + (j - d + 1) * ct;
+	box->t_hi = vol->theta_lo + (j + d) * ct;
+
+	/* d - 1 células inteiras vazias em volta, mais o resto da própria */
+	double dr = (d - 1 + fmin(fr - i, i + 1 - fr)) * cr;
+	double dt = (d - 1 + fmin(ft - j, j + 1 - ft)) * ct;
+	return fmin(dr / vr, dt / vt);
+}
+
+/* O raio ainda está em @box em @lambda? */
+static bool in_box(const struct bhs_geodesic_stepper *st, double lambda,
+		   const struct free_box *box)
+{
+	struct bhs_vec4 pos, vel;
+	bhs_geodesic_dense_eval(st, lambda, &pos, &vel);
+	return pos.x >= box->r_lo && pos.x <= box->r_hi &&
+	       pos.y >= box->t_lo && pos.y <= box->t_hi;
+}
+
+/* ============================================================================
+ * TRANSFERÊNCIA
+ * ============================================================================
+ */
+
+bool bhs_volume_supports(const struct bhs_geodesic_config *gc)
+{
+	return gc->mode != BHS_GEO_MODE_METRIC;
+}
+
+int bhs_volume_ray_attach(struct bhs_volume_ray *ray,
+			  const struct bhs_volume *vol,
+			  const struct bhs_geodesic *geo,
+			  struct bhs_geodesic_config *gc)
+{
+	if (!bhs_volume_supports(gc))
+		return -1;
+
+	struct bhs_geodesic_constants k;
+	bhs_geodesic_constants(geo, &vol->bh, &k);
+
+	memset(ray, 0, sizeof(*ray));
+	ray->vol = vol;
+	ray->E = k.E;
+	ray->xi = k.L / k.E;
+	ray->transmittance = 1.0;
+
+	gc->mode = BHS_GEO_MODE_CHRISTOFFEL;
+	if (gc->tolerance <= 0.0)
+		gc->tolerance = BHS_VOLUME_TOLERANCE;
+
+	/* A sombra antecipa a captura abaixo do disco (ou logo de cara) */
+	double capture_r = gc->disk_outer > 0.0 ? gc->disk_inner : INFINITY;
+	if (vol->r_min < capture_r)
+		gc->shadow_capture = false;
+	if (gc->far_field_radius > 0.0)
+		gc->far_field_radius = fmax(gc->far_field_radius, vol->r_max);
+
+	gc->on_step = bhs_volume_ray_step;
+	gc->step_userdata = ray;
+	return 0;
+}
+
+/**
+ * sample - Soma o trecho de @dlam em @pos (j e α constantes no trecho)
+ *
+ * Cada componente tem o próprio referencial: dl = (E / g) dλ é medido
+ * no do emissor, e a emissão chega com g⁴.
+ */
+static void sample(struct bhs_volume_ray *ray, const struct bhs_vec4 *pos,
+		   double dlam)
+{
+	const struct bhs_volume *vol = ray->vol;
+	double tau = 0.0;
+	double em[3] = { 0.0, 0.0, 0.0 };
+
+	ray->samples++;
+	for (int k = 0; k < vol->count; k++) {
+		const struct bhs_volume_component *c = &vol->comp[k];
+		double rho = bhs_volume_density(c, pos->x, pos->y);
+		if (rho == 0.0)
+			continue;
+
+		double g = emitter_g(vol, c, ray->xi, pos->x, pos->y);
+		if (!(g > 0.0))
+			continue;
+
+		double dl = ray->E / g * dlam;
+		double g2 = g * g;
+		double w = c->emissivity * rho * g2 * g2 * dl;
+
+		tau += c->absorption * rho * dl;
+		em[0] += w * c->color.r;
+		em[1] += w * c->color.g;
+		em[2] += w * c->color.b;
+	}
+
+	/* ∫ e^(-τ s) ds em [0, 1]: meio opaco satura em j / α */
+	double f = tau > 1e-6 ? -expm1(-tau) / tau : 1.0 - 0.5 * tau;
+	double tf = ray->transmittance * f;
+
+	ray->emission.r += (float)(tf * em[0]);
+	ray->emission.g += (float)(tf * em[1]);
+	ray->emission.b += (float)(tf * em[2]);
+	ray->transmittance *= exp(-tau);
+}
+
+bool bhs_volume_ray_step(const struct bhs_geodesic_stepper *st,
+			 double lambda_end, void *user)
+{
+	struct bhs_volume_ray *ray = user;
+	const struct bhs_volume *vol = ray->vol;
+	double ds = vol->step > 0.0 ? vol->step : BHS_VOLUME_STEP;
+	double t_min = vol->min_transmittance > 0.0
+			       ? vol->min_transmittance
+			       : BHS_VOLUME_MIN_TRANSMITTANCE;
+	double lambda = st->lambda0;
+	double cap = SKIP_FRACTION * (lambda_end - st->lambda0);
+
+	while (lambda < lambda_end) {
+		struct bhs_vec4 pos, vel;
+		bhs_geodesic_dense_eval(st, lambda, &pos, &vel);
+
+		/* Comprimento de coordenada por λ, para amostrar a cada ds */
+		double s = sin(pos.y);
+		double speed = sqrt(vel.x * vel.x +
+				    pos.x * pos.x * (vel.y * vel.y +
+						     s * s * vel.z * vel.z));
+		double dlam = speed > 0.0 ? ds / speed : lambda_end - lambda;
+
+		/*
+		 * Salto limitado a uma fração do passo e conferido na saída
+		 * densa: se o destino saiu da caixa (v_θ ≈ 0 num ponto de
+		 * retorno, casca atravessada de lado a lado), metade e tenta
+		 * de novo. Abaixo de dlam vira amostra comum.
+		 */
+		struct free_box box;
+		double skip = fmin(free_lambda(vol, &pos, &vel, &box),
+				   fmax(cap, dlam));
+		while (skip >= dlam &&
+		       !in_box(st, fmin(lambda + skip, lambda_end), &box))
+			skip *= 0.5;
+		if (skip >= dlam) {
+			ray->skips++;
+			lambda += skip;
+			continue;
+		}
+
+		dlam = fmin(dlam, lambda_end - lambda);
+		sample(ray, &pos, dlam);
+		lambda += dlam;
+		if (ray->transmittance < t_min)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file volume.h
+ * @brief Emissão e absorção volumétricas (disco grosso, coroa) no tracer
+ *
+ * "Disco fino é a aproximação que todo mundo faz. Até o disco engordar."
+ *
+ * Meios opticamente finos ou grossos em volta do buraco, integrados ao
+ * longo da geodésica em vez de acertados num plano: um disco grosso
+ * (perfil gaussiano em altura, H/r constante) e coroas esféricas, cada um
+ * com densidade em lei de potência no raio, emissividade, absorção e cor.
+ *
+ * A transferência radiativa (cinza, integrada em frequência) é feita sobre
+ * a saída densa do DOPRI5, no observador de passos de
+ * bhs_geodesic_propagate(), sem mexer no tamanho do passo:
+ *   I_obs = Σ T g⁴ j dl,   T = exp(-Σ α dl),   dl = (E / g) dλ
+ * com g = ν_obs / ν_emit do emissor (órbita kepleriana no disco, ZAMO na
+ * coroa) e E = -p_t do raio. Em cada amostra j e α são constantes e a
+ * contribuição é a exata, (1 - e^(-dτ)) / dτ, estável em dτ grande.
+ *
+ * O custo não depende do comprimento do caminho:
+ * - uma casca analítica (r_min ≤ r ≤ r_max, |cos θ| ≤ cos_max) envolve
+ *   todo o meio; fora dela o raio salta para a borda da casca (em 1ª
+ *   ordem, pela velocidade em r e θ);
+ * - dentro da casca, uma grade grossa de ocupação em (r, θ) guarda a
+ *   distância, em células, até a célula ocupada mais próxima; células
+ *   vazias saltam a caixa livre em volta do ponto;
+ * - cada salto cobre no máximo um quarto do passo do integrador e o
+ *   destino é conferido na saída densa: fora da caixa livre (v_θ ≈ 0
+ *   num retorno polar, casca atravessada), o salto cai pela metade;
+ * - só células ocupadas amostram, a cada @step de caminho;
+ * - quando T cai abaixo de min_transmittance o raio para
+ *   (BHS_GEO_ABSORBED): o que vem de trás não aparece mais.
+ * Densidade abaixo de BHS_VOLUME_DENSITY_CUTOFF é zero por definição, o
+ * que deixa a grade exata (célula vazia nunca emite).
+ */
+
+#ifndef BHS_ENGINE_RENDER_VOLUME_H
+#define BHS_ENGINE_RENDER_VOLUME_H
+
+#include <stdint.h>
+
+#include "engine/components/disk/disk.h"
+#include "engine/physics/geodesic/geodesic.h"
+#include "math/spacetime/kerr.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Componentes por volume */
+#define BHS_VOLUME_MAX_COMPONENTS 4
+
+/** Células da grade de ocupação em r e em θ */
+#define BHS_VOLUME_GRID 32
+
+/** Espaçamento padrão das amostras ao longo do caminho (em M) */
+#define BHS_VOLUME_STEP 0.25
+
+/** Densidade relativa abaixo da qual o meio é vazio */
+#define BHS_VOLUME_DENSITY_CUTOFF 1e-3
+
+/** Transmitância padrão abaixo da qual o raio para */
+#define BHS_VOLUME_MIN_TRANSMITTANCE 1e-3
+
+/** rtol padrão do DOPRI5 quando a configuração pede passo fixo */
+#define BHS_VOLUME_TOLERANCE 1e-7
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * enum bhs_volume_shape - Geometria de um componente
+ * @BHS_VOLUME_THICK_DISK: ρ = (r/r_in)^-power · exp(-cos²θ / 2h²), com
+ *                         h = H/r; gira em órbita kepleriana prograde
+ * @BHS_VOLUME_CORONA: casca esférica, ρ = (r/r_in)^-power; parada no
+ *                     referencial ZAMO (sem momento angular)
+ */
+enum bhs_volume_shape {
+	BHS_VOLUME_THICK_DISK,
+	BHS_VOLUME_CORONA,
+};
+
+/**
+ * struct bhs_volume_component - Um meio emissor
+ * @shape: geometria
+ * @r_in, @r_out: raios (Boyer-Lindquist) onde há matéria
+ * @h_over_r: altura de escala H/r (só no disco grosso)
+ * @power: expoente da densidade em r
+ * @emissivity: j em ρ = 1 (por M, por esterradiano)
+ * @absorption: α em ρ = 1 (1/M)
+ * @color: cor da emissão (multiplica j)
+ */
+struct bhs_volume_component {
+	enum bhs_volume_shape shape;
+	double r_in;
+	double r_out;
+	double h_over_r;
+	double power;
+	double emissivity;
+	double absorption;
+	struct bhs_color_rgb color;
+};
+
+/**
+ * struct bhs_volume - Meios emissores e suas estruturas de salto
+ * @bh: buraco negro (para g e ZAMO)
+ * @comp: componentes; @count em uso
+ * @step: espaçamento das amostras (0 = BHS_VOLUME_STEP)
+ * @min_transmittance: abaixo disso o raio para
+ *                     (0 = BHS_VOLUME_MIN_TRANSMITTANCE)
+ * @r_min, @r_max, @cos_max: casca que envolve todos os componentes
+ * @theta_lo: θ da borda superior da casca (acos cos_max)
+ * @dist: distância de Chebyshev, em células, até a célula ocupada mais
+ *        próxima (0 = ocupada), índice [i_r][i_θ]
+ *
+ * Só @bh, @comp, @count, @step e @min_transmittance são do usuário; o
+ * resto sai de bhs_volume_init().
+ */
+struct bhs_volume {
+	struct bhs_kerr bh;
+	struct bhs_volume_component comp[BHS_VOLUME_MAX_COMPONENTS];
+	int count;
+	double step;
+	double min_transmittance;
+	double r_min;
+	double r_max;
+	double cos_max;
+	double theta_lo;
+	uint8_t dist[BHS_VOLUME_GRID][BHS_VOLUME_GRID];
+};
+
+/**
+ * struct bhs_volume_ray - Transferência acumulada ao longo de um raio
+ * @vol: volume
+ * @E: -p_t do raio
+ * @xi: L/E do raio
+ * @transmittance: T = e^(-τ) acumulado
+ * @emission: luz acumulada, já atenuada (frente para trás)
+ * @samples: amostras dentro de células ocupadas
+ * @skips: saltos sobre espaço vazio
+ */
+struct bhs_volume_ray {
+	const struct bhs_volume *vol;
+	double E;
+	double xi;
+	double transmittance;
+	struct bhs_color_rgb emission;
+	long samples;
+	long skips;
+};
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_volume_init - Monta casca e grade de ocupação dos componentes
+ * @vol: volume com bh, comp e count preenchidos
+ *
+ * Retorna: 0 em sucesso, -1 sem componentes ou com raios inválidos
+ */
+int bhs_volume_init(struct bhs_volume *vol);
+
+/**
+ * bhs_volume_density - Densidade de um componente em (r, θ)
+ *
+ * Zero fora de [r_in, r_out] e abaixo de BHS_VOLUME_DENSITY_CUTOFF.
+ */
+double bhs_volume_density(const struct bhs_volume_component *c, double r,
+			  double theta);
+
+/**
+ * bhs_volume_supports - O volume pode ser integrado com @gc?
+ *
+ * Emissores e g são de Kerr: a métrica tabelada (BHS_GEO_MODE_METRIC)
+ * não combina com volume. Os outros modos são o mesmo Kerr e viram
+ * Christoffel em bhs_volume_ray_attach().
+ */
+bool bhs_volume_supports(const struct bhs_geodesic_config *gc);
+
+/**
+ * bhs_volume_ray_attach - Prepara @ray e @gc para integrar @vol
+ * @ray: [out] acumulador
+ * @vol: volume (bhs_volume_init)
+ * @geo: raio na câmera, antes de propagar
+ * @gc: configuração da geodésica, ajustada para o volume
+ *
+ * O volume amostra a saída densa do DOPRI5 em Boyer-Lindquist: os modos
+ * de Kerr (Carter, Kerr-Schild, planar, elíptico) passam para o modo
+ * Christoffel (tolerance 0 vira BHS_VOLUME_TOLERANCE). A captura pela
+ * sombra é desligada quando o volume desce abaixo de onde ela pode
+ * disparar, e o campo fraco só fecha raios além de r_max. escape_radius
+ * deve ficar além de r_max.
+ *
+ * Retorna: 0 em sucesso, -1 se !bhs_volume_supports(@gc) (@gc intacto)
+ */
+int bhs_volume_ray_attach(struct bhs_volume_ray *ray,
+			   const struct bhs_volume *vol,
+			   const struct bhs_geodesic *geo,
+			   struct bhs_geodesic_config *gc);
+
+/**
+ * bhs_volume_ray_step - Integra um passo aceito (observador on_step)
+ * @st: integrador com a saída densa do passo
+ * @lambda_end: fim do trecho a integrar
+ * @user: struct bhs_volume_ray
+ *
+ * Retorna: false quando a transmitância acabou
+ */
+bool bhs_volume_ray_step(const struct bhs_geodesic_stepper *st,
+			 double lambda_end, void *user);
+
+#endif /* BHS_ENGINE_RENDER_VOLUME_H */
@@ -233,12 +233,18 @@ unsafe extern "C" {
 }
 pub type __gnuc_va_list = __builtin_va_list;
 pub type va_list = __gnuc_va_list;
-#[doc = " struct bhs_metric - Tensor métrico covariante g_μν\n\n Matriz 4x4 simétrica: g[μ][ν] = g[ν][μ]\n Índices: 0=t, 1=x/r, 2=y/θ, 3=z/φ\n\n Alinhamento 16 bytes para compatibilidade com GPU (std140/std430)"]
+pub const bhs_metric_structure_BHS_METRIC_GENERAL: bhs_metric_structure = 0;
+pub const bhs_metric_structure_BHS_METRIC_DIAGONAL: bhs_metric_structure = 1;
+pub const bhs_metric_structure_BHS_METRIC_TPHI: bhs_metric_structure = 2;
+#[doc = " enum bhs_metric_structure - Componentes de g_μν que podem ser não-nulas\n @BHS_METRIC_GENERAL: todas (vale zero: memset e { 0 } são sempre seguros)\n @BHS_METRIC_DIAGONAL: só g_μμ (Minkowski, Schwarzschild)\n @BHS_METRIC_TPHI: bloco 2x2 (t, φ) mais g_rr e g_θθ (Kerr em BL e toda\n                   métrica estacionária axissimétrica nessas coordenadas)\n\n A inversa de uma métrica tem a mesma estrutura dela."]
+pub type bhs_metric_structure = core::ffi::c_uint;
+#[doc = " struct bhs_metric - Tensor métrico covariante g_μν\n @g: componentes\n @structure: componentes fora de @structure são zero exato\n\n Matriz 4x4 simétrica: g[μ][ν] = g[ν][μ]\n Índices: 0=t, 1=x/r, 2=y/θ, 3=z/φ\n\n Os construtores deste módulo e dos espaço-tempos preenchem @structure;\n quem monta g à mão e deixa componentes fora da diagonal deve deixar\n BHS_METRIC_GENERAL. Uma etiqueta mais estreita que a matriz dá inversa\n e produtos errados.\n\n Alinhamento 16 bytes para compatibilidade com GPU (std140/std430)"]
 #[repr(C)]
 #[repr(align(16))]
 #[derive(Debug, Copy, Clone)]
 pub struct bhs_metric {
     pub g: [[real_t; 4usize]; 4usize],
+    pub structure: bhs_metric_structure,
 }
 #[doc = " struct bhs_christoffel - Símbolos de Christoffel Γ^α_μν\n\n Conexão de Levi-Civita, simétrica nos índices inferiores.\n Γ[α][μ][ν] = Γ[α][ν][μ]"]
 #[repr(C)]
@@ -263,6 +269,10 @@ unsafe extern "C" {
     #[doc = " bhs_metric_diag - Cria métrica diagonal\n @g00, g11, g22, g33: elementos da diagonal\n\n Útil pra métricas esféricas onde só a diagonal importa."]
     pub fn bhs_metric_diag(g00: real_t, g11: real_t, g22: real_t, g33: real_t) -> bhs_metric;
 }
+unsafe extern "C" {
+    #[doc = " bhs_metric_classify - Estrutura mais estreita que os zeros de @m admitem\n\n Olha zeros exatos, não tolerância. Para etiquetar métricas montadas à\n mão: m.structure = bhs_metric_classify(&m)."]
+    pub fn bhs_metric_classify(m: *const bhs_metric) -> bhs_metric_structure;
+}
 unsafe extern "C" {
     #[doc = " bhs_metric_is_symmetric - Verifica simetria\n\n Retorna true se g[μ][ν] = g[ν][μ] para todos μ, ν."]
     pub fn bhs_metric_is_symmetric(m: *const bhs_metric, tol: real_t) -> bool;
@@ -56,8 +56,14 @@ ffi.cdef[[
         real_t y;
         real_t z;
     } bhs_vec3;
+    enum bhs_metric_structure {
+        BHS_METRIC_GENERAL = 0,
+        BHS_METRIC_DIAGONAL = 1,
+        BHS_METRIC_TPHI = 2,
+    };
     typedef struct bhs_metric {
         BHS_ALIGN(16) real_t[4][4] g;
+        enum bhs_metric_structure structure;
     } bhs_metric;
     typedef struct bhs_christoffel {
         BHS_ALIGN(16) real_t[4][4][4] gamma;
@@ -196,6 +202,7 @@ ffi.cdef[[
     bhs_metric bhs_metric_zero();
     bhs_metric bhs_metric_minkowski();
     bhs_metric bhs_metric_diag(real_t g00, real_t g11, real_t g22, real_t g33);
+    enum bhs_metric_structure bhs_metric_classify(const struct bhs_metric* m);
     bool bhs_metric_is_symmetric(const struct bhs_metric* m, real_t tol);
     real_t bhs_metric_det(const struct bhs_metric* m);
     int bhs_metric_invert(const struct bhs_metric* m, struct bhs_metric* inv);
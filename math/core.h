@@ -40,6 +40,7 @@
  */
 
 #include "math/spacetime/kerr.h"
+#include "math/spacetime/kerr_spin.h"
 #include "math/spacetime/schwarzschild.h"
 
 #endif /* BHS_CORE_LIB_H */
@@ -0,0 +1,204 @@
+/**
+ * @file elliptic.c
+ * @brief Duplicação de Carlson e média aritmético-geométrica
+ *
+ * "Divida por quatro até os argumentos ficarem iguais. Depois é Taylor."
+ */
+
+#include "elliptic.h"
+
+#include <math.h>
+
+/*
+ * Fatores de parada de Carlson (1995) para erro relativo ~ 2⁻⁵³:
+ * (3r)^(-1/6), (3r)^(-1/8) e (r/4)^(-1/6) com r = 2⁻⁵³.
+ */
+#define RF_Q_FACTOR 380.0
+#define RC_Q_FACTOR 86.0
+#define RJ_Q_FACTOR 575.0
+
+/* Limite de duplicações: cada uma divide a dispersão por 4 */
+#define MAX_DUPLICATIONS 64
+
+static double max4(double a, double b, double c, double d)
+{
+	return fmax(fmax(a, b), fmax(c, d));
+}
+
+/* ============================================================================
+ * CARLSON
+ * ============================================================================
+ */
+
+double complex bhs_elliptic_rf(double complex x, double complex y,
+			       double complex z)
+{
+	double complex a0 = (x + y + z) / 3.0, a = a0;
+	double q = RF_Q_FACTOR *
+		   max4(cabs(a0 - x), cabs(a0 - y), cabs(a0 - z), 0.0);
+	double f = 1.0;
+
+	for (int i = 0; i < MAX_DUPLICATIONS && f * q >= cabs(a); i++) {
+		double complex sx = csqrt(x), sy = csqrt(y), sz = csqrt(z);
+		double complex lam = sx * sy + sx * sz + sy * sz;
+		x = 0.25 * (x + lam);
+		y = 0.25 * (y + lam);
+		z = 0.25 * (z + lam);
+		a = 0.25 * (a + lam);
+		f *= 0.25;
+	}
+
+	/* (A - x)/A depois das duplicações = 4⁻ᵐ(A₀ - x₀)/A */
+	double complex X = (a - x) / a, Y = (a - y) / a;
+	double complex Z = -(X + Y);
+	double complex e2 = X * Y - Z * Z, e3 = X * Y * Z;
+
+	return (1.0 - e2 / 10.0 + e3 / 14.0 + e2 * e2 / 24.0 -
+		3.0 * e2 * e3 / 44.0) /
+	       csqrt(a);
+}
+
+double complex bhs_elliptic_rc(double complex x, double complex y)
+{
+	/* Valor principal de Cauchy para y real negativo (DLMF 19.2.20) */
+	if (cimag(y) == 0.0 && creal(y) < 0.0)
+		return csqrt(x / (x - y)) * bhs_elliptic_rc(x - y, -y);
+
+	double complex a0 = (x + 2.0 * y) / 3.0, a = a0;
+	double q = RC_Q_FACTOR * cabs(a0 - x);
+	double f = 1.0;
+
+	for (int i = 0; i < MAX_DUPLICATIONS && f * q >= cabs(a); i++) {
+		double complex lam = 2.0 * csqrt(x) * csqrt(y) + y;
+		x = 0.25 * (x + lam);
+		y = 0.25 * (y + lam);
+		a = 0.25 * (a + lam);
+		f *= 0.25;
+	}
+
+	double complex s = (y - a) / a;
+	double complex s2 = s * s;
+	return (1.0 + s2 * (0.3 + s * (1.0 / 7.0 +
+				       s * (0.375 + s * (9.0 / 22.0 +
+							 s * (159.0 / 208.0 +
+							      s * 1.125)))))) /
+	       csqrt(a);
+}
+
+double complex bhs_elliptic_rj(double complex x, double complex y,
+			       double complex z, double complex p)
+{
+	double complex a0 = (x + y + z + 2.0 * p) / 5.0, a = a0;
+	double complex delta = (p - x) * (p - y) * (p - z);
+	double q = RJ_Q_FACTOR * max4(cabs(a0 - x), cabs(a0 - y),
+				      cabs(a0 - z), cabs(a0 - p));
+	double complex sum = 0.0;
+	double f = 1.0;
+
+	for (int i = 0; i < MAX_DUPLICATIONS && f * q >= cabs(a); i++) {
+		double complex sx = csqrt(x), sy = csqrt(y), sz = csqrt(z);
+		double complex sp = csqrt(p);
+		double complex lam = sx * sy + sx * sz + sy * sz;
+		double complex d = (sp + sx) * (sp + sy) * (sp + sz);
+		double complex e = f * f * f * delta / (d * d);
+
+		sum += f * bhs_elliptic_rc(1.0, 1.0 + e) / d;
+
+		x = 0.25 * (x + lam);
+		y = 0.25 * (y + lam);
+		z = 0.25 * (z + lam);
+		p = 0.25 * (p + lam);
+		a = 0.25 * (a + lam);
+		f *= 0.25;
+	}
+
+	double complex X = (a - x) / a, Y = (a - y) / a;
+	double complex Z = (a - z) / a;
+	double complex P = -0.5 * (X + Y + Z);
+	double complex P2 = P * P;
+	double complex e2 = X * Y + X * Z + Y * Z - 3.0 * P2;
+	double complex e3 = X * Y * Z + 2.0 * e2 * P + 4.0 * P2 * P;
+	double complex e4 = (2.0 * X * Y * Z + e2 * P + 3.0 * P2 * P) * P;
+	double complex e5 = X * Y * Z * P2;
+
+	return f / (a * csqrt(a)) *
+		       (1.0 - 3.0 * e2 / 14.0 + e3 / 6.0 +
+			9.0 * e2 * e2 / 88.0 - 3.0 * e4 / 22.0 -
+			9.0 * e2 * e3 / 52.0 + 3.0 * e5 / 26.0) +
+	       6.0 * sum;
+}
+
+/* ============================================================================
+ * LEGENDRE
+ * ============================================================================
+ */
+
+double bhs_elliptic_f(double phi, double m)
+{
+	double s = sin(phi), c = cos(phi);
+	return s * creal(bhs_elliptic_rf(c * c, 1.0 - m * s * s, 1.0));
+}
+
+double bhs_elliptic_k(double m)
+{
+	return creal(bhs_elliptic_rf(0.0, 1.0 - m, 1.0));
+}
+
+double bhs_elliptic_pi(double n, double phi, double m)
+{
+	double s = sin(phi), c = cos(phi);
+	double c2 = c * c, d2 = 1.0 - m * s * s;
+	return s * creal(bhs_elliptic_rf(c2, d2, 1.0)) +
+	       n / 3.0 * s * s * s *
+		       creal(bhs_elliptic_rj(c2, d2, 1.0, 1.0 - n * s * s));
+}
+
+/* ============================================================================
+ * JACOBI
+ * ============================================================================
+ */
+
+void bhs_elliptic_jacobi(double u, double m, double *sn, double *cn,
+			 double *dn)
+{
+	double s, c, d;
+
+	if (m < 0.0) {
+		/* sn(u|m) = sd(v|μ)/√(1-m), v = u√(1-m), μ = -m/(1-m) */
+		double r = sqrt(1.0 - m);
+		double s1, c1, d1;
+		bhs_elliptic_jacobi(u * r, -m / (1.0 - m), &s1, &c1, &d1);
+		s = s1 / (d1 * r);
+		c = c1 / d1;
+		d = 1.0 / d1;
+	} else {
+		/* AGM descendente (A&S 16.4) */
+		double a[32], cc[32];
+		double b = sqrt(1.0 - m);
+		int n = 0;
+
+		a[0] = 1.0;
+		cc[0] = sqrt(m);
+		while (n < 31 && fabs(cc[n]) > 1e-16 * a[n]) {
+			a[n + 1] = 0.5 * (a[n] + b);
+			cc[n + 1] = 0.5 * (a[n] - b);
+			b = sqrt(a[n] * b);
+			n++;
+		}
+
+		double phi = ldexp(a[n] * u, n);
+		for (int i = n; i > 0; i--)
+			phi = 0.5 * (phi + asin(cc[i] / a[i] * sin(phi)));
+
+		s = sin(phi);
+		c = cos(phi);
+		d = sqrt(1.0 - m * s * s);
+	}
+
+	if (sn)
+		*sn = s;
+	if (cn)
+		*cn = c;
+	if (dn)
+		*dn = d;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file elliptic.h
+ * @brief Integrais elípticas de Carlson e funções de Jacobi
+ *
+ * "Toda integral com raiz de quártica é elíptica.
+ * Toda integral elíptica é R_F, R_J ou vergonha."
+ *
+ * Formas simétricas de Carlson (DLMF §19.16) por duplicação, com
+ * argumentos complexos: as raízes de potenciais de fótons de Kerr vêm
+ * em pares conjugados, e com eles as fórmulas de redução continuam
+ * valendo sem separar casos. Para argumentos reais o resultado é real
+ * (parte imaginária zero até arredondamento).
+ *
+ * Legendre e Jacobi usam o parâmetro m = k² (convenção de A&S e DLMF),
+ * aceitando m < 0.
+ */
+
+#ifndef BHS_CORE_MATH_ELLIPTIC_H
+#define BHS_CORE_MATH_ELLIPTIC_H
+
+#include <complex.h>
+
+/* ============================================================================
+ * CARLSON
+ * ============================================================================
+ */
+
+/**
+ * bhs_elliptic_rf - R_F(x, y, z) = ½∫₀^∞ dt / √((t+x)(t+y)(t+z))
+ *
+ * No máximo um argumento zero; nenhum no semieixo real negativo.
+ */
+double complex bhs_elliptic_rf(double complex x, double complex y,
+			       double complex z);
+
+/**
+ * bhs_elliptic_rc - R_C(x, y) = R_F(x, y, y), forma elementar
+ */
+double complex bhs_elliptic_rc(double complex x, double complex y);
+
+/**
+ * bhs_elliptic_rj - R_J(x, y, z, p) = 3/2 ∫₀^∞ dt / ((t+p)√(...))
+ *
+ * Com p ≠ 0. Soma de R_C da duplicação feita com argumentos complexos,
+ * sem a ramificação real de arctan/arctanh.
+ */
+double complex bhs_elliptic_rj(double complex x, double complex y,
+			       double complex z, double complex p);
+
+/* ============================================================================
+ * LEGENDRE
+ * ============================================================================
+ */
+
+/**
+ * bhs_elliptic_f - F(φ | m) para |φ| ≤ π/2
+ */
+double bhs_elliptic_f(double phi, double m);
+
+/**
+ * bhs_elliptic_k - K(m) = F(π/2 | m), m < 1
+ */
+double bhs_elliptic_k(double m);
+
+/**
+ * bhs_elliptic_pi - Π(n; φ | m) para |φ| ≤ π/2, n sin²φ < 1
+ */
+double bhs_elliptic_pi(double n, double phi, double m);
+
+/* ============================================================================
+ * JACOBI
+ * ============================================================================
+ */
+
+/**
+ * bhs_elliptic_jacobi - sn, cn, dn de (u | m) para m < 1
+ * @sn, @cn, @dn: [out] (qualquer um pode ser NULL)
+ *
+ * Média aritmético-geométrica descendente para 0 ≤ m < 1; m < 0 vai
+ * para o parâmetro m/(m - 1) ∈ (0, 1) pela transformação recíproca
+ * (A&S 16.10).
+ */
+void bhs_elliptic_jacobi(double u, double m, double *sn, double *cn,
+			 double *dn);
+
+#endif /* BHS_CORE_MATH_ELLIPTIC_H */
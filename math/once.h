@@ -0,0 +1,49 @@
+/**
+ * @file once.h
+ * @brief Inicialização preguiçosa, uma vez por processo
+ *
+ * "Três cópias do mesmo CAS. A quarta ia ter um bug."
+ *
+ * Para tabelas globais montadas na primeira consulta, de qualquer thread.
+ * O estado é um atomic_int estático zerado (0 = vazia, 1 = em construção,
+ * 2 = pronta): não precisa de construtor nem de pthread, então serve a
+ * bhs_math, que só liga com libm.
+ *
+ * Quem perde a corrida espera girando. Só vale para construções curtas
+ * (microssegundos a alguns ms) e que não chamam bhs_once() no mesmo
+ * estado, senão a thread espera por ela mesma.
+ */
+
+#ifndef BHS_CORE_MATH_ONCE_H
+#define BHS_CORE_MATH_ONCE_H
+
+#include <stdatomic.h>
+
+/**
+ * bhs_once - Roda @init na primeira chamada com @state
+ * @state: estado estático, inicialmente 0
+ * @init: monta a tabela; roda em exatamente uma thread
+ *
+ * Ao retornar, tudo que @init escreveu está visível para a chamadora
+ * (release no fim de @init, acquire aqui). Depois da primeira vez custa
+ * uma carga atômica.
+ */
+static inline void bhs_once(atomic_int *state, void (*init)(void))
+{
+	int expected = 0;
+
+	if (atomic_load_explicit(state, memory_order_acquire) == 2)
+		return;
+
+	if (atomic_compare_exchange_strong(state, &expected, 1)) {
+		init();
+		atomic_store_explicit(state, 2, memory_order_release);
+		return;
+	}
+
+	/* Outra thread está montando */
+	while (atomic_load_explicit(state, memory_order_acquire) != 2)
+		;
+}
+
+#endif /* BHS_CORE_MATH_ONCE_H */
@@ -115,6 +115,75 @@ double bhs_kerr_isco(const struct bhs_kerr *bh, bool prograde)
 		return M * (3.0 + Z2 + sqrt_inner);
 }
 
+/* ============================================================================
+ * ÓRBITAS DE FÓTONS E SOMBRA
+ * ============================================================================
+ */
+
+double bhs_kerr_photon_orbit(const struct bhs_kerr *bh, bool prograde)
+{
+	double chi = fmin(fmax(bh->a / bh->M, -1.0), 1.0);
+	double s = prograde ? -chi : chi;
+	return 2.0 * bh->M * (1.0 + cos(2.0 / 3.0 * acos(s)));
+}
+
+void bhs_kerr_critical_orbit(const struct bhs_kerr *bh, double r, double *xi,
+			     double *eta)
+{
+	double M = bh->M;
+	double a = bh->a;
+	double a2 = a * a;
+	double rm = r - M;
+	double r3m = r - 3.0 * M;
+
+	*xi = (r * r * (3.0 * M - r) - a2 * (r + M)) / (a * rm);
+	*eta = r * r * r * (4.0 * a2 * M - r * r3m * r3m) / (a2 * rm * rm);
+}
+
+bool bhs_kerr_in_shadow(const struct bhs_kerr *bh, double xi, double eta)
+{
+	double M = bh->M;
+
+	if (eta < 0.0)
+		return false;
+
+	/* Schwarzschild: b² = ξ² + η < 27 M² */
+	if (fabs(bh->a) < 1e-10 * M)
+		return xi * xi + eta < 27.0 * M * M;
+
+	/*
+	 * Trocar o sinal de a é espelhar φ: trabalha com a > 0 e ξ com o
+	 * sinal ajustado. Aí ξ(r) decresce de ξ(r_pro) a ξ(r_retro).
+	 */
+	struct bhs_kerr pos = { .M = M, .a = fabs(bh->a) };
+	if (bh->a < 0.0)
+		xi = -xi;
+
+	double lo = bhs_kerr_photon_orbit(&pos, true);
+	double hi = bhs_kerr_photon_orbit(&pos, false);
+	double xi_lo, xi_hi, eta_c;
+	bhs_kerr_critical_orbit(&pos, lo, &xi_lo, &eta_c);
+	bhs_kerr_critical_orbit(&pos, hi, &xi_hi, &eta_c);
+
+	if (!(xi < xi_lo && xi > xi_hi))
+		return false;
+
+	/* Bisseção: raio da órbita esférica com esse ξ */
+	for (int i = 0; i < 60; i++) {
+		double mid = 0.5 * (lo + hi);
+		double xm;
+		bhs_kerr_critical_orbit(&pos, mid, &xm, &eta_c);
+		if (xm > xi)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	double xc;
+	bhs_kerr_critical_orbit(&pos, 0.5 * (lo + hi), &xc, &eta_c);
+	return eta < eta_c;
+}
+
 /* ============================================================================
  * FRAME DRAGGING
  * ============================================================================
@@ -207,6 +276,8 @@ void bhs_kerr_metric(const struct bhs_kerr *bh, double r, double theta,
 
 	/* g_φφ */
 	out->g[3][3] = A * sin2 / Sigma;
+
+	out->structure = BHS_METRIC_TPHI;
 }
 
 void bhs_kerr_metric_inverse(const struct bhs_kerr *bh, double r, double theta,
@@ -261,6 +332,8 @@ void bhs_kerr_metric_inverse(const struct bhs_kerr *bh, double r, double theta,
 	/* Inversa dos elementos diagonais simples */
 	out->g[1][1] = Delta / Sigma; /* g^rr */
 	out->g[2][2] = 1.0 / Sigma;   /* g^θθ */
+
+	out->structure = BHS_METRIC_TPHI;
 }
 
 /* ============================================================================
@@ -307,3 +380,175 @@ void bhs_kerr_metric_func(struct bhs_vec4 coords, void *userdata,
 
 	bhs_kerr_metric(bh, r, theta, out);
 }
+
+void bhs_kerr_metric_dual(const struct bhs_dual coords[4], void *userdata,
+			  struct bhs_dual out[4][4])
+{
+	const struct bhs_kerr *bh = userdata;
+	double M = bh->M;
+	double a = bh->a;
+	double a2 = a * a;
+
+	struct bhs_dual r = coords[1];
+	struct bhs_dual sin_theta = bhs_dual_sin(coords[2]);
+	struct bhs_dual cos_theta = bhs_dual_cos(coords[2]);
+	struct bhs_dual sin2 = bhs_dual_mul(sin_theta, sin_theta);
+	struct bhs_dual cos2 = bhs_dual_mul(cos_theta, cos_theta);
+	struct bhs_dual r2 = bhs_dual_mul(r, r);
+
+	/* Σ = r² + a² cos²θ, Δ = r² - 2Mr + a² */
+	struct bhs_dual Sigma = bhs_dual_add(r2, bhs_dual_scale(cos2, a2));
+	struct bhs_dual Delta = bhs_dual_add_const(
+		bhs_dual_sub(r2, bhs_dual_scale(r, 2.0 * M)), a2);
+
+	/* A = (r² + a²)² - a²Δ sin²θ */
+	struct bhs_dual sum = bhs_dual_add_const(r2, a2);
+	struct bhs_dual A = bhs_dual_sub(
+		bhs_dual_mul(sum, sum),
+		bhs_dual_scale(bhs_dual_mul(Delta, sin2), a2));
+
+	for (int mu = 0; mu < 4; mu++) {
+		for (int nu = 0; nu < 4; nu++)
+			out[mu][nu] = bhs_dual_const(0.0);
+	}
+
+	/* g_tt = -(1 - 2Mr/Σ) */
+	out[0][0] = bhs_dual_add_const(
+		bhs_dual_scale(bhs_dual_div(r, Sigma), 2.0 * M), -1.0);
+
+	/* g_tφ = -2Mar sin²θ / Σ */
+	out[0][3] = bhs_dual_scale(bhs_dual_div(bhs_dual_mul(r, sin2), Sigma),
+				   -2.0 * M * a);
+	out[3][0] = out[0][3];
+
+	out[1][1] = bhs_dual_div(Sigma, Delta);
+	out[2][2] = Sigma;
+	out[3][3] = bhs_dual_div(bhs_dual_mul(A, sin2), Sigma);
+}
+
+const struct bhs_metric_desc BHS_KERR_METRIC_DESC = {
+	.fn = bhs_kerr_metric_func,
+	.dual_fn = bhs_kerr_metric_dual,
+	.killing = BHS_METRIC_COORD(0) | BHS_METRIC_COORD(3),
+	.zero = BHS_METRIC_COMP(0, 1) | BHS_METRIC_COMP(0, 2) |
+		BHS_METRIC_COMP(1, 2) | BHS_METRIC_COMP(1, 3) |
+		BHS_METRIC_COMP(2, 3),
+};
+
+/* ============================================================================
+ * CHRISTOFFEL ANALÍTICO
+ * ============================================================================
+ */
+
+static inline void set_sym(struct bhs_christoffel *out, int a, int m, int n,
+			   double v)
+{
+	out->gamma[a][m][n] = v;
+	out->gamma[a][n][m] = v;
+}
+
+int bhs_kerr_christoffel(const struct bhs_kerr *bh, double r, double theta,
+			 struct bhs_christoffel *out)
+{
+	/*
+   * Γ^α_μν = ½ g^αβ (∂_μ g_βν + ∂_ν g_βμ - ∂_β g_μν)
+   *
+   * Só ∂_r e ∂_θ sobrevivem (t e φ são Killing) e a métrica é
+   * bloco (t, φ) ⊕ diag(g_rr, g_θθ). Escrevemos g_φφ na forma
+   *
+   *   g_φφ = sin²θ [(r² + a²) + 2Mra² sin²θ / Σ]
+   *
+   * que deriva bem mais limpo que A sin²θ / Σ. As derivadas:
+   *
+   *   ∂_r g_tt = 2M(Σ - 2r²)/Σ²          ∂_θ g_tt = 4Mra² sc/Σ²
+   *   ∂_r g_tφ = -2Ma s²(Σ - 2r²)/Σ²     ∂_θ g_tφ = -4Mar sc(r²+a²)/Σ²
+   *   ∂_r g_rr = [2rΔ - Σ(2r - 2M)]/Δ²   ∂_θ g_rr = -2a² sc/Δ
+   *   ∂_r g_θθ = 2r                      ∂_θ g_θθ = -2a² sc
+   *   ∂_r g_φφ = 2r s² + 2Ma² s⁴(Σ - 2r²)/Σ²
+   *   ∂_θ g_φφ = 2sc(r²+a²) + 4Mra² s³c(2Σ + a² s²)/Σ²
+   *
+   * E o bloco (t, φ) tem det = g_tt g_φφ - g_tφ² = -Δ sin²θ.
+   */
+	double M = bh->M;
+	double a = bh->a;
+
+	double s = sin(theta);
+	double c = cos(theta);
+	double s2 = s * s;
+	double sc = s * c;
+
+	double r2 = r * r;
+	double a2 = a * a;
+	double rho2 = r2 + a2;
+
+	double Sigma = r2 + a2 * c * c;
+	double Delta = r2 - 2.0 * M * r + a2;
+	double det_block = -Delta * s2;
+
+	if (fabs(Sigma) < 1e-15 || fabs(Delta) < 1e-15 ||
+	    fabs(det_block) < 1e-15)
+		return -1;
+
+	double inv_S = 1.0 / Sigma;
+	double inv_S2 = inv_S * inv_S;
+	double inv_D = 1.0 / Delta;
+	double S_2r2 = Sigma - 2.0 * r2;
+
+	/* Métrica covariante (só o que a inversa do bloco precisa) */
+	double g_tt = -(1.0 - 2.0 * M * r * inv_S);
+	double g_tp = -2.0 * M * a * r * s2 * inv_S;
+	double g_pp = s2 * (rho2 + 2.0 * M * r * a2 * s2 * inv_S);
+
+	/* Derivadas */
+	double dr_tt = 2.0 * M * S_2r2 * inv_S2;
+	double dh_tt = 4.0 * M * r * a2 * sc * inv_S2;
+	double dr_tp = -2.0 * M * a * s2 * S_2r2 * inv_S2;
+	double dh_tp = -4.0 * M * a * r * sc * rho2 * inv_S2;
+	double dr_pp = 2.0 * r * s2 + 2.0 * M * a2 * s2 * s2 * S_2r2 * inv_S2;
+	double dh_pp = 2.0 * sc * rho2 + 4.0 * M * r * a2 * sc * s2 *
+						 (2.0 * Sigma + a2 * s2) * inv_S2;
+	double dr_rr =
+		(2.0 * r * Delta - Sigma * (2.0 * r - 2.0 * M)) * inv_D * inv_D;
+	double dh_rr = -2.0 * a2 * sc * inv_D;
+	double dr_hh = 2.0 * r;
+	double dh_hh = -2.0 * a2 * sc;
+
+	/* Inversa: bloco (t, φ) explícito + diagonal */
+	double inv_det = 1.0 / det_block;
+	double gi_tt = g_pp * inv_det;
+	double gi_tp = -g_tp * inv_det;
+	double gi_pp = g_tt * inv_det;
+	double gi_rr = Delta * inv_S;
+	double gi_hh = inv_S;
+
+	*out = bhs_christoffel_zero();
+
+	/* Γ^t e Γ^φ: só (r|θ, t|φ) */
+	set_sym(out, 0, 1, 0, 0.5 * (gi_tt * dr_tt + gi_tp * dr_tp));
+	set_sym(out, 0, 1, 3, 0.5 * (gi_tt * dr_tp + gi_tp * dr_pp));
+	set_sym(out, 0, 2, 0, 0.5 * (gi_tt * dh_tt + gi_tp * dh_tp));
+	set_sym(out, 0, 2, 3, 0.5 * (gi_tt * dh_tp + gi_tp * dh_pp));
+
+	set_sym(out, 3, 1, 0, 0.5 * (gi_tp * dr_tt + gi_pp * dr_tp));
+	set_sym(out, 3, 1, 3, 0.5 * (gi_tp * dr_tp + gi_pp * dr_pp));
+	set_sym(out, 3, 2, 0, 0.5 * (gi_tp * dh_tt + gi_pp * dh_tp));
+	set_sym(out, 3, 2, 3, 0.5 * (gi_tp * dh_tp + gi_pp * dh_pp));
+
+	/* Γ^r */
+	out->gamma[1][0][0] = -0.5 * gi_rr * dr_tt;
+	set_sym(out, 1, 0, 3, -0.5 * gi_rr * dr_tp);
+	out->gamma[1][3][3] = -0.5 * gi_rr * dr_pp;
+	out->gamma[1][1][1] = 0.5 * gi_rr * dr_rr;
+	set_sym(out, 1, 1, 2, 0.5 * gi_rr * dh_rr);
+	out->gamma[1][2][2] = -0.5 * gi_rr * dr_hh;
+
+	/* Γ^θ */
+	out->gamma[2][0][0] = -0.5 * gi_hh * dh_tt;
+	set_sym(out, 2, 0, 3, -0.5 * gi_hh * dh_tp);
+	out->gamma[2][3][3] = -0.5 * gi_hh * dh_pp;
+	out->gamma[2][1][1] = -0.5 * gi_hh * dh_rr;
+	set_sym(out, 2, 1, 2, 0.5 * gi_hh * dr_hh);
+	out->gamma[2][2][2] = 0.5 * gi_hh * dh_hh;
+
+	return 0;
+}
@@ -124,6 +124,48 @@ double bhs_kerr_ergosphere(const struct bhs_kerr *bh, double theta);
  */
 double bhs_kerr_isco(const struct bhs_kerr *bh, bool prograde);
 
+/* ============================================================================
+ * ÓRBITAS DE FÓTONS E SOMBRA
+ * ============================================================================
+ */
+
+/**
+ * bhs_kerr_photon_orbit - Raio da órbita circular equatorial de fótons
+ * @prograde: true para co-rotante
+ *
+ * r_ph = 2M { 1 + cos[ (2/3) arccos(∓a/M) ] }
+ *
+ * As órbitas esféricas de fótons (não equatoriais) ficam todas entre a
+ * prograde e a retrógrada: é a "região de fótons". Para a = 0, 3M.
+ */
+double bhs_kerr_photon_orbit(const struct bhs_kerr *bh, bool prograde);
+
+/**
+ * bhs_kerr_critical_orbit - Constantes da órbita esférica de fótons em r
+ * @r: raio da órbita, entre as duas órbitas equatoriais
+ * @xi: [out] ξ = L/E
+ * @eta: [out] η = Q/E²
+ *
+ *   ξ = [r²(3M - r) - a²(r + M)] / [a(r - M)]
+ *   η = r³ [4a²M - r(r - 3M)²] / [a²(r - M)²]
+ *
+ * Percorrer r na região de fótons desenha a curva crítica (borda da
+ * sombra de Bardeen). Exige a ≠ 0.
+ */
+void bhs_kerr_critical_orbit(const struct bhs_kerr *bh, double r, double *xi,
+			     double *eta);
+
+/**
+ * bhs_kerr_in_shadow - Fóton com (ξ, η) está dentro da curva crítica?
+ * @xi: L/E
+ * @eta: Q/E²
+ *
+ * Dentro da curva R(r) não tem raiz fora do horizonte: um fóton que está
+ * caindo cai até o fim, sem ponto de retorno. A comparação é estrita, a
+ * curva em si (o anel de fótons) fica de fora. η < 0 responde false.
+ */
+bool bhs_kerr_in_shadow(const struct bhs_kerr *bh, double xi, double eta);
+
 /* ============================================================================
  * FRAME DRAGGING
  * ============================================================================
@@ -200,4 +242,50 @@ double bhs_kerr_redshift_zamo(const struct bhs_kerr *bh, double r,
 void bhs_kerr_metric_func(struct bhs_vec4 coords, void *userdata,
 			  struct bhs_metric *out);
 
+/**
+ * bhs_kerr_metric_dual - bhs_kerr_metric_func em números duais
+ *
+ * Use como bhs_metric_dual_func com userdata = struct bhs_kerr*. Serve de
+ * referência para métricas novas: é bhs_kerr_metric() linha a linha.
+ */
+void bhs_kerr_metric_dual(const struct bhs_dual coords[4], void *userdata,
+			  struct bhs_dual out[4][4]);
+
+/**
+ * BHS_KERR_METRIC_DESC - bhs_kerr_metric_func com as simetrias de Kerr
+ *
+ * t e φ de Killing; fora da diagonal só g_tφ; derivadas pela variante
+ * dual. Para bhs_christoffel_compute_desc(): uma avaliação dual em vez
+ * de 9 métricas.
+ */
+extern const struct bhs_metric_desc BHS_KERR_METRIC_DESC;
+
+/* ============================================================================
+ * CHRISTOFFEL ANALÍTICO
+ * ============================================================================
+ */
+
+/**
+ * bhs_kerr_christoffel - Símbolos de Christoffel de Kerr em forma fechada
+ * @bh: parâmetros do buraco negro
+ * @r: coordenada radial (fora do horizonte)
+ * @theta: ângulo polar (0, π)
+ * @out: [out] Γ^α_μν em Boyer-Lindquist
+ *
+ * Substitui bhs_christoffel_compute(bhs_kerr_metric_func, ...) no caminho
+ * quente: nada de 9 avaliações de métrica, inversão 4x4 nem diferença
+ * finita. Como a métrica só depende de (r, θ) e é bloco-diagonal, só 20
+ * componentes independentes são não-nulas:
+ *
+ *   Γ^t_{rt} Γ^t_{rφ} Γ^t_{θt} Γ^t_{θφ}  (idem para Γ^φ)
+ *   Γ^r_{tt} Γ^r_{tφ} Γ^r_{φφ} Γ^r_{rr} Γ^r_{rθ} Γ^r_{θθ}
+ *   Γ^θ_{tt} Γ^θ_{tφ} Γ^θ_{φφ} Γ^θ_{rr} Γ^θ_{rθ} Γ^θ_{θθ}
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 se Δ ou Σ degeneram (horizonte, singularidade em anel)
+ */
+int bhs_kerr_christoffel(const struct bhs_kerr *bh, double r, double theta,
+			 struct bhs_christoffel *out);
+
 #endif /* BHS_CORE_SPACETIME_KERR_H */
@@ -0,0 +1,553 @@
+/**
+ * @file kerr_elliptic.c
+ * @brief Raízes de R(r), reduções de Carlson e fases de Jacobi
+ *
+ * "Quatro raízes, duas fases, nenhum passo. O fóton que se vire para
+ * chegar lá."
+ *
+ * Referências:
+ * - Carlson (1988) - A table of elliptic integrals of the third kind
+ * - Gralla & Lupsasca (2020) - Null geodesics of the Kerr exterior
+ */
+
+#define _GNU_SOURCE /* Para M_PI */
+
+#include "kerr_elliptic.h"
+#include "math/elliptic.h"
+
+#include <math.h>
+
+/* Iterações da inversão radial sem ponto de retorno */
+#define INVERT_MAX_ITER 60
+
+/* ============================================================================
+ * RAÍZES DE R(r)
+ * ============================================================================
+ */
+
+static double radial_potential(const struct bhs_kerr_elliptic *ray, double r)
+{
+	double a = ray->a, lam = ray->lambda, eta = ray->eta;
+	double A = a * a - eta - lam * lam;
+	double B = 2.0 * ray->M * (eta + (lam - a) * (lam - a));
+	double r2 = r * r;
+
+	return r2 * (r2 + A) + B * r - a * a * eta;
+}
+
+/* Maior raiz real de y³ + P y + Q = 0 */
+static double cubic_max_root(double P, double Q)
+{
+	double D = 0.25 * Q * Q + P * P * P / 27.0;
+
+	if (D > 0.0) {
+		double s = sqrt(D);
+		return cbrt(-0.5 * Q + s) + cbrt(-0.5 * Q - s);
+	}
+
+	/* Três raízes reais: forma trigonométrica, k = 0 é a maior */
+	double c = 1.5 * Q / P * sqrt(-3.0 / P);
+	return 2.0 * sqrt(-P / 3.0) * cos(acos(fmin(fmax(c, -1.0), 1.0)) / 3.0);
+}
+
+static void sort_real(double *r, int n)
+{
+	for (int i = 1; i < n; i++)
+		for (int j = i; j > 0 && r[j] < r[j - 1]; j--) {
+			double t = r[j];
+			r[j] = r[j - 1];
+			r[j - 1] = t;
+		}
+}
+
+/**
+ * radial_roots - As quatro raízes de R pelo resolvente cúbico
+ *
+ * R não tem termo cúbico: R = (r² + z r + ...)(r² - z r + ...) com
+ * z = √(ξ₀/2), ξ₀ = y₀ - A/3 e y₀ a maior raiz do cúbico deprimido.
+ * Os dois radicandos s₁₂ > s₃₄ decidem quantas raízes são reais, sem
+ * tolerância em partes imaginárias.
+ *
+ * Retorna: número de raízes reais, -1 se o resolvente degenerou
+ */
+static int radial_roots(struct bhs_kerr_elliptic *ray)
+{
+	double a = ray->a, lam = ray->lambda, eta = ray->eta;
+	double A = a * a - eta - lam * lam;
+	double B = 2.0 * ray->M * (eta + (lam - a) * (lam - a));
+	double C = -a * a * eta;
+	double P = -A * A / 12.0 - C;
+	double Q = -A / 3.0 * (A * A / 36.0 - C) - B * B / 8.0;
+
+	double xi0 = cubic_max_root(P, Q) - A / 3.0;
+	if (!(xi0 > 0.0))
+		return -1;
+
+	double z = sqrt(0.5 * xi0);
+	double s12 = -0.5 * A - z * z + B / (4.0 * z);
+	double s34 = -0.5 * A - z * z - B / (4.0 * z);
+	double r[4];
+	int n = 0;
+
+	if (s12 >= 0.0) {
+		r[n++] = -z - sqrt(s12);
+		r[n++] = -z + sqrt(s12);
+	}
+	if (s34 >= 0.0) {
+		r[n++] = z - sqrt(s34);
+		r[n++] = z + sqrt(s34);
+	}
+
+	/* Um passo de Newton: o ponto de retorno vira limite de integral */
+	for (int i = 0; i < n; i++) {
+		double f = radial_potential(ray, r[i]);
+		double df = 4.0 * r[i] * r[i] * r[i] + 2.0 * A * r[i] + B;
+		double next = r[i] - f / df;
+		if (df != 0.0 && fabs(radial_potential(ray, next)) < fabs(f))
+			r[i] = next;
+	}
+	sort_real(r, n);
+
+	for (int i = 0; i < n; i++)
+		ray->root[i] = r[i];
+	if (s12 < 0.0) {
+		ray->root[n] = -z + I * sqrt(-s12);
+		ray->root[n + 1] = -z - I * sqrt(-s12);
+	}
+	if (s34 < 0.0) {
+		int k = s12 < 0.0 ? 2 : n;
+		ray->root[k] = z + I * sqrt(-s34);
+		ray->root[k + 1] = z - I * sqrt(-s34);
+	}
+	return n;
+}
+
+/* ============================================================================
+ * TRECHOS RADIAIS (CARLSON)
+ * ============================================================================
+ */
+
+/**
+ * struct radial_path - Um trecho monótono y ≤ r ≤ x
+ * @X, @Y: √(x - r_i), √(y - r_i)
+ * @U2: U₁₂², U₁₃², U₁₄²
+ * @i0: ∫ dr/√R = 2 R_F(U₁₂², U₁₃², U₁₄²)
+ */
+struct radial_path {
+	double x, y;
+	double complex X[4], Y[4];
+	double complex U2[3];
+	double i0;
+};
+
+static void path_init(const struct bhs_kerr_elliptic *ray, double y, double x,
+		      struct radial_path *p)
+{
+	const double complex *X = p->X, *Y = p->Y;
+
+	p->x = x;
+	p->y = y;
+	for (int i = 0; i < 4; i++) {
+		p->X[i] = csqrt(x - ray->root[i]);
+		p->Y[i] = csqrt(y - ray->root[i]);
+	}
+
+	double complex U12 =
+		(X[0] * X[1] * Y[2] * Y[3] + Y[0] * Y[1] * X[2] * X[3]) /
+		(x - y);
+	double complex U13 =
+		(X[0] * X[2] * Y[1] * Y[3] + Y[0] * Y[2] * X[1] * X[3]) /
+		(x - y);
+	double complex U14 =
+		(X[0] * X[3] * Y[1] * Y[2] + Y[0] * Y[3] * X[1] * X[2]) /
+		(x - y);
+
+	p->U2[0] = U12 * U12;
+	p->U2[1] = U13 * U13;
+	p->U2[2] = U14 * U14;
+	p->i0 = 2.0 * creal(bhs_elliptic_rf(p->U2[0], p->U2[1], p->U2[2]));
+}
+
+/**
+ * path_third - ∫ dr / ((r - q) √R) no trecho, q fora dele
+ *
+ * Carlson (1988): com d_ij = r_j - r_i e o índice 5 para q,
+ *   ∫ (r - r₁)/(r - q) dr/√R = ⅔ d₁₂d₁₃d₁₄/d₁₅ R_J(U², W²)
+ *                              + 2 R_C(P², Q²)
+ *   W² = U₁₂² - d₁₃d₁₄d₂₅/d₁₅
+ *   Q² = (X₅Y₅ / X₁Y₁)² W²,  P² = Q² + d₂₅d₃₅d₄₅/d₁₅
+ * e (r - r₁)/(r - q) = 1 + d₁₅/(r - q). r₁ tem que ser real quando
+ * houver raiz real; com duas ou mais reais W², P² e Q² são reais.
+ */
+static double path_third(const struct bhs_kerr_elliptic *ray,
+			 const struct radial_path *p, double q)
+{
+	const double complex *r = ray->root;
+	double complex d12 = r[1] - r[0], d13 = r[2] - r[0];
+	double complex d14 = r[3] - r[0], d15 = q - r[0];
+	double complex d25 = q - r[1], d35 = q - r[2], d45 = q - r[3];
+	double complex X5Y5 = sqrt((p->x - q) * (p->y - q));
+
+	double complex W2 = p->U2[0] - d13 * d14 * d25 / d15;
+	double complex f = X5Y5 / (p->X[0] * p->Y[0]);
+	double complex Q2 = f * f * W2;
+	double complex P2 = Q2 + d25 * d35 * d45 / d15;
+
+	if (ray->n_real > 0) {
+		W2 = creal(W2);
+		Q2 = creal(Q2);
+		P2 = creal(P2);
+	}
+
+	double complex ie =
+		2.0 / 3.0 * d12 * d13 * d14 / d15 *
+			bhs_elliptic_rj(p->U2[0], p->U2[1], p->U2[2], W2) +
+		2.0 * bhs_elliptic_rc(P2, Q2);
+
+	return creal((ie - p->i0) / d15);
+}
+
+/**
+ * path_phi - Parte radial de φ no trecho
+ *
+ * a(2Mr - aλ)/Δ em frações parciais sobre r±:
+ *   a/(r+ - r-) [(2Mr+ - aλ)/(r - r+) - (2Mr- - aλ)/(r - r-)]
+ */
+static double path_phi(const struct bhs_kerr_elliptic *ray,
+		       const struct radial_path *p)
+{
+	double a = ray->a, M = ray->M, al = a * ray->lambda;
+	double rp = ray->r_plus, rm = ray->r_minus;
+
+	if (a == 0.0)
+		return 0.0;
+
+	return a / (rp - rm) *
+	       ((2.0 * M * rp - al) * path_third(ray, p, rp) -
+		(2.0 * M * rm - al) * path_third(ray, p, rm));
+}
+
+/* Tempo de Mino e (se @phi) parte radial de φ entre y e x */
+static double segment(const struct bhs_kerr_elliptic *ray, double y, double x,
+		      double *phi)
+{
+	struct radial_path p;
+
+	if (!(x > y)) {
+		if (phi)
+			*phi = 0.0;
+		return 0.0;
+	}
+
+	path_init(ray, y, x, &p);
+	if (phi)
+		*phi = path_phi(ray, &p);
+	return p.i0;
+}
+
+/* ============================================================================
+ * r(σ)
+ * ============================================================================
+ */
+
+/* Raio a Mino τ ≥ 0 do ponto de retorno r₄ (quatro raízes reais) */
+static double radial_jacobi(const struct bhs_kerr_elliptic *ray, double tau)
+{
+	double r1 = creal(ray->root[0]), r3 = creal(ray->root[2]);
+	double r4 = creal(ray->root[3]);
+	double r31 = r3 - r1, r41 = r4 - r1;
+	double sn;
+
+	bhs_elliptic_jacobi(ray->X_scale * tau, ray->k2, &sn, NULL, NULL);
+	double s2 = sn * sn;
+	double den = r31 - r41 * s2;
+
+	/* Além do polo de r(σ): o raio já foi para o infinito */
+	if (!(den > 0.0))
+		return INFINITY;
+	return (r4 * r31 - r3 * r41 * s2) / den;
+}
+
+/* Menor raio em que R > 0 até r₀ sem ponto de retorno */
+static double radial_floor(const struct bhs_kerr_elliptic *ray)
+{
+	double lo = ray->r_minus;
+
+	if (ray->n_real > 0)
+		lo = fmax(lo, creal(ray->root[ray->n_real - 1]));
+	return lo;
+}
+
+/**
+ * radial_invert - r(σ) sem ponto de retorno
+ *
+ * Newton sobre σ(r) = ∫ dr/√R com dσ/dr = ±1/√R, protegido por
+ * bisseção: cada iteração é um R_F.
+ */
+static double radial_invert(const struct bhs_kerr_elliptic *ray, double sigma)
+{
+	double r0 = ray->r0;
+	double lo, hi, r;
+
+	if (sigma <= 0.0)
+		return r0;
+
+	if (ray->ingoing) {
+		lo = radial_floor(ray);
+		hi = r0;
+		if (segment(ray, lo, r0, NULL) <= sigma)
+			return lo;
+	} else {
+		lo = r0;
+		hi = 2.0 * r0;
+		for (int i = 0; i < 64 && segment(ray, r0, hi, NULL) < sigma;
+		     i++) {
+			lo = hi;
+			hi *= 2.0;
+		}
+	}
+
+	r = ray->ingoing ? r0 - sigma * sqrt(radial_potential(ray, r0))
+			 : r0 + sigma * sqrt(radial_potential(ray, r0));
+	for (int it = 0; it < INVERT_MAX_ITER; it++) {
+		if (!(r > lo && r < hi))
+			r = 0.5 * (lo + hi);
+
+		double s = ray->ingoing ? segment(ray, r, r0, NULL)
+					: segment(ray, r0, r, NULL);
+		double f = s - sigma;
+
+		/* σ cresce para dentro se caindo, para fora se saindo */
+		if ((f > 0.0) == ray->ingoing)
+			lo = r;
+		else
+			hi = r;
+
+		double step = f * sqrt(fmax(radial_potential(ray, r), 0.0));
+		double next = ray->ingoing ? r + step : r - step;
+		if (fabs(next - r) < 1e-14 * r || hi - lo < 1e-14 * r)
+			return next > lo && next < hi ? next : r;
+		r = next;
+	}
+	return r;
+}
+
+double bhs_kerr_elliptic_r(const struct bhs_kerr_elliptic *ray, double sigma,
+			   double *dr)
+{
+	double r, sign;
+
+	if (ray->turning) {
+		double tau = sigma - ray->sigma_turn;
+		r = radial_jacobi(ray, fabs(tau));
+		sign = tau < 0.0 ? -1.0 : 1.0;
+	} else {
+		r = radial_invert(ray, sigma);
+		sign = ray->ingoing ? -1.0 : 1.0;
+	}
+
+	if (dr)
+		*dr = sign * sqrt(fmax(radial_potential(ray, r), 0.0));
+	return r;
+}
+
+double bhs_kerr_elliptic_end(const struct bhs_kerr_elliptic *ray, double r_in,
+			     double r_out, bool *captured)
+{
+	double r0 = ray->r0;
+
+	*captured = !ray->turning && ray->ingoing;
+
+	if (*captured)
+		return segment(ray, fmax(r_in, radial_floor(ray)), r0, NULL);
+
+	if (ray->turning)
+		return fmax(ray->sigma_turn +
+				    segment(ray, creal(ray->root[3]), r_out,
+					    NULL),
+			    0.0);
+
+	return segment(ray, r0, r_out, NULL);
+}
+
+/* ============================================================================
+ * POLAR
+ * ============================================================================
+ */
+
+static void polar_jacobi(const struct bhs_kerr_elliptic *ray, double w,
+			 double *sn, double *cn, double *dn)
+{
+	double period = 4.0 * ray->K;
+
+	w -= period * floor(w / period);
+	bhs_elliptic_jacobi(w, ray->m, sn, cn, dn);
+}
+
+/**
+ * polar_pi - Π(u₊; am w | m) continuada para todo w
+ *
+ * Em w ∈ [-K, K) a amplitude é atan2(sn, cn); cada 2K somam 2Π(u₊|m).
+ */
+static double polar_pi(const struct bhs_kerr_elliptic *ray, double w)
+{
+	double K = ray->K;
+	double j = floor((w + K) / (2.0 * K));
+	double sn, cn;
+
+	bhs_elliptic_jacobi(w - 2.0 * K * j, ray->m, &sn, &cn, NULL);
+	return 2.0 * j * ray->Pi +
+	       bhs_elliptic_pi(ray->u_plus, atan2(sn, cn), ray->m);
+}
+
+double bhs_kerr_elliptic_theta(const struct bhs_kerr_elliptic *ray,
+			       double sigma, double *dtheta)
+{
+	double su = sqrt(ray->u_plus);
+	double sn, cn, dn;
+
+	polar_jacobi(ray, ray->w0 + ray->A * sigma, &sn, &cn, &dn);
+
+	double x = su * sn;
+	if (dtheta)
+		*dtheta = -su * ray->A * cn * dn / sqrt(1.0 - x * x);
+	return acos(x);
+}
+
+double bhs_kerr_elliptic_equator(const struct bhs_kerr_elliptic *ray, int n)
+{
+	double K2 = 2.0 * ray->K;
+	double j = floor(ray->w0 / K2) + 1.0 + n;
+
+	return (K2 * j - ray->w0) / ray->A;
+}
+
+int bhs_kerr_elliptic_polar_turns(const struct bhs_kerr_elliptic *ray,
+				  double sigma)
+{
+	double K = ray->K, w0 = ray->w0;
+	double w = w0 + ray->A * sigma;
+
+	return (int)(floor((w - K) / (2.0 * K)) - floor((w0 - K) / (2.0 * K)));
+}
+
+/* ============================================================================
+ * φ
+ * ============================================================================
+ */
+
+double bhs_kerr_elliptic_phi_at(const struct bhs_kerr_elliptic *ray,
+				double sigma, double r)
+{
+	double r0 = ray->r0;
+	double phi_r;
+
+	if (ray->ingoing && (!ray->turning || sigma <= ray->sigma_turn)) {
+		segment(ray, r, r0, &phi_r);
+	} else if (ray->ingoing) {
+		segment(ray, creal(ray->root[3]), r, &phi_r);
+		phi_r += ray->phi_turn;
+	} else {
+		segment(ray, r0, r, &phi_r);
+	}
+
+	double w = ray->w0 + ray->A * sigma;
+	double phi_theta =
+		ray->lambda / ray->A * (polar_pi(ray, w) - ray->Pi_w0);
+
+	return ray->phi0 + phi_r + phi_theta;
+}
+
+double bhs_kerr_elliptic_phi(const struct bhs_kerr_elliptic *ray,
+			     double sigma)
+{
+	return bhs_kerr_elliptic_phi_at(
+		ray, sigma, bhs_kerr_elliptic_r(ray, sigma, NULL));
+}
+
+/* ============================================================================
+ * INICIALIZAÇÃO
+ * ============================================================================
+ */
+
+/**
+ * polar_init - u₊, A, m e fase inicial
+ *
+ * Raízes em x² de a²x⁴ + (η + λ² - a²)x² - η: com h = (a² - η - λ²)/2,
+ * a²u± = h ± √(h² + a²η). Escolhendo a forma sem cancelamento, a = 0
+ * não é caso especial (m = 0, u₊ = η/(η + λ²)).
+ */
+static int polar_init(struct bhs_kerr_elliptic *ray, double theta,
+		      int sign_theta)
+{
+	double a2 = ray->a * ray->a, eta = ray->eta, lam = ray->lambda;
+	double h = 0.5 * (a2 - eta - lam * lam);
+	double disc = sqrt(h * h + a2 * eta);
+
+	ray->u_plus = h <= 0.0 ? eta / (disc - h) : (h + disc) / a2;
+	if (!(ray->u_plus < 1.0 - 1e-12))
+		return -1;
+
+	ray->A = sqrt(eta / ray->u_plus);
+	ray->m = -a2 * ray->u_plus * ray->u_plus / eta;
+	ray->K = bhs_elliptic_k(ray->m);
+	ray->Pi = bhs_elliptic_pi(ray->u_plus, M_PI_2, ray->m);
+
+	double s0 = cos(theta) / sqrt(ray->u_plus);
+	double F0 = bhs_elliptic_f(asin(fmin(fmax(s0, -1.0), 1.0)), ray->m);
+
+	/* dx/dσ = -sin θ dθ/dσ: θ crescendo é sn descendo */
+	ray->w0 = sign_theta > 0 ? 2.0 * ray->K - F0 : F0;
+	ray->Pi_w0 = polar_pi(ray, ray->w0);
+	return 0;
+}
+
+int bhs_kerr_elliptic_init(struct bhs_kerr_elliptic *ray,
+			   const struct bhs_kerr *bh, double r, double theta,
+			   double phi, double lambda, double eta, int sign_r,
+			   int sign_theta)
+{
+	double M = bh->M, a = bh->a;
+
+	ray->M = M;
+	ray->a = a;
+	ray->lambda = lambda;
+	ray->eta = eta;
+	ray->r0 = r;
+	ray->phi0 = phi;
+	ray->r_plus = bhs_kerr_horizon_outer(bh);
+	ray->r_minus = bhs_kerr_horizon_inner(bh);
+	ray->ingoing = sign_r < 0;
+
+	if (!(eta > 0.0) || !(ray->r_plus - ray->r_minus > 1e-6 * M) ||
+	    !(r > ray->r_plus) || !(theta > 0.0 && theta < M_PI))
+		return -1;
+
+	ray->n_real = radial_roots(ray);
+	if (ray->n_real < 0)
+		return -1;
+
+	/* r₀ tem que estar acima de todas as raízes reais */
+	double top = ray->n_real > 0 ? creal(ray->root[ray->n_real - 1])
+				     : -INFINITY;
+	if (r < top)
+		return -1;
+
+	ray->turning = ray->n_real == 4 && top > ray->r_plus;
+	ray->sigma_turn = 0.0;
+	ray->phi_turn = 0.0;
+	ray->X_scale = 0.0;
+	ray->k2 = 0.0;
+
+	if (ray->turning) {
+		double r1 = creal(ray->root[0]), r2 = creal(ray->root[1]);
+		double r3 = creal(ray->root[2]), r4 = top;
+		double tau0 = segment(ray, r4, r, &ray->phi_turn);
+
+		ray->X_scale = 0.5 * sqrt((r3 - r1) * (r4 - r2));
+		ray->k2 = (r3 - r2) * (r4 - r1) / ((r3 - r1) * (r4 - r2));
+		ray->sigma_turn = ray->ingoing ? tau0 : -tau0;
+	}
+
+	return polar_init(ray, theta, sign_theta);
+}
@@ -0,0 +1,170 @@
+/**
+ * @file kerr_elliptic.h
+ * @brief Geodésicas nulas de Kerr em forma fechada (tempo de Mino)
+ *
+ * "Por que integrar passo a passo o que Carter separou em 1968?"
+ *
+ * Com λ = L/E e η = Q/E² o movimento de um fóton separa em tempo de
+ * Mino σ (dλ_afim = Σ dσ / E):
+ *
+ *   (dr/dσ)² = R(r) = r⁴ + (a² - η - λ²) r² + 2M[η + (λ - a)²] r - a²η
+ *   (dx/dσ)² = η - (η + λ² - a²) x² - a² x⁴,   x = cos θ
+ *   dφ/dσ    = a(2Mr - aλ)/Δ + λ/(1 - x²)
+ *
+ * Polar: x(σ) = √u₊ sn(A σ + w₀ | m), com u₊ a raiz positiva em x² e
+ * m = -a²u₊²/η ≤ 0. Cruzamentos do equador em A σ + w₀ = 2Kj, pontos de
+ * retorno polares em (2j + 1)K: sem busca nenhuma, a imagem de ordem n
+ * do disco é o n-ésimo zero de sn.
+ *
+ * Radial: as raízes de R saem do resolvente cúbico (Gralla & Lupsasca
+ * 2020) e todo trecho monótono de r vira R_F (tempo de Mino) e R_J + R_C
+ * (parte radial de φ) pelas reduções de Carlson (1988) para quárticas,
+ * com as raízes complexas entrando direto nos argumentos. Com ponto de
+ * retorno r₄ > r+ o raio escapa e r(σ) é a inversão de Jacobi; sem ele,
+ * cai, e r(σ) é Newton sobre R_F.
+ *
+ * Custo fixo por raio: nada aqui depende de quantas voltas o fóton dá na
+ * esfera de fótons. O tempo coordenado t (e o parâmetro afim) pedem
+ * integrais de segunda espécie e não são calculados.
+ *
+ * Fora do escopo (bhs_kerr_elliptic_init() devolve -1): η ≤ 0 (raios
+ * presos ao equador ou vorticais), λ ≈ 0 (passa pelo eixo, onde φ de BL
+ * salta), raio começando entre raízes ou dentro do horizonte, e Kerr
+ * extremo (r+ = r-).
+ */
+
+#ifndef BHS_CORE_SPACETIME_KERR_ELLIPTIC_H
+#define BHS_CORE_SPACETIME_KERR_ELLIPTIC_H
+
+#include <complex.h>
+#include <stdbool.h>
+
+#include "math/spacetime/kerr.h"
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_kerr_elliptic - Um fóton de Kerr resolvido
+ * @M, @a: buraco negro
+ * @lambda, @eta: λ = L/E, η = Q/E²
+ * @r0, @phi0: posição inicial (θ₀ fica em @w0)
+ * @r_plus, @r_minus: horizontes
+ * @root: raízes de R; reais primeiro, crescentes, depois o par complexo
+ * @n_real: quantas raízes reais (0, 2 ou 4)
+ * @turning: há ponto de retorno radial r₄ > r+ (o raio escapa)
+ * @ingoing: dr/dσ < 0 no início
+ * @sigma_turn: σ do ponto de retorno (negativo se já passou, raio saindo)
+ * @phi_turn: parte radial de φ entre r₀ e r₄
+ * @X_scale, @k2: r(σ) de Jacobi: sn(X_scale |σ - sigma_turn| | k2)
+ * @u_plus: maior x² alcançado (x² ≤ u₊)
+ * @A, @m: x(σ) = √u₊ sn(A σ + w₀ | m)
+ * @K: K(m)
+ * @Pi: Π(u₊ | m) completa
+ * @w0: fase inicial em [-K, 3K)
+ * @Pi_w0: Π(u₊; am w₀ | m) estendida (quase-periódica)
+ */
+struct bhs_kerr_elliptic {
+	double M, a;
+	double lambda, eta;
+	double r0, phi0;
+	double r_plus, r_minus;
+
+	double complex root[4];
+	int n_real;
+	bool turning;
+	bool ingoing;
+	double sigma_turn;
+	double phi_turn;
+	double X_scale, k2;
+
+	double u_plus;
+	double A, m;
+	double K;
+	double Pi;
+	double w0;
+	double Pi_w0;
+};
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_kerr_elliptic_init - Raízes, fases e constantes de um fóton
+ * @ray: [out] estado
+ * @bh: buraco negro (|a| < M)
+ * @r, @theta, @phi: posição inicial em Boyer-Lindquist
+ * @lambda: L/E
+ * @eta: Q/E² (> 0)
+ * @sign_r: sinal de dr/dλ (≥ 0 conta como saindo)
+ * @sign_theta: sinal de dθ/dλ
+ *
+ * Retorna: 0 em sucesso, -1 fora do escopo (ver o topo do arquivo)
+ */
+int bhs_kerr_elliptic_init(struct bhs_kerr_elliptic *ray,
+			   const struct bhs_kerr *bh, double r, double theta,
+			   double phi, double lambda, double eta, int sign_r,
+			   int sign_theta);
+
+/**
+ * bhs_kerr_elliptic_end - Tempo de Mino até o fim do raio
+ * @r_in: raio de captura (≥ r+; com r+ a parte radial de φ diverge)
+ * @r_out: raio de escape
+ * @captured: [out] termina em @r_in (senão, em @r_out)
+ *
+ * Um raio caindo sem ponto de retorno é capturado; todo o resto escapa.
+ * Um raio que já começa além de @r_out saindo termina em σ = 0.
+ */
+double bhs_kerr_elliptic_end(const struct bhs_kerr_elliptic *ray, double r_in,
+			     double r_out, bool *captured);
+
+/**
+ * bhs_kerr_elliptic_r - r(σ)
+ * @dr: [out] dr/dσ = ±√R (pode ser NULL)
+ */
+double bhs_kerr_elliptic_r(const struct bhs_kerr_elliptic *ray, double sigma,
+			   double *dr);
+
+/**
+ * bhs_kerr_elliptic_theta - θ(σ)
+ * @dtheta: [out] dθ/dσ = ±√Θ (pode ser NULL)
+ */
+double bhs_kerr_elliptic_theta(const struct bhs_kerr_elliptic *ray,
+			       double sigma, double *dtheta);
+
+/**
+ * bhs_kerr_elliptic_phi - φ(σ), sem redução a [0, 2π)
+ *
+ * Cada chamada resolve r(σ) de novo; quem já tem r passa por
+ * bhs_kerr_elliptic_phi_at().
+ */
+double bhs_kerr_elliptic_phi(const struct bhs_kerr_elliptic *ray,
+			     double sigma);
+
+/**
+ * bhs_kerr_elliptic_phi_at - φ(σ) com r = r(σ) já conhecido
+ */
+double bhs_kerr_elliptic_phi_at(const struct bhs_kerr_elliptic *ray,
+				double sigma, double r);
+
+/**
+ * bhs_kerr_elliptic_equator - σ do @n-ésimo cruzamento de θ = π/2
+ * @n: 0 para o primeiro depois de σ = 0 (imagem direta), 1 para o
+ *     seguinte (primeira imagem secundária), ...
+ *
+ * Sempre existe: com η > 0 o fóton oscila em θ para sempre. Quem chama
+ * compara com bhs_kerr_elliptic_end().
+ */
+double bhs_kerr_elliptic_equator(const struct bhs_kerr_elliptic *ray, int n);
+
+/**
+ * bhs_kerr_elliptic_polar_turns - Pontos de retorno em θ em (0, σ]
+ */
+int bhs_kerr_elliptic_polar_turns(const struct bhs_kerr_elliptic *ray,
+				  double sigma);
+
+#endif /* BHS_CORE_SPACETIME_KERR_ELLIPTIC_H */
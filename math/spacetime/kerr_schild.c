@@ -0,0 +1,340 @@
+/**
+ * @file kerr_schild.c
+ * @brief Implementação da métrica de Kerr em Kerr-Schild cartesiano
+ *
+ * "Kerr publicou a solução já nessas coordenadas. Boyer e Lindquist
+ * vieram depois deixar tudo mais bonito e mais singular."
+ *
+ * Referência:
+ * - Kerr (1963), Phys. Rev. Lett. 11, 237
+ * - Visser (2007) - The Kerr spacetime: a brief introduction
+ */
+
+#define _GNU_SOURCE /* Para M_PI */
+
+#include "kerr_schild.h"
+#include <math.h>
+
+/* ============================================================================
+ * CAMPO f, l E DERIVADAS
+ * ============================================================================
+ */
+
+/**
+ * struct ks_field - Tudo que a métrica precisa num ponto
+ * @r: raio BL
+ * @f: 2Mr³ / (r⁴ + a²z²)
+ * @l: l_μ covariante (l[0] = 1)
+ * @df: ∂_i f, i = x, y, z
+ * @dl: ∂_i l_μ (dl[i][0] = 0)
+ */
+struct ks_field {
+	double r;
+	double f;
+	double l[4];
+	double df[3];
+	double dl[3][4];
+};
+
+/*
+ * Com D = r⁴ + a²z² e s = r² + a², derivando a equação implícita de r:
+ *   ∂r/∂x = x r³/D,  ∂r/∂y = y r³/D,  ∂r/∂z = z r s/D
+ */
+static int ks_field(const struct bhs_kerr *bh, double x, double y, double z,
+		    struct ks_field *F, bool derivs)
+{
+	double M = bh->M;
+	double a = bh->a;
+	double a2 = a * a;
+
+	double r = bhs_kerr_schild_r(bh, x, y, z);
+	double r2 = r * r;
+	double s = r2 + a2;
+	double D = r2 * r2 + a2 * z * z;
+	if (!(D > 0.0) || !(r > 0.0))
+		return -1;
+
+	F->r = r;
+	F->f = 2.0 * M * r2 * r / D;
+	F->l[0] = 1.0;
+	F->l[1] = (r * x + a * y) / s;
+	F->l[2] = (r * y - a * x) / s;
+	F->l[3] = z / r;
+
+	if (!derivs)
+		return 0;
+
+	double dr[3] = { x * r2 * r / D, y * r2 * r / D, z * r * s / D };
+
+	for (int i = 0; i < 3; i++) {
+		double dD = 4.0 * r2 * r * dr[i] + (i == 2 ? 2.0 * a2 * z : 0.0);
+		F->df[i] = 2.0 * M * (3.0 * r2 * dr[i] * D - r2 * r * dD) /
+			   (D * D);
+
+		double tr = 2.0 * r * dr[i] / s;
+		F->dl[i][0] = 0.0;
+		F->dl[i][1] = (dr[i] * x + (i == 0 ? r : 0.0) +
+			       (i == 1 ? a : 0.0)) / s -
+			      F->l[1] * tr;
+		F->dl[i][2] = (dr[i] * y + (i == 1 ? r : 0.0) -
+			       (i == 0 ? a : 0.0)) / s -
+			      F->l[2] * tr;
+		F->dl[i][3] = ((i == 2 ? 1.0 : 0.0) - z * dr[i] / r) / r;
+	}
+	return 0;
+}
+
+/* η^μμ: a diagonal de Minkowski */
+static const double ETA[4] = { -1.0, 1.0, 1.0, 1.0 };
+
+/* ============================================================================
+ * COORDENADAS
+ * ============================================================================
+ */
+
+double bhs_kerr_schild_r(const struct bhs_kerr *bh, double x, double y,
+			 double z)
+{
+	double a2 = bh->a * bh->a;
+	double w = 0.5 * (x * x + y * y + z * z - a2);
+	double r2 = w + sqrt(w * w + a2 * z * z);
+	return sqrt(fmax(r2, 0.0));
+}
+
+/*
+ * Integrais de 2Mr/Δ e a/Δ (t̃ - t e φ̃ - φ), com Φ → 0 no infinito:
+ *   T(r) = (M/w)[r+ ln|r - r+| - r- ln|r - r-|]
+ *   Φ(r) = (a/2w) ln|(r - r+)/(r - r-)|,  w = √(M² - a²)
+ * No extremo (w → 0) viram 2M ln|r - M| - 2M²/(r - M) e -a/(r - M).
+ */
+static void bl_offsets(const struct bhs_kerr *bh, double r, double *T,
+		       double *Phi)
+{
+	double M = bh->M;
+	double a = bh->a;
+	double w = sqrt(fmax(M * M - a * a, 0.0));
+
+	if (w < 1e-8 * M) {
+		*T = 2.0 * M * log(fabs(r - M)) - 2.0 * M * M / (r - M);
+		*Phi = -a / (r - M);
+		return;
+	}
+
+	double rp = M + w, rm = M - w;
+	*T = M / w * (rp * log(fabs(r - rp)) - rm * log(fabs(r - rm)));
+	*Phi = a / (2.0 * w) * log(fabs((r - rp) / (r - rm)));
+}
+
+int bhs_kerr_schild_from_bl(const struct bhs_kerr *bh, struct bhs_vec4 pos,
+			    struct bhs_vec4 vel, struct bhs_vec4 *pos_ks,
+			    struct bhs_vec4 *vel_ks)
+{
+	double a = bh->a;
+	double r = pos.x;
+	double Delta = bhs_kerr_Delta(bh, r);
+	if (Delta == 0.0)
+		return -1;
+
+	double T, Phi;
+	bl_offsets(bh, r, &T, &Phi);
+
+	double st = sin(pos.y), ct = cos(pos.y);
+	double pt = pos.z + Phi;
+	double sp = sin(pt), cp = cos(pt);
+
+	double x = st * (r * cp - a * sp);
+	double y = st * (r * sp + a * cp);
+	double z = r * ct;
+	*pos_ks = bhs_vec4_make(pos.t + T, x, y, z);
+
+	if (!vel_ks)
+		return 0;
+
+	double dr = vel.x;
+	double dth = vel.y;
+	double dpt = vel.z + a / Delta * dr;
+	*vel_ks = bhs_vec4_make(
+		vel.t + 2.0 * bh->M * r / Delta * dr,
+		ct * (r * cp - a * sp) * dth + st * cp * dr - y * dpt,
+		ct * (r * sp + a * cp) * dth + st * sp * dr + x * dpt,
+		ct * dr - r * st * dth);
+	return 0;
+}
+
+int bhs_kerr_schild_to_bl(const struct bhs_kerr *bh, struct bhs_vec4 pos_ks,
+			  struct bhs_vec4 vel_ks, struct bhs_vec4 *pos,
+			  struct bhs_vec4 *vel)
+{
+	double a = bh->a;
+	double x = pos_ks.x, y = pos_ks.y, z = pos_ks.z;
+	double rc2 = x * x + y * y;
+
+	double r = bhs_kerr_schild_r(bh, x, y, z);
+	double Delta = bhs_kerr_Delta(bh, r);
+	if (!(r > 0.0) || Delta == 0.0 || !(rc2 > 0.0))
+		return -1;
+
+	double T, Phi;
+	bl_offsets(bh, r, &T, &Phi);
+
+	double ct = fmin(fmax(z / r, -1.0), 1.0);
+	double theta = acos(ct);
+	double pt = atan2(y, x) - atan2(a, r);
+	*pos = bhs_vec4_make(pos_ks.t - T, r, theta,
+			     remainder(pt - Phi, 2.0 * M_PI));
+
+	if (!vel)
+		return 0;
+
+	double D = r * r * r * r + a * a * z * z;
+	double s = r * r + a * a;
+	double dr = (r * r * r * (x * vel_ks.x + y * vel_ks.y) +
+		     z * r * s * vel_ks.z) /
+		    D;
+	double st = sqrt(rc2 / s);
+	double dth = (ct * dr - vel_ks.z) / (r * st);
+	double dpt = (x * vel_ks.y - y * vel_ks.x) / rc2 + a * dr / s;
+
+	*vel = bhs_vec4_make(vel_ks.t - 2.0 * bh->M * r / Delta * dr, dr, dth,
+			     dpt - a / Delta * dr);
+	return 0;
+}
+
+/* ============================================================================
+ * MÉTRICA
+ * ============================================================================
+ */
+
+void bhs_kerr_schild_metric(const struct bhs_kerr *bh, double x, double y,
+			    double z, struct bhs_metric *out)
+{
+	struct ks_field F;
+	*out = bhs_metric_minkowski();
+	if (ks_field(bh, x, y, z, &F, false) != 0)
+		return;
+
+	out->structure = BHS_METRIC_GENERAL;
+	for (int m = 0; m < 4; m++)
+		for (int n = 0; n < 4; n++)
+			out->g[m][n] += F.f * F.l[m] * F.l[n];
+}
+
+void bhs_kerr_schild_metric_inverse(const struct bhs_kerr *bh, double x,
+				    double y, double z, struct bhs_metric *out)
+{
+	struct ks_field F;
+	*out = bhs_metric_minkowski();
+	if (ks_field(bh, x, y, z, &F, false) != 0)
+		return;
+
+	out->structure = BHS_METRIC_GENERAL;
+	/* l^μ = η^μν l_ν */
+	for (int m = 0; m < 4; m++)
+		for (int n = 0; n < 4; n++)
+			out->g[m][n] -= F.f * ETA[m] * F.l[m] * ETA[n] * F.l[n];
+}
+
+void bhs_kerr_schild_metric_func(struct bhs_vec4 coords, void *userdata,
+				 struct bhs_metric *out)
+{
+	const struct bhs_kerr *bh = userdata;
+	bhs_kerr_schild_metric(bh, coords.x, coords.y, coords.z, out);
+}
+
+const struct bhs_metric_desc BHS_KERR_SCHILD_METRIC_DESC = {
+	.fn = bhs_kerr_schild_metric_func,
+	.killing = BHS_METRIC_COORD(0),
+};
+
+/* ============================================================================
+ * CHRISTOFFEL E ACELERAÇÃO
+ * ============================================================================
+ */
+
+int bhs_kerr_schild_christoffel(const struct bhs_kerr *bh, double x, double y,
+				double z, struct bhs_christoffel *out)
+{
+	struct ks_field F;
+	if (ks_field(bh, x, y, z, &F, true) != 0)
+		return -1;
+
+	/* dg[μ][α][β] = ∂_μ g_αβ; ∂_t = 0 */
+	double dg[4][4][4] = { { { 0 } } };
+	for (int i = 0; i < 3; i++)
+		for (int m = 0; m < 4; m++)
+			for (int n = 0; n < 4; n++)
+				dg[i + 1][m][n] =
+					F.df[i] * F.l[m] * F.l[n] +
+					F.f * (F.dl[i][m] * F.l[n] +
+					       F.l[m] * F.dl[i][n]);
+
+	/* Γ_βμν = ½(∂_μ g_βν + ∂_ν g_βμ - ∂_β g_μν) */
+	double low[4][4][4];
+	for (int b = 0; b < 4; b++)
+		for (int m = 0; m < 4; m++)
+			for (int n = 0; n < 4; n++)
+				low[b][m][n] = 0.5 * (dg[m][b][n] +
+						      dg[n][b][m] -
+						      dg[b][m][n]);
+
+	/* Γ^α_μν = (η^αβ - f l^α l^β) Γ_βμν */
+	for (int m = 0; m < 4; m++) {
+		for (int n = 0; n < 4; n++) {
+			double lG = 0.0;
+			for (int b = 0; b < 4; b++)
+				lG += ETA[b] * F.l[b] * low[b][m][n];
+			for (int al = 0; al < 4; al++)
+				out->gamma[al][m][n] =
+					ETA[al] * low[al][m][n] -
+					F.f * ETA[al] * F.l[al] * lG;
+		}
+	}
+	return 0;
+}
+
+int bhs_kerr_schild_accel(const struct bhs_kerr *bh, struct bhs_vec4 pos,
+			  struct bhs_vec4 vel, struct bhs_vec4 *out)
+{
+	/*
+	 * a^α = -g^αβ (A_β - ½ B_β), com
+	 *   A_β = u^μ u^ν ∂_μ g_βν = l_β (L Df + f DL) + f L Dl_β
+	 *   B_β = u^μ u^ν ∂_β g_μν = ∂_β f L² + 2 f L ∂_β L
+	 * onde L = l·u, D = u^i ∂_i (derivada ao longo de u).
+	 */
+	struct ks_field F;
+	if (ks_field(bh, pos.x, pos.y, pos.z, &F, true) != 0)
+		return -1;
+
+	double u[4] = { vel.t, vel.x, vel.y, vel.z };
+
+	double L = 0.0;
+	for (int m = 0; m < 4; m++)
+		L += F.l[m] * u[m];
+
+	double dL[3], Df = 0.0, DL = 0.0, Dl[4] = { 0.0, 0.0, 0.0, 0.0 };
+	for (int i = 0; i < 3; i++) {
+		dL[i] = 0.0;
+		for (int m = 1; m < 4; m++) {
+			dL[i] += F.dl[i][m] * u[m];
+			Dl[m] += u[i + 1] * F.dl[i][m];
+		}
+		Df += u[i + 1] * F.df[i];
+		DL += u[i + 1] * dL[i];
+	}
+
+	double G[4], lG = 0.0;
+	for (int b = 0; b < 4; b++) {
+		G[b] = F.l[b] * (L * Df + F.f * DL) + F.f * L * Dl[b];
+		if (b > 0)
+			G[b] -= 0.5 * (F.df[b - 1] * L * L +
+				       2.0 * F.f * L * dL[b - 1]);
+		lG += ETA[b] * F.l[b] * G[b];
+	}
+
+	double acc[4];
+	for (int al = 0; al < 4; al++)
+		acc[al] = -ETA[al] * G[al] + F.f * ETA[al] * F.l[al] * lG;
+
+	*out = bhs_vec4_make(acc[0], acc[1], acc[2], acc[3]);
+	return 0;
+}
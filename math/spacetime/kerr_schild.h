@@ -0,0 +1,160 @@
+/**
+ * @file kerr_schild.h
+ * @brief Métrica de Kerr em coordenadas de Kerr-Schild cartesianas
+ *
+ * "Boyer-Lindquist vê o horizonte como o fim do mundo.
+ * Kerr-Schild vê como mais um lugar."
+ *
+ * Mesma geometria de kerr.h, outra carta. Em (t, x, y, z) a métrica é
+ * Minkowski mais um termo de posto 1 ao longo de uma congruência nula:
+ *
+ *   g_μν = η_μν + f l_μ l_ν
+ *   f    = 2Mr³ / (r⁴ + a²z²)
+ *   l_μ  = (1, (rx + ay)/(r² + a²), (ry - ax)/(r² + a²), z/r)
+ *
+ * onde r é o raio de Boyer-Lindquist, raiz de
+ *   (x² + y²)/(r² + a²) + z²/r² = 1.
+ *
+ * Nada diverge em Δ = 0 nem nos polos: só no anel r = 0, z = 0. Um raio
+ * entra no horizonte com passo do mesmo tamanho que tinha fora.
+ *
+ * A carta é a de Kerr ingoing:
+ *   x + iy = (r + ia) sinθ e^{iφ̃},  z = r cosθ
+ *   dt̃ = dt + (2Mr/Δ) dr,  dφ̃ = dφ + (a/Δ) dr
+ * com as constantes de integração escolhidas para φ̃ → φ quando r → ∞.
+ *
+ * Assinatura: (-,+,+,+) mostly plus
+ */
+
+#ifndef BHS_CORE_SPACETIME_KERR_SCHILD_H
+#define BHS_CORE_SPACETIME_KERR_SCHILD_H
+
+#include "math/spacetime/kerr.h"
+#include "math/tensor/tensor.h"
+#include "math/vec4.h"
+
+/* ============================================================================
+ * COORDENADAS
+ * ============================================================================
+ */
+
+/**
+ * bhs_kerr_schild_r - Raio de Boyer-Lindquist no ponto (x, y, z)
+ *
+ * r² = ½(ρ² - a²) + √(¼(ρ² - a²)² + a²z²),  ρ² = x² + y² + z²
+ *
+ * r ≥ 0; é zero só no disco z = 0, x² + y² ≤ a².
+ */
+double bhs_kerr_schild_r(const struct bhs_kerr *bh, double x, double y,
+			 double z);
+
+/**
+ * bhs_kerr_schild_from_bl - Boyer-Lindquist → Kerr-Schild
+ * @bh: parâmetros do buraco negro
+ * @pos: (t, r, θ, φ)
+ * @vel: dx^μ/dλ em BL
+ * @pos_ks: [out] (t̃, x, y, z)
+ * @vel_ks: [out] dx^μ/dλ em KS (pode ser NULL)
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 se r está num horizonte (Δ = 0: a transformação é singular)
+ */
+int bhs_kerr_schild_from_bl(const struct bhs_kerr *bh, struct bhs_vec4 pos,
+			    struct bhs_vec4 vel, struct bhs_vec4 *pos_ks,
+			    struct bhs_vec4 *vel_ks);
+
+/**
+ * bhs_kerr_schild_to_bl - Kerr-Schild → Boyer-Lindquist
+ * @bh: parâmetros do buraco negro
+ * @pos_ks: (t̃, x, y, z)
+ * @vel_ks: dx^μ/dλ em KS
+ * @pos: [out] (t, r, θ, φ), φ em [-π, π]
+ * @vel: [out] dx^μ/dλ em BL (pode ser NULL)
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 em um horizonte, no anel ou no eixo (onde BL não tem u^θ, u^φ)
+ */
+int bhs_kerr_schild_to_bl(const struct bhs_kerr *bh, struct bhs_vec4 pos_ks,
+			  struct bhs_vec4 vel_ks, struct bhs_vec4 *pos,
+			  struct bhs_vec4 *vel);
+
+/* ============================================================================
+ * MÉTRICA
+ * ============================================================================
+ */
+
+/**
+ * bhs_kerr_schild_metric - g_μν em (t, x, y, z)
+ */
+void bhs_kerr_schild_metric(const struct bhs_kerr *bh, double x, double y,
+			    double z, struct bhs_metric *out);
+
+/**
+ * bhs_kerr_schild_metric_inverse - g^μν = η^μν - f l^μ l^ν
+ *
+ * Exata, sem inversão numérica: l é nulo para η e para g.
+ */
+void bhs_kerr_schild_metric_inverse(const struct bhs_kerr *bh, double x,
+				    double y, double z, struct bhs_metric *out);
+
+/**
+ * bhs_kerr_schild_metric_func - Wrapper para bhs_christoffel_compute
+ *
+ * Use como bhs_metric_func com userdata = struct bhs_kerr*
+ *
+ * Coordenadas em vec4: (t, x, y, z)
+ */
+void bhs_kerr_schild_metric_func(struct bhs_vec4 coords, void *userdata,
+				 struct bhs_metric *out);
+
+/**
+ * BHS_KERR_SCHILD_METRIC_DESC - Só t é de Killing
+ *
+ * A simetria axial existe mas não é uma coordenada (x, y, z); a métrica
+ * é densa.
+ */
+extern const struct bhs_metric_desc BHS_KERR_SCHILD_METRIC_DESC;
+
+/* ============================================================================
+ * CHRISTOFFEL E ACELERAÇÃO
+ * ============================================================================
+ */
+
+/**
+ * bhs_kerr_schild_christoffel - Γ^α_μν em forma fechada
+ * @bh: parâmetros do buraco negro
+ * @x, @y, @z: ponto
+ * @out: [out] símbolos de Christoffel em KS
+ *
+ * ∂_i g_μν = ∂_i f l_μ l_ν + f (∂_i l_μ l_ν + l_μ ∂_i l_ν), com ∂_i r
+ * tirado da equação implícita de r. Nenhuma diferença finita.
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 no anel (r⁴ + a²z² = 0)
+ */
+int bhs_kerr_schild_christoffel(const struct bhs_kerr *bh, double x, double y,
+				double z, struct bhs_christoffel *out);
+
+/**
+ * bhs_kerr_schild_accel - Aceleração geodésica -Γ^α_μν u^μ u^ν direta
+ * @bh: parâmetros do buraco negro
+ * @pos: (t, x, y, z)
+ * @vel: u^μ
+ * @out: [out] du^α/dλ
+ *
+ * Caminho quente do integrador. Com a forma de posto 1 tudo se reduz a
+ * escalares ao longo de u (L = l·u, u^i ∂_i f, u^i ∂_i l_μ): nenhuma
+ * das 64 componentes de Γ é montada. Mesmo resultado que contrair
+ * bhs_kerr_schild_christoffel().
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 no anel
+ */
+int bhs_kerr_schild_accel(const struct bhs_kerr *bh, struct bhs_vec4 pos,
+			  struct bhs_vec4 vel, struct bhs_vec4 *out);
+
+#endif /* BHS_CORE_SPACETIME_KERR_SCHILD_H */
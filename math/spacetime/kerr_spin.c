@@ -0,0 +1,292 @@
+/**
+ * @file kerr_spin.c
+ * @brief Tabela de raios críticos por spin
+ *
+ * "O ISCO não muda entre um pixel e outro. Ninguém tinha avisado a GPU."
+ */
+
+#include "kerr_spin.h"
+
+#include <math.h>
+
+#include "math/once.h"
+
+/* ============================================================================
+ * TABELA
+ * ============================================================================
+ */
+
+/* s do primeiro nó: χ = 1 - 0.05⁶ ≈ 1 - 1.6e-8 */
+#define S_MIN 0.05
+
+#define N BHS_KERR_SPIN_NODES
+#define C BHS_KERR_SPIN_CURVE
+
+enum {
+	COL_R_PLUS,
+	COL_R_MINUS,
+	COL_ISCO_PRO,
+	COL_ISCO_RETRO,
+	COL_PHOTON_PRO,
+	COL_PHOTON_RETRO,
+	COL_XI_PRO,
+	COL_XI_RETRO,
+};
+
+/*
+ * Com M = 1 e a = χ ≥ 0. u[i][k] é a posição relativa, entre as órbitas
+ * equatoriais, da órbita esférica com ξ = ξ_pro + k/(C-1) (ξ_retro - ξ_pro)
+ */
+static struct {
+	double rows[N][BHS_KERR_SPIN_COLS];
+	double u[N][C];
+} table;
+
+/* Estado de bhs_once() */
+static atomic_int table_state;
+
+static double node_s(int i)
+{
+	return S_MIN + (1.0 - S_MIN) * i / (N - 1);
+}
+
+/* ξ(r) da órbita esférica de fótons e dξ/dr (bhs_kerr_critical_orbit) */
+static double orbit_xi(double M, double a, double r, double *dxi)
+{
+	double num = r * r * (3.0 * M - r) - a * a * (r + M);
+	double dnum = 6.0 * M * r - 3.0 * r * r - a * a;
+	double den = a * (r - M);
+
+	*dxi = (dnum * den - num * a) / (den * den);
+	return num / den;
+}
+
+static void build_row(int i)
+{
+	double s = node_s(i);
+	double s3 = s * s * s;
+	double *row = table.rows[i];
+	struct bhs_kerr bh = { .M = 1.0, .a = 1.0 - s3 * s3 };
+
+	row[COL_R_PLUS] = bhs_kerr_horizon_outer(&bh);
+	row[COL_R_MINUS] = bhs_kerr_horizon_inner(&bh);
+	row[COL_ISCO_PRO] = bhs_kerr_isco(&bh, true);
+	row[COL_ISCO_RETRO] = bhs_kerr_isco(&bh, false);
+	row[COL_PHOTON_PRO] = bhs_kerr_photon_orbit(&bh, true);
+	row[COL_PHOTON_RETRO] = bhs_kerr_photon_orbit(&bh, false);
+
+	/* Em a = 0 ξ(r) é 0/0: vale o limite ±√27 e a curva de a → 0 */
+	double a = fmax(bh.a, 1e-6), d;
+	double lo = bhs_kerr_photon_orbit(&(struct bhs_kerr){ 1.0, a }, true);
+	double hi = bhs_kerr_photon_orbit(&(struct bhs_kerr){ 1.0, a }, false);
+	double xi_lo = orbit_xi(1.0, a, lo, &d);
+	double xi_hi = orbit_xi(1.0, a, hi, &d);
+
+	row[COL_XI_PRO] = bh.a > 0.0 ? xi_lo : sqrt(27.0);
+	row[COL_XI_RETRO] = bh.a > 0.0 ? xi_hi : -sqrt(27.0);
+
+	/* Bisseção como em bhs_kerr_in_shadow: ξ decresce de lo a hi */
+	for (int k = 0; k < C; k++) {
+		double xi = xi_lo + (xi_hi - xi_lo) * k / (C - 1);
+		double l = lo, h = hi;
+
+		for (int it = 0; it < 60; it++) {
+			double mid = 0.5 * (l + h);
+			if (orbit_xi(1.0, a, mid, &d) > xi)
+				l = mid;
+			else
+				h = mid;
+		}
+		table.u[i][k] = (0.5 * (l + h) - lo) / (hi - lo);
+	}
+}
+
+static void build_table(void)
+{
+	for (int i = 0; i < N; i++)
+		build_row(i);
+}
+
+static void table_ensure(void)
+{
+	bhs_once(&table_state, build_table);
+}
+
+/*
+ * Lagrange cúbico nos 4 nós em volta de @x (unidades de índice). As
+ * colunas são suaves em s, então não precisa da trava de monotonia de
+ * spline.h, que achata a derivada perto de χ = 0 (extremo de r+ em s = 1)
+ * e perde duas ordens de precisão ali.
+ */
+static double lagrange4(const double *y, int stride, double x)
+{
+	int i = (int)x - 1;
+	i = i < 0 ? 0 : (i > N - 4 ? N - 4 : i);
+	double t = x - i;
+	double t1 = t - 1.0, t2 = t - 2.0, t3 = t - 3.0;
+	const double *p = y + i * stride;
+
+	return (-t1 * t2 * t3 * p[0] + 3.0 * t * t2 * t3 * p[stride] -
+		3.0 * t * t1 * t3 * p[2 * stride] +
+		t * t1 * t2 * p[3 * stride]) / 6.0;
+}
+
+/* Posição de χ ≥ 0 na grade, em unidades de índice; < 0 fora da tabela */
+static double spin_pos(double chi)
+{
+	double s = sqrt(cbrt(1.0 - chi));
+
+	if (!(s >= S_MIN))
+		return -1.0; /* χ acima do último nó, ou > 1 (NaN) */
+	return (s - S_MIN) / (1.0 - S_MIN) * (N - 1);
+}
+
+/* ============================================================================
+ * CONSULTAS
+ * ============================================================================
+ */
+
+void bhs_kerr_spin_radii(const struct bhs_kerr *bh, struct bhs_kerr_radii *out)
+{
+	double M = bh->M;
+	double x = spin_pos(fabs(bh->a / M));
+
+	if (x < 0.0) {
+		/* photon_orbit conta "pro" a partir de +φ, o ISCO não */
+		bool pos = bh->a >= 0.0;
+		out->r_plus = bhs_kerr_horizon_outer(bh);
+		out->r_minus = bhs_kerr_horizon_inner(bh);
+		out->isco_pro = bhs_kerr_isco(bh, true);
+		out->isco_retro = bhs_kerr_isco(bh, false);
+		out->photon_pro = bhs_kerr_photon_orbit(bh, pos);
+		out->photon_retro = bhs_kerr_photon_orbit(bh, !pos);
+		return;
+	}
+
+	table_ensure();
+	double v[COL_PHOTON_RETRO + 1];
+	for (int c = 0; c <= COL_PHOTON_RETRO; c++)
+		v[c] = M * lagrange4(&table.rows[0][c], BHS_KERR_SPIN_COLS, x);
+
+	out->r_plus = v[COL_R_PLUS];
+	out->r_minus = v[COL_R_MINUS];
+	out->isco_pro = v[COL_ISCO_PRO];
+	out->isco_retro = v[COL_ISCO_RETRO];
+	out->photon_pro = v[COL_PHOTON_PRO];
+	out->photon_retro = v[COL_PHOTON_RETRO];
+}
+
+/*
+ * Raio da órbita esférica de fótons com esse ξ, para a > 0.
+ *
+ * Retorna 0 com *r, 1 se ξ está claramente fora da região de fótons, -1 se
+ * a tabela não cobre o spin ou Newton não convergiu.
+ */
+static int orbit_radius(const struct bhs_kerr *pos, double xi, double *r)
+{
+	double M = pos->M, a = pos->a;
+	double x = spin_pos(a / M);
+
+	if (x < 0.0)
+		return -1;
+	table_ensure();
+
+	int i = x < N - 1 ? (int)x : N - 2;
+	double f = x - i;
+	const double *r0 = table.rows[i], *r1 = table.rows[i + 1];
+#define LERP(col) (r0[col] + f * (r1[col] - r0[col]))
+	double lo = M * LERP(COL_PHOTON_PRO), hi = M * LERP(COL_PHOTON_RETRO);
+	double xi_lo = M * LERP(COL_XI_PRO), xi_hi = M * LERP(COL_XI_RETRO);
+#undef LERP
+
+	/* Folga de 1% da faixa: bem acima do erro do lerp nas pontas */
+	double v = (xi - xi_lo) / (xi_hi - xi_lo);
+	if (!(v > -0.01 && v < 1.01))
+		return 1;
+
+	double y = fmin(fmax(v, 0.0), 1.0) * (C - 1);
+	int k = y < C - 1 ? (int)y : C - 2;
+	double g = y - k;
+	double u = (1.0 - f) * ((1.0 - g) * table.u[i][k] +
+				g * table.u[i][k + 1]) +
+		   f * ((1.0 - g) * table.u[i + 1][k] +
+			g * table.u[i + 1][k + 1]);
+
+	/*
+	 * Fora da região de fótons a raiz (se achar) tem η_c < 0 e a
+	 * resposta continua certa, então Newton não precisa de trava ali
+	 */
+	*r = lo + u * (hi - lo);
+	for (int it = 0; it < 8; it++) {
+		double d, step = (orbit_xi(M, a, *r, &d) - xi) / d;
+		*r -= step;
+		if (!(*r > M))
+			return -1;
+		if (fabs(step) <= 1e-14 * *r)
+			return 0;
+	}
+	return -1;
+}
+
+bool bhs_kerr_spin_in_shadow(const struct bhs_kerr *bh, double xi, double eta)
+{
+	double M = bh->M;
+
+	if (eta < 0.0)
+		return false;
+
+	/* Schwarzschild: b² = ξ² + η < 27 M² */
+	if (fabs(bh->a) < 1e-10 * M)
+		return xi * xi + eta < 27.0 * M * M;
+
+	/* Espelho em φ, como em bhs_kerr_in_shadow */
+	struct bhs_kerr pos = { .M = M, .a = fabs(bh->a) };
+	double r, xc, eta_c;
+
+	switch (orbit_radius(&pos, bh->a < 0.0 ? -xi : xi, &r)) {
+	case 0:
+		bhs_kerr_critical_orbit(&pos, r, &xc, &eta_c);
+		return eta < eta_c;
+	case 1:
+		return false;
+	default:
+		return bhs_kerr_in_shadow(bh, xi, eta);
+	}
+}
+
+int bhs_kerr_spin_critical_curve(const struct bhs_kerr *bh, double v,
+				 double *xi, double *eta)
+{
+	if (bh->a == 0.0)
+		return -1;
+
+	struct bhs_kerr pos = { .M = bh->M, .a = fabs(bh->a) };
+	double lo = bhs_kerr_photon_orbit(&pos, true);
+	double hi = bhs_kerr_photon_orbit(&pos, false);
+	double d, r, xc;
+	double xi_lo = orbit_xi(pos.M, pos.a, lo, &d);
+	double xi_hi = orbit_xi(pos.M, pos.a, hi, &d);
+
+	v = fmin(fmax(v, 0.0), 1.0);
+	if (orbit_radius(&pos, xi_lo + v * (xi_hi - xi_lo), &r) != 0)
+		return -1;
+
+	bhs_kerr_critical_orbit(&pos, r, &xc, eta);
+	*xi = bh->a < 0.0 ? -xc : xc;
+	return 0;
+}
+
+void bhs_kerr_spin_pack(float *out)
+{
+	table_ensure();
+
+	out[0] = (float)N;
+	out[1] = (float)S_MIN;
+	out[2] = 1.0f;
+	out[3] = 0.0f;
+	for (int i = 0; i < N; i++) {
+		for (int c = 0; c < BHS_KERR_SPIN_COLS; c++)
+			out[4 + i * BHS_KERR_SPIN_COLS + c] =
+				(float)table.rows[i][c];
+	}
+}
@@ -0,0 +1,130 @@
+/**
+ * @file kerr_spin.h
+ * @brief Raios críticos de Kerr tabelados em função do spin
+ *
+ * "Raiz cúbica por pixel é o tipo de coisa que só se faz uma vez:
+ * a vez que alguém finalmente olha o profiler."
+ *
+ * Horizontes, ISCO, órbitas de fótons e a curva crítica (borda da sombra)
+ * só dependem de χ = a/M, com tudo em unidades de M. Este módulo calcula
+ * tudo uma vez numa grade de spin e as consultas interpolam.
+ *
+ * A grade é uniforme em s = (1 - |χ|)^(1/6), não em χ: perto do extremo
+ * r+ vai com √(1 - χ) e o ISCO com ∛(1 - χ), e os dois são polinômios em
+ * s. Interpolação cúbica em s vale até χ = 1 - 1.6e-8; acima disso, e
+ * para |χ| > 1, as consultas usam as fórmulas fechadas de kerr.h.
+ *
+ * A tabela é construída na primeira consulta (uns poucos ms), é global e
+ * só de leitura depois disso, e pode ser lida de qualquer thread.
+ */
+
+#ifndef BHS_CORE_SPACETIME_KERR_SPIN_H
+#define BHS_CORE_SPACETIME_KERR_SPIN_H
+
+#include <stdbool.h>
+
+#include "math/spacetime/kerr.h"
+
+/* ============================================================================
+ * CONSTANTES
+ * ============================================================================
+ */
+
+/** Nós de spin da tabela */
+#define BHS_KERR_SPIN_NODES 257
+
+/** Amostras da curva crítica por nó (uniformes em ξ) */
+#define BHS_KERR_SPIN_CURVE 33
+
+/** Colunas por nó no buffer da GPU (2 vec4) */
+#define BHS_KERR_SPIN_COLS 8
+
+/** Floats de bhs_kerr_spin_pack(): vec4 de cabeçalho + nós x colunas */
+#define BHS_KERR_SPIN_PACK_FLOATS (4 + BHS_KERR_SPIN_NODES * BHS_KERR_SPIN_COLS)
+
+/* ============================================================================
+ * TIPOS
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_kerr_radii - Raios críticos de um buraco negro de Kerr
+ * @r_plus, @r_minus: horizontes externo e interno
+ * @isco_pro, @isco_retro: ISCO co-rotante e contra-rotante
+ * @photon_pro, @photon_retro: órbitas circulares equatoriais de fótons
+ *                             (limites da região de fótons)
+ *
+ * Tudo em unidades de comprimento (já multiplicado por M). Com a < 0,
+ * "pro" continua sendo a órbita co-rotante com o buraco.
+ */
+struct bhs_kerr_radii {
+	double r_plus;
+	double r_minus;
+	double isco_pro;
+	double isco_retro;
+	double photon_pro;
+	double photon_retro;
+};
+
+/* ============================================================================
+ * API
+ * ============================================================================
+ */
+
+/**
+ * bhs_kerr_spin_radii - Raios críticos interpolados da tabela
+ * @bh: buraco negro
+ * @out: [out] raios
+ *
+ * Erro relativo abaixo de 1e-7 contra bhs_kerr_isco() e afins. Para
+ * HUD, disco e shaders; onde um raio decide captura, continue com a
+ * fórmula fechada (bhs_kerr_horizon_outer custa um sqrt).
+ */
+void bhs_kerr_spin_radii(const struct bhs_kerr *bh, struct bhs_kerr_radii *out);
+
+/**
+ * bhs_kerr_spin_in_shadow - bhs_kerr_in_shadow() partindo da tabela
+ * @bh: buraco negro
+ * @xi: L/E
+ * @eta: Q/E²
+ *
+ * A tabela dá o raio da órbita esférica com esse ξ a menos de ~1e-4. Dois
+ * ou três passos de Newton no ξ(r) exato fecham a conta. A resposta é a
+ * mesma de bhs_kerr_in_shadow() (salvo η a ~1e-12 da curva), sem as 60
+ * bisseções. Se Newton não converge, cai na versão exata.
+ */
+bool bhs_kerr_spin_in_shadow(const struct bhs_kerr *bh, double xi, double eta);
+
+/**
+ * bhs_kerr_spin_critical_curve - Ponto da curva crítica
+ * @bh: buraco negro (a ≠ 0)
+ * @v: parâmetro em [0, 1]: 0 = órbita co-rotante, 1 = contra-rotante,
+ *     ξ linear em @v entre as duas
+ * @xi: [out] ξ = L/E
+ * @eta: [out] η = Q/E²
+ *
+ * A borda da sombra parametrizada para desenho: ξ(v) e η(v) exatos (mesmo
+ * Newton de bhs_kerr_spin_in_shadow). O anel na tela vem de
+ * α = -ξ / sin θo, β = ±√(η + a² cos² θo - ξ² cot² θo).
+ *
+ * Retorna: 0 em sucesso, -1 com a = 0 (use b = √27 M) ou spin fora da tabela
+ */
+int bhs_kerr_spin_critical_curve(const struct bhs_kerr *bh, double v,
+				 double *xi, double *eta);
+
+/**
+ * bhs_kerr_spin_pack - Tabela de raios em float para a GPU
+ * @out: [out] BHS_KERR_SPIN_PACK_FLOATS floats
+ *
+ * Layout (std140/std430, vec4 alinhado):
+ *   out[0..3]: nós, s do primeiro nó, s do último nó, 0
+ *   depois, por nó i (s uniforme, χ = 1 - s⁶, com M = 1):
+ *     vec4 (r+, r-, isco_pro, isco_retro)
+ *     vec4 (photon_pro, photon_retro, ξ_pro, ξ_retro)
+ *
+ * Cabe num UBO (8 KB). Um shader com spin fixo no quadro recebe r+ e
+ * ISCO pelo push constant; a tabela é para spin variando por pixel/objeto.
+ */
+void bhs_kerr_spin_pack(float *out);
+
+#endif /* BHS_CORE_SPACETIME_KERR_SPIN_H */
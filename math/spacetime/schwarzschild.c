@@ -32,6 +32,7 @@ void bhs_schwarzschild_metric(const struct bhs_schwarzschild *bh, double r,
 	out->g[1][1] = 1.0 / f;			   /* g_rr */
 	out->g[2][2] = r2;			   /* g_θθ */
 	out->g[3][3] = r2 * sin_theta * sin_theta; /* g_φφ */
+	out->structure = BHS_METRIC_DIAGONAL;
 }
 
 void bhs_schwarzschild_metric_inverse(const struct bhs_schwarzschild *bh,
@@ -54,6 +55,7 @@ void bhs_schwarzschild_metric_inverse(const struct bhs_schwarzschild *bh,
 	out->g[1][1] = f;				   /* g^rr */
 	out->g[2][2] = 1.0 / r2;			   /* g^θθ */
 	out->g[3][3] = 1.0 / (r2 * sin_theta * sin_theta); /* g^φφ */
+	out->structure = BHS_METRIC_DIAGONAL;
 }
 
 double bhs_schwarzschild_redshift(const struct bhs_schwarzschild *bh, double r)
@@ -105,3 +107,11 @@ void bhs_schwarzschild_metric_func(struct bhs_vec4 coords, void *userdata,
 
 	bhs_schwarzschild_metric(bh, r, theta, out);
 }
+
+const struct bhs_metric_desc BHS_SCHWARZSCHILD_METRIC_DESC = {
+	.fn = bhs_schwarzschild_metric_func,
+	.killing = BHS_METRIC_COORD(0) | BHS_METRIC_COORD(3),
+	.zero = BHS_METRIC_COMP(0, 1) | BHS_METRIC_COMP(0, 2) |
+		BHS_METRIC_COMP(0, 3) | BHS_METRIC_COMP(1, 2) |
+		BHS_METRIC_COMP(1, 3) | BHS_METRIC_COMP(2, 3),
+};
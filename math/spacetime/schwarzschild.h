@@ -12,6 +12,8 @@
 #ifndef BHS_CORE_SPACETIME_SCHWARZSCHILD_H
 #define BHS_CORE_SPACETIME_SCHWARZSCHILD_H
 
+#include <math.h>
+
 #include "math/tensor/tensor.h"
 
 /* ============================================================================
@@ -75,6 +77,41 @@ bhs_schwarzschild_photon_sphere(const struct bhs_schwarzschild *bh)
 	return 3.0 * bh->M;
 }
 
+/* ============================================================================
+ * ÓRBITAS DE FÓTONS (BINET)
+ * ============================================================================
+ */
+
+/**
+ * bhs_schwarzschild_critical_b - Parâmetro de impacto crítico
+ *
+ * b_c = √27 M
+ *
+ * Fóton com b < b_c cai; com b > b_c passa. Em b = b_c ele espirala
+ * para sempre na esfera de fótons. É o raio da sombra visto do infinito.
+ */
+static inline double
+bhs_schwarzschild_critical_b(const struct bhs_schwarzschild *bh)
+{
+	return sqrt(27.0) * bh->M;
+}
+
+/**
+ * bhs_schwarzschild_binet - Lado direito da equação de Binet para luz
+ * @u: 1/r
+ *
+ * u'' + u = 3Mu²,  com ' = d/dψ no plano da órbita
+ *
+ * Retorna: u'' = 3Mu² - u. O fóton nunca sai do plano inicial: a
+ * trajetória inteira é esse problema 1D, com b = L/E só na condição
+ * inicial (u'² + u² - 2Mu³ = 1/b²).
+ */
+static inline double bhs_schwarzschild_binet(const struct bhs_schwarzschild *bh,
+					     double u)
+{
+	return 3.0 * bh->M * u * u - u;
+}
+
 /* ============================================================================
  * MÉTRICA
  * ============================================================================
@@ -145,4 +182,11 @@ double bhs_schwarzschild_escape_velocity(const struct bhs_schwarzschild *bh,
 void bhs_schwarzschild_metric_func(struct bhs_vec4 coords, void *userdata,
 				   struct bhs_metric *out);
 
+/**
+ * BHS_SCHWARZSCHILD_METRIC_DESC - Estática, esférica e diagonal
+ *
+ * t e φ de Killing, nada fora da diagonal.
+ */
+extern const struct bhs_metric_desc BHS_SCHWARZSCHILD_METRIC_DESC;
+
 #endif /* BHS_CORE_SPACETIME_SCHWARZSCHILD_H */
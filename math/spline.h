@@ -0,0 +1,35 @@
+/**
+ * @file spline.h
+ * @brief Interpolação cúbica monótona (Fritsch-Carlson) em grade uniforme
+ *
+ * "Spline natural passa por todos os pontos. E por alguns lugares onde
+ * ninguém pediu."
+ *
+ * Hermite cúbica com derivadas escolhidas para não criar extremos novos:
+ * entre duas amostras o valor fica entre elas, e um trecho monótono
+ * continua monótono (invertível). Tabelas de r(ψ), deflexão e afins não
+ * ganham oscilações perto de b crítico, onde a curva é quase degrau.
+ *
+ * Cada avaliação lê só as 4 amostras vizinhas: não há coeficientes
+ * pré-computados, então a tabela pode ser um mmap direto.
+ */
+
+#ifndef BHS_CORE_MATH_SPLINE_H
+#define BHS_CORE_MATH_SPLINE_H
+
+#include <stddef.h>
+
+/**
+ * bhs_spline_monotone - Valor em @x de amostras uniformes
+ * @y: primeira amostra
+ * @stride: distância (em doubles) entre amostras consecutivas
+ * @n: número de amostras (≥ 1)
+ * @x: posição em unidades de índice, presa em [0, n - 1]
+ *
+ * Derivadas nos nós: secante central limitada a 3x a menor secante
+ * vizinha e zero onde elas trocam de sinal (filtro de Hyman); nas pontas,
+ * a parábola pelos 3 nós da borda com o mesmo limite.
+ */
+double bhs_spline_monotone(const double *y, ptrdiff_t stride, int n, double x);
+
+#endif /* BHS_CORE_MATH_SPLINE_H */
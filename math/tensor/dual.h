@@ -0,0 +1,169 @@
+/**
+ * @file dual.h
+ * @brief Números duais para derivada automática (modo direto)
+ *
+ * "h = 1e-5 ou h = 1e-6? Nenhum dos dois. h = ε, com ε² = 0."
+ *
+ * Um struct bhs_dual carrega um valor e o gradiente dele em relação às
+ * quatro coordenadas: x = v + Σ d_μ ε_μ, com ε_μ ε_ν = 0. Avaliar uma
+ * métrica escrita com estas operações devolve g_μν e ∂_σ g_μν exatos
+ * (até o arredondamento) numa única passada, sem passo para ajustar.
+ *
+ * Para escrever um bhs_metric_dual_func: as coordenadas chegam já como
+ * variáveis (bhs_dual_var), constantes entram com bhs_dual_const ou
+ * pelas variantes _scale/_add_const, e cada conta de double vira a
+ * chamada correspondente. Ver bhs_kerr_metric_dual().
+ */
+
+#ifndef BHS_CORE_TENSOR_DUAL_H
+#define BHS_CORE_TENSOR_DUAL_H
+
+#include "math/bhs_math.h"
+
+/* ============================================================================
+ * TIPO
+ * ============================================================================
+ */
+
+/**
+ * struct bhs_dual - Valor e gradiente em (t, x¹, x², x³)
+ * @v: valor
+ * @d: ∂/∂x^μ
+ */
+struct bhs_dual {
+	real_t v;
+	real_t d[4];
+};
+
+/* ============================================================================
+ * CONSTRUÇÃO
+ * ============================================================================
+ */
+
+/**
+ * bhs_dual_const - Constante (gradiente nulo)
+ */
+static inline struct bhs_dual bhs_dual_const(real_t v)
+{
+	return (struct bhs_dual){ .v = v };
+}
+
+/**
+ * bhs_dual_var - Coordenada @mu valendo @v (∂x^μ/∂x^μ = 1)
+ */
+static inline struct bhs_dual bhs_dual_var(real_t v, int mu)
+{
+	struct bhs_dual x = { .v = v };
+	x.d[mu] = 1.0;
+	return x;
+}
+
+/* ============================================================================
+ * ARITMÉTICA
+ * ============================================================================
+ */
+
+static inline struct bhs_dual bhs_dual_add(struct bhs_dual a, struct bhs_dual b)
+{
+	struct bhs_dual r = { .v = a.v + b.v };
+	for (int i = 0; i < 4; i++)
+		r.d[i] = a.d[i] + b.d[i];
+	return r;
+}
+
+static inline struct bhs_dual bhs_dual_sub(struct bhs_dual a, struct bhs_dual b)
+{
+	struct bhs_dual r = { .v = a.v - b.v };
+	for (int i = 0; i < 4; i++)
+		r.d[i] = a.d[i] - b.d[i];
+	return r;
+}
+
+static inline struct bhs_dual bhs_dual_mul(struct bhs_dual a, struct bhs_dual b)
+{
+	struct bhs_dual r = { .v = a.v * b.v };
+	for (int i = 0; i < 4; i++)
+		r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+	return r;
+}
+
+static inline struct bhs_dual bhs_dual_div(struct bhs_dual a, struct bhs_dual b)
+{
+	real_t inv = 1.0 / b.v;
+	struct bhs_dual r = { .v = a.v * inv };
+	for (int i = 0; i < 4; i++)
+		r.d[i] = (a.d[i] - r.v * b.d[i]) * inv;
+	return r;
+}
+
+/**
+ * bhs_dual_scale - s · a, com s constante
+ */
+static inline struct bhs_dual bhs_dual_scale(struct bhs_dual a, real_t s)
+{
+	struct bhs_dual r = { .v = a.v * s };
+	for (int i = 0; i < 4; i++)
+		r.d[i] = a.d[i] * s;
+	return r;
+}
+
+/**
+ * bhs_dual_add_const - a + c, com c constante
+ */
+static inline struct bhs_dual bhs_dual_add_const(struct bhs_dual a, real_t c)
+{
+	a.v += c;
+	return a;
+}
+
+/* ============================================================================
+ * FUNÇÕES ELEMENTARES (f(a) = f(v) + f'(v) d ε)
+ * ============================================================================
+ */
+
+static inline struct bhs_dual bhs_dual_chain(struct bhs_dual a, real_t f,
+					     real_t df)
+{
+	struct bhs_dual r = { .v = f };
+	for (int i = 0; i < 4; i++)
+		r.d[i] = df * a.d[i];
+	return r;
+}
+
+static inline struct bhs_dual bhs_dual_sqrt(struct bhs_dual a)
+{
+	real_t s = bhs_sqrt(a.v);
+	return bhs_dual_chain(a, s, 0.5 / s);
+}
+
+static inline struct bhs_dual bhs_dual_sin(struct bhs_dual a)
+{
+	return bhs_dual_chain(a, bhs_sin(a.v), bhs_cos(a.v));
+}
+
+static inline struct bhs_dual bhs_dual_cos(struct bhs_dual a)
+{
+	return bhs_dual_chain(a, bhs_cos(a.v), -bhs_sin(a.v));
+}
+
+static inline struct bhs_dual bhs_dual_exp(struct bhs_dual a)
+{
+	real_t e = exp(a.v);
+	return bhs_dual_chain(a, e, e);
+}
+
+static inline struct bhs_dual bhs_dual_log(struct bhs_dual a)
+{
+	return bhs_dual_chain(a, log(a.v), 1.0 / a.v);
+}
+
+/**
+ * bhs_dual_pow - a^p com expoente constante
+ */
+static inline struct bhs_dual bhs_dual_pow(struct bhs_dual a, real_t p)
+{
+	real_t f = bhs_pow(a.v, p);
+	return bhs_dual_chain(a, f, p * bhs_pow(a.v, p - 1.0));
+}
+
+#endif /* BHS_CORE_TENSOR_DUAL_H */
@@ -21,7 +21,8 @@ const struct bhs_metric BHS_MINKOWSKI = { .g = {
 						  { 0.0, 1.0, 0.0, 0.0 },
 						  { 0.0, 0.0, 1.0, 0.0 },
 						  { 0.0, 0.0, 0.0, 1.0 },
-					  } };
+					  },
+					  .structure = BHS_METRIC_DIAGONAL };
 
 /* ============================================================================
  * OPERAÇÕES COM MÉTRICA
@@ -48,9 +49,23 @@ struct bhs_metric bhs_metric_diag(real_t g00, real_t g11, real_t g22,
 	m.g[1][1] = g11;
 	m.g[2][2] = g22;
 	m.g[3][3] = g33;
+	m.structure = BHS_METRIC_DIAGONAL;
 	return m;
 }
 
+enum bhs_metric_structure bhs_metric_classify(const struct bhs_metric *m)
+{
+	unsigned zero = 0;
+
+	for (int mu = 0; mu < 4; mu++) {
+		for (int nu = 0; nu < 4; nu++) {
+			if (m->g[mu][nu] == 0.0 && m->g[nu][mu] == 0.0)
+				zero |= BHS_METRIC_COMP(mu, nu);
+		}
+	}
+	return bhs_metric_structure_of(zero);
+}
+
 bool bhs_metric_is_symmetric(const struct bhs_metric *m, real_t tol)
 {
 	for (int i = 0; i < 4; i++) {
@@ -64,6 +79,14 @@ bool bhs_metric_is_symmetric(const struct bhs_metric *m, real_t tol)
 
 real_t bhs_metric_det(const struct bhs_metric *m)
 {
+	const real_t(*d)[4] = m->g;
+
+	if (m->structure == BHS_METRIC_DIAGONAL)
+		return d[0][0] * d[1][1] * d[2][2] * d[3][3];
+	if (m->structure == BHS_METRIC_TPHI)
+		return (d[0][0] * d[3][3] - d[0][3] * d[3][0]) * d[1][1] *
+		       d[2][2];
+
 	/*
    * Determinante 4x4 por expansão de Laplace.
    * Isso é O(n!) mas n=4 então tanto faz.
@@ -101,19 +124,55 @@ real_t bhs_metric_det(const struct bhs_metric *m)
 	return det;
 }
 
+/* Diagonal: g^μμ = 1/g_μμ */
+static void invert_diagonal(const struct bhs_metric *m, struct bhs_metric *inv)
+{
+	*inv = bhs_metric_zero();
+	for (int mu = 0; mu < 4; mu++)
+		inv->g[mu][mu] = 1.0 / m->g[mu][mu];
+}
+
+/*
+ * Bloco t-φ: a inversa do bloco 2x2 é o adjunto sobre o determinante do
+ * bloco, e r e θ invertem sozinhos (mesma conta de bhs_kerr_metric_inverse)
+ */
+static void invert_tphi(const struct bhs_metric *m, struct bhs_metric *inv)
+{
+	const real_t(*g)[4] = m->g;
+	real_t inv_block = 1.0 / (g[0][0] * g[3][3] - g[0][3] * g[3][0]);
+
+	*inv = bhs_metric_zero();
+	inv->g[0][0] = g[3][3] * inv_block;
+	inv->g[0][3] = -g[0][3] * inv_block;
+	inv->g[3][0] = -g[3][0] * inv_block;
+	inv->g[3][3] = g[0][0] * inv_block;
+	inv->g[1][1] = 1.0 / g[1][1];
+	inv->g[2][2] = 1.0 / g[2][2];
+}
+
 int bhs_metric_invert(const struct bhs_metric *m, struct bhs_metric *inv)
 {
-	/*
-   * Inversão 4x4 usando matriz adjunta:
-   * A^(-1) = adj(A) / det(A)
-   *
-   * Para métricas diagonais é trivial, mas fazemos o caso geral.
-   */
 	real_t det = bhs_metric_det(m);
 
 	if (bhs_abs(det) < 1e-15)
 		return -1; /* Matriz singular */
 
+	if (m->structure == BHS_METRIC_DIAGONAL) {
+		invert_diagonal(m, inv);
+		inv->structure = BHS_METRIC_DIAGONAL;
+		return 0;
+	}
+	if (m->structure == BHS_METRIC_TPHI) {
+		invert_tphi(m, inv);
+		inv->structure = BHS_METRIC_TPHI;
+		return 0;
+	}
+
+	/*
+   * Inversão 4x4 usando matriz adjunta:
+   * A^(-1) = adj(A) / det(A)
+   */
+
 	real_t inv_det = 1.0 / det;
 	const real_t(*g)[4] = m->g;
 
@@ -206,6 +265,7 @@ int bhs_metric_invert(const struct bhs_metric *m, struct bhs_metric *inv)
 			   g[0][1] * (g[1][0] * g[2][2] - g[1][2] * g[2][0]) +
 			   g[0][2] * (g[1][0] * g[2][1] - g[1][1] * g[2][0]));
 
+	inv->structure = BHS_METRIC_GENERAL;
 	return 0;
 }
 
@@ -216,6 +276,16 @@ int bhs_metric_invert(const struct bhs_metric *m, struct bhs_metric *inv)
 
 struct bhs_vec4 bhs_metric_lower(const struct bhs_metric *m, struct bhs_vec4 v)
 {
+	const real_t(*g)[4] = m->g;
+
+	if (m->structure == BHS_METRIC_DIAGONAL)
+		return bhs_vec4_make(g[0][0] * v.t, g[1][1] * v.x,
+				     g[2][2] * v.y, g[3][3] * v.z);
+	if (m->structure == BHS_METRIC_TPHI)
+		return bhs_vec4_make(g[0][0] * v.t + g[0][3] * v.z,
+				     g[1][1] * v.x, g[2][2] * v.y,
+				     g[3][0] * v.t + g[3][3] * v.z);
+
 	/* v_μ = g_μν v^ν */
 	double components[4] = { v.t, v.x, v.y, v.z };
 	real_t result[4] = { 0 };
@@ -239,6 +309,16 @@ struct bhs_vec4 bhs_metric_raise(const struct bhs_metric *m_inv,
 real_t bhs_metric_dot(const struct bhs_metric *m, struct bhs_vec4 a,
 		      struct bhs_vec4 b)
 {
+	const real_t(*g)[4] = m->g;
+
+	if (m->structure == BHS_METRIC_DIAGONAL)
+		return g[0][0] * a.t * b.t + g[1][1] * a.x * b.x +
+		       g[2][2] * a.y * b.y + g[3][3] * a.z * b.z;
+	if (m->structure == BHS_METRIC_TPHI)
+		return g[0][0] * a.t * b.t + g[1][1] * a.x * b.x +
+		       g[2][2] * a.y * b.y + g[3][3] * a.z * b.z +
+		       g[0][3] * a.t * b.z + g[3][0] * a.z * b.t;
+
 	/* g_μν a^μ b^ν */
 	double a_comp[4] = { a.t, a.x, a.y, a.z };
 	double b_comp[4] = { b.t, b.x, b.y, b.z };
@@ -265,35 +345,47 @@ struct bhs_christoffel bhs_christoffel_zero(void)
 	return c;
 }
 
-int bhs_christoffel_compute(bhs_metric_func metric_fn, struct bhs_vec4 coords,
-			    void *userdata, real_t h,
-			    struct bhs_christoffel *out)
+/* ∂_σ g_μν pode ser não-nulo */
+static bool dg_may(const struct bhs_metric_desc *desc, int sigma, int mu,
+		   int nu)
 {
-	/*
-   * Γ^α_μν = (1/2) g^αβ (∂_μ g_βν + ∂_ν g_βμ - ∂_β g_μν)
-   *
-   * Estratégia:
-   * 1. Calcular métrica no ponto central
-   * 2. Calcular derivadas por diferença central
-   * 3. Inverter métrica
-   * 4. Contrair com inversa
-   */
-
-	double coords_arr[4] = { coords.t, coords.x, coords.y, coords.z };
+	return !(desc->killing & BHS_METRIC_COORD(sigma)) &&
+	       !(desc->zero & (1u << (4 * mu + nu)));
+}
 
-	/* 1. Métrica no ponto */
-	struct bhs_metric g_center;
-	metric_fn(coords, userdata, &g_center);
+/*
+ * g^αβ pode ser não-nulo: α e β no mesmo bloco conexo de g (a inversa de
+ * uma matriz bloco-diagonal é bloco-diagonal com os mesmos blocos).
+ */
+static void inverse_pattern(unsigned zero, bool out[4][4])
+{
+	int block[4] = { 0, 1, 2, 3 };
 
-	/* 2. Inversa da métrica */
-	struct bhs_metric g_inv;
-	if (bhs_metric_invert(&g_center, &g_inv) != 0)
-		return -1;
+	for (int mu = 0; mu < 4; mu++) {
+		for (int nu = mu + 1; nu < 4; nu++) {
+			int from = block[nu], to = block[mu];
+			if ((zero & (1u << (4 * mu + nu))) || from == to)
+				continue;
+			for (int k = 0; k < 4; k++)
+				block[k] = block[k] == from ? to : block[k];
+		}
+	}
 
-	/* 3. Derivadas parciais: dg[sigma][mu][nu] = ∂_sigma g_munu */
-	real_t dg[4][4][4]; /* dg[sigma][mu][nu] */
+	for (int a = 0; a < 4; a++) {
+		for (int b = 0; b < 4; b++)
+			out[a][b] = block[a] == block[b];
+	}
+}
 
+/* dg[sigma][mu][nu] = ∂_sigma g_munu, só fora das coordenadas de Killing */
+static void metric_derivs_fd(const struct bhs_metric_desc *desc,
+			     const double coords_arr[4], void *userdata,
+			     real_t h, real_t dg[4][4][4])
+{
 	for (int sigma = 0; sigma < 4; sigma++) {
+		if (desc->killing & BHS_METRIC_COORD(sigma))
+			continue;
+
 		struct bhs_vec4 coords_plus, coords_minus;
 		real_t c_plus[4], c_minus[4];
 
@@ -311,8 +403,8 @@ int bhs_christoffel_compute(bhs_metric_func metric_fn, struct bhs_vec4 coords,
 					     c_minus[3]);
 
 		struct bhs_metric g_plus, g_minus;
-		metric_fn(coords_plus, userdata, &g_plus);
-		metric_fn(coords_minus, userdata, &g_minus);
+		desc->fn(coords_plus, userdata, &g_plus);
+		desc->fn(coords_minus, userdata, &g_minus);
 
 		/* Diferença central */
 		real_t inv_2h = 1.0 / (2.0 * h);
@@ -324,28 +416,87 @@ int bhs_christoffel_compute(bhs_metric_func metric_fn, struct bhs_vec4 coords,
 			}
 		}
 	}
+}
 
-	/* 4. Calcula Γ^α_μν */
-	*out = bhs_christoffel_zero();
+int bhs_christoffel_compute_desc(const struct bhs_metric_desc *desc,
+				 struct bhs_vec4 coords, void *userdata,
+				 real_t h, struct bhs_christoffel_sparse *out)
+{
+	/*
+   * Γ^α_μν = (1/2) g^αβ (∂_μ g_βν + ∂_ν g_βμ - ∂_β g_μν)
+   *
+   * Estratégia:
+   * 1. Métrica no ponto e derivadas (duais, ou diferença central
+   *    fora das coordenadas de Killing)
+   * 2. Inverter métrica
+   * 3. Contrair com inversa (só termos estruturalmente não-nulos)
+   */
+
+	double coords_arr[4] = { coords.t, coords.x, coords.y, coords.z };
+	struct bhs_metric g_center;
+	real_t dg[4][4][4]; /* dg[sigma][mu][nu] */
+	memset(dg, 0, sizeof(dg));
+
+	if (desc->dual_fn) {
+		/* 1. Uma avaliação dual: métrica e derivadas exatas */
+		struct bhs_dual x[4], gd[4][4];
+		for (int i = 0; i < 4; i++)
+			x[i] = bhs_dual_var(coords_arr[i], i);
+		desc->dual_fn(x, userdata, gd);
+
+		for (int mu = 0; mu < 4; mu++) {
+			for (int nu = 0; nu < 4; nu++) {
+				g_center.g[mu][nu] = gd[mu][nu].v;
+				for (int sigma = 0; sigma < 4; sigma++)
+					dg[sigma][mu][nu] = gd[mu][nu].d[sigma];
+			}
+		}
+	} else {
+		/* 1. Métrica no ponto e derivadas por diferença central */
+		desc->fn(coords, userdata, &g_center);
+		metric_derivs_fd(desc, coords_arr, userdata, h, dg);
+	}
+	g_center.structure = bhs_metric_structure_of(desc->zero);
+
+	/* 2. Inversa da métrica */
+	struct bhs_metric g_inv;
+	if (bhs_metric_invert(&g_center, &g_inv) != 0)
+		return -1;
+
+	/* 3. Calcula Γ^α_μν, só metade (μ ≤ ν) */
+	bool inv_may[4][4];
+	inverse_pattern(desc->zero, inv_may);
+	out->n = 0;
 
 	for (int alpha = 0; alpha < 4; alpha++) {
 		for (int mu = 0; mu < 4; mu++) {
-			for (int nu = mu; nu < 4;
-			     nu++) { /* Só metade, depois simetriza */
+			for (int nu = mu; nu < 4; nu++) {
 				real_t sum = 0.0;
+				bool may = false;
 
 				for (int beta = 0; beta < 4; beta++) {
+					if (!inv_may[alpha][beta] ||
+					    !(dg_may(desc, mu, beta, nu) ||
+					      dg_may(desc, nu, beta, mu) ||
+					      dg_may(desc, beta, mu, nu)))
+						continue;
+
 					/* (1/2) g^αβ (∂_μ g_βν + ∂_ν g_βμ - ∂_β g_μν) */
 					real_t term = dg[mu][beta][nu] +
 						      dg[nu][beta][mu] -
 						      dg[beta][mu][nu];
 					sum += g_inv.g[alpha][beta] * term;
+					may = true;
 				}
 
-				out->gamma[alpha][mu][nu] = 0.5 * sum;
-				out->gamma[alpha][nu][mu] =
-					out->gamma[alpha][mu]
-						  [nu]; /* Simetria */
+				if (!may)
+					continue;
+
+				int k = out->n++;
+				out->alpha[k] = (unsigned char)alpha;
+				out->mu[k] = (unsigned char)mu;
+				out->nu[k] = (unsigned char)nu;
+				out->gamma[k] = 0.5 * sum;
 			}
 		}
 	}
@@ -353,6 +504,104 @@ int bhs_christoffel_compute(bhs_metric_func metric_fn, struct bhs_vec4 coords,
 	return 0;
 }
 
+int bhs_christoffel_compute(bhs_metric_func metric_fn, struct bhs_vec4 coords,
+			    void *userdata, real_t h,
+			    struct bhs_christoffel *out)
+{
+	/* Sem simetria declarada: todas as derivadas, todas as contrações */
+	struct bhs_metric_desc desc = { .fn = metric_fn };
+	struct bhs_christoffel_sparse sparse;
+
+	if (bhs_christoffel_compute_desc(&desc, coords, userdata, h,
+					 &sparse) != 0)
+		return -1;
+
+	bhs_christoffel_expand(&sparse, out);
+	return 0;
+}
+
+void bhs_christoffel_expand(const struct bhs_christoffel_sparse *sparse,
+			    struct bhs_christoffel *out)
+{
+	*out = bhs_christoffel_zero();
+
+	for (int k = 0; k < sparse->n; k++) {
+		int a = sparse->alpha[k], m = sparse->mu[k], n = sparse->nu[k];
+		out->gamma[a][m][n] = sparse->gamma[k];
+		out->gamma[a][n][m] = sparse->gamma[k]; /* Simetria */
+	}
+}
+
+enum bhs_metric_structure bhs_metric_structure_of(unsigned zero)
+{
+	/* Fora da diagonal, com e sem o par (t, φ) */
+	const unsigned off = ~(BHS_METRIC_COMP(0, 0) | BHS_METRIC_COMP(1, 1) |
+			       BHS_METRIC_COMP(2, 2) | BHS_METRIC_COMP(3, 3)) &
+			     0xffffu;
+	const unsigned off_tphi = off & ~BHS_METRIC_COMP(0, 3);
+
+	if ((zero & off) == off)
+		return BHS_METRIC_DIAGONAL;
+	if ((zero & off_tphi) == off_tphi)
+		return BHS_METRIC_TPHI;
+	return BHS_METRIC_GENERAL;
+}
+
+void bhs_metric_desc_probe(bhs_metric_func fn, struct bhs_vec4 coords,
+			   void *userdata, struct bhs_metric_desc *out)
+{
+	/* Translações sem relação com π nem com escalas típicas */
+	static const double shift[2] = { 0.7310, -1.3790 };
+
+	double base[2][4] = { { coords.t, coords.x, coords.y, coords.z } };
+	for (int i = 0; i < 4; i++)
+		base[1][i] = base[0][i] + 0.0137 * (i + 1);
+
+	struct bhs_metric g[2];
+	for (int p = 0; p < 2; p++) {
+		fn(bhs_vec4_make(base[p][0], base[p][1], base[p][2],
+				 base[p][3]),
+		   userdata, &g[p]);
+	}
+
+	out->fn = fn;
+	out->killing = 0;
+	out->zero = 0;
+	for (int mu = 0; mu < 4; mu++) {
+		for (int nu = 0; nu < 4; nu++) {
+			if (g[0].g[mu][nu] == 0.0 && g[1].g[mu][nu] == 0.0)
+				out->zero |= 1u << (4 * mu + nu);
+		}
+	}
+
+	for (int sigma = 0; sigma < 4; sigma++) {
+		bool killing = true;
+
+		for (int p = 0; p < 2; p++) {
+			double x[4];
+			memcpy(x, base[p], sizeof(x));
+			x[sigma] += shift[p];
+
+			struct bhs_metric gs;
+			fn(bhs_vec4_make(x[0], x[1], x[2], x[3]), userdata,
+			   &gs);
+
+			for (int mu = 0; mu < 4; mu++) {
+				for (int nu = 0; nu < 4; nu++) {
+					if (gs.g[mu][nu] != 0.0)
+						out->zero &=
+							~(1u << (4 * mu + nu));
+					killing &= gs.g[mu][nu] ==
+						   g[p].g[mu][nu];
+				}
+			}
+		}
+
+		if (killing)
+			out->killing |= BHS_METRIC_COORD(sigma);
+	}
+}
+
 struct bhs_vec4 bhs_geodesic_accel(const struct bhs_christoffel *chris,
 				   struct bhs_vec4 vel)
 {
@@ -378,3 +627,19 @@ struct bhs_vec4 bhs_geodesic_accel(const struct bhs_christoffel *chris,
 
 	return bhs_vec4_make(a[0], a[1], a[2], a[3]);
 }
+
+struct bhs_vec4
+bhs_geodesic_accel_sparse(const struct bhs_christoffel_sparse *chris,
+			  struct bhs_vec4 vel)
+{
+	double u[4] = { vel.t, vel.x, vel.y, vel.z };
+	real_t a[4] = { 0 };
+
+	for (int k = 0; k < chris->n; k++) {
+		int m = chris->mu[k], n = chris->nu[k];
+		real_t w = m == n ? 1.0 : 2.0; /* Γ^α_μν = Γ^α_νμ */
+		a[chris->alpha[k]] -= w * chris->gamma[k] * u[m] * u[n];
+	}
+
+	return bhs_vec4_make(a[0], a[1], a[2], a[3]);
+}
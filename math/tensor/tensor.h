@@ -8,7 +8,12 @@
  * Este módulo implementa:
  * - Tensor métrico g_μν (covariante, 4x4 simétrico)
  * - Tensor métrico inverso g^μν (contravariante)
+ * - Etiqueta de estrutura (diagonal, bloco t-φ, geral) que leva inversão,
+ *   raise/lower e produto interno para kernels especializados
  * - Símbolos de Christoffel Γ^α_μν
+ * - Descritor de simetrias da métrica (Killing, componentes nulas) e
+ *   Christoffel esparso que só calcula o que pode ser não-nulo
+ * - Métricas em números duais (dual.h): g e ∂g exatos numa avaliação
  */
 
 #ifndef BHS_CORE_TENSOR_TENSOR_H
@@ -17,6 +22,7 @@
 #include <stdbool.h>
 
 #include "math/bhs_math.h"
+#include "math/tensor/dual.h"
 #include "math/vec4.h"
 
 /* ============================================================================
@@ -24,16 +30,39 @@
  * ============================================================================
  */
 
+/**
+ * enum bhs_metric_structure - Componentes de g_μν que podem ser não-nulas
+ * @BHS_METRIC_GENERAL: todas (vale zero: memset e { 0 } são sempre seguros)
+ * @BHS_METRIC_DIAGONAL: só g_μμ (Minkowski, Schwarzschild)
+ * @BHS_METRIC_TPHI: bloco 2x2 (t, φ) mais g_rr e g_θθ (Kerr em BL e toda
+ *                   métrica estacionária axissimétrica nessas coordenadas)
+ *
+ * A inversa de uma métrica tem a mesma estrutura dela.
+ */
+enum bhs_metric_structure {
+	BHS_METRIC_GENERAL = 0,
+	BHS_METRIC_DIAGONAL,
+	BHS_METRIC_TPHI,
+};
+
 /**
  * struct bhs_metric - Tensor métrico covariante g_μν
+ * @g: componentes
+ * @structure: componentes fora de @structure são zero exato
  *
  * Matriz 4x4 simétrica: g[μ][ν] = g[ν][μ]
  * Índices: 0=t, 1=x/r, 2=y/θ, 3=z/φ
  *
+ * Os construtores deste módulo e dos espaço-tempos preenchem @structure;
+ * quem monta g à mão e deixa componentes fora da diagonal deve deixar
+ * BHS_METRIC_GENERAL. Uma etiqueta mais estreita que a matriz dá inversa
+ * e produtos errados.
+ *
  * Alinhamento 16 bytes para compatibilidade com GPU (std140/std430)
  */
 struct bhs_metric {
 	BHS_ALIGN(16) real_t g[4][4];
+	enum bhs_metric_structure structure;
 };
 
 /**
@@ -46,6 +75,26 @@ struct bhs_christoffel {
 	BHS_ALIGN(16) real_t gamma[4][4][4];
 };
 
+/** Máximo de Γ^α_μν independentes (4 x 10 pares μ ≤ ν) */
+#define BHS_CHRISTOFFEL_SPARSE_MAX 40
+
+/**
+ * struct bhs_christoffel_sparse - Γ^α_μν só onde pode ser não-nulo
+ * @n: entradas usadas
+ * @alpha, @mu, @nu: índices de cada entrada (sempre μ ≤ ν)
+ * @gamma: valores
+ *
+ * O padrão de entradas sai do descritor da métrica, não dos valores: uma
+ * entrada listada pode valer zero num ponto, uma ausente é zero sempre.
+ */
+struct bhs_christoffel_sparse {
+	int n;
+	unsigned char alpha[BHS_CHRISTOFFEL_SPARSE_MAX];
+	unsigned char mu[BHS_CHRISTOFFEL_SPARSE_MAX];
+	unsigned char nu[BHS_CHRISTOFFEL_SPARSE_MAX];
+	real_t gamma[BHS_CHRISTOFFEL_SPARSE_MAX];
+};
+
 /* ============================================================================
  * CONSTANTES
  * ============================================================================
@@ -82,6 +131,14 @@ struct bhs_metric bhs_metric_minkowski(void);
 struct bhs_metric bhs_metric_diag(real_t g00, real_t g11, real_t g22,
 				  real_t g33);
 
+/**
+ * bhs_metric_classify - Estrutura mais estreita que os zeros de @m admitem
+ *
+ * Olha zeros exatos, não tolerância. Para etiquetar métricas montadas à
+ * mão: m.structure = bhs_metric_classify(&m).
+ */
+enum bhs_metric_structure bhs_metric_classify(const struct bhs_metric *m);
+
 /**
  * bhs_metric_is_symmetric - Verifica simetria
  *
@@ -94,6 +151,7 @@ bool bhs_metric_is_symmetric(const struct bhs_metric *m, real_t tol);
  *
  * Retorna det(g_μν).
  * Para métricas diagonais: g00 * g11 * g22 * g33
+ * Para bloco t-φ: (g_tt g_φφ - g_tφ²) g_rr g_θθ
  *
  * O determinante é usado para calcular elementos de volume:
  * dV = √|g| d⁴x
@@ -105,7 +163,9 @@ real_t bhs_metric_det(const struct bhs_metric *m);
  * @m: métrica covariante g_μν
  * @inv: [out] métrica contravariante g^μν
  *
- * Calcula g^μν tal que g^μα g_αν = δ^μ_ν
+ * Calcula g^μν tal que g^μα g_αν = δ^μ_ν. Diagonal e bloco t-φ invertem
+ * por componente e pelo bloco 2x2; só BHS_METRIC_GENERAL paga os
+ * cofatores 4x4. inv->structure = m->structure.
  *
  * Retorna:
  *   0 em sucesso
@@ -123,7 +183,7 @@ int bhs_metric_invert(const struct bhs_metric *m, struct bhs_metric *inv);
  * @m: métrica g_μν
  * @v: vetor contravariante v^μ
  *
- * Retorna: v_μ = g_μν v^ν
+ * Retorna: v_μ = g_μν v^ν (só as componentes que m->structure admite)
  */
 struct bhs_vec4 bhs_metric_lower(const struct bhs_metric *m, struct bhs_vec4 v);
 
@@ -142,7 +202,7 @@ struct bhs_vec4 bhs_metric_raise(const struct bhs_metric *m_inv,
  * @m: métrica g_μν
  * @a, @b: vetores contravariantes
  *
- * Retorna: g_μν a^μ b^ν
+ * Retorna: g_μν a^μ b^ν (4 ou 6 produtos com diagonal ou bloco t-φ)
  */
 real_t bhs_metric_dot(const struct bhs_metric *m, struct bhs_vec4 a,
 		      struct bhs_vec4 b);
@@ -162,6 +222,46 @@ real_t bhs_metric_dot(const struct bhs_metric *m, struct bhs_vec4 a,
  */
 typedef void (*bhs_metric_func)(struct bhs_vec4 coords, void *userdata,
 				struct bhs_metric *out);
+
+/**
+ * Variante dual de bhs_metric_func
+ *
+ * @coords: coordenadas como variáveis duais (coords[μ].d[ν] = δ^μ_ν)
+ * @userdata: parâmetros adicionais
+ * @out: g_μν com out[μ][ν].d[σ] = ∂_σ g_μν
+ *
+ * Mesma métrica que o bhs_metric_func do descritor, escrita com as
+ * operações de dual.h.
+ */
+typedef void (*bhs_metric_dual_func)(const struct bhs_dual coords[4],
+				     void *userdata,
+				     struct bhs_dual out[4][4]);
+
+/** Bit da coordenada μ em bhs_metric_desc.killing */
+#define BHS_METRIC_COORD(mu) (1u << (mu))
+
+/** Bit da componente g_μν (e g_νμ) em bhs_metric_desc.zero */
+#define BHS_METRIC_COMP(mu, nu) ((1u << (4 * (mu) + (nu))) | \
+				 (1u << (4 * (nu) + (mu))))
+
+/**
+ * struct bhs_metric_desc - Métrica parametrizada com simetrias declaradas
+ * @fn: métrica num ponto
+ * @dual_fn: mesma métrica em números duais (NULL = diferença finita)
+ * @killing: coordenadas das quais g_μν não depende (BHS_METRIC_COORD)
+ * @zero: componentes identicamente nulas (BHS_METRIC_COMP)
+ *
+ * Em Kerr e Schwarzschild (BL) t e φ são de Killing e só g_tφ fica fora
+ * da diagonal: metade das derivadas e a maior parte das contrações de
+ * bhs_christoffel_compute() somem. Declarar a mais dá Γ errado; declarar
+ * a menos só custa tempo. { .fn = fn } é a métrica genérica.
+ */
+struct bhs_metric_desc {
+	bhs_metric_func fn;
+	bhs_metric_dual_func dual_fn;
+	unsigned killing;
+	unsigned zero;
+};
 #endif
 
 #ifndef BHS_SHADER_COMPILER
@@ -173,7 +273,9 @@ typedef void (*bhs_metric_func)(struct bhs_vec4 coords, void *userdata,
  * @h: tamanho do passo para diferença finita
  * @out: [out] símbolos de Christoffel Γ^α_μν
  *
- * Usa diferença central: ∂_μ g ≈ [g(x+h) - g(x-h)] / (2h)
+ * Usa diferença central: ∂_μ g ≈ [g(x+h) - g(x-h)] / (2h). Quem tem a
+ * métrica em duais ou conhece as simetrias passa por
+ * bhs_christoffel_compute_desc().
  *
  * Retorna:
  *   0 em sucesso
@@ -182,6 +284,53 @@ typedef void (*bhs_metric_func)(struct bhs_vec4 coords, void *userdata,
 int bhs_christoffel_compute(bhs_metric_func metric_fn, struct bhs_vec4 coords,
 			    void *userdata, real_t h,
 			    struct bhs_christoffel *out);
+
+/**
+ * bhs_christoffel_compute_desc - Christoffel numérico usando as simetrias
+ * @desc: métrica e simetrias declaradas
+ * @coords, @userdata, @h: como em bhs_christoffel_compute()
+ * @out: [out] Γ^α_μν esparso
+ *
+ * Com desc->dual_fn, uma avaliação dual dá g e ∂g exatos e @h é
+ * ignorado. Sem ela, diferença central só ao longo das coordenadas que
+ * não são de Killing (1 + 2 x não-Killing avaliações de métrica). Nos
+ * dois casos só contrai termos estruturalmente não-nulos: ∂_σ g_μν some
+ * com σ de Killing ou g_μν nula, g^αβ some entre blocos desconexos da
+ * métrica.
+ *
+ * Retorna:
+ *   0 em sucesso
+ *  -1 se falhou (métrica singular)
+ */
+int bhs_christoffel_compute_desc(const struct bhs_metric_desc *desc,
+				 struct bhs_vec4 coords, void *userdata,
+				 real_t h, struct bhs_christoffel_sparse *out);
+
+/**
+ * bhs_metric_structure_of - Estrutura implicada pelas componentes nulas
+ * @zero: máscara BHS_METRIC_COMP, como em bhs_metric_desc.zero
+ *
+ * bhs_christoffel_compute_desc() etiqueta a métrica por aqui, sem confiar
+ * no que desc->fn deixou em structure.
+ */
+enum bhs_metric_structure bhs_metric_structure_of(unsigned zero);
+
+/**
+ * bhs_metric_desc_probe - Descobre as simetrias de uma métrica qualquer
+ * @fn: métrica
+ * @coords: ponto típico (fora de singularidades e eixos)
+ * @userdata: parâmetros passados para @fn
+ * @out: [out] descritor
+ *
+ * Para quem só tem um bhs_metric_func: compara g em @coords, num ponto
+ * vizinho genérico e em translações grandes ao longo de cada coordenada.
+ * Uma coordenada é de Killing se g não muda um bit em nenhuma delas; uma
+ * componente é nula se vale exatamente 0 em todas. São 10 avaliações:
+ * chame uma vez por espaço-tempo e reuse. O descritor vale para aquele
+ * @userdata (Kerr com a = 0 perde g_tφ).
+ */
+void bhs_metric_desc_probe(bhs_metric_func fn, struct bhs_vec4 coords,
+			   void *userdata, struct bhs_metric_desc *out);
 #endif
 
 /**
@@ -202,4 +351,19 @@ struct bhs_christoffel bhs_christoffel_zero(void);
 struct bhs_vec4 bhs_geodesic_accel(const struct bhs_christoffel *chris,
 				   struct bhs_vec4 vel);
 
+/**
+ * bhs_geodesic_accel_sparse - bhs_geodesic_accel() com Γ esparso
+ *
+ * Percorre só as entradas listadas, com o fator 2 dos pares μ < ν.
+ */
+struct bhs_vec4
+bhs_geodesic_accel_sparse(const struct bhs_christoffel_sparse *chris,
+			  struct bhs_vec4 vel);
+
+/**
+ * bhs_christoffel_expand - Esparso para o layout denso 4x4x4
+ */
+void bhs_christoffel_expand(const struct bhs_christoffel_sparse *sparse,
+			    struct bhs_christoffel *out);
+
 #endif /* BHS_CORE_TENSOR_TENSOR_H */
@@ -12,7 +12,12 @@
 #include <string.h>
 
 #include "math/core.h"
+#include "math/elliptic.h"
+#include "math/spacetime/kerr_elliptic.h"
+#include "math/spacetime/kerr_schild.h"
+#include "math/spacetime/kerr_spin.h"
 #include "math/spacetime/schwarzschild.h"
+#include "math/spline.h"
 #include "math/tensor/tensor.h"
 #include "math/vec4.h"
 
@@ -85,6 +90,104 @@ void test_metric_invert()
 	ASSERT_EPS(inv.g[2][2], 0.25, 1e-10, "inv_diag[2][2]");
 }
 
+/* Maior |a - b| componente a componente, relativo a max(1, |b|) */
+static double metric_diff(const struct bhs_metric *a,
+			  const struct bhs_metric *b)
+{
+	double worst = 0.0;
+	for (int m = 0; m < 4; m++)
+		for (int n = 0; n < 4; n++)
+			worst = fmax(worst,
+				     fabs(a->g[m][n] - b->g[m][n]) /
+					     fmax(1.0, fabs(b->g[m][n])));
+	return worst;
+}
+
+void test_metric_structure()
+{
+	struct bhs_kerr kerr = { .M = 1.0, .a = 0.9 };
+	struct bhs_schwarzschild schw = { .M = 1.0 };
+	struct bhs_vec4 u = bhs_vec4_make(1.3, -0.4, 0.07, 0.21);
+	struct bhs_vec4 w = bhs_vec4_make(-0.6, 0.9, -0.02, 0.35);
+	static const double pts[][2] = {
+		{ 1.5, 0.3 }, { 2.1, 1.5707963 }, { 6.0, 1.0 }, { 40.0, 2.9 },
+	};
+	double worst_inv = 0.0, worst_vec = 0.0, worst_det = 0.0;
+	bool tags = true;
+
+	for (int k = 0; k < 8; k++) {
+		double r = pts[k % 4][0], th = pts[k % 4][1];
+		struct bhs_metric g, gen, inv, inv_gen, ref_inv;
+
+		/* Metade Kerr (bloco t-φ), metade Schwarzschild (diagonal) */
+		if (k < 4) {
+			bhs_kerr_metric(&kerr, r, th, &g);
+			bhs_kerr_metric_inverse(&kerr, r, th, &ref_inv);
+			tags &= g.structure == BHS_METRIC_TPHI;
+		} else {
+			bhs_schwarzschild_metric(&schw, r + 1.0, th, &g);
+			bhs_schwarzschild_metric_inverse(&schw, r + 1.0, th,
+							 &ref_inv);
+			tags &= g.structure == BHS_METRIC_DIAGONAL;
+		}
+		tags &= bhs_metric_classify(&g) == g.structure;
+
+		/* Mesma matriz pelo caminho geral */
+		gen = g;
+		gen.structure = BHS_METRIC_GENERAL;
+
+		tags &= bhs_metric_invert(&g, &inv) == 0;
+		tags &= bhs_metric_invert(&gen, &inv_gen) == 0;
+		tags &= inv.structure == g.structure &&
+			inv_gen.structure == BHS_METRIC_GENERAL;
+		worst_inv = fmax(worst_inv, metric_diff(&inv, &inv_gen));
+		worst_inv = fmax(worst_inv, metric_diff(&inv, &ref_inv));
+
+		double det = bhs_metric_det(&g), det_gen = bhs_metric_det(&gen);
+		worst_det = fmax(worst_det,
+				 fabs(det - det_gen) / fabs(det_gen));
+
+		struct bhs_vec4 lo = bhs_metric_lower(&g, u);
+		struct bhs_vec4 lo_gen = bhs_metric_lower(&gen, u);
+		struct bhs_vec4 up = bhs_metric_raise(&inv, lo);
+		struct bhs_vec4 up_gen = bhs_metric_raise(&inv_gen, lo_gen);
+		double dot = bhs_metric_dot(&g, u, w);
+		double dot_gen = bhs_metric_dot(&gen, u, w);
+		double d[] = {
+			lo.t - lo_gen.t, lo.x - lo_gen.x, lo.y - lo_gen.y,
+			lo.z - lo_gen.z, up.t - up_gen.t, up.x - up_gen.x,
+			up.y - up_gen.y, up.z - up_gen.z, up.t - u.t,
+			up.x - u.x, up.y - u.y, up.z - u.z,
+			(dot - dot_gen) / fmax(1.0, fabs(dot_gen)),
+		};
+		for (size_t i = 0; i < sizeof(d) / sizeof(d[0]); i++)
+			worst_vec = fmax(worst_vec, fabs(d[i]));
+	}
+	ASSERT_EPS(tags, 1.0, 0.1, "estrutura: etiquetas");
+	ASSERT_EPS(worst_inv, 0.0, 1e-12, "estrutura: inversa = geral");
+	ASSERT_EPS(worst_det, 0.0, 1e-13, "estrutura: det = geral");
+	ASSERT_EPS(worst_vec, 0.0, 1e-11, "estrutura: lower/raise/dot");
+
+	/* Máscaras dos descritores e métricas montadas à mão */
+	struct bhs_metric ks;
+	bhs_kerr_schild_metric(&kerr, 3.0, 2.0, 1.0, &ks);
+	ASSERT_EPS(bhs_metric_structure_of(BHS_KERR_METRIC_DESC.zero),
+		   BHS_METRIC_TPHI, 0.1, "estrutura: descritor Kerr");
+	ASSERT_EPS(bhs_metric_structure_of(BHS_SCHWARZSCHILD_METRIC_DESC.zero),
+		   BHS_METRIC_DIAGONAL, 0.1, "estrutura: descritor Schw.");
+	ASSERT_EPS(bhs_metric_structure_of(0), BHS_METRIC_GENERAL, 0.1,
+		   "estrutura: sem zeros");
+	ASSERT_EPS(ks.structure, BHS_METRIC_GENERAL, 0.1,
+		   "estrutura: Kerr-Schild geral");
+	ASSERT_EPS(bhs_metric_minkowski().structure, BHS_METRIC_DIAGONAL, 0.1,
+		   "estrutura: Minkowski");
+
+	/* Singular continua singular em qualquer caminho */
+	struct bhs_metric sing = bhs_metric_diag(-1.0, 0.0, 1.0, 1.0), si;
+	ASSERT_EPS(bhs_metric_invert(&sing, &si), -1, 0.1,
+		   "estrutura: diagonal singular");
+}
+
 /* ============================================================================
  * TESTES: SCHWARZSCHILD
  * ============================================================================
@@ -111,6 +214,589 @@ void test_schwarzschild()
 	ASSERT_EPS(z, 0.41421356237, 1e-8, "schwarzschild_redshift");
 }
 
+/* ============================================================================
+ * TESTES: KERR CHRISTOFFEL
+ * ============================================================================
+ */
+
+void test_kerr_christoffel()
+{
+	/* Forma fechada deve bater com a diferença finita genérica */
+	struct bhs_kerr bh = { .M = 1.0, .a = 0.9 };
+	const double pts[][2] = { { 2.5, 0.4 }, { 4.0, 1.2 }, { 12.0, 2.1 } };
+
+	for (unsigned p = 0; p < sizeof(pts) / sizeof(pts[0]); p++) {
+		struct bhs_christoffel exact, fd;
+		struct bhs_vec4 x = bhs_vec4_make(0.0, pts[p][0], pts[p][1],
+						  0.3);
+
+		int ret = bhs_kerr_christoffel(&bh, x.x, x.y, &exact);
+		ASSERT_EPS(ret, 0, 0.1, "kerr_christoffel status");
+		bhs_christoffel_compute(bhs_kerr_metric_func, x, &bh, 1e-5,
+					&fd);
+
+		double worst = 0.0;
+		for (int a = 0; a < 4; a++)
+			for (int m = 0; m < 4; m++)
+				for (int n = 0; n < 4; n++) {
+					double d = fabs(exact.gamma[a][m][n] -
+							fd.gamma[a][m][n]);
+					if (d > worst)
+						worst = d;
+				}
+		ASSERT_EPS(worst, 0.0, 1e-6, "kerr_christoffel vs diff. finita");
+	}
+}
+
+static int metric_calls;
+
+static void counted_kerr_metric(struct bhs_vec4 coords, void *userdata,
+				struct bhs_metric *out)
+{
+	metric_calls++;
+	bhs_kerr_metric_func(coords, userdata, out);
+}
+
+void test_christoffel_desc()
+{
+	struct bhs_kerr bh = { .M = 1.0, .a = 0.9 };
+	struct bhs_vec4 x = bhs_vec4_make(0.0, 4.0, 1.2, 0.3);
+	struct bhs_christoffel dense, expanded;
+	struct bhs_christoffel_sparse sparse;
+
+	/* Descritor declarado: mesmos Γ com 5 métricas e só os 20 de Kerr */
+	struct bhs_metric_desc desc = BHS_KERR_METRIC_DESC;
+	desc.fn = counted_kerr_metric;
+	desc.dual_fn = NULL;
+
+	metric_calls = 0;
+	bhs_christoffel_compute(counted_kerr_metric, x, &bh, 1e-5, &dense);
+	ASSERT_EPS(metric_calls, 9, 0.1, "christoffel genérico: 9 métricas");
+
+	metric_calls = 0;
+	int ret = bhs_christoffel_compute_desc(&desc, x, &bh, 1e-5, &sparse);
+	ASSERT_EPS(ret, 0, 0.1, "christoffel_desc status");
+	ASSERT_EPS(metric_calls, 5, 0.1, "christoffel_desc: 5 métricas");
+	ASSERT_EPS(sparse.n, 20, 0.1, "christoffel_desc: 20 entradas");
+
+	bhs_christoffel_expand(&sparse, &expanded);
+	double worst = 0.0;
+	for (int a = 0; a < 4; a++)
+		for (int m = 0; m < 4; m++)
+			for (int n = 0; n < 4; n++)
+				worst = fmax(worst,
+					     fabs(expanded.gamma[a][m][n] -
+						  dense.gamma[a][m][n]));
+	ASSERT_EPS(worst, 0.0, 1e-12, "christoffel_desc vs genérico");
+
+	struct bhs_vec4 u = bhs_vec4_make(1.3, -0.2, 0.05, 0.04);
+	struct bhs_vec4 acc = bhs_geodesic_accel_sparse(&sparse, u);
+	struct bhs_vec4 ref = bhs_geodesic_accel(&dense, u);
+	ASSERT_EPS(acc.t, ref.t, 1e-12, "accel_sparse t");
+	ASSERT_EPS(acc.x, ref.x, 1e-12, "accel_sparse r");
+	ASSERT_EPS(acc.y, ref.y, 1e-12, "accel_sparse θ");
+	ASSERT_EPS(acc.z, ref.z, 1e-12, "accel_sparse φ");
+
+	/* Sondagem acha sozinha o que Kerr e Kerr-Schild declaram */
+	struct bhs_metric_desc probed;
+	bhs_metric_desc_probe(bhs_kerr_metric_func, x, &bh, &probed);
+	ASSERT_EPS(probed.killing == BHS_KERR_METRIC_DESC.killing &&
+			   probed.zero == BHS_KERR_METRIC_DESC.zero,
+		   1.0, 0.1, "desc_probe kerr");
+
+	bhs_metric_desc_probe(bhs_kerr_schild_metric_func,
+			      bhs_vec4_make(0.0, 6.0, -3.0, 2.0), &bh, &probed);
+	ASSERT_EPS(probed.killing == BHS_KERR_SCHILD_METRIC_DESC.killing &&
+			   probed.zero == 0,
+		   1.0, 0.1, "desc_probe kerr-schild");
+
+	/* Schwarzschild via Kerr com a = 0: g_tφ some também */
+	struct bhs_kerr schw = { .M = 1.0, .a = 0.0 };
+	bhs_metric_desc_probe(bhs_kerr_metric_func, x, &schw, &probed);
+	ASSERT_EPS(probed.zero == BHS_SCHWARZSCHILD_METRIC_DESC.zero, 1.0, 0.1,
+		   "desc_probe a = 0");
+}
+
+static void counted_kerr_dual(const struct bhs_dual coords[4], void *userdata,
+			      struct bhs_dual out[4][4])
+{
+	metric_calls++;
+	bhs_kerr_metric_dual(coords, userdata, out);
+}
+
+void test_dual()
+{
+	/* f = sin(x) y / (1 + x²) + √y e^x, derivadas à mão */
+	double xv = 0.7, yv = 2.3;
+	struct bhs_dual x = bhs_dual_var(xv, 1), y = bhs_dual_var(yv, 2);
+	struct bhs_dual f = bhs_dual_add(
+		bhs_dual_div(bhs_dual_mul(bhs_dual_sin(x), y),
+			     bhs_dual_add_const(bhs_dual_mul(x, x), 1.0)),
+		bhs_dual_mul(bhs_dual_sqrt(y), bhs_dual_exp(x)));
+	double q = 1.0 + xv * xv;
+
+	ASSERT_EPS(f.v, sin(xv) * yv / q + sqrt(yv) * exp(xv), 1e-15,
+		   "dual valor");
+	ASSERT_EPS(f.d[1],
+		   yv * (cos(xv) * q - 2.0 * xv * sin(xv)) / (q * q) +
+			   sqrt(yv) * exp(xv),
+		   1e-14, "dual ∂x");
+	ASSERT_EPS(f.d[2], sin(xv) / q + 0.5 / sqrt(yv) * exp(xv), 1e-15,
+		   "dual ∂y");
+	ASSERT_EPS(f.d[0] + f.d[3], 0.0, 0.0, "dual ∂t = ∂z = 0");
+
+	struct bhs_dual p = bhs_dual_pow(bhs_dual_log(y), 1.5);
+	ASSERT_EPS(p.d[2], 1.5 * sqrt(log(yv)) / yv, 1e-15, "dual pow/log");
+
+	/* Kerr dual: uma avaliação, Γ no arredondamento da forma fechada */
+	struct bhs_kerr bh = { .M = 1.0, .a = 0.9 };
+	const double pts[][2] = { { 2.5, 0.4 }, { 4.0, 1.2 }, { 12.0, 2.1 } };
+	struct bhs_metric_desc desc = BHS_KERR_METRIC_DESC;
+	desc.dual_fn = counted_kerr_dual;
+
+	for (unsigned k = 0; k < sizeof(pts) / sizeof(pts[0]); k++) {
+		struct bhs_christoffel exact, dual;
+		struct bhs_christoffel_sparse sparse;
+		struct bhs_vec4 at = bhs_vec4_make(0.0, pts[k][0], pts[k][1],
+						   0.3);
+
+		metric_calls = 0;
+		bhs_kerr_christoffel(&bh, at.x, at.y, &exact);
+		int ret = bhs_christoffel_compute_desc(&desc, at, &bh, 0.0,
+						       &sparse);
+		ASSERT_EPS(ret, 0, 0.1, "christoffel dual status");
+		ASSERT_EPS(metric_calls, 1, 0.1, "christoffel dual: 1 métrica");
+
+		bhs_christoffel_expand(&sparse, &dual);
+		double worst = 0.0;
+		for (int a = 0; a < 4; a++)
+			for (int m = 0; m < 4; m++)
+				for (int n = 0; n < 4; n++)
+					worst = fmax(worst,
+						     fabs(exact.gamma[a][m][n] -
+							  dual.gamma[a][m][n]));
+		ASSERT_EPS(worst, 0.0, 1e-13, "christoffel dual vs exato");
+	}
+}
+
+/* ============================================================================
+ * TESTES: SOMBRA DE KERR
+ * ============================================================================
+ */
+
+void test_kerr_shadow()
+{
+	struct bhs_kerr schw = { .M = 1.0, .a = 0.0 };
+	struct bhs_kerr ext = { .M = 1.0, .a = 1.0 };
+	struct bhs_kerr bh = { .M = 1.0, .a = 0.9 };
+
+	ASSERT_EPS(bhs_kerr_photon_orbit(&schw, true), 3.0, 1e-12,
+		   "photon_orbit a=0");
+	ASSERT_EPS(bhs_kerr_photon_orbit(&ext, true), 1.0, 1e-12,
+		   "photon_orbit prograde a=M");
+	ASSERT_EPS(bhs_kerr_photon_orbit(&ext, false), 4.0, 1e-12,
+		   "photon_orbit retro a=M");
+
+	/* Órbita esférica: R(r) = R'(r) = 0 com E = 1 */
+	double r = 2.7, xi, eta;
+	bhs_kerr_critical_orbit(&bh, r, &xi, &eta);
+	double a = bh.a;
+	double P = r * r + a * a - a * xi;
+	double K = eta + (xi - a) * (xi - a);
+	double Delta = r * r - 2.0 * r + a * a;
+	ASSERT_EPS(P * P - Delta * K, 0.0, 1e-9, "critical_orbit R = 0");
+	ASSERT_EPS(4.0 * r * P - (2.0 * r - 2.0) * K, 0.0, 1e-9,
+		   "critical_orbit R' = 0");
+
+	/* Dentro/fora, e a borda de Schwarzschild em b² = 27 */
+	ASSERT_EPS(bhs_kerr_in_shadow(&bh, 0.0, 0.0), 1.0, 0.1,
+		   "in_shadow centro");
+	ASSERT_EPS(bhs_kerr_in_shadow(&bh, xi, eta * 0.98), 1.0, 0.1,
+		   "in_shadow logo dentro da curva");
+	ASSERT_EPS(bhs_kerr_in_shadow(&bh, xi, eta * 1.02), 0.0, 0.1,
+		   "in_shadow logo fora da curva");
+	ASSERT_EPS(bhs_kerr_in_shadow(&bh, 9.0, 1.0), 0.0, 0.1,
+		   "in_shadow longe");
+	ASSERT_EPS(bhs_kerr_in_shadow(&schw, 3.0, 26.9 - 9.0), 1.0, 0.1,
+		   "in_shadow schwarzschild dentro");
+	ASSERT_EPS(bhs_kerr_in_shadow(&schw, 3.0, 27.1 - 9.0), 0.0, 0.1,
+		   "in_shadow schwarzschild fora");
+
+	/* Spin negativo espelha ξ */
+	struct bhs_kerr neg = { .M = 1.0, .a = -0.9 };
+	ASSERT_EPS(bhs_kerr_in_shadow(&neg, -xi, eta * 0.98), 1.0, 0.1,
+		   "in_shadow spin negativo");
+}
+
+/* ============================================================================
+ * TESTES: KERR-SCHILD
+ * ============================================================================
+ */
+
+void test_kerr_schild()
+{
+	struct bhs_kerr bh = { .M = 1.0, .a = 0.9 };
+	double rp = bhs_kerr_horizon_outer(&bh);
+
+	/* Forma fechada contra diferença finita, fora, no e dentro do horizonte */
+	const double pts[][3] = { { 6.0, -3.0, 2.0 },
+				  { 1.2, 0.5, 0.7 },
+				  { 0.9, 0.4, 0.3 } };
+	for (unsigned p = 0; p < sizeof(pts) / sizeof(pts[0]); p++) {
+		struct bhs_christoffel exact, fd;
+		struct bhs_vec4 x = bhs_vec4_make(0.0, pts[p][0], pts[p][1],
+						  pts[p][2]);
+
+		int ret = bhs_kerr_schild_christoffel(&bh, x.x, x.y, x.z,
+						      &exact);
+		ASSERT_EPS(ret, 0, 0.1, "kerr_schild_christoffel status");
+		bhs_christoffel_compute(bhs_kerr_schild_metric_func, x, &bh,
+					1e-5, &fd);
+
+		double worst = 0.0;
+		for (int a = 0; a < 4; a++)
+			for (int m = 0; m < 4; m++)
+				for (int n = 0; n < 4; n++) {
+					double d = fabs(exact.gamma[a][m][n] -
+							fd.gamma[a][m][n]);
+					if (d > worst)
+						worst = d;
+				}
+		ASSERT_EPS(worst, 0.0, 1e-6,
+			   "kerr_schild_christoffel vs diff. finita");
+
+		/* Aceleração direta = -Γ u u */
+		struct bhs_vec4 u = bhs_vec4_make(1.3, -0.2, 0.5, 0.4);
+		struct bhs_vec4 acc, ref = bhs_geodesic_accel(&exact, u);
+		bhs_kerr_schild_accel(&bh, x, u, &acc);
+		ASSERT_EPS(acc.t, ref.t, 1e-12, "kerr_schild_accel t");
+		ASSERT_EPS(acc.x, ref.x, 1e-12, "kerr_schild_accel x");
+		ASSERT_EPS(acc.y, ref.y, 1e-12, "kerr_schild_accel y");
+		ASSERT_EPS(acc.z, ref.z, 1e-12, "kerr_schild_accel z");
+
+		/* g g^-1 = 1 sem inversão numérica */
+		struct bhs_metric g, gi;
+		bhs_kerr_schild_metric(&bh, x.x, x.y, x.z, &g);
+		bhs_kerr_schild_metric_inverse(&bh, x.x, x.y, x.z, &gi);
+		double off = 0.0;
+		for (int m = 0; m < 4; m++)
+			for (int n = 0; n < 4; n++) {
+				double d = 0.0;
+				for (int k = 0; k < 4; k++)
+					d += g.g[m][k] * gi.g[k][n];
+				off = fmax(off, fabs(d - (m == n ? 1.0 : 0.0)));
+			}
+		ASSERT_EPS(off, 0.0, 1e-12, "kerr_schild_metric_inverse");
+	}
+
+	/* No horizonte a métrica é finita e não degenera */
+	struct bhs_metric gh;
+	bhs_kerr_schild_metric(&bh, rp, 0.0, 0.0, &gh);
+	ASSERT_EPS(isfinite(bhs_metric_det(&gh)) && bhs_metric_det(&gh) < 0.0,
+		   1.0, 0.1, "kerr_schild no horizonte");
+
+	/* A transformação leva g_BL em g_KS: g_BL(a, b) = g_KS(J a, J b) */
+	struct bhs_vec4 pos = bhs_vec4_make(3.0, 4.5, 1.1, -2.0);
+	struct bhs_vec4 e[4] = { bhs_vec4_make(1, 0, 0, 0),
+				 bhs_vec4_make(0, 1, 0, 0),
+				 bhs_vec4_make(0, 0, 1, 0),
+				 bhs_vec4_make(0, 0, 0, 1) };
+	struct bhs_vec4 pks, J[4];
+	for (int k = 0; k < 4; k++)
+		bhs_kerr_schild_from_bl(&bh, pos, e[k], &pks, &J[k]);
+
+	struct bhs_metric gbl, gks;
+	bhs_kerr_metric(&bh, pos.x, pos.y, &gbl);
+	bhs_kerr_schild_metric(&bh, pks.x, pks.y, pks.z, &gks);
+	double worst = 0.0;
+	for (int m = 0; m < 4; m++)
+		for (int n = 0; n < 4; n++)
+			worst = fmax(worst,
+				     fabs(bhs_metric_dot(&gks, J[m], J[n]) -
+					  gbl.g[m][n]));
+	ASSERT_EPS(worst, 0.0, 1e-10, "kerr_schild pullback = BL");
+	ASSERT_EPS(bhs_kerr_schild_r(&bh, pks.x, pks.y, pks.z), pos.x, 1e-12,
+		   "kerr_schild_r");
+
+	/* Ida e volta */
+	struct bhs_vec4 vel = bhs_vec4_make(1.1, -0.3, 0.02, 0.05);
+	struct bhs_vec4 vks, pos2, vel2;
+	bhs_kerr_schild_from_bl(&bh, pos, vel, &pks, &vks);
+	bhs_kerr_schild_to_bl(&bh, pks, vks, &pos2, &vel2);
+	ASSERT_EPS(pos2.t, pos.t, 1e-10, "kerr_schild ida e volta t");
+	ASSERT_EPS(pos2.y, pos.y, 1e-12, "kerr_schild ida e volta theta");
+	ASSERT_EPS(pos2.z, pos.z, 1e-12, "kerr_schild ida e volta phi");
+	ASSERT_EPS(vel2.t, vel.t, 1e-12, "kerr_schild ida e volta u^t");
+	ASSERT_EPS(vel2.x, vel.x, 1e-12, "kerr_schild ida e volta u^r");
+	ASSERT_EPS(vel2.y, vel.y, 1e-12, "kerr_schild ida e volta u^theta");
+	ASSERT_EPS(vel2.z, vel.z, 1e-12, "kerr_schild ida e volta u^phi");
+}
+
+/* ============================================================================
+ * TESTES: SPLINE MONÓTONA
+ * ============================================================================
+ */
+
+void test_kerr_spin()
+{
+	/*
+	 * Raios contra as fórmulas fechadas, a < 0 e M ≠ 1 inclusive (r- vai
+	 * a zero com o spin: o erro dele é relativo a M)
+	 */
+	double worst = 0.0;
+	for (int i = 0; i <= 4000; i++) {
+		double chi = -0.99999998 + 2.0 * 0.99999998 * i / 4000.0;
+		struct bhs_kerr bh = { .M = 2.5, .a = 2.5 * chi };
+		struct bhs_kerr_radii r;
+		bool co = bh.a >= 0.0;
+
+		bhs_kerr_spin_radii(&bh, &r);
+		double got[] = { r.r_plus,	r.r_minus,    r.isco_pro,
+				 r.isco_retro,	r.photon_pro, r.photon_retro };
+		double ref[] = { bhs_kerr_horizon_outer(&bh),
+				 bhs_kerr_horizon_inner(&bh),
+				 bhs_kerr_isco(&bh, true),
+				 bhs_kerr_isco(&bh, false),
+				 bhs_kerr_photon_orbit(&bh, co),
+				 bhs_kerr_photon_orbit(&bh, !co) };
+		for (int c = 0; c < 6; c++)
+			worst = fmax(worst, fabs(got[c] - ref[c]) /
+						    fmax(fabs(ref[c]), bh.M));
+	}
+	ASSERT_EPS(worst, 0.0, 1e-7, "kerr_spin: raios = fórmulas");
+
+	/* Fora da tabela (χ ≈ 1) vale a fórmula fechada, sem diferença */
+	struct bhs_kerr ext = { .M = 1.0, .a = 1.0 - 1e-10 };
+	struct bhs_kerr_radii re;
+	bhs_kerr_spin_radii(&ext, &re);
+	ASSERT_EPS(re.isco_pro, bhs_kerr_isco(&ext, true), 0.0,
+		   "kerr_spin: acima do último nó");
+
+	/* Sombra: mesma resposta da bisseção em toda a faixa de spin */
+	unsigned seed = 12345u;
+	int mismatch = 0;
+	for (int i = 0; i < 200000; i++) {
+		double rnd[3];
+		for (int k = 0; k < 3; k++) {
+			seed = seed * 1664525u + 1013904223u;
+			rnd[k] = (seed >> 8) / 16777216.0;
+		}
+		struct bhs_kerr bh = { .M = 1.3, .a = 1.3 * (2.0 * rnd[0] - 1) };
+		double xi = 1.3 * (24.0 * rnd[1] - 12.0);
+		double eta = 1.69 * 40.0 * rnd[2];
+		mismatch += bhs_kerr_spin_in_shadow(&bh, xi, eta) !=
+			    bhs_kerr_in_shadow(&bh, xi, eta);
+	}
+	ASSERT_EPS(mismatch, 0, 0.1, "kerr_spin: sombra = bisseção");
+
+	/* Curva crítica: o ponto está na borda, com ξ linear em v */
+	struct bhs_kerr bh = { .M = 1.0, .a = -0.9 };
+	double xi, eta, xi0, eta0, xi1, eta1;
+	bool edge = bhs_kerr_spin_critical_curve(&bh, 0.0, &xi0, &eta0) == 0 &&
+		    bhs_kerr_spin_critical_curve(&bh, 1.0, &xi1, &eta1) == 0 &&
+		    bhs_kerr_spin_critical_curve(&bh, 0.3, &xi, &eta) == 0;
+	edge &= bhs_kerr_in_shadow(&bh, xi, eta * (1.0 - 1e-9)) &&
+		!bhs_kerr_in_shadow(&bh, xi, eta * (1.0 + 1e-9));
+	ASSERT_EPS(edge, 1.0, 0.1, "kerr_spin: curva crítica na borda");
+	ASSERT_EPS(xi, xi0 + 0.3 * (xi1 - xi0), 1e-12, "kerr_spin: ξ(v)");
+	ASSERT_EPS(fabs(eta0) + fabs(eta1), 0.0, 1e-9,
+		   "kerr_spin: η = 0 nas órbitas equatoriais");
+	ASSERT_EPS(xi0 < 0.0, 1.0, 0.1, "kerr_spin: a < 0 espelha ξ");
+
+	/* Buffer da GPU: cabeçalho e o primeiro nó (χ = 1 - 0.05⁶) */
+	static float packed[BHS_KERR_SPIN_PACK_FLOATS];
+	bhs_kerr_spin_pack(packed);
+	struct bhs_kerr first = { .M = 1.0, .a = 1.0 - pow(0.05, 6.0) };
+	ASSERT_EPS(packed[0], BHS_KERR_SPIN_NODES, 0.0, "kerr_spin: nós");
+	ASSERT_EPS(packed[4 + 2], bhs_kerr_isco(&first, true), 1e-6,
+		   "kerr_spin: pack isco");
+	ASSERT_EPS(packed[BHS_KERR_SPIN_PACK_FLOATS - 8], 2.0, 1e-6,
+		   "kerr_spin: pack r+ em a = 0");
+}
+
+void test_spline_monotone()
+{
+	/* Passa pelos nós, com stride */
+	double y[2 * 9];
+	for (int i = 0; i < 9; i++) {
+		y[2 * i] = sin(0.1 * i);
+		y[2 * i + 1] = -1.0;
+	}
+	for (int i = 0; i < 9; i++)
+		ASSERT_EPS(bhs_spline_monotone(y, 2, 9, i), sin(0.1 * i), 1e-15,
+			   "spline: nó");
+
+	/* Trecho monótono e suave: erro de ordem h³ */
+	double worst = 0.0;
+	for (double x = 0.0; x <= 8.0; x += 0.01)
+		worst = fmax(worst, fabs(bhs_spline_monotone(y, 2, 9, x) -
+					 sin(0.1 * x)));
+	ASSERT_EPS(worst, 0.0, 1e-4, "spline: precisão em sin");
+
+	/* Degrau: nada de overshoot, e continua monótona */
+	double step[8] = { 0, 0, 0, 0.01, 0.99, 1, 1, 1 };
+	double prev = -1.0, lo = 1.0, hi = 0.0;
+	bool mono = true;
+	for (double x = 0.0; x <= 7.0; x += 0.005) {
+		double v = bhs_spline_monotone(step, 1, 8, x);
+		mono = mono && v >= prev;
+		prev = v;
+		lo = fmin(lo, v);
+		hi = fmax(hi, v);
+	}
+	ASSERT_EPS(mono, true, 0, "spline: monótona no degrau");
+	ASSERT_EPS(lo, 0.0, 0.0, "spline: sem undershoot");
+	ASSERT_EPS(hi, 1.0, 0.0, "spline: sem overshoot");
+
+	/* Fora da grade: presa nas pontas */
+	ASSERT_EPS(bhs_spline_monotone(step, 1, 8, -3.0), 0.0, 0.0,
+		   "spline: clamp inferior");
+	ASSERT_EPS(bhs_spline_monotone(step, 1, 8, 42.0), 1.0, 0.0,
+		   "spline: clamp superior");
+}
+
+/* ============================================================================
+ * TESTES: INTEGRAIS ELÍPTICAS
+ * ============================================================================
+ */
+
+void test_elliptic()
+{
+	/* Valores de Carlson (1995) */
+	ASSERT_EPS(creal(bhs_elliptic_rf(1.0, 2.0, 0.0)), 1.3110287771461, 1e-13,
+		   "R_F(1, 2, 0)");
+	ASSERT_EPS(creal(bhs_elliptic_rj(0.0, 1.0, 2.0, 3.0)),
+		   0.77688623778582, 1e-13, "R_J(0, 1, 2, 3)");
+	ASSERT_EPS(creal(bhs_elliptic_rc(0.0, 0.25)), M_PI, 1e-13,
+		   "R_C(0, 1/4) = π");
+	ASSERT_EPS(creal(bhs_elliptic_rc(2.25, 2.0)), log(2.0), 1e-13,
+		   "R_C(9/4, 2) = ln 2");
+	ASSERT_EPS(creal(bhs_elliptic_rc(0.25, -2.0)), log(2.0) / 3.0, 1e-13,
+		   "R_C(1/4, -2): valor principal");
+
+	/* Argumentos complexos conjugados dão resultado real */
+	double complex rf = bhs_elliptic_rf(1.0 + 2.0 * I, 1.0 - 2.0 * I, 3.0);
+	ASSERT_EPS(cimag(rf), 0.0, 1e-15, "R_F de par conjugado é real");
+
+	ASSERT_EPS(bhs_elliptic_k(0.0), M_PI_2, 1e-15, "K(0) = π/2");
+	ASSERT_EPS(bhs_elliptic_k(0.5), 1.8540746773013719, 1e-13, "K(1/2)");
+
+	/* Π(n; φ | 0) = atan(√(1 - n) tan φ) / √(1 - n) */
+	double n = 0.6, phi = 1.1, c = sqrt(1.0 - n);
+	ASSERT_EPS(bhs_elliptic_pi(n, phi, 0.0), atan(c * tan(phi)) / c, 1e-13,
+		   "Π(n; φ | 0)");
+	ASSERT_EPS(bhs_elliptic_pi(0.0, phi, 0.7), bhs_elliptic_f(phi, 0.7),
+		   1e-14, "Π(0; φ | m) = F");
+
+	/* Jacobi: identidades, F inverte am, sn(K) = 1, inclusive m < 0 */
+	const double ms[3] = { 0.7, 0.0, -2.5 };
+	for (int i = 0; i < 3; i++) {
+		double m = ms[i], sn, cn, dn;
+		bhs_elliptic_jacobi(0.8, m, &sn, &cn, &dn);
+		ASSERT_EPS(sn * sn + cn * cn, 1.0, 1e-14, "jacobi: sn² + cn²");
+		ASSERT_EPS(dn * dn + m * sn * sn, 1.0, 1e-14,
+			   "jacobi: dn² + m sn²");
+		ASSERT_EPS(bhs_elliptic_f(atan2(sn, cn), m), 0.8, 1e-13,
+			   "jacobi: F(am u) = u");
+		bhs_elliptic_jacobi(bhs_elliptic_k(m), m, &sn, NULL, NULL);
+		ASSERT_EPS(sn, 1.0, 1e-13, "jacobi: sn(K) = 1");
+	}
+}
+
+/*
+ * Confere r(σ), θ(σ), φ(σ) contra as próprias equações de 1ª ordem por
+ * diferença central: pega sinal de raiz, ramo de Π e lado do retorno.
+ */
+static void check_kerr_elliptic_rates(const struct bhs_kerr *bh,
+				      const struct bhs_kerr_elliptic *ray,
+				      double sigma)
+{
+	const double h = 1e-5;
+	double dr, dth;
+	double r = bhs_kerr_elliptic_r(ray, sigma, &dr);
+	double th = bhs_kerr_elliptic_theta(ray, sigma, &dth);
+	double st = sin(th);
+	double dphi = bh->a * (2.0 * bh->M * r - bh->a * ray->lambda) /
+			      bhs_kerr_Delta(bh, r) +
+		      ray->lambda / (st * st);
+
+	double num_r = (bhs_kerr_elliptic_r(ray, sigma + h, NULL) -
+			bhs_kerr_elliptic_r(ray, sigma - h, NULL)) /
+		       (2.0 * h);
+	double num_th = (bhs_kerr_elliptic_theta(ray, sigma + h, NULL) -
+			 bhs_kerr_elliptic_theta(ray, sigma - h, NULL)) /
+			(2.0 * h);
+	double num_phi = (bhs_kerr_elliptic_phi(ray, sigma + h) -
+			  bhs_kerr_elliptic_phi(ray, sigma - h)) /
+			 (2.0 * h);
+
+	ASSERT_EPS(num_r, dr, 1e-5 * (1.0 + fabs(dr)), "kerr_elliptic: dr/dσ");
+	ASSERT_EPS(num_th, dth, 1e-6, "kerr_elliptic: dθ/dσ");
+	ASSERT_EPS(num_phi, dphi, 1e-6 * (1.0 + fabs(dphi)),
+		   "kerr_elliptic: dφ/dσ");
+}
+
+void test_kerr_elliptic()
+{
+	const struct bhs_kerr bh = { .M = 1.0, .a = 0.9 };
+	struct bhs_kerr_elliptic ray;
+	bool captured;
+
+	/* Passa longe e volta: ponto de retorno e escape */
+	int rc = bhs_kerr_elliptic_init(&ray, &bh, 40.0, 1.3, 0.2, 4.0, 30.0,
+					-1, 1);
+	ASSERT_EPS(rc, 0, 0, "kerr_elliptic: init (retorno)");
+	ASSERT_EPS(ray.turning, true, 0, "kerr_elliptic: tem retorno");
+
+	double end = bhs_kerr_elliptic_end(&ray, 1.01 * ray.r_plus, 100.0,
+					   &captured);
+	ASSERT_EPS(captured, false, 0, "kerr_elliptic: escapa");
+	ASSERT_EPS(bhs_kerr_elliptic_r(&ray, end, NULL), 100.0, 1e-9,
+		   "kerr_elliptic: r(fim) = r_out");
+	ASSERT_EPS(bhs_kerr_elliptic_r(&ray, 0.0, NULL), 40.0, 1e-10,
+		   "kerr_elliptic: r(0) = r0");
+	ASSERT_EPS(bhs_kerr_elliptic_theta(&ray, 0.0, NULL), 1.3, 1e-12,
+		   "kerr_elliptic: θ(0) = θ0");
+	ASSERT_EPS(bhs_kerr_elliptic_phi(&ray, 0.0), 0.2, 1e-12,
+		   "kerr_elliptic: φ(0) = φ0");
+
+	double s[4] = { 0.3 * ray.sigma_turn, 0.999 * ray.sigma_turn,
+			1.001 * ray.sigma_turn, 0.5 * (ray.sigma_turn + end) };
+	for (int i = 0; i < 4; i++)
+		check_kerr_elliptic_rates(&bh, &ray, s[i]);
+
+	/* Cruzamentos do equador: θ = π/2 e em ordem */
+	double prev = 0.0;
+	for (int n = 0; n < 3; n++) {
+		double sn = bhs_kerr_elliptic_equator(&ray, n);
+		ASSERT_EPS(bhs_kerr_elliptic_theta(&ray, sn, NULL), M_PI_2,
+			   1e-12, "kerr_elliptic: cruzamento no equador");
+		ASSERT_EPS(sn > prev, true, 0, "kerr_elliptic: em ordem");
+		prev = sn;
+	}
+	ASSERT_EPS(bhs_kerr_elliptic_polar_turns(&ray, 0.0), 0, 0,
+		   "kerr_elliptic: nenhuma volta em σ = 0");
+
+	/* Dentro da sombra: cai sem retorno, r(σ) por Newton */
+	rc = bhs_kerr_elliptic_init(&ray, &bh, 40.0, 1.3, 0.2, 1.0, 5.0, -1,
+				    -1);
+	ASSERT_EPS(rc, 0, 0, "kerr_elliptic: init (captura)");
+	end = bhs_kerr_elliptic_end(&ray, 1.01 * ray.r_plus, 100.0, &captured);
+	ASSERT_EPS(captured, true, 0, "kerr_elliptic: capturado");
+	ASSERT_EPS(bhs_kerr_elliptic_r(&ray, end, NULL), 1.01 * ray.r_plus,
+		   1e-9, "kerr_elliptic: r(fim) = r_in");
+	check_kerr_elliptic_rates(&bh, &ray, 0.5 * end);
+	check_kerr_elliptic_rates(&bh, &ray, 0.95 * end);
+
+	/* Fora do escopo */
+	ASSERT_EPS(bhs_kerr_elliptic_init(&ray, &bh, 40.0, 1.3, 0.2, 4.0, 0.0,
+					  -1, 1),
+		   -1, 0, "kerr_elliptic: η = 0 recusado");
+	ASSERT_EPS(bhs_kerr_elliptic_init(&ray, &bh, 40.0, 1.3, 0.2, 0.0, 20.0,
+					  -1, 1),
+		   -1, 0, "kerr_elliptic: λ = 0 recusado");
+}
+
 /* ============================================================================
  * MAIN
  * ============================================================================
@@ -122,7 +808,17 @@ int main()
 
 	test_vec4_math();
 	test_metric_invert();
+	test_metric_structure();
 	test_schwarzschild();
+	test_kerr_christoffel();
+	test_christoffel_desc();
+	test_dual();
+	test_kerr_shadow();
+	test_kerr_schild();
+	test_kerr_spin();
+	test_spline_monotone();
+	test_elliptic();
+	test_kerr_elliptic();
 
 	printf("\nResultados:\n");
 	printf("  Rodados: %d\n", tests_run);
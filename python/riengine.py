@@ -51,6 +51,10 @@ BHS_SUN_MAIN_SEQUENCE = 0
 BHS_SUN_RED_GIANT = 1
 BHS_SUN_WHITE_DWARF = 2
 BHS_SUN_NEUTRON_STAR = 3
+# enum bhs_metric_structure
+BHS_METRIC_GENERAL = 0
+BHS_METRIC_DIAGONAL = 1
+BHS_METRIC_TPHI = 2
 # enum bhs_body_type
 BHS_BODY_PLANET = 0
 BHS_BODY_MOON = 1
@@ -136,6 +140,7 @@ bhs_vec3._fields_ = [
 # bhs_metric definition
 bhs_metric._fields_ = [
         ('g', ('BHS_ALIGN(16) real_t' * 4)),
+        ('structure', ctypes.c_int),
     ]
 
 # bhs_christoffel definition
@@ -562,6 +567,13 @@ if _lib:
         bhs_metric_diag.restype = 'bhs_metric'
     else:
         print(f'Warning: Function bhs_metric_diag not found in library')
+    # enum bhs_metric_structure bhs_metric_classify
+    if hasattr(_lib, 'bhs_metric_classify'):
+        bhs_metric_classify = _lib.bhs_metric_classify
+        bhs_metric_classify.argtypes = [ctypes.POINTER('const struct bhs_metric')]
+        bhs_metric_classify.restype = ctypes.c_int
+    else:
+        print(f'Warning: Function bhs_metric_classify not found in library')
     # bool bhs_metric_is_symmetric
     if hasattr(_lib, 'bhs_metric_is_symmetric'):
         bhs_metric_is_symmetric = _lib.bhs_metric_is_symmetric
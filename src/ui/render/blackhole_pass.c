@@ -9,6 +9,7 @@
 #include <string.h>
 #include "engine/assets/image_loader.h" /* Para utils de IO de arquivo se precisar */
 #include "gui/log.h"
+#include "math/spacetime/kerr_spin.h"
 
 /* ============================================================================
  * ESTRUTURAS PRIVADAS
@@ -26,6 +27,8 @@ struct blackhole_params {
 	float res_x;
 	float res_y;
 	int render_mode;
+	float r_horizon;
+	float r_isco;
 };
 
 struct bhs_blackhole_pass {
@@ -307,6 +310,14 @@ void bhs_blackhole_pass_dispatch(bhs_blackhole_pass_t pass,
 	if (params.mass == 0.0f)
 		params.mass = 1.0f; /* Fallback */
 
+	/* Raios críticos uma vez por quadro, não por pixel no shader */
+	struct bhs_kerr bh = { .M = params.mass,
+			       .a = params.spin * params.mass };
+	struct bhs_kerr_radii radii;
+	bhs_kerr_spin_radii(&bh, &radii);
+	params.r_horizon = (float)radii.r_plus;
+	params.r_isco = (float)radii.isco_pro;
+
 	bhs_gpu_cmd_push_constants(cmd, 0, &params, sizeof(params));
 
 	/* 5. Dispatch */
@@ -4,6 +4,7 @@
 #include <time.h>			/* [NEW] For dynamic date */
 #include "engine/assets/image_loader.h" /* [NEW] */
 #include "engine/assets/svg_loader.h"	/* [NEW] */
+#include "math/spacetime/kerr_spin.h"	/* Raios críticos por spin */
 #include "math/units.h"			/* [NEW] Para bhs_sim_time_to_date */
 #include "src/simulation/data/orbit_marker.h" /* [NEW] */
 #include "src/simulation/data/planet.h"
@@ -1481,9 +1482,17 @@ void bhs_hud_draw(bhs_ui_ctx_t ctx, bhs_hud_state_t *state, int window_w,
 			DRAW_PROP("Class:", "%s", b->prop.star.spectral_type);
 			DRAW_PROP("Age:", "%.1e yr", b->prop.star.age);
 		} else if (b->type == BHS_BODY_BLACKHOLE) {
+			/* Raios críticos em unidades de M (tabela de spin) */
+			struct bhs_kerr_radii radii;
+			bhs_kerr_spin_radii(
+				&(struct bhs_kerr){
+					.M = 1.0, .a = b->prop.bh.spin_factor },
+				&radii);
 			DRAW_PROP("Spin:", "%.2f", b->prop.bh.spin_factor);
 			DRAW_PROP("Horizon:", "%.2f",
 				  b->prop.bh.event_horizon_r);
+			DRAW_PROP("ISCO:", "%.2f M", radii.isco_pro);
+			DRAW_PROP("Photon:", "%.2f M", radii.photon_pro);
 		}
 
 		/* Strongest Attractor Display */
@@ -0,0 +1,1028 @@
+/**
+ * @file test_geodesic.c
+ * @brief Testes do integrador de geodésicas
+ *
+ * "Dois caminhos diferentes para o mesmo fóton.
+ * Se eles discordam, um dos dois está mentindo."
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "engine/physics/geodesic/geodesic.h"
+#include "engine/physics/geodesic/geodesic_batch.h"
+#include "engine/physics/geodesic/metric_table.h"
+#include "engine/physics/geodesic/planar_lut.h"
+#include "math/spacetime/kerr_elliptic.h"
+
+#define TEST_FAIL "[\033[31m FAIL \033[0m]"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT_EPS(a, b, eps, msg)                                             \
+	do {                                                                   \
+		tests_run++;                                                   \
+		double diff = (double)(a) - (double)(b);                       \
+		if (diff < 0) diff = -diff;                                    \
+		if (diff > (eps)) {                                            \
+			fprintf(stderr, "%s %s: exp %f, got %f (eps %e)\n",    \
+				TEST_FAIL, msg, (double)(b), (double)(a),      \
+				(double)(eps));                                \
+			tests_failed++;                                        \
+		}                                                              \
+	} while (0)
+
+#define ASSERT_TRUE(cond, msg)                                                 \
+	do {                                                                   \
+		tests_run++;                                                   \
+		if (!(cond)) {                                                 \
+			fprintf(stderr, "%s %s\n", TEST_FAIL, msg);            \
+			tests_failed++;                                        \
+		}                                                              \
+	} while (0)
+
+static const struct bhs_kerr BH = { .M = 1.0, .a = 0.9 };
+
+static void make_ray(struct bhs_geodesic *geo, double u, double v)
+{
+	struct bhs_vec3 cam = bhs_vec3_make(0.0, -30.0, 4.0);
+	struct bhs_vec3 dir = bhs_vec3_make(0.0, 1.0, -4.0 / 30.0);
+	struct bhs_vec3 up = bhs_vec3_make(0.0, 0.0, 1.0);
+
+	bhs_geodesic_ray_from_camera(geo, cam, dir, up, u, v, 0.8, &BH);
+}
+
+/* ============================================================================
+ * TESTES: INICIALIZAÇÃO
+ * ============================================================================
+ */
+
+static void test_init_photon_null()
+{
+	struct bhs_geodesic geo;
+	struct bhs_vec4 pos = bhs_vec4_make(0.0, 6.0, 1.2, 0.0);
+
+	/* k^φ ≠ 0 com spin: o termo g_tφ precisa entrar certo */
+	bhs_geodesic_init_photon(&geo, pos, bhs_vec3_make(-0.3, 0.05, 0.08),
+				 &BH);
+	ASSERT_EPS(bhs_geodesic_norm2(&geo, &BH), 0.0, 1e-12,
+		   "init_photon nulo");
+	ASSERT_TRUE(geo.vel.t > 0.0, "init_photon futuro");
+}
+
+/* ============================================================================
+ * TESTES: CARTER
+ * ============================================================================
+ */
+
+static void test_carter_matches_christoffel()
+{
+	struct bhs_geodesic_config cfg = {
+		.dlambda = 0.05,
+		.max_steps = 20000,
+		.escape_radius = 60.0,
+	};
+	const double uv[][2] = { { 0.0, 0.0 }, { 0.3, 0.1 }, { -0.2, 0.25 } };
+
+	for (unsigned i = 0; i < sizeof(uv) / sizeof(uv[0]); i++) {
+		struct bhs_geodesic a, b;
+		make_ray(&a, uv[i][0], uv[i][1]);
+		b = a;
+
+		cfg.mode = BHS_GEO_MODE_CHRISTOFFEL;
+		enum bhs_geodesic_status sa = bhs_geodesic_propagate(&a, &BH,
+								     &cfg);
+		cfg.mode = BHS_GEO_MODE_CARTER;
+		enum bhs_geodesic_status sb = bhs_geodesic_propagate(&b, &BH,
+								     &cfg);
+
+		ASSERT_TRUE(sa == sb, "carter: mesmo status");
+		if (sa == BHS_GEO_ESCAPED && sb == BHS_GEO_ESCAPED) {
+			ASSERT_EPS(b.pos.y, a.pos.y, 2e-2, "carter: θ final");
+			ASSERT_EPS(cos(b.pos.z - a.pos.z), 1.0, 2e-3,
+				   "carter: φ final");
+		}
+	}
+}
+
+static void test_carter_invariants()
+{
+	struct bhs_geodesic geo;
+	struct bhs_geodesic_constants k0, k1;
+	struct bhs_geodesic_config cfg = {
+		.dlambda = 0.1,
+		.max_steps = 5000,
+		.mode = BHS_GEO_MODE_CARTER,
+	};
+
+	make_ray(&geo, 0.25, 0.2);
+	bhs_geodesic_constants(&geo, &BH, &k0);
+	bhs_geodesic_propagate(&geo, &BH, &cfg);
+	bhs_geodesic_constants(&geo, &BH, &k1);
+
+	ASSERT_EPS(k1.E, k0.E, 1e-9 * fabs(k0.E), "carter: E conservado");
+	ASSERT_EPS(k1.L, k0.L, 1e-9 * fabs(k0.L) + 1e-9, "carter: L conservado");
+	ASSERT_EPS(k1.Q, k0.Q, 1e-6 * (fabs(k0.Q) + 1.0),
+		   "carter: Q conservado");
+	ASSERT_EPS(bhs_geodesic_norm2(&geo, &BH), 0.0, 1e-6,
+		   "carter: continua nulo");
+}
+
+/* ============================================================================
+ * TESTES: DOPRI5
+ * ============================================================================
+ */
+
+static void test_dopri5_propagate()
+{
+	struct bhs_geodesic_config fixed = {
+		.dlambda = 0.05,
+		.max_steps = 40000,
+		.escape_radius = 60.0,
+	};
+	struct bhs_geodesic_config adapt = fixed;
+	adapt.tolerance = 1e-8;
+
+	/* Raio que escapa e raio que passa rente à esfera de fótons */
+	const double uv[][2] = { { 0.3, 0.1 }, { 0.16, 0.02 } };
+
+	for (unsigned i = 0; i < sizeof(uv) / sizeof(uv[0]); i++) {
+		struct bhs_geodesic a, b;
+		struct bhs_geodesic_constants k0, k1;
+
+		make_ray(&a, uv[i][0], uv[i][1]);
+		b = a;
+		bhs_geodesic_constants(&a, &BH, &k0);
+
+		enum bhs_geodesic_status sa =
+			bhs_geodesic_propagate(&a, &BH, &fixed);
+		enum bhs_geodesic_status sb =
+			bhs_geodesic_propagate(&b, &BH, &adapt);
+		bhs_geodesic_constants(&b, &BH, &k1);
+
+		ASSERT_TRUE(sa == sb, "dopri5: mesmo status que RK4");
+		ASSERT_TRUE(b.step_count * 5 < a.step_count,
+			    "dopri5: bem menos passos");
+		ASSERT_EPS(k1.Q, k0.Q, 1e-4 * (fabs(k0.Q) + 1.0),
+			   "dopri5: Q conservado");
+		ASSERT_EPS(k1.L, k0.L, 1e-5, "dopri5: L conservado");
+	}
+}
+
+static void test_dopri5_dense_output()
+{
+	struct bhs_geodesic geo, ref;
+	struct bhs_geodesic_stepper st, st_ref;
+
+	make_ray(&geo, 0.1, 0.05);
+	ref = geo;
+
+	/* Um passo grande, depois interpola no meio */
+	bhs_geodesic_stepper_init(&st, 2.0, 1e-10, 1e-10);
+	st.h_max = 2.0;
+	bhs_geodesic_step_dopri5(&geo, &BH, &st);
+
+	double mid = st.lambda0 + 0.37 * st.h_last;
+	struct bhs_vec4 pos, vel;
+	bhs_geodesic_dense_eval(&st, mid, &pos, &vel);
+
+	/* Referência: integra direto até λ = mid */
+	bhs_geodesic_stepper_init(&st_ref, mid, 1e-12, 1e-12);
+	while (ref.affine_param < mid - 1e-12) {
+		st_ref.h_max = mid - ref.affine_param;
+		bhs_geodesic_step_dopri5(&ref, &BH, &st_ref);
+	}
+
+	ASSERT_EPS(pos.x, ref.pos.x, 1e-7, "dopri5: densa r");
+	ASSERT_EPS(pos.y, ref.pos.y, 1e-7, "dopri5: densa θ");
+	ASSERT_EPS(pos.z, ref.pos.z, 1e-7, "dopri5: densa φ");
+	ASSERT_EPS(vel.x, ref.vel.x, 1e-7, "dopri5: densa u^r");
+}
+
+/* ============================================================================
+ * TESTES: DISCO FINO
+ * ============================================================================
+ */
+
+static void test_thin_disk_crossing()
+{
+	struct bhs_geodesic_config coarse = {
+		.dlambda = 0.25,
+		.max_steps = 20000,
+		.escape_radius = 60.0,
+		.disk_inner = 3.0,
+		.disk_outer = 20.0,
+	};
+	struct bhs_geodesic_config fine = coarse;
+	fine.dlambda = 0.05;
+	fine.tolerance = 1e-10;
+
+	/* Raio que desce direto no disco, na frente do buraco */
+	struct bhs_geodesic a, b;
+	struct bhs_geodesic_constants k0;
+	make_ray(&a, 0.05, -0.2);
+	b = a;
+	bhs_geodesic_constants(&a, &BH, &k0);
+
+	ASSERT_TRUE(bhs_geodesic_propagate(&a, &BH, &coarse) ==
+			    BHS_GEO_HIT_DISK,
+		    "disco fino: RK4 acerta com passo grande");
+	ASSERT_TRUE(bhs_geodesic_propagate(&b, &BH, &fine) == BHS_GEO_HIT_DISK,
+		    "disco fino: DOPRI5 acerta");
+
+	ASSERT_EPS(a.pos.y, M_PI_2, 1e-15, "disco fino: para no plano");
+	ASSERT_EPS(a.hit.r, b.hit.r, 1e-4, "disco fino: r de impacto");
+	ASSERT_EPS(cos(a.hit.phi - b.hit.phi), 1.0, 1e-8,
+		   "disco fino: φ de impacto");
+	ASSERT_EPS(-b.hit.p.t, k0.E, 1e-8 * k0.E, "disco fino: p_t = -E");
+	ASSERT_EPS(b.hit.p.z, k0.L, 1e-7, "disco fino: p_φ = L");
+}
+
+/*
+ * Direção espacial de movimento (esféricas planas). Longe do buraco ela
+ * quase não muda, então não depende de onde cada um parou além de R.
+ */
+static struct bhs_vec3 heading(const struct bhs_geodesic *g)
+{
+	double r = g->pos.x;
+	double st = sin(g->pos.y), ct = cos(g->pos.y);
+	double sp = sin(g->pos.z), cp = cos(g->pos.z);
+
+	return bhs_vec3_normalize(bhs_vec3_make(
+		g->vel.x * st * cp + r * g->vel.y * ct * cp -
+			r * st * g->vel.z * sp,
+		g->vel.x * st * sp + r * g->vel.y * ct * sp +
+			r * st * g->vel.z * cp,
+		g->vel.x * ct - r * g->vel.y * st));
+}
+
+/* ============================================================================
+ * TESTES: LOTE SoA
+ * ============================================================================
+ */
+
+static void batch_matches_scalar(const struct bhs_geodesic_config *config)
+{
+	enum { N = 12 };
+	struct bhs_geodesic_config cfg = *config;
+	struct bhs_geodesic_batch batch;
+	struct bhs_geodesic ref[N * N], out[N * N];
+
+	/* N² não é múltiplo de lanes: último bloco parcial de propósito */
+	ASSERT_TRUE(bhs_geodesic_batch_init(&batch, N * N) == 0,
+		    "batch: init");
+
+	for (int j = 0; j < N; j++) {
+		for (int i = 0; i < N; i++) {
+			struct bhs_geodesic *g = &ref[j * N + i];
+			make_ray(g, -0.6 + 1.2 * i / (N - 1),
+				 -0.6 + 1.2 * j / (N - 1));
+			bhs_geodesic_batch_push(&batch, g);
+		}
+	}
+
+	bhs_geodesic_batch_propagate(&batch, &BH, &cfg);
+	bhs_geodesic_batch_scatter(&batch, out);
+
+	int status_mismatch = 0;
+	double max_err = 0.0;
+	for (int k = 0; k < N * N; k++) {
+		bhs_geodesic_propagate(&ref[k], &BH, &cfg);
+		if (ref[k].status != out[k].status ||
+		    ref[k].step_count != out[k].step_count) {
+			status_mismatch++;
+			continue;
+		}
+		/*
+		 * Passo fixo perto do horizonte às vezes explode para r enorme
+		 * e sai como ESCAPED nos dois caminhos; aí só o status conta.
+		 */
+		if (ref[k].pos.x > 10.0 * cfg.escape_radius)
+			continue;
+		max_err = fmax(max_err, fabs(ref[k].pos.x - out[k].pos.x));
+		max_err = fmax(max_err, fabs(ref[k].pos.y - out[k].pos.y));
+		max_err = fmax(max_err, fabs(cos(ref[k].pos.z - out[k].pos.z) -
+					     1.0));
+	}
+
+	ASSERT_TRUE(status_mismatch == 0, "batch: mesmo status por raio");
+	ASSERT_EPS(max_err, 0.0, 1e-8, "batch: mesma posição final");
+	ASSERT_TRUE(batch.active == 0, "batch: todos compactados");
+
+	bhs_geodesic_batch_free(&batch);
+}
+
+static void test_batch_matches_scalar()
+{
+	struct bhs_geodesic_config cfg = {
+		.dlambda = 0.05,
+		.max_steps = 4000,
+		.escape_radius = 60.0,
+		.disk_inner = 6.0,
+		.disk_outer = 20.0,
+		.disk_half_thickness = 0.2,
+	};
+
+	batch_matches_scalar(&cfg);
+
+	/* Disco fino: impacto por busca de raiz nos dois caminhos */
+	cfg.disk_half_thickness = 0.0;
+	cfg.dlambda = 0.2;
+	batch_matches_scalar(&cfg);
+}
+
+static void test_batch_mixed_precision()
+{
+	enum { N = 12 };
+	struct bhs_geodesic_config cfg = {
+		.dlambda = 0.2,
+		.max_steps = 4000,
+		.escape_radius = 60.0,
+		.disk_inner = 6.0,
+		.disk_outer = 20.0,
+	};
+	struct bhs_geodesic_batch wide, mixed;
+	struct bhs_geodesic geo, ref[N * N], out[N * N];
+	unsigned char fp32[N * N];
+
+	ASSERT_TRUE(bhs_geodesic_batch_init(&wide, N * N) == 0 &&
+			    bhs_geodesic_batch_init(&mixed, N * N) == 0,
+		    "mixed: init");
+
+	for (int j = 0; j < N; j++) {
+		for (int i = 0; i < N; i++) {
+			make_ray(&geo, -0.6 + 1.2 * i / (N - 1),
+				 -0.6 + 1.2 * j / (N - 1));
+			bhs_geodesic_batch_push(&wide, &geo);
+			bhs_geodesic_batch_push(&mixed, &geo);
+		}
+	}
+
+	bhs_geodesic_batch_propagate(&wide, &BH, &cfg);
+	cfg.mixed_precision = true;
+	bhs_geodesic_batch_propagate(&mixed, &BH, &cfg);
+	bhs_geodesic_batch_scatter(&wide, ref);
+	bhs_geodesic_batch_scatter(&mixed, out);
+
+	for (int i = 0; i < mixed.count; i++)
+		fp32[mixed.id[i]] = mixed.fp32[i];
+
+	/*
+	 * Quem promoveu passou pela esfera de fótons, onde qualquer
+	 * diferença cresce exponencialmente: só o status conta. Quem ficou
+	 * em float inteiro tem que bater com o double até o arredondamento.
+	 */
+	int n_fp32 = 0;
+	int status_mismatch = 0;
+	double hit_err = 0.0, dir_err = 0.0;
+	for (int k = 0; k < N * N; k++) {
+		status_mismatch += ref[k].status != out[k].status;
+		if (!fp32[k] || ref[k].status != out[k].status)
+			continue;
+		n_fp32++;
+
+		if (ref[k].status == BHS_GEO_HIT_DISK) {
+			hit_err = fmax(hit_err,
+				       fabs(ref[k].hit.r - out[k].hit.r));
+		} else if (ref[k].pos.y >= 0.0 && ref[k].pos.y <= M_PI) {
+			double c = bhs_vec3_dot(heading(&ref[k]),
+						heading(&out[k]));
+			dir_err = fmax(dir_err, 1.0 - c);
+		}
+	}
+
+	ASSERT_TRUE(n_fp32 > 0 && n_fp32 < N * N,
+		    "mixed: parte em float, parte promovida");
+	ASSERT_TRUE(status_mismatch <= N * N / 50, "mixed: mesmo status");
+	ASSERT_EPS(hit_err, 0.0, 1e-3, "mixed: impacto dos raios float");
+	ASSERT_EPS(dir_err, 0.0, 1e-8, "mixed: direção dos raios float");
+
+	/* Norma nula estragada longe do buraco: promovido na hora */
+	bhs_geodesic_batch_clear(&mixed);
+	make_ray(&geo, 0.6, 0.6);
+	geo.vel.x *= 1.01;
+	bhs_geodesic_batch_push(&mixed, &geo);
+	cfg.max_steps = 1;
+	bhs_geodesic_batch_propagate(&mixed, &BH, &cfg);
+	ASSERT_TRUE(mixed.fp32[0] == 0, "mixed: promove pela norma");
+
+	bhs_geodesic_batch_free(&wide);
+	bhs_geodesic_batch_free(&mixed);
+}
+
+/* ============================================================================
+ * TESTES: ATALHOS ANALÍTICOS
+ * ============================================================================
+ */
+
+static void test_shortcuts()
+{
+	struct bhs_geodesic_config full = {
+		.dlambda = 0.5,
+		.max_steps = 40000,
+		.escape_radius = 400.0,
+		.tolerance = 1e-10,
+	};
+	struct bhs_geodesic_config fast = full;
+	fast.shadow_capture = true;
+	fast.far_field_radius = 40.0;
+
+	int steps_full = 0, steps_fast = 0, shadow = 0, far = 0;
+	double worst = 0.0;
+
+	for (int j = 0; j < 9; j++) {
+		for (int i = 0; i < 9; i++) {
+			struct bhs_geodesic a, b;
+			make_ray(&a, -0.4 + 0.1 * i, -0.4 + 0.1 * j);
+			b = a;
+
+			enum bhs_geodesic_status sa =
+				bhs_geodesic_propagate(&a, &BH, &full);
+			enum bhs_geodesic_status sb =
+				bhs_geodesic_propagate(&b, &BH, &fast);
+
+			ASSERT_TRUE(sa == sb, "atalhos: mesmo veredito");
+			ASSERT_TRUE(a.shortcut == BHS_GEO_SHORTCUT_NONE,
+				    "atalhos: desligados não marcam");
+			steps_full += a.step_count;
+			steps_fast += b.step_count;
+			shadow += b.shortcut == BHS_GEO_SHORTCUT_SHADOW;
+			far += b.shortcut == BHS_GEO_SHORTCUT_FAR_FIELD;
+
+			if (sa == BHS_GEO_ESCAPED && sb == BHS_GEO_ESCAPED) {
+				ASSERT_EPS(b.pos.x, full.escape_radius, 1e-9,
+					   "atalhos: termina no raio de escape");
+				double c = bhs_vec3_dot(heading(&a),
+							heading(&b));
+				worst = fmax(worst, acos(fmin(c, 1.0)));
+			}
+		}
+	}
+
+	ASSERT_TRUE(shadow > 0 && far > 0, "atalhos: ambos disparam");
+	ASSERT_TRUE(steps_fast * 2 < steps_full, "atalhos: menos passos");
+	ASSERT_EPS(worst, 0.0, 1e-4, "atalhos: direção final de campo fraco");
+}
+
+/* ============================================================================
+ * TESTES: KERR-SCHILD
+ * ============================================================================
+ */
+
+static void test_kerr_schild_mode()
+{
+	struct bhs_geodesic_config bl = {
+		.dlambda = 0.5,
+		.max_steps = 40000,
+		.escape_radius = 100.0,
+		.disk_inner = 3.0,
+		.disk_outer = 20.0,
+		.tolerance = 1e-10,
+	};
+	struct bhs_geodesic_config ks = bl;
+	ks.mode = BHS_GEO_MODE_KERR_SCHILD;
+	double r_horizon = bhs_kerr_horizon_outer(&BH);
+
+	int steps_bl = 0, steps_ks = 0, captured = 0, hits = 0;
+	double worst_dir = 0.0, worst_r = 0.0;
+
+	for (int j = 0; j < 9; j++) {
+		for (int i = 0; i < 9; i++) {
+			struct bhs_geodesic a, b;
+			make_ray(&a, -0.4 + 0.1 * i, -0.4 + 0.1 * j);
+			b = a;
+
+			enum bhs_geodesic_status sa =
+				bhs_geodesic_propagate(&a, &BH, &bl);
+			enum bhs_geodesic_status sb =
+				bhs_geodesic_propagate(&b, &BH, &ks);
+			ASSERT_TRUE(sa == sb, "kerr-schild: mesmo veredito");
+			if (sa != sb)
+				continue;
+
+			if (sa == BHS_GEO_CAPTURED) {
+				ASSERT_TRUE(b.pos.x < r_horizon,
+					    "kerr-schild: cruza r+");
+				steps_bl += a.step_count;
+				steps_ks += b.step_count;
+				captured++;
+			} else if (sa == BHS_GEO_HIT_DISK) {
+				ASSERT_EPS(b.pos.y, M_PI_2, 1e-15,
+					   "kerr-schild: para no plano");
+				worst_r = fmax(worst_r, fabs(a.hit.r - b.hit.r));
+				ASSERT_EPS(cos(a.hit.phi - b.hit.phi), 1.0,
+					   1e-10, "kerr-schild: φ de impacto");
+				ASSERT_EPS(b.hit.p.t, a.hit.p.t, 1e-8,
+					   "kerr-schild: p_t no impacto");
+				hits++;
+			} else if (sa == BHS_GEO_ESCAPED) {
+				double c = bhs_vec3_dot(heading(&a),
+							heading(&b));
+				worst_dir = fmax(worst_dir,
+						 acos(fmin(c, 1.0)));
+			}
+		}
+	}
+
+	ASSERT_TRUE(captured > 0 && hits > 0,
+		    "kerr-schild: amostra tem sombra e disco");
+	ASSERT_EPS(worst_r, 0.0, 1e-5, "kerr-schild: r de impacto");
+	ASSERT_EPS(worst_dir, 0.0, 1e-5, "kerr-schild: direção de escape");
+
+	/* Perto do horizonte o passo não desaba */
+	ASSERT_TRUE(steps_ks * 2 < steps_bl,
+		    "kerr-schild: capturados com menos da metade dos passos");
+}
+
+/* ============================================================================
+ * TESTES: SCHWARZSCHILD PLANAR
+ * ============================================================================
+ */
+
+static void test_planar_matches_christoffel()
+{
+	const struct bhs_kerr schw = { .M = 1.0, .a = 0.0 };
+	struct bhs_geodesic_config ref = {
+		.dlambda = 0.5,
+		.max_steps = 40000,
+		.escape_radius = 100.0,
+		.disk_inner = 6.0,
+		.disk_outer = 20.0,
+		.tolerance = 1e-11,
+	};
+	struct bhs_geodesic_config pl = ref;
+	pl.mode = BHS_GEO_MODE_PLANAR;
+	pl.tolerance = 1e-8;
+
+	struct bhs_vec3 cam = bhs_vec3_make(0.0, -30.0, 4.0);
+	struct bhs_vec3 dir = bhs_vec3_make(0.0, 1.0, -4.0 / 30.0);
+	struct bhs_vec3 up = bhs_vec3_make(0.0, 0.0, 1.0);
+
+	/* Grade fora de x = 0: sobre o polo quem trava é o BL de referência */
+	int hits = 0, captured = 0, escaped = 0;
+	double worst_r = 0.0, worst_dir = 0.0;
+
+	for (int j = 0; j < 9; j++) {
+		for (int i = 0; i < 9; i++) {
+			struct bhs_geodesic a, b;
+			bhs_geodesic_ray_from_camera(&a, cam, dir, up,
+						     -0.45 + 0.1 * i,
+						     -0.4 + 0.1 * j, 0.8,
+						     &schw);
+			b = a;
+
+			enum bhs_geodesic_status sa =
+				bhs_geodesic_propagate(&a, &schw, &ref);
+			enum bhs_geodesic_status sb =
+				bhs_geodesic_propagate(&b, &schw, &pl);
+			ASSERT_TRUE(sa == sb, "planar: mesmo veredito");
+			if (sa != sb)
+				continue;
+
+			if (sa == BHS_GEO_HIT_DISK) {
+				worst_r = fmax(worst_r, fabs(a.hit.r - b.hit.r));
+				ASSERT_EPS(cos(a.hit.phi - b.hit.phi), 1.0,
+					   1e-10, "planar: φ de impacto");
+				ASSERT_EPS(b.hit.p.x, a.hit.p.x, 1e-6,
+					   "planar: p_r no impacto");
+				ASSERT_EPS(b.hit.p.y, a.hit.p.y, 1e-6,
+					   "planar: p_θ no impacto");
+				hits++;
+			} else if (sa == BHS_GEO_ESCAPED) {
+				ASSERT_EPS(b.pos.x, ref.escape_radius, 1e-9,
+					   "planar: termina no raio de escape");
+				double c = bhs_vec3_dot(heading(&a),
+							heading(&b));
+				worst_dir = fmax(worst_dir,
+						 acos(fmin(c, 1.0)));
+				escaped++;
+			} else if (sa == BHS_GEO_CAPTURED) {
+				captured++;
+			}
+		}
+	}
+
+	ASSERT_TRUE(hits > 0 && captured > 0 && escaped > 0,
+		    "planar: amostra tem disco, sombra e céu");
+	ASSERT_EPS(worst_r, 0.0, 1e-5, "planar: r de impacto");
+	ASSERT_EPS(worst_dir, 0.0, 1e-5, "planar: direção de escape");
+
+	/* Com spin cai no Christoffel, bit a bit */
+	struct bhs_geodesic a, b;
+	make_ray(&a, 0.1, -0.1);
+	b = a;
+	ref.tolerance = 1e-8;
+	pl.tolerance = 1e-8;
+	bhs_geodesic_propagate(&a, &BH, &ref);
+	bhs_geodesic_propagate(&b, &BH, &pl);
+	ASSERT_TRUE(memcmp(&a.pos, &b.pos, sizeof(a.pos)) == 0 &&
+			    a.step_count == b.step_count,
+		    "planar: spin usa o caminho genérico");
+}
+
+static void test_planar_lut()
+{
+	const struct bhs_kerr schw = { .M = 1.0, .a = 0.0 };
+	struct bhs_vec3 cam = bhs_vec3_make(0.0, -30.0, 4.0);
+	struct bhs_vec3 dir = bhs_vec3_make(0.0, 1.0, -4.0 / 30.0);
+	struct bhs_vec3 up = bhs_vec3_make(0.0, 0.0, 1.0);
+
+	struct bhs_geodesic probe;
+	bhs_geodesic_ray_from_camera(&probe, cam, dir, up, 0.0, 0.0, 0.8,
+				     &schw);
+
+	struct bhs_planar_lut_key key = {
+		.M = 1.0,
+		.r_obs = probe.pos.x,
+		.escape_radius = 100.0,
+	};
+	struct bhs_planar_lut built, lut;
+	ASSERT_TRUE(bhs_planar_lut_build(&built, &key) == 0, "lut: build");
+
+	/* Round trip pelo arquivo: daqui em diante só a versão mapeada */
+	const char *path = "./planar_lut_test.bin";
+	ASSERT_TRUE(bhs_planar_lut_save(&built, path) == 0, "lut: save");
+	bhs_planar_lut_free(&built);
+	ASSERT_TRUE(bhs_planar_lut_open(&lut, path, &key) == 0, "lut: open");
+
+	struct bhs_planar_lut wrong;
+	struct bhs_planar_lut_key other = key;
+	other.escape_radius = 200.0;
+	ASSERT_TRUE(bhs_planar_lut_open(&wrong, path, &other) != 0,
+		    "lut: open recusa outra chave");
+	remove(path);
+
+	struct bhs_geodesic_config ref = {
+		.dlambda = 0.5,
+		.max_steps = 40000,
+		.escape_radius = 100.0,
+		.disk_inner = 6.0,
+		.disk_outer = 20.0,
+		.mode = BHS_GEO_MODE_PLANAR,
+		.tolerance = 1e-10,
+	};
+	struct bhs_geodesic_config tab = ref;
+	tab.planar_lut = &lut;
+
+	int hits = 0, captured = 0, escaped = 0;
+	double worst_r = 0.0, worst_dir = 0.0;
+	bool no_steps = true;
+
+	for (int j = 0; j < 9; j++) {
+		for (int i = 0; i < 9; i++) {
+			struct bhs_geodesic a, b;
+			bhs_geodesic_ray_from_camera(&a, cam, dir, up,
+						     -0.45 + 0.1 * i,
+						     -0.4 + 0.1 * j, 0.8,
+						     &schw);
+			b = a;
+
+			enum bhs_geodesic_status sa =
+				bhs_geodesic_propagate(&a, &schw, &ref);
+			enum bhs_geodesic_status sb =
+				bhs_geodesic_propagate(&b, &schw, &tab);
+			ASSERT_TRUE(sa == sb, "lut: mesmo veredito");
+			no_steps = no_steps && b.step_count == 0;
+			if (sa != sb)
+				continue;
+
+			if (sa == BHS_GEO_HIT_DISK) {
+				worst_r = fmax(worst_r,
+					       fabs(a.hit.r - b.hit.r) / a.hit.r);
+				ASSERT_EPS(cos(a.hit.phi - b.hit.phi), 1.0,
+					   1e-8, "lut: φ de impacto");
+				hits++;
+			} else if (sa == BHS_GEO_ESCAPED) {
+				double c = bhs_vec3_dot(heading(&a),
+							heading(&b));
+				worst_dir = fmax(worst_dir,
+						 acos(fmin(c, 1.0)));
+				escaped++;
+			} else if (sa == BHS_GEO_CAPTURED) {
+				captured++;
+			}
+		}
+	}
+
+	ASSERT_TRUE(hits > 0 && captured > 0 && escaped > 0,
+		    "lut: amostra tem disco, sombra e céu");
+	ASSERT_TRUE(no_steps, "lut: nenhum passo de integração");
+	ASSERT_EPS(worst_r, 0.0, 2e-4, "lut: r de impacto (relativo)");
+	ASSERT_EPS(worst_dir, 0.0, 1e-4, "lut: direção de escape");
+
+	/* Outro raio inicial: a tabela não serve e o RK4 assume */
+	struct bhs_geodesic far;
+	bhs_geodesic_ray_from_camera(&far, bhs_vec3_scale(cam, 1.5), dir, up,
+				     0.1, 0.1, 0.8, &schw);
+	bhs_geodesic_propagate(&far, &schw, &tab);
+	ASSERT_TRUE(far.step_count > 0, "lut: r_obs diferente integra");
+
+	bhs_planar_lut_free(&lut);
+}
+
+/* ============================================================================
+ * TESTES: MÉTRICA TABELADA
+ * ============================================================================
+ */
+
+/* Kerr com uma tag de estrutura errada: o chamador tem que refazê-la */
+static void stale_tag_metric(struct bhs_vec4 coords, void *userdata,
+			     struct bhs_metric *out)
+{
+	bhs_kerr_metric_func(coords, userdata, out);
+	out->structure = BHS_METRIC_DIAGONAL;
+}
+
+static void test_metric_table()
+{
+	struct bhs_metric_table_key key = {
+		.r_min = 1.2,
+		.r_max = 51.2,
+		.theta_min = 0.0,
+		.theta_max = M_PI,
+		.r_horizon = bhs_kerr_horizon_outer(&BH),
+		.nr = 801,
+		.ntheta = 361,
+	};
+	struct bhs_metric_table built, table;
+	ASSERT_TRUE(bhs_metric_table_build(&built, &key, bhs_kerr_metric_func,
+					   (void *)&BH) == 0,
+		    "tabela: build");
+	ASSERT_TRUE(built.desc.zero == BHS_KERR_METRIC_DESC.zero,
+		    "tabela: componentes nulas de Kerr");
+
+	const char *path = "./metric_table_test.bin";
+	ASSERT_TRUE(bhs_metric_table_save(&built, path) == 0, "tabela: save");
+	ASSERT_TRUE(bhs_metric_table_open(&table, path) == 0, "tabela: open");
+	remove(path);
+	struct bhs_metric_table missing;
+	ASSERT_TRUE(bhs_metric_table_open(&missing, path) != 0,
+		    "tabela: open sem arquivo falha");
+
+	/* Spline interpolante: exata nos nós, O(h⁴) entre eles */
+	struct bhs_metric g, ex, g2;
+	bhs_metric_table_eval(&table, key.r_min + 40 * 0.0625, M_PI / 3.0, &g,
+			      NULL, NULL);
+	bhs_kerr_metric(&BH, key.r_min + 40 * 0.0625, M_PI / 3.0, &ex);
+	ASSERT_EPS(g.g[0][3], ex.g[0][3], 1e-14, "tabela: nó exato");
+
+	double worst_g = 0.0, worst_gamma = 0.0;
+	for (int n = 0; n < 50; n++) {
+		double r = 3.0 + 0.29 * n;
+		double th = 0.4 + 0.047 * n;
+		struct bhs_christoffel_sparse sp;
+		struct bhs_christoffel gt, gk;
+
+		bhs_metric_table_eval(&table, r, th, &g, NULL, NULL);
+		bhs_kerr_metric(&BH, r, th, &ex);
+		for (int mu = 0; mu < 4; mu++)
+			for (int nu = 0; nu < 4; nu++)
+				worst_g = fmax(worst_g, fabs(g.g[mu][nu] -
+							     ex.g[mu][nu]));
+
+		bhs_christoffel_compute_desc(&table.desc,
+					     bhs_vec4_make(0.0, r, th, 0.0),
+					     &table, 0.0, &sp);
+		bhs_christoffel_expand(&sp, &gt);
+		bhs_kerr_christoffel(&BH, r, th, &gk);
+		for (int a = 0; a < 4; a++)
+			for (int mu = 0; mu < 4; mu++)
+				for (int nu = 0; nu < 4; nu++)
+					worst_gamma = fmax(
+						worst_gamma,
+						fabs(gt.gamma[a][mu][nu] -
+						     gk.gamma[a][mu][nu]));
+	}
+	ASSERT_EPS(worst_g, 0.0, 1e-6, "tabela: g interpolada");
+	ASSERT_EPS(worst_gamma, 0.0, 2e-5, "tabela: Γ do interpolante");
+
+	/* Duas tabelas alternadas: o cache por thread não mistura */
+	bhs_metric_table_eval(&built, 7.3, 1.1, &g, NULL, NULL);
+	bhs_metric_table_eval(&table, 7.3, 1.1, &g2, NULL, NULL);
+	ASSERT_TRUE(memcmp(g.g, g2.g, sizeof(g.g)) == 0,
+		    "tabela: mapeada igual à da RAM");
+	bhs_metric_table_free(&built);
+
+	struct bhs_geodesic_config ref = {
+		.dlambda = 0.5,
+		.max_steps = 40000,
+		.escape_radius = 50.0,
+		.disk_inner = 3.0,
+		.disk_outer = 20.0,
+		.tolerance = 1e-9,
+	};
+	struct bhs_geodesic_config tab = ref;
+	bhs_metric_table_use(&table, &tab);
+
+	int hits = 0, captured = 0, escaped = 0, mismatch = 0;
+	int steps_ref = 0, steps_tab = 0;
+	double worst_r = 0.0, worst_dir = 0.0;
+
+	for (int j = 0; j < 7; j++) {
+		for (int i = 0; i < 7; i++) {
+			struct bhs_geodesic a, b;
+			make_ray(&a, -0.42 + 0.14 * i, -0.42 + 0.14 * j);
+			b = a;
+
+			enum bhs_geodesic_status sa =
+				bhs_geodesic_propagate(&a, &BH, &ref);
+			enum bhs_geodesic_status sb =
+				bhs_geodesic_propagate(&b, &BH, &tab);
+			if (sa != sb) {
+				mismatch++;
+				continue;
+			}
+
+			/* Rente ao horizonte g_rr ~ 1/Δ: a grade não basta */
+			if (sa != BHS_GEO_CAPTURED) {
+				steps_ref += a.step_count;
+				steps_tab += b.step_count;
+			}
+
+			if (sa == BHS_GEO_HIT_DISK) {
+				worst_r = fmax(worst_r, fabs(a.hit.r - b.hit.r));
+				ASSERT_EPS(b.hit.p.t, a.hit.p.t, 1e-6,
+					   "tabela: p_t no impacto");
+				hits++;
+			} else if (sa == BHS_GEO_ESCAPED) {
+				double c = bhs_vec3_dot(heading(&a),
+							heading(&b));
+				worst_dir = fmax(worst_dir,
+						 acos(fmin(c, 1.0)));
+				escaped++;
+			} else if (sa == BHS_GEO_CAPTURED) {
+				captured++;
+			}
+		}
+	}
+
+	ASSERT_TRUE(hits > 0 && captured > 0 && escaped > 0,
+		    "tabela: amostra tem disco, sombra e céu");
+	ASSERT_TRUE(mismatch <= 1, "tabela: mesmo veredito");
+	ASSERT_EPS(worst_r, 0.0, 1e-4, "tabela: r de impacto");
+	ASSERT_EPS(worst_dir, 0.0, 5e-4, "tabela: direção de escape");
+
+	/* g em C²: o DOPRI5 não sente as bordas das células */
+	ASSERT_TRUE(steps_tab * 10 <= steps_ref * 11,
+		    "tabela: passos como em Kerr");
+
+	/* Modo métrica sem descritor: recusa sem dar passo */
+	struct bhs_geodesic none;
+	make_ray(&none, 0.0, 0.0);
+	tab.metric = NULL;
+	ASSERT_TRUE(bhs_geodesic_propagate(&none, &BH, &tab) ==
+				    BHS_GEO_TIMEOUT &&
+			    none.status == BHS_GEO_TIMEOUT &&
+			    none.step_count == 0,
+		    "tabela: modo métrica sem descritor");
+
+	/* p_μ no impacto sai da estrutura de desc->zero, não do que fn deixou */
+	struct bhs_metric_desc stale = BHS_KERR_METRIC_DESC;
+	stale.fn = stale_tag_metric;
+	tab.metric = &stale;
+	tab.metric_userdata = (void *)&BH;
+	bool checked = false;
+	for (int i = 0; i < 7 && !checked; i++) {
+		struct bhs_geodesic a, b;
+		make_ray(&a, -0.42 + 0.14 * i, -0.28);
+		b = a;
+		if (bhs_geodesic_propagate(&a, &BH, &ref) != BHS_GEO_HIT_DISK ||
+		    bhs_geodesic_propagate(&b, &BH, &tab) != BHS_GEO_HIT_DISK)
+			continue;
+		ASSERT_EPS(b.hit.p.t, a.hit.p.t, 1e-6,
+			   "tabela: p_t com tag de estrutura errada");
+		checked = true;
+	}
+	ASSERT_TRUE(checked, "tabela: raio no disco com tag errada");
+
+	bhs_metric_table_free(&table);
+}
+
+/*
+ * Ordem da imagem de um impacto: quantos cruzamentos do equador vieram
+ * antes, pela própria solução fechada
+ */
+static int elliptic_image_order(const struct bhs_geodesic *start,
+				const struct bhs_geodesic *hit)
+{
+	struct bhs_geodesic_constants k;
+	struct bhs_kerr_elliptic ray;
+
+	bhs_geodesic_constants(start, &BH, &k);
+	bhs_kerr_elliptic_init(&ray, &BH, start->pos.x, start->pos.y,
+			       start->pos.z, k.L / k.E, k.Q / (k.E * k.E),
+			       start->vel.x < 0.0 ? -1 : 1,
+			       start->vel.y < 0.0 ? -1 : 1);
+
+	int n = 0;
+	while (fabs(bhs_kerr_elliptic_r(&ray, bhs_kerr_elliptic_equator(&ray, n),
+					NULL) -
+		    hit->hit.r) > 1e-9 &&
+	       n < 8)
+		n++;
+	return n;
+}
+
+static void test_elliptic_matches_christoffel()
+{
+	struct bhs_geodesic_config ref = {
+		.dlambda = 0.5,
+		.max_steps = 40000,
+		.escape_radius = 100.0,
+		.disk_inner = 3.0,
+		.disk_outer = 15.0,
+		.tolerance = 1e-11,
+	};
+	struct bhs_geodesic_config el = ref;
+	el.mode = BHS_GEO_MODE_ELLIPTIC;
+
+	/*
+	 * Grade fora de x = 0: sobre o polo quem trava é o BL de referência.
+	 * A linha de cima passa por cima do buraco além de disk_outer e bate
+	 * na volta: imagem secundária.
+	 */
+	int hits = 0, higher = 0, captured = 0, escaped = 0, fallback = 0;
+	double worst_r = 0.0, worst_dir = 0.0;
+
+	for (int j = 0; j < 9; j++) {
+		for (int i = 0; i < 9; i++) {
+			struct bhs_geodesic a, b, start;
+			make_ray(&start, -0.45 + 0.1 * i, -0.4 + 0.1 * j);
+			a = b = start;
+
+			enum bhs_geodesic_status sa =
+				bhs_geodesic_propagate(&a, &BH, &ref);
+			enum bhs_geodesic_status sb =
+				bhs_geodesic_propagate(&b, &BH, &el);
+			ASSERT_TRUE(sa == sb, "elíptico: mesmo veredito");
+			if (sa != sb)
+				continue;
+			fallback += b.step_count > 0;
+
+			if (sa == BHS_GEO_HIT_DISK) {
+				worst_r = fmax(worst_r, fabs(a.hit.r - b.hit.r));
+				ASSERT_EPS(cos(a.hit.phi - b.hit.phi), 1.0,
+					   1e-10, "elíptico: φ de impacto");
+				ASSERT_EPS(b.hit.p.x, a.hit.p.x, 1e-6,
+					   "elíptico: p_r no impacto");
+				ASSERT_EPS(b.hit.p.y, a.hit.p.y, 1e-6,
+					   "elíptico: p_θ no impacto");
+				ASSERT_EPS(b.hit.p.z, a.hit.p.z, 1e-6,
+					   "elíptico: p_φ no impacto");
+				higher += elliptic_image_order(&start, &b) > 0;
+				hits++;
+			} else if (sa == BHS_GEO_ESCAPED) {
+				ASSERT_EPS(b.pos.x, ref.escape_radius, 1e-9,
+					   "elíptico: termina no raio de escape");
+				double c = bhs_vec3_dot(heading(&a),
+							heading(&b));
+				worst_dir = fmax(worst_dir,
+						 acos(fmin(c, 1.0)));
+				escaped++;
+			} else if (sa == BHS_GEO_CAPTURED) {
+				captured++;
+			}
+		}
+	}
+
+	ASSERT_TRUE(hits > 0 && captured > 0 && escaped > 0,
+		    "elíptico: amostra tem disco, sombra e céu");
+	ASSERT_TRUE(higher > 0, "elíptico: amostra tem imagem secundária");
+	/* Só os dois quase radiais do centro (η < 0) integram */
+	ASSERT_TRUE(fallback <= 2, "elíptico: sem passos fora de η < 0");
+	ASSERT_EPS(worst_r, 0.0, 1e-6, "elíptico: r de impacto");
+	ASSERT_EPS(worst_dir, 0.0, 1e-5, "elíptico: direção de escape");
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================
+ */
+
+int main()
+{
+	printf("=== [BHS GEODESIC TEST SUITE] ===\n");
+
+	test_init_photon_null();
+	test_carter_matches_christoffel();
+	test_carter_invariants();
+	test_dopri5_propagate();
+	test_dopri5_dense_output();
+	test_thin_disk_crossing();
+	test_batch_matches_scalar();
+	test_batch_mixed_precision();
+	test_shortcuts();
+	test_kerr_schild_mode();
+	test_planar_matches_christoffel();
+	test_planar_lut();
+	test_metric_table();
+	test_elliptic_matches_christoffel();
+
+	printf("\nResultados:\n");
+	printf("  Rodados: %d\n", tests_run);
+	printf("  Falhas:  %d\n", tests_failed);
+
+	return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,976 @@
+/**
+ * @file test_tracer.c
+ * @brief Testes do tracer de referência na CPU
+ *
+ * "Threads não podem mudar a física. Só o tempo de espera."
+ */
+
+#define _GNU_SOURCE /* Para M_PI */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "engine/components/disk/spectrum.h"
+#include "engine/render/tracer.h"
+#include "engine/render/transfer.h"
+
+#define TEST_FAIL "[\033[31m FAIL \033[0m]"
+
+static int tests_run = 0;
+static int tests_failed = 0;
+
+#define ASSERT_TRUE(cond, msg)                                                 \
+	do {                                                                   \
+		tests_run++;                                                   \
+		if (!(cond)) {                                                 \
+			fprintf(stderr, "%s %s\n", TEST_FAIL, msg);            \
+			tests_failed++;                                        \
+		}                                                              \
+	} while (0)
+
+static struct bhs_tracer_config make_config(int threads)
+{
+	struct bhs_tracer_config cfg = {
+		.width = 48,
+		.height = 27,
+		.tile_size = 8,
+		.threads = threads,
+		.bh = { .M = 1.0, .a = 0.9 },
+		.disk = { .outer_radius = 20.0, .mdot = 1.0 },
+		.camera = {
+			.distance = 30.0,
+			.inclination = 80.0 * M_PI / 180.0,
+			.fov = 50.0 * M_PI / 180.0,
+		},
+		.geo = {
+			.dlambda = 0.1,
+			.max_steps = 4000,
+			.escape_radius = 60.0,
+		},
+	};
+	cfg.disk.inner_radius = bhs_disk_isco(&cfg.bh);
+	return cfg;
+}
+
+/* ============================================================================
+ * TESTES
+ * ============================================================================
+ */
+
+static void test_threads_bit_identical()
+{
+	struct bhs_tracer_config c1 = make_config(1);
+	struct bhs_tracer_config c4 = make_config(4);
+	struct bhs_tracer_image a, b;
+
+	ASSERT_TRUE(bhs_tracer_render(&c1, &a) == 0, "tracer: render 1 thread");
+	ASSERT_TRUE(bhs_tracer_render(&c4, &b) == 0, "tracer: render 4 threads");
+
+	size_t n = (size_t)a.width * a.height * 3 * sizeof(float);
+	ASSERT_TRUE(memcmp(a.rgb, b.rgb, n) == 0,
+		    "tracer: resultado independe do nº de threads");
+
+	/* Centro da imagem olha direto para o buraco: sombra */
+	const float *c = a.rgb + ((size_t)(a.height / 2) * a.width +
+				  a.width / 2) * 3;
+	ASSERT_TRUE(c[0] == 0.0f && c[1] == 0.0f && c[2] == 0.0f,
+		    "tracer: sombra no centro");
+
+	/* Algum pixel tem que ter batido no disco */
+	float peak = 0.0f;
+	for (size_t i = 0; i < (size_t)a.width * a.height * 3; i++)
+		peak = fmaxf(peak, a.rgb[i]);
+	ASSERT_TRUE(peak > 0.05f, "tracer: disco visível");
+
+	bhs_tracer_image_free(&a);
+	bhs_tracer_image_free(&b);
+}
+
+static void test_adaptive_refinement()
+{
+	struct bhs_tracer_config full = make_config(2);
+	struct bhs_tracer_config coarse = make_config(2);
+	full.width = coarse.width = 96;
+	full.height = coarse.height = 54;
+	full.tile_size = coarse.tile_size = 32;
+	coarse.refine_cell = 8;
+	struct bhs_tracer_image a, b;
+
+	ASSERT_TRUE(bhs_tracer_render(&full, &a) == 0, "refine: render exato");
+	ASSERT_TRUE(bhs_tracer_render(&coarse, &b) == 0,
+		    "refine: render adaptativo");
+	ASSERT_TRUE(a.stats.rays == (long)a.width * a.height,
+		    "refine: exato traça um raio por pixel");
+	ASSERT_TRUE(b.stats.rays * 2 < a.stats.rays,
+		    "refine: adaptativo traça menos raios");
+
+	/* Diferença média pequena; estrelas perdidas são os únicos picos */
+	size_t n = (size_t)a.width * a.height * 3;
+	double err = 0.0;
+	for (size_t i = 0; i < n; i++)
+		err += fabs((double)a.rgb[i] - (double)b.rgb[i]);
+	ASSERT_TRUE(err / (double)n < 0.01, "refine: imagem próxima da exata");
+
+	/* A sombra tem que continuar lá */
+	const float *c = b.rgb + ((size_t)(b.height / 2) * b.width +
+				  b.width / 2) * 3;
+	ASSERT_TRUE(c[0] == 0.0f && c[1] == 0.0f && c[2] == 0.0f,
+		    "refine: sombra no centro");
+
+	bhs_tracer_image_free(&a);
+	bhs_tracer_image_free(&b);
+}
+
+static void test_deflection_cache()
+{
+	struct bhs_tracer_config cfg = make_config(2);
+	struct bhs_tracer_image direct, first, cached;
+	struct bhs_deflection_key key;
+	char path[256];
+
+	bhs_tracer_deflection_key(&cfg, &key);
+	ASSERT_TRUE(bhs_deflection_cache_path(&key, ".", path,
+					      sizeof(path)) == 0,
+		    "deflexão: caminho do cache");
+	remove(path);
+
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &direct) == 0,
+		    "deflexão: render direto");
+	ASSERT_TRUE(bhs_tracer_render_cached(&cfg, ".", &first) == 0,
+		    "deflexão: primeiro render monta o mapa");
+	ASSERT_TRUE(first.stats.rays == (long)cfg.width * cfg.height,
+		    "deflexão: sem cache traça tudo");
+
+	/* Outro modelo de disco: mesmo mapa, só shading */
+	cfg.disk.mdot = 3.0;
+	struct bhs_tracer_image other;
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &other) == 0,
+		    "deflexão: render direto com outro mdot");
+	ASSERT_TRUE(bhs_tracer_render_cached(&cfg, ".", &cached) == 0,
+		    "deflexão: render do cache");
+	ASSERT_TRUE(cached.stats.rays == 0, "deflexão: cache não traça nada");
+
+	size_t n = (size_t)direct.width * direct.height * 3 * sizeof(float);
+	ASSERT_TRUE(memcmp(direct.rgb, first.rgb, n) == 0,
+		    "deflexão: mapa novo igual ao render direto");
+	ASSERT_TRUE(memcmp(other.rgb, cached.rgb, n) == 0,
+		    "deflexão: mapa do disco igual ao render direto");
+
+	/* Outra câmera não pode aceitar o arquivo */
+	struct bhs_deflection_map map;
+	struct bhs_deflection_key wrong = key;
+	wrong.inclination += 0.1;
+	ASSERT_TRUE(bhs_deflection_map_open(&map, path, &key) == 0,
+		    "deflexão: abre com a chave certa");
+	bhs_deflection_map_free(&map);
+	ASSERT_TRUE(bhs_deflection_map_open(&map, path, &wrong) != 0,
+		    "deflexão: recusa chave diferente");
+
+	/* Integração entra na chave; a métrica tabelada nem cabe nela */
+	struct bhs_tracer_config far = cfg;
+	far.geo.escape_radius += 50.0;
+	bhs_tracer_deflection_key(&far, &wrong);
+	ASSERT_TRUE(!bhs_deflection_key_equal(&key, &wrong),
+		    "deflexão: raio de escape muda a chave");
+	far = cfg;
+	far.geo.disk_half_thickness = 0.1;
+	bhs_tracer_deflection_key(&far, &wrong);
+	ASSERT_TRUE(!bhs_deflection_key_equal(&key, &wrong),
+		    "deflexão: espessura do disco muda a chave");
+	far = cfg;
+	far.geo.mode = BHS_GEO_MODE_METRIC;
+	struct bhs_tracer_image refused;
+	ASSERT_TRUE(bhs_tracer_render_cached(&far, ".", &refused) != 0,
+		    "deflexão: cache recusa métrica tabelada");
+
+	/* Cabeçalho corrompido com resolução absurda não passa */
+	struct bhs_deflection_header hdr;
+	FILE *f = fopen(path, "rb");
+	ASSERT_TRUE(f && fread(&hdr, sizeof(hdr), 1, f) == 1,
+		    "deflexão: lê o cabeçalho");
+	if (f)
+		fclose(f);
+	hdr.key.width = INT32_MAX;
+	hdr.key.height = INT32_MAX;
+	f = fopen("deflection-corrupt.bin", "wb");
+	ASSERT_TRUE(f && fwrite(&hdr, sizeof(hdr), 1, f) == 1,
+		    "deflexão: grava cabeçalho corrompido");
+	if (f)
+		fclose(f);
+	ASSERT_TRUE(bhs_deflection_map_open(&map, "deflection-corrupt.bin",
+					    NULL) != 0,
+		    "deflexão: recusa resolução fora do limite");
+	remove("deflection-corrupt.bin");
+
+	bhs_tracer_image_free(&direct);
+	bhs_tracer_image_free(&first);
+	bhs_tracer_image_free(&other);
+	bhs_tracer_image_free(&cached);
+	remove(path);
+}
+
+static void test_shortcut_stats()
+{
+	struct bhs_tracer_config full = make_config(2);
+	struct bhs_tracer_config fast = make_config(2);
+	fast.geo.shadow_capture = true;
+	fast.geo.far_field_radius = fast.camera.distance;
+	struct bhs_tracer_image a, b;
+
+	ASSERT_TRUE(bhs_tracer_render(&full, &a) == 0, "atalhos: render exato");
+	ASSERT_TRUE(bhs_tracer_render(&fast, &b) == 0,
+		    "atalhos: render com atalhos");
+	ASSERT_TRUE(a.stats.shadow_exits == 0 && a.stats.far_field_exits == 0,
+		    "atalhos: desligados não contam");
+	ASSERT_TRUE(b.stats.shadow_exits > 0 && b.stats.far_field_exits > 0,
+		    "atalhos: ligados são usados");
+	ASSERT_TRUE(b.stats.steps < a.stats.steps, "atalhos: menos passos");
+
+	/* Sombra e disco iguais; só o fundo se move um pouco */
+	const float *c = b.rgb + ((size_t)(b.height / 2) * b.width +
+				  b.width / 2) * 3;
+	ASSERT_TRUE(c[0] == 0.0f && c[1] == 0.0f && c[2] == 0.0f,
+		    "atalhos: sombra no centro");
+	size_t n = (size_t)a.width * a.height * 3;
+	double err = 0.0;
+	for (size_t i = 0; i < n; i++)
+		err += fabs((double)a.rgb[i] - (double)b.rgb[i]);
+	ASSERT_TRUE(err / (double)n < 0.01, "atalhos: imagem próxima da exata");
+
+	bhs_tracer_image_free(&a);
+	bhs_tracer_image_free(&b);
+}
+
+/* Uniforme em [0, 1): LCG de 64 bits, reprodutível em qualquer libc */
+static double lcg_unit(unsigned long long *seed)
+{
+	*seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (double)(*seed >> 11) / 9007199254740992.0;
+}
+
+static void test_disk_shade_batch()
+{
+	enum { N = 1001 }; /* não múltiplo de BHS_DISK_SHADE_LANES */
+	static double r[N], phi[N], g[N];
+	static struct bhs_color_rgb batch[N], via_g[N];
+	const double spins[] = { 0.0, 0.9, 0.998, -0.5 };
+	struct bhs_disk disk = { .outer_radius = 20.0, .mdot = 1.0 };
+	double incl = 80.0 * M_PI / 180.0;
+	unsigned long long seed = 7;
+	double err = 0.0, err_g = 0.0;
+	int lit = 0;
+
+	for (int s = 0; s < 4; s++) {
+		struct bhs_kerr bh = { .M = 1.0, .a = spins[s] };
+		double isco = bhs_disk_isco(&bh);
+		struct bhs_disk_shade ds;
+
+		/* Raios cobrindo as duas bordas do anel, φ qualquer */
+		for (int i = 0; i < N; i++) {
+			double u = lcg_unit(&seed);
+			double v = lcg_unit(&seed);
+
+			r[i] = isco * 0.9 + u * (disk.outer_radius * 1.1 -
+						 isco * 0.9);
+			phi[i] = 2.0 * M_PI * v;
+			g[i] = bhs_disk_doppler_factor(&bh, r[i], phi[i], incl);
+		}
+
+		bhs_disk_shade_init(&ds, &bh, &disk, incl);
+		bhs_disk_shade_batch(&ds, r, phi, NULL, N, batch);
+		bhs_disk_shade_batch(&ds, r, phi, g, N, via_g);
+
+		for (int i = 0; i < N; i++) {
+			struct bhs_color_rgb ref =
+				bhs_disk_color(&bh, &disk, r[i], phi[i], incl);
+			lit += ref.r > 0.0f;
+			err = fmax(err, fabs(batch[i].r - ref.r));
+			err = fmax(err, fabs(batch[i].g - ref.g));
+			err = fmax(err, fabs(batch[i].b - ref.b));
+			err_g = fmax(err_g, fabs(via_g[i].r - ref.r));
+			err_g = fmax(err_g, fabs(via_g[i].g - ref.g));
+			err_g = fmax(err_g, fabs(via_g[i].b - ref.b));
+		}
+	}
+
+	ASSERT_TRUE(lit > 3000, "shade: amostras no disco");
+	ASSERT_TRUE(err < 1e-4, "shade: lote igual a bhs_disk_color");
+	ASSERT_TRUE(err_g < 1e-4, "shade: fator g dado igual ao modelo");
+
+	/* Disco vazio: tudo preto */
+	struct bhs_kerr bh = { .M = 1.0, .a = 0.5 };
+	struct bhs_disk none = { 0 };
+	struct bhs_disk_shade ds;
+	bhs_disk_shade_init(&ds, &bh, &none, incl);
+	bhs_disk_shade_batch(&ds, r, phi, NULL, N, batch);
+	float peak = 0.0f;
+	for (int i = 0; i < N; i++)
+		peak = fmaxf(peak, batch[i].r + batch[i].g + batch[i].b);
+	ASSERT_TRUE(peak == 0.0f, "shade: disco desligado é preto");
+}
+
+static void test_disk_g_factor()
+{
+	struct bhs_tracer_config cfg = make_config(1);
+	struct bhs_kerr schw = { .M = 1.0, .a = 0.0 };
+
+	/* Face-on em Schwarzschild: ξ = 0 e g = 1/u^t = √(1 - 3M/r) */
+	ASSERT_TRUE(fabs(bhs_disk_g_factor(&schw, 10.0, 0.0) - sqrt(0.7)) <
+			    1e-12,
+		    "g: Schwarzschild face-on");
+	ASSERT_TRUE(bhs_disk_g_factor(&schw, 2.5, 0.0) == 0.0,
+		    "g: sem órbita circular dentro de 3M");
+
+	/* Mesmo g pelo p_μ do impacto: -p_t / (-p_μ u^μ) */
+	struct bhs_geodesic geo;
+	struct bhs_geodesic_config gc = cfg.geo;
+	gc.disk_inner = cfg.disk.inner_radius;
+	gc.disk_outer = cfg.disk.outer_radius;
+	bhs_tracer_pixel_ray(&cfg, cfg.width * 0.25, cfg.height * 0.5, &geo);
+
+	struct bhs_geodesic_constants c;
+	bhs_geodesic_constants(&geo, &cfg.bh, &c);
+	ASSERT_TRUE(bhs_geodesic_propagate(&geo, &cfg.bh, &gc) ==
+			    BHS_GEO_HIT_DISK,
+		    "g: raio de teste bate no disco");
+
+	double r = geo.hit.r, M = cfg.bh.M, a = cfg.bh.a;
+	double r32 = r * sqrt(r);
+	double omega = sqrt(M) / (r32 + a * sqrt(M));
+	double ut = (r32 + a * sqrt(M)) /
+		    sqrt(r32 * (r32 - 3.0 * M * sqrt(r) + 2.0 * a * sqrt(M)));
+	double g_hit = -geo.hit.p.t /
+		       (-(geo.hit.p.t * ut + geo.hit.p.z * ut * omega));
+	double g = bhs_disk_g_factor(&cfg.bh, r, c.L / c.E);
+	ASSERT_TRUE(fabs(g - g_hit) < 1e-4 * g, "g: igual ao do momento");
+}
+
+static double line_power3(double r, void *user)
+{
+	(void)user;
+	return 1.0 / (r * r * r);
+}
+
+static double flat_intensity(double r, double nu, void *user)
+{
+	(void)r;
+	(void)nu;
+	(void)user;
+	return 1.0;
+}
+
+static void test_transfer()
+{
+	struct bhs_transfer_config cfg = {
+		.bh = { .M = 1.0, .a = 0.9 },
+		.inclination = 60.0 * M_PI / 180.0,
+		.r_out = 20.0,
+		.distance = 200.0,
+		.resolution = 48,
+		.radii = 16,
+		.gbins = 32,
+		.threads = 2,
+		.geo = {
+			.dlambda = 0.5,
+			.max_steps = 4000,
+			.escape_radius = 400.0,
+			.tolerance = 1e-8,
+			.shadow_capture = true,
+		},
+	};
+	struct bhs_transfer_table tilt, face;
+
+	ASSERT_TRUE(bhs_transfer_build(&cfg, &tilt) == 0,
+		    "transfer: monta inclinado");
+	cfg.bh.a = 0.0;
+	cfg.inclination = 0.0;
+	ASSERT_TRUE(bhs_transfer_build(&cfg, &face) == 0,
+		    "transfer: monta face-on");
+
+	/* Área total perto da projeção geométrica (a lente só aumenta) */
+	const struct bhs_transfer_key *key = &tilt.key;
+	size_t cells = (size_t)key->radii * key->gbins;
+	double area = 0.0;
+	for (size_t i = 0; i < cells; i++)
+		area += tilt.weights[i];
+	double proj = M_PI * (key->r_out * key->r_out - key->r_in * key->r_in) *
+		      cos(key->inclination);
+	ASSERT_TRUE(area > 0.9 * proj && area < 1.5 * proj,
+		    "transfer: área do disco na imagem");
+	ASSERT_TRUE(key->g_lo < 1.0 && key->g_hi > 1.0,
+		    "transfer: lado que se aproxima sai azul");
+
+	/* Face-on em Schwarzschild: g médio do anel é √(1 - 3M/r) */
+	double worst = 0.0;
+	for (int k = 0; k < face.key.radii; k++) {
+		double w = 0.0, wg = 0.0;
+		for (int j = 0; j < face.key.gbins; j++) {
+			double wj = face.weights[k * face.key.gbins + j];
+			w += wj;
+			wg += wj * bhs_transfer_g(&face, j);
+		}
+		double r = bhs_transfer_radius(&face, k);
+		if (w > 0.0)
+			worst = fmax(worst, fabs(wg / w - sqrt(1.0 - 3.0 / r)));
+	}
+	ASSERT_TRUE(worst < 0.02, "transfer: g do anel face-on");
+
+	/* Linha ε ∝ r⁻³: chifre azul mais alto que o vermelho */
+	double line[32], blue = 0.0, red = 0.0, sum = 0.0;
+	bhs_transfer_line(&tilt, line_power3, NULL, line);
+	for (int j = 0; j < key->gbins; j++) {
+		double g = bhs_transfer_g(&tilt, j);
+		if (g > 1.0)
+			blue = fmax(blue, line[j]);
+		else
+			red = fmax(red, line[j]);
+		sum += line[j];
+	}
+	ASSERT_TRUE(blue > red, "transfer: perfil de linha assimétrico");
+
+	/* I_ν constante: F_ν = Σ W g³ em qualquer ν */
+	double nu[3] = { 0.5, 1.0, 2.0 }, spec[3], expect = 0.0;
+	bhs_transfer_spectrum(&tilt, flat_intensity, NULL, nu, 3, spec);
+	for (size_t i = 0; i < cells; i++) {
+		double g = bhs_transfer_g(&tilt, (int)(i % key->gbins));
+		expect += tilt.weights[i] * g * g * g;
+	}
+	ASSERT_TRUE(fabs(spec[0] - expect) < 1e-9 * expect &&
+			    spec[0] == spec[1] && spec[1] == spec[2],
+		    "transfer: espectro plano");
+
+	/* Arquivo com as duas: mesmo resultado pelo mmap */
+	const char *path = "transfer-test.bin";
+	struct bhs_transfer_table both[2] = { face, tilt };
+	struct bhs_transfer_file file;
+	struct bhs_transfer_table mapped;
+	ASSERT_TRUE(bhs_transfer_save(path, both, 2) == 0,
+		    "transfer: grava arquivo");
+	ASSERT_TRUE(bhs_transfer_file_open(&file, path) == 0,
+		    "transfer: abre arquivo");
+	int i = bhs_transfer_file_find(&file, 0.85, 1.0);
+	ASSERT_TRUE(i == 1, "transfer: acha a mais próxima");
+	ASSERT_TRUE(bhs_transfer_file_get(&file, i, &mapped) == 0 &&
+			    memcmp(mapped.weights, tilt.weights,
+				   cells * sizeof(float)) == 0 &&
+			    mapped.key.g_hi == tilt.key.g_hi,
+		    "transfer: pesos iguais no arquivo");
+
+	double again[32], diff = 0.0;
+	bhs_transfer_line(&mapped, line_power3, NULL, again);
+	for (int j = 0; j < key->gbins; j++)
+		diff += fabs(again[j] - line[j]);
+	ASSERT_TRUE(diff == 0.0 && sum > 0.0, "transfer: linha pelo mmap");
+	ASSERT_TRUE(bhs_transfer_file_get(&file, 2, &mapped) != 0,
+		    "transfer: índice fora do arquivo");
+
+	bhs_transfer_file_close(&file);
+	bhs_transfer_table_free(&tilt);
+	bhs_transfer_table_free(&face);
+	remove(path);
+}
+
+static void test_spectrum()
+{
+	const double temps[] = { 1500.0, 6504.0, 1e5 };
+	double spec[BHS_SPECTRUM_BINS], xyz[3], worst = 0.0;
+
+	/* Recorrência das exponenciais contra Planck direto */
+	for (int t = 0; t < 3; t++) {
+		bhs_spectrum_blackbody(temps[t], spec);
+		for (int i = 0; i < BHS_SPECTRUM_BINS; i++) {
+			double l = bhs_spectrum_lambda(i) * 1e-3;
+			double ref = 1.0 / (pow(l, 5.0) *
+					    expm1(BHS_SPECTRUM_C2 /
+						  (l * temps[t])));
+			worst = fmax(worst, fabs(spec[i] - ref) / ref);
+		}
+	}
+	ASSERT_TRUE(worst < 1e-12, "espectro: corpo negro exato");
+	ASSERT_TRUE(bhs_spectrum_lambda(0) > bhs_spectrum_lambda(1),
+		    "espectro: faixa 0 é a mais vermelha");
+
+	/* ~6500 K é quase o branco D65; frio é vermelho, quente é azul */
+	bhs_spectrum_blackbody(6504.0, spec);
+	bhs_spectrum_to_xyz(spec, xyz);
+	struct bhs_color_rgb w = bhs_spectrum_xyz_to_rgb(xyz);
+	ASSERT_TRUE(fabsf(w.r / w.g - 1.0f) < 0.1f &&
+			    fabsf(w.b / w.g - 1.0f) < 0.1f,
+		    "espectro: 6500 K é branco");
+
+	bhs_spectrum_blackbody(2000.0, spec);
+	bhs_spectrum_to_xyz(spec, xyz);
+	struct bhs_color_rgb cold = bhs_spectrum_xyz_to_rgb(xyz);
+	bhs_spectrum_blackbody(30000.0, spec);
+	bhs_spectrum_to_xyz(spec, xyz);
+	struct bhs_color_rgb hot = bhs_spectrum_xyz_to_rgb(xyz);
+	ASSERT_TRUE(cold.r > cold.g && cold.g > cold.b, "espectro: frio");
+	ASSERT_TRUE(hot.b > hot.r, "espectro: quente");
+
+	/* No disco: g maior é mais brilhante e mais azul */
+	struct bhs_kerr bh = { .M = 1.0, .a = 0.9 };
+	struct bhs_disk disk = { .outer_radius = 20.0 };
+	struct bhs_disk_shade ds;
+	bhs_disk_shade_init(&ds, &bh, &disk, 1.0);
+	bhs_disk_shade_spectral_init(&ds, 6000.0);
+
+	double r[3] = { 6.0, 6.0, 30.0 }, g[3] = { 0.8, 1.2, 1.0 };
+	struct bhs_color_rgb c[3];
+	bhs_disk_shade_spectral(&ds, r, NULL, g, 3, c);
+	ASSERT_TRUE(c[1].g > 2.0f * c[0].g, "espectro: beaming");
+	ASSERT_TRUE(c[1].b / c[1].r > c[0].b / c[0].r,
+		    "espectro: blueshift azula");
+	ASSERT_TRUE(c[2].r == 0.0f && c[2].g == 0.0f && c[2].b == 0.0f,
+		    "espectro: fora do disco é preto");
+}
+
+static void test_spectral_render()
+{
+	struct bhs_tracer_config cfg = make_config(2);
+	struct bhs_tracer_image tint, spec, shaded;
+	struct bhs_deflection_map map;
+
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &tint) == 0,
+		    "espectral: render tingido");
+	cfg.spectral = true;
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &spec) == 0,
+		    "espectral: render espectral");
+	ASSERT_TRUE(bhs_tracer_build_deflection(&cfg, &map) == 0 &&
+			    bhs_tracer_shade(&cfg, &map, &shaded) == 0,
+		    "espectral: shading do mapa");
+
+	size_t n = (size_t)spec.width * spec.height * 3;
+	ASSERT_TRUE(memcmp(spec.rgb, shaded.rgb, n * sizeof(float)) == 0,
+		    "espectral: mapa igual ao render direto");
+	ASSERT_TRUE(memcmp(spec.rgb, tint.rgb, n * sizeof(float)) != 0,
+		    "espectral: cor diferente do tingimento");
+
+	/* Sombra preta; lado que se aproxima passa de Y = 1 */
+	const float *c = spec.rgb + ((size_t)(spec.height / 2) * spec.width +
+				     spec.width / 2) * 3;
+	float peak = 0.0f;
+	for (size_t i = 0; i < n; i++)
+		peak = fmaxf(peak, spec.rgb[i]);
+	ASSERT_TRUE(c[0] == 0.0f && c[1] == 0.0f && c[2] == 0.0f,
+		    "espectral: sombra no centro");
+	ASSERT_TRUE(peak > 1.0f, "espectral: beaming acima do anel quente");
+
+	bhs_deflection_map_free(&map);
+	bhs_tracer_image_free(&tint);
+	bhs_tracer_image_free(&spec);
+	bhs_tracer_image_free(&shaded);
+}
+
+/* Relógio falso: cada leitura avança um "segundo" */
+static double tick_clock(void *user)
+{
+	double *t = user;
+	return (*t)++;
+}
+
+static void test_progressive()
+{
+	struct bhs_tracer_config cfg = make_config(1);
+	struct bhs_tracer_image ref;
+	struct bhs_tracer_progress p;
+	double t = 0.0;
+
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &ref) == 0,
+		    "progressivo: render de referência");
+	size_t bytes = (size_t)ref.width * ref.height * 3 * sizeof(float);
+
+	bhs_tracer_progress_init(&p);
+	p.stride = 8;
+	p.clock = tick_clock;
+	p.clock_user = &t;
+
+	/* Prazo vence antes do nível 1: só a grade grossa, inteira */
+	ASSERT_TRUE(bhs_tracer_render_progressive(&cfg, 0.5, &p) == 0,
+		    "progressivo: primeiro quadro incompleto");
+	ASSERT_TRUE(p.image.stats.rays == p.level_end[0] &&
+			    p.level_end[0] == 6 * 4,
+		    "progressivo: nível 0 passa do prazo, mas só ele");
+	int coarse = 1;
+	for (int y = 0; y < cfg.height; y++) {
+		for (int x = 0; x < cfg.width; x++) {
+			const float *a = p.image.rgb +
+					 ((size_t)y * cfg.width + x) * 3;
+			const float *b = ref.rgb + ((size_t)(y & ~7) *
+							    cfg.width +
+						    (x & ~7)) * 3;
+			coarse &= memcmp(a, b, 3 * sizeof(float)) == 0;
+		}
+	}
+	ASSERT_TRUE(coarse, "progressivo: blocos 8x8 com a amostra do canto");
+
+	/* Quadros seguintes continuam; a soma de raios é um por pixel */
+	long rays = p.image.stats.rays;
+	int frames = 1, rc = 0;
+	while (rc == 0 && frames < 1000) {
+		rc = bhs_tracer_render_progressive(&cfg, 3.0, &p);
+		rays += p.image.stats.rays;
+		frames++;
+	}
+	ASSERT_TRUE(rc == 1 && frames > 10, "progressivo: termina aos poucos");
+	ASSERT_TRUE(rays == (long)cfg.width * cfg.height,
+		    "progressivo: nenhum pixel traçado duas vezes");
+	ASSERT_TRUE(memcmp(p.image.rgb, ref.rgb, bytes) == 0,
+		    "progressivo: final igual ao render completo");
+
+	ASSERT_TRUE(bhs_tracer_render_progressive(&cfg, 3.0, &p) == 1 &&
+			    p.image.stats.rays == 0,
+		    "progressivo: completo não traça de novo");
+
+	/* Câmera nova recomeça do nível 0 */
+	cfg.camera.azimuth = 0.1;
+	ASSERT_TRUE(bhs_tracer_render_progressive(&cfg, 0.5, &p) == 0 &&
+			    p.image.stats.rays == p.level_end[0],
+		    "progressivo: câmera nova recomeça");
+
+	/* Sem prazo e com threads: tudo de uma vez, mesmo resultado */
+	cfg = make_config(4);
+	bhs_tracer_progress_free(&p);
+	p.clock = NULL;
+	ASSERT_TRUE(bhs_tracer_render_progressive(&cfg, 0.0, &p) == 1,
+		    "progressivo: sem prazo completa");
+	ASSERT_TRUE(memcmp(p.image.rgb, ref.rgb, bytes) == 0,
+		    "progressivo: threads não mudam a imagem");
+
+	bhs_tracer_progress_free(&p);
+	bhs_tracer_image_free(&ref);
+}
+
+static double mean_abs_diff(const struct bhs_tracer_image *a,
+			    const struct bhs_tracer_image *b)
+{
+	size_t n = (size_t)a->width * a->height * 3;
+	double sum = 0.0;
+
+	for (size_t i = 0; i < n; i++)
+		sum += fabs(a->rgb[i] - b->rgb[i]);
+	return sum / n;
+}
+
+static void test_temporal()
+{
+	struct bhs_tracer_config cfg = make_config(2);
+	struct bhs_tracer_image ref, img;
+	struct bhs_tracer_history h;
+	long pixels = (long)cfg.width * cfg.height;
+
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &ref) == 0,
+		    "temporal: render de referência");
+	size_t bytes = (size_t)ref.width * ref.height * 3 * sizeof(float);
+
+	/* Sem histórico traça tudo e sai igual ao render */
+	bhs_tracer_history_init(&h);
+	ASSERT_TRUE(bhs_tracer_render_temporal(&cfg, &h, &img) == 0,
+		    "temporal: primeiro quadro");
+	ASSERT_TRUE(img.stats.rays == pixels &&
+			    memcmp(img.rgb, ref.rgb, bytes) == 0,
+		    "temporal: primeiro quadro igual ao render");
+	bhs_tracer_image_free(&img);
+
+	/* Mesma câmera: tudo copiado, nada traçado */
+	ASSERT_TRUE(bhs_tracer_render_temporal(&cfg, &h, &img) == 0 &&
+			    img.stats.rays == 0 &&
+			    memcmp(img.rgb, ref.rgb, bytes) == 0,
+		    "temporal: câmera parada não traça");
+	bhs_tracer_image_free(&img);
+	bhs_tracer_image_free(&ref);
+
+	/* Azimute girando: Kerr é axissimétrico, ainda nada traçado */
+	cfg.camera.azimuth = 0.05;
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &ref) == 0 &&
+			    bhs_tracer_render_temporal(&cfg, &h, &img) == 0,
+		    "temporal: azimute");
+	ASSERT_TRUE(img.stats.rays == 0, "temporal: azimute não traça");
+	ASSERT_TRUE(mean_abs_diff(&img, &ref) < 1e-4,
+		    "temporal: azimute igual ao render");
+	bhs_tracer_image_free(&img);
+	bhs_tracer_image_free(&ref);
+
+	/*
+	 * Câmera descendo um pouco: só bordas de sombra e disco e o disco
+	 * interno (que já mudava muito entre pixels) são traçados de novo.
+	 * Em 48x27 as bordas são boa parte da imagem.
+	 */
+	cfg.camera.inclination += 0.2 * M_PI / 180.0;
+	cfg.camera.distance -= 0.05;
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &ref) == 0 &&
+			    bhs_tracer_render_temporal(&cfg, &h, &img) == 0,
+		    "temporal: câmera em movimento");
+	ASSERT_TRUE(img.stats.rays > 0 && img.stats.rays < pixels * 2 / 3,
+		    "temporal: movimento pequeno reaproveita o resto");
+	ASSERT_TRUE(mean_abs_diff(&img, &ref) < 1e-2,
+		    "temporal: reprojeção perto do render");
+	bhs_tracer_image_free(&img);
+	bhs_tracer_image_free(&ref);
+
+	/* Outro spin invalida o histórico */
+	cfg.bh.a = 0.5;
+	cfg.disk.inner_radius = bhs_disk_isco(&cfg.bh);
+	ASSERT_TRUE(bhs_tracer_render_temporal(&cfg, &h, &img) == 0 &&
+			    img.stats.rays == pixels,
+		    "temporal: spin novo traça tudo");
+	bhs_tracer_image_free(&img);
+
+	/* Outra integração também, mesmo com a câmera parada */
+	cfg.geo.dlambda *= 0.5;
+	ASSERT_TRUE(bhs_tracer_render_temporal(&cfg, &h, &img) == 0 &&
+			    img.stats.rays == pixels,
+		    "temporal: passo novo traça tudo");
+	bhs_tracer_image_free(&img);
+
+	bhs_tracer_history_free(&h);
+}
+
+/* Um raio só, de parâmetro de impacto ~b, pelo volume; devolve o status */
+static enum bhs_geodesic_status volume_ray(const struct bhs_volume *vol,
+					   double distance, double b,
+					   struct bhs_volume_ray *ray)
+{
+	struct bhs_tracer_config cfg = {
+		.width = 1,
+		.height = 1,
+		.bh = vol->bh,
+		.camera = {
+			.distance = distance,
+			.inclination = M_PI / 2.0,
+			.fov = 10.0 * M_PI / 180.0,
+		},
+		.geo = {
+			.dlambda = 0.1,
+			.max_steps = 100000,
+			.escape_radius = 2.0 * distance,
+			.tolerance = 1e-8,
+		},
+	};
+	struct bhs_geodesic geo;
+	struct bhs_geodesic_config gc = cfg.geo;
+	double u = tan(asin(b / distance)) / tan(cfg.camera.fov / 2.0);
+
+	bhs_tracer_pixel_ray(&cfg, u / 2.0, 0.0, &geo);
+	bhs_volume_ray_attach(ray, vol, &geo, &gc);
+	return bhs_geodesic_propagate(&geo, &vol->bh, &gc);
+}
+
+static void test_volume()
+{
+	struct bhs_volume vol = {
+		.bh = { .M = 1.0, .a = 0.0 },
+		.count = 1,
+		.comp[0] = {
+			.shape = BHS_VOLUME_CORONA,
+			.r_in = 10.0,
+			.r_out = 12.0,
+			.emissivity = 0.1,
+			.color = { 1.0f, 1.0f, 1.0f },
+		},
+	};
+	struct bhs_volume_ray near, far;
+
+	ASSERT_TRUE(bhs_volume_init(&vol) == 0, "volume: init");
+
+	/* Casca fina opticamente fina: a luz é j ∫ g³ dl pela corda */
+	volume_ray(&vol, 50.0, 11.0, &near);
+	volume_ray(&vol, 400.0, 11.0, &far);
+	double g = sqrt(1.0 - 2.0 / 11.5);
+	double chord = 2.0 * sqrt(12.0 * 12.0 - 11.0 * 11.0);
+	ASSERT_TRUE(fabs(near.emission.r / (0.1 * g * g * g * chord) - 1.0) <
+			    0.15,
+		    "volume: casca fina bate com a corda");
+	ASSERT_TRUE(fabs(far.emission.r / near.emission.r - 1.0) < 0.03 &&
+			    near.transmittance == 1.0,
+		    "volume: câmera longe não muda a luz");
+
+	/* Custo é a matéria atravessada, não o caminho (8x mais longo) */
+	ASSERT_TRUE(near.samples > chord / BHS_VOLUME_STEP * 0.5 &&
+			    far.samples < near.samples * 1.1,
+		    "volume: amostras só dentro da matéria");
+
+	/* Opaco: para na superfície, com a luz saturada em g⁴ j / α */
+	vol.comp[0].absorption = 100.0;
+	ASSERT_TRUE(volume_ray(&vol, 50.0, 0.0, &near) == BHS_GEO_ABSORBED,
+		    "volume: meio opaco absorve o raio");
+	double g4 = (1.0 - 2.0 / 12.0) * (1.0 - 2.0 / 12.0);
+	ASSERT_TRUE(fabs(near.emission.r / (g4 * 0.1 / 100.0) - 1.0) < 0.02 &&
+			    near.samples < 10,
+		    "volume: superfície opaca emite a função fonte");
+
+	/* Grade conservadora: onde há densidade, a célula é ocupada */
+	vol.count = 2;
+	vol.comp[1] = (struct bhs_volume_component){
+		.shape = BHS_VOLUME_THICK_DISK,
+		.r_in = 4.0,
+		.r_out = 20.0,
+		.h_over_r = 0.1,
+		.power = 1.0,
+	};
+	ASSERT_TRUE(bhs_volume_init(&vol) == 0 && vol.r_min == 4.0 &&
+			    vol.r_max == 20.0,
+		    "volume: casca envolve os componentes");
+	int missed = 0, empty = 0;
+	for (int i = 0; i < BHS_VOLUME_GRID; i++) {
+		for (int j = 0; j < BHS_VOLUME_GRID; j++) {
+			double r = vol.r_min + (i + 0.5) / BHS_VOLUME_GRID *
+						       (vol.r_max - vol.r_min);
+			double th = vol.theta_lo +
+				    (j + 0.5) / BHS_VOLUME_GRID *
+					    (M_PI - 2.0 * vol.theta_lo);
+			double rho = bhs_volume_density(&vol.comp[0], r, th) +
+				     bhs_volume_density(&vol.comp[1], r, th);
+			missed += rho > 0.0 && vol.dist[i][j] != 0;
+			empty += vol.dist[i][j] != 0;
+		}
+	}
+	ASSERT_TRUE(missed == 0 && empty > 0, "volume: grade de ocupação");
+
+	vol.comp[1].r_out = 2.0;
+	ASSERT_TRUE(bhs_volume_init(&vol) != 0, "volume: raios inválidos");
+
+	/* No tracer, volume sem emissão nem absorção não muda nada */
+	struct bhs_tracer_config cfg = make_config(2);
+	struct bhs_tracer_image ref, img;
+	cfg.geo.tolerance = 1e-7;
+	vol.bh = cfg.bh;
+	vol.comp[0].absorption = 0.0;
+	vol.comp[0].emissivity = 0.0;
+	vol.comp[1].r_out = 20.0;
+	bhs_volume_init(&vol);
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &ref) == 0, "volume: referência");
+	cfg.volume = &vol;
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &img) == 0 &&
+			    memcmp(img.rgb, ref.rgb,
+				   (size_t)ref.width * ref.height * 3 *
+					   sizeof(float)) == 0,
+		    "volume: meio vazio deixa a imagem igual");
+	ASSERT_TRUE(img.stats.steps == ref.stats.steps &&
+			    img.stats.volume_samples > 0,
+		    "volume: não mexe no passo do integrador");
+	bhs_tracer_image_free(&img);
+
+	/* Disco grosso emissor acende pixels que eram céu */
+	vol.comp[1].emissivity = 0.05;
+	vol.comp[1].absorption = 0.05;
+	vol.comp[1].color = (struct bhs_color_rgb){ 1.0f, 0.6f, 0.3f };
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &img) == 0, "volume: render");
+	int brighter = 0;
+	for (int i = 0; i < img.width * img.height; i++)
+		brighter += img.rgb[i * 3] > ref.rgb[i * 3] + 0.05f;
+	ASSERT_TRUE(brighter > img.width * img.height / 10,
+		    "volume: disco grosso aparece na imagem");
+	bhs_tracer_image_free(&img);
+
+	/* Cache e reprojeção guardam só o destino: recusam o volume */
+	struct bhs_tracer_history h;
+	bhs_tracer_history_init(&h);
+	ASSERT_TRUE(bhs_tracer_render_temporal(&cfg, &h, &img) != 0,
+		    "volume: render temporal recusa");
+	ASSERT_TRUE(bhs_tracer_render_cached(&cfg, ".", &img) != 0,
+		    "volume: render com cache recusa");
+	bhs_tracer_history_free(&h);
+
+	/*
+	 * Passos longos (rtol 1e-3) começando perto de um retorno polar, fora
+	 * da faixa do disco: v_θ ≈ 0 prometia saltar o passo inteiro. A
+	 * referência ocupa todas as células com uma coroa sem emissão, o que
+	 * desliga os saltos.
+	 */
+	struct bhs_volume skip_vol = {
+		.bh = cfg.bh,
+		.count = 1,
+		.comp[0] = {
+			.shape = BHS_VOLUME_THICK_DISK,
+			.r_in = 4.0,
+			.r_out = 100.0,
+			.h_over_r = 0.1,
+			.power = 0.5,
+			.emissivity = 0.05,
+			.color = { 1.0f, 1.0f, 1.0f },
+		},
+	};
+	struct bhs_volume dense_vol = skip_vol;
+	dense_vol.count = 2;
+	dense_vol.comp[1] = (struct bhs_volume_component){
+		.shape = BHS_VOLUME_CORONA,
+		.r_in = 3.0,
+		.r_out = 150.0,
+	};
+	bhs_volume_init(&skip_vol);
+	bhs_volume_init(&dense_vol);
+	struct bhs_tracer_config turn = {
+		.width = 1,
+		.height = 1,
+		.bh = cfg.bh,
+		.camera = {
+			.distance = 90.0,
+			.inclination = 50.0 * M_PI / 180.0,
+			.fov = 120.0 * M_PI / 180.0,
+		},
+		.geo = {
+			.dlambda = 1.0,
+			.max_steps = 100000,
+			.escape_radius = 200.0,
+			.tolerance = 1e-3,
+		},
+	};
+	int lost = 0;
+	for (int k = 0; k < 9; k++) {
+		struct bhs_geodesic g0, g1;
+		struct bhs_volume_ray r0, r1;
+		struct bhs_geodesic_config c0 = turn.geo, c1 = turn.geo;
+
+		bhs_tracer_pixel_ray(&turn, -0.1 + 0.025 * k, 0.1, &g0);
+		g1 = g0;
+		bhs_volume_ray_attach(&r0, &skip_vol, &g0, &c0);
+		bhs_volume_ray_attach(&r1, &dense_vol, &g1, &c1);
+		bhs_geodesic_propagate(&g0, &turn.bh, &c0);
+		bhs_geodesic_propagate(&g1, &turn.bh, &c1);
+		lost += fabs(r0.emission.r / r1.emission.r - 1.0) > 0.02;
+	}
+	ASSERT_TRUE(lost == 0, "volume: salto não pula o disco no retorno");
+
+	/* Métrica tabelada não é Kerr: recusa em vez de trocar de modo */
+	struct bhs_geodesic geo;
+	struct bhs_volume_ray ray;
+	struct bhs_geodesic_config gc = { .mode = BHS_GEO_MODE_METRIC };
+	bhs_tracer_pixel_ray(&cfg, 0.0, 0.0, &geo);
+	ASSERT_TRUE(bhs_volume_ray_attach(&ray, &vol, &geo, &gc) != 0 &&
+			    gc.mode == BHS_GEO_MODE_METRIC && !gc.on_step,
+		    "volume: recusa a métrica tabelada");
+	cfg.geo.mode = BHS_GEO_MODE_METRIC;
+	ASSERT_TRUE(bhs_tracer_render(&cfg, &img) != 0,
+		    "volume: render recusa a métrica tabelada");
+	bhs_tracer_image_free(&ref);
+}
+
+/* ============================================================================
+ * MAIN
+ * ============================================================================
+ */
+
+int main()
+{
+	printf("=== [BHS TRACER TEST SUITE] ===\n");
+
+	test_threads_bit_identical();
+	test_adaptive_refinement();
+	test_deflection_cache();
+	test_shortcut_stats();
+	test_disk_shade_batch();
+	test_disk_g_factor();
+	test_transfer();
+	test_spectrum();
+	test_spectral_render();
+	test_progressive();
+	test_temporal();
+	test_volume();
+
+	printf("\nResultados:\n");
+	printf("  Rodados: %d\n", tests_run);
+	printf("  Falhas:  %d\n", tests_failed);
+
+	return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+/**
+ * @file main.c
+ * @brief bhs_tracer - Render headless do buraco negro na CPU
+ *
+ * "Nem toda máquina tem GPU. Todo buraco negro tem geodésicas."
+ *
+ * Uso:
+ *   bhs_tracer [-W largura] [-H altura] [-a spin] [-d distância]
+ *              [-i inclinação°] [-f fov°] [-j threads] [-e tolerância]
+ *              [-r célula] [-t limiar] [-c dir_cache] [-x] [-k] [-E]
+ *              [-l tabela] [-m métrica] [-s kelvin] [-p ms]
+ *              [-F quadros] [-T H/r] [-C raio] [-o saída.pfm]
+ *
+ * -e 0 volta ao RK4 de passo fixo. -r N liga o render adaptativo com
+ * células grossas de N pixels (8 é um bom preview); -t muda o limiar de
+ * |Δr|/r e |Δz| entre cantos que pede subdivisão. -c usa (e preenche) o
+ * cache de mapas de deflexão no diretório: a segunda vez que a mesma
+ * câmera renderiza não traça nenhuma geodésica. -x desliga os atalhos
+ * analíticos (sombra e campo fraco) e integra todo raio até o fim. -k
+ * integra em Kerr-Schild: para câmeras perto do horizonte, onde os raios
+ * capturados dominam o custo em Boyer-Lindquist. -E fecha cada fóton em
+ * forma analítica (integrais elípticas, kerr_elliptic.h): sem passo, sem
+ * erro de integração e com o mesmo custo rente à esfera de fótons, para
+ * imagens finais. Com -a 0 (e sem -k nem -E) os raios vão pelo caminho
+ * planar de Schwarzschild (equação de Binet); -l arquivo ainda troca a
+ * integração por consulta à tabela de órbitas (planar_lut.h) dessa
+ * distância de câmera, montada e gravada no arquivo se faltar ou for de
+ * outra configuração. -m arquivo troca Kerr por uma métrica tabelada
+ * (metric_table.h), mapeada do disco: o spin ainda define o ISCO do
+ * disco, e -c é ignorado (a chave do mapa de deflexão não conhece a
+ * tabela). -s colore o disco pelo espectro de corpo negro com o g exato
+ * de cada raio, com o anel mais quente na temperatura dada (0 = padrão);
+ * a saída vira HDR, com Y = 1 nesse anel. -p ms renderiza um quadro de
+ * preview com esse orçamento (bhs_tracer_render_progressive): a grade
+ * grossa sempre sai inteira e o que sobrar do tempo refina; -c e -r são
+ * ignorados. -F N renderiza um voo de N quadros (a câmera desce 0,1° e
+ * gira 0,5° por quadro) com bhs_tracer_render_temporal e grava o último:
+ * cada quadro só traça o que não reprojeta do anterior. -T h cobre o
+ * disco com um disco grosso volumétrico de altura H/r = h e -C r põe uma
+ * coroa do horizonte até o raio r (volume.h): emissão e absorção somadas
+ * ao longo do raio, com DOPRI5 mesmo sem -e; -c é ignorado (o mapa de
+ * deflexão não guarda o volume) e -k, -E e -m são recusados.
+ */
+
+#define _GNU_SOURCE /* Para M_PI, getopt e clock_gettime */
+
+#include "engine/physics/geodesic/metric_table.h"
+#include "engine/physics/geodesic/planar_lut.h"
+#include "engine/render/tracer.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static void usage(const char *argv0)
+{
+	fprintf(stderr,
+		"uso: %s [-W largura] [-H altura] [-a spin] [-d distancia]\n"
+		"          [-i inclinacao_graus] [-f fov_graus] [-j threads]\n"
+		"          [-e tolerancia] [-r celula] [-t limiar]\n"
+		"          [-c dir_cache] [-x] [-k] [-E] [-l tabela]\n"
+		"          [-m metrica] [-s kelvin] [-p ms] [-F quadros]\n"
+		"          [-T h_sobre_r] [-C raio] [-o saida.pfm]\n",
+		argv0);
+}
+
+static double now_seconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+	const char *output = "blackhole.pfm";
+	const char *cache_dir = NULL;
+	const char *lut_path = NULL;
+	const char *metric_path = NULL;
+	double spin = 0.9;
+	double budget_ms = 0.0;
+	int frames = 0;
+	double thick_h = 0.0;
+	double corona_r = 0.0;
+	bool shortcuts = true;
+
+	struct bhs_tracer_config cfg = {
+		.width = 640,
+		.height = 360,
+		.bh = { .M = 1.0, .a = 0.0 },
+		.disk = { .outer_radius = 20.0, .mdot = 1.0 },
+		.camera = {
+			.distance = 30.0,
+			.inclination = 80.0 * M_PI / 180.0,
+			.fov = 60.0 * M_PI / 180.0,
+		},
+		.geo = {
+			.dlambda = 0.05,
+			.max_steps = 20000,
+			.escape_radius = 60.0,
+			.tolerance = 1e-7,
+			.shadow_capture = true,
+		},
+	};
+
+	int opt;
+	while ((opt = getopt(argc, argv, "W:H:a:d:i:f:j:e:r:t:c:xkEl:m:s:p:F:T:C:o:")) != -1) {
+		switch (opt) {
+		case 'W':
+			cfg.width = atoi(optarg);
+			break;
+		case 'H':
+			cfg.height = atoi(optarg);
+			break;
+		case 'a':
+			spin = atof(optarg);
+			break;
+		case 'd':
+			cfg.camera.distance = atof(optarg);
+			break;
+		case 'i':
+			cfg.camera.inclination = atof(optarg) * M_PI / 180.0;
+			break;
+		case 'f':
+			cfg.camera.fov = atof(optarg) * M_PI / 180.0;
+			break;
+		case 'j':
+			cfg.threads = atoi(optarg);
+			break;
+		case 'e':
+			cfg.geo.tolerance = atof(optarg);
+			break;
+		case 'r':
+			cfg.refine_cell = atoi(optarg);
+			break;
+		case 't':
+			cfg.refine_threshold = atof(optarg);
+			break;
+		case 'c':
+			cache_dir = optarg;
+			break;
+		case 'x':
+			shortcuts = false;
+			break;
+		case 'k':
+			cfg.geo.mode = BHS_GEO_MODE_KERR_SCHILD;
+			break;
+		case 'E':
+			cfg.geo.mode = BHS_GEO_MODE_ELLIPTIC;
+			break;
+		case 'l':
+			lut_path = optarg;
+			break;
+		case 'm':
+			metric_path = optarg;
+			break;
+		case 's':
+			cfg.spectral = true;
+			cfg.disk_temperature = atof(optarg);
+			break;
+		case 'p':
+			budget_ms = atof(optarg);
+			break;
+		case 'F':
+			frames = atoi(optarg);
+			break;
+		case 'T':
+			thick_h = atof(optarg);
+			break;
+		case 'C':
+			corona_r = atof(optarg);
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	/* O volume amostra o DOPRI5 de Boyer-Lindquist em Kerr */
+	if ((thick_h > 0.0 || corona_r > 0.0) &&
+	    (metric_path || cfg.geo.mode != BHS_GEO_MODE_CHRISTOFFEL)) {
+		fprintf(stderr, "bhs_tracer: -T e -C não combinam com -k, -E "
+				"nem -m\n");
+		return EXIT_FAILURE;
+	}
+
+	cfg.bh.a = spin * cfg.bh.M;
+
+	struct bhs_metric_table metric = { 0 };
+	if (metric_path) {
+		if (bhs_metric_table_open(&metric, metric_path) != 0) {
+			fprintf(stderr, "bhs_tracer: métrica inválida: %s\n",
+				metric_path);
+			return EXIT_FAILURE;
+		}
+		bhs_metric_table_use(&metric, &cfg.geo);
+		cache_dir = NULL;
+	}
+
+	/* Sem spin toda geodésica é plana: uma EDO 1D em vez de quatro */
+	if (cfg.bh.a == 0.0 && cfg.geo.mode == BHS_GEO_MODE_CHRISTOFFEL)
+		cfg.geo.mode = BHS_GEO_MODE_PLANAR;
+	cfg.disk.inner_radius = bhs_disk_isco(&cfg.bh);
+	cfg.disk.inclination = cfg.camera.inclination;
+
+	/* Escape precisa ficar além da câmera, senão o raio nasce "escapado" */
+	if (cfg.geo.escape_radius <= cfg.camera.distance)
+		cfg.geo.escape_radius = 2.0 * cfg.camera.distance;
+
+	/* Depois da câmera a curvatura já é fraca: Binet fecha o resto */
+	cfg.geo.shadow_capture = shortcuts;
+	cfg.geo.far_field_radius = shortcuts ? cfg.camera.distance : 0.0;
+
+	struct bhs_planar_lut lut = { 0 };
+	if (lut_path && cfg.geo.mode == BHS_GEO_MODE_PLANAR) {
+		struct bhs_planar_lut_key key = {
+			.M = cfg.bh.M,
+			.r_obs = cfg.camera.distance,
+			.escape_radius = cfg.geo.escape_radius,
+		};
+		if (bhs_planar_lut_open(&lut, lut_path, &key) != 0) {
+			double tb = now_seconds();
+			if (bhs_planar_lut_build(&lut, &key) != 0) {
+				fprintf(stderr, "bhs_tracer: falha na tabela\n");
+				return EXIT_FAILURE;
+			}
+			if (bhs_planar_lut_save(&lut, lut_path) != 0)
+				fprintf(stderr, "bhs_tracer: falha ao gravar %s\n",
+					lut_path);
+			printf("tabela de órbitas montada em %.2fs -> %s\n",
+			       now_seconds() - tb, lut_path);
+		}
+		cfg.geo.planar_lut = &lut;
+	}
+
+	struct bhs_volume vol = { .bh = cfg.bh };
+	if (thick_h > 0.0) {
+		vol.comp[vol.count++] = (struct bhs_volume_component){
+			.shape = BHS_VOLUME_THICK_DISK,
+			.r_in = cfg.disk.inner_radius,
+			.r_out = cfg.disk.outer_radius,
+			.h_over_r = thick_h,
+			.power = 1.5,
+			.emissivity = 0.05,
+			.absorption = 0.1,
+			.color = { 1.0f, 0.7f, 0.4f },
+		};
+	}
+	if (corona_r > 0.0) {
+		vol.comp[vol.count++] = (struct bhs_volume_component){
+			.shape = BHS_VOLUME_CORONA,
+			.r_in = 1.05 * bhs_kerr_horizon_outer(&cfg.bh),
+			.r_out = corona_r,
+			.power = 2.0,
+			.emissivity = 0.05,
+			.color = { 0.5f, 0.7f, 1.0f },
+		};
+	}
+	if (vol.count > 0) {
+		if (bhs_volume_init(&vol) != 0) {
+			fprintf(stderr, "bhs_tracer: volume inválido\n");
+			bhs_planar_lut_free(&lut);
+			bhs_metric_table_free(&metric);
+			return EXIT_FAILURE;
+		}
+		cfg.volume = &vol;
+		cache_dir = NULL;
+	}
+
+	struct bhs_tracer_image img;
+	struct bhs_tracer_progress prog;
+	double coverage = 1.0;
+	double t0 = now_seconds();
+	int ret;
+	if (budget_ms > 0.0) {
+		bhs_tracer_progress_init(&prog);
+		ret = bhs_tracer_render_progressive(&cfg, budget_ms * 1e-3,
+						    &prog);
+		if (ret >= 0) {
+			coverage = (double)prog.cursor /
+				   prog.level_end[prog.levels - 1];
+			img = prog.image;
+			prog.image.rgb = NULL;
+			ret = 0;
+		}
+		bhs_tracer_progress_free(&prog);
+	} else if (frames > 0) {
+		struct bhs_tracer_history hist;
+		long rays = 0;
+
+		bhs_tracer_history_init(&hist);
+		ret = 0;
+		for (int f = 0; f < frames && ret == 0; f++) {
+			if (f > 0) {
+				bhs_tracer_image_free(&img);
+				cfg.camera.inclination += 0.1 * M_PI / 180.0;
+				cfg.camera.azimuth += 0.5 * M_PI / 180.0;
+			}
+			ret = bhs_tracer_render_temporal(&cfg, &hist, &img);
+			if (ret == 0)
+				rays += img.stats.rays;
+		}
+		if (ret == 0)
+			coverage = (double)rays / ((double)frames * cfg.width *
+						   cfg.height);
+		bhs_tracer_history_free(&hist);
+	} else {
+		ret = cache_dir
+			      ? bhs_tracer_render_cached(&cfg, cache_dir, &img)
+			      : bhs_tracer_render(&cfg, &img);
+	}
+	if (ret != 0) {
+		fprintf(stderr, "bhs_tracer: falha no render\n");
+		bhs_planar_lut_free(&lut);
+		bhs_metric_table_free(&metric);
+		return EXIT_FAILURE;
+	}
+	double t1 = now_seconds();
+
+	if (bhs_tracer_write_pfm(&img, output) != 0) {
+		fprintf(stderr, "bhs_tracer: falha ao escrever %s\n", output);
+		bhs_tracer_image_free(&img);
+		bhs_planar_lut_free(&lut);
+		bhs_metric_table_free(&metric);
+		return EXIT_FAILURE;
+	}
+
+	printf("%dx%d a=%.3f em %.2fs, %ld raios, %ld passos "
+	       "(%ld sombra, %ld campo fraco) -> %s\n",
+	       cfg.width, cfg.height, spin, t1 - t0, img.stats.rays,
+	       img.stats.steps, img.stats.shadow_exits,
+	       img.stats.far_field_exits, output);
+	if (cfg.volume)
+		printf("volume: %ld amostras em matéria\n",
+		       img.stats.volume_samples);
+	if (budget_ms > 0.0)
+		printf("preview: %.1f%% dos pixels traçados\n",
+		       100.0 * coverage);
+	else if (frames > 0)
+		printf("voo: %d quadros, %.1f%% dos pixels traçados\n", frames,
+		       100.0 * coverage);
+
+	bhs_tracer_image_free(&img);
+	bhs_planar_lut_free(&lut);
+	bhs_metric_table_free(&metric);
+	return EXIT_SUCCESS;
+}